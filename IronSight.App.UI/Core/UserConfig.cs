@@ -14,6 +14,8 @@ namespace IronSight.App.UI.Core
         public int SamplingIntervalMs { get; set; } = 1000;
         public bool IsAutoStart { get; set; } = false;
         public bool AlwaysOnTop { get; set; } = false;
+        public bool IsFlightRecorderEnabled { get; set; } = false;  // 持续录制系统/进程/连接快照到本地分段文件
+        public bool IsAutoTrimEnabled { get; set; } = false;        // 可用内存低于水位时自动回收工作集
     }
 
     /// <summary>
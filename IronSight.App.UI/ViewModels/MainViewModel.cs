@@ -7,6 +7,7 @@ using IronSight.App.UI.Core;
 using IronSight.Interop.Core;
 using IronSight.Interop.Events;
 using IronSight.Interop.Native.Memory;
+using IronSight.Interop.Native.Recorder;
 using IronSight.Interop.Services;
 
 namespace IronSight.App.UI.ViewModels
@@ -15,6 +16,7 @@ namespace IronSight.App.UI.ViewModels
     {
         private readonly SystemMonitorService _systemMonitor;
         private readonly ClipboardService _clipboardService;
+        private readonly ConfigService _configService;
 
         private string _statusMessage = "System Ready";
         private double _cpuUsage;
@@ -50,6 +52,40 @@ namespace IronSight.App.UI.ViewModels
             set => SetProperty(ref _diskWriteRate, value);
         }
 
+        /// <summary>
+        /// 飞行记录开关：切换时立即开始/停止录制并保存到配置
+        /// </summary>
+        public bool IsFlightRecorderEnabled
+        {
+            get => _configService.CurrentConfig.IsFlightRecorderEnabled;
+            set
+            {
+                if (_configService.CurrentConfig.IsFlightRecorderEnabled == value) return;
+
+                _configService.CurrentConfig.IsFlightRecorderEnabled = value;
+                _configService.Save();
+                ApplyFlightRecorder();
+                OnPropertyChanged();
+            }
+        }
+
+        /// <summary>
+        /// 内存压力自动回收开关：切换时立即启动/停止监视并保存到配置
+        /// </summary>
+        public bool IsAutoTrimEnabled
+        {
+            get => _configService.CurrentConfig.IsAutoTrimEnabled;
+            set
+            {
+                if (_configService.CurrentConfig.IsAutoTrimEnabled == value) return;
+
+                _configService.CurrentConfig.IsAutoTrimEnabled = value;
+                _configService.Save();
+                ApplyAutoTrim();
+                OnPropertyChanged();
+            }
+        }
+
         public ICommand CleanMemoryCommand { get; }
         public ICommand CopyClipboardItemCommand { get; }
 
@@ -61,6 +97,8 @@ namespace IronSight.App.UI.ViewModels
             // Initialize Services
             LoggerService.Initialize(); // Initialize Logging
 
+            _configService = new ConfigService();
+
             _systemMonitor = new SystemMonitorService();
             _systemMonitor.StatsUpdated += OnSystemStatsUpdated;
             _systemMonitor.Start();
@@ -68,6 +106,24 @@ namespace IronSight.App.UI.ViewModels
             _clipboardService = new ClipboardService();
             _clipboardService.ClipboardChanged += OnClipboardChanged;
             _clipboardService.Start();
+
+            // 采集服务已启动，录制从第一个周期开始
+            ApplyFlightRecorder();
+            ApplyAutoTrim();
+        }
+
+        private void ApplyFlightRecorder()
+        {
+            if (!_configService.CurrentConfig.IsFlightRecorderEnabled)
+            {
+                FlightRecorderMethods.FlightRecorder_Stop();
+                return;
+            }
+
+            if (!FlightRecorderMethods.FlightRecorder_Start(FlightRecorderMethods.DefaultDirectory, 0, 0))
+            {
+                LoggerService.Log(LogLevel.Warn, $"Flight recorder failed to start: {FlightRecorderMethods.DefaultDirectory}");
+            }
         }
 
         private void OnSystemStatsUpdated(object? sender, SystemStatsEventArgs e)
@@ -81,32 +137,32 @@ namespace IronSight.App.UI.ViewModels
             });
         }
 
-        private void OnClipboardChanged(object? sender, EventArgs e)
+        private void OnClipboardChanged(object? sender, ClipboardChangedEventArgs e)
         {
             Application.Current.Dispatcher.Invoke(() =>
             {
                 try
                 {
-                    if (Clipboard.ContainsText())
+                    // 文本已由原生层按条目 ID 取出；未保存的超大内容才回退到读取剪贴板
+                    string? text = e.Text ?? (e.EntryId == 0 && Clipboard.ContainsText() ? Clipboard.GetText() : null);
+                    if (!string.IsNullOrWhiteSpace(text))
                     {
-                        string text = Clipboard.GetText();
-                        if (!string.IsNullOrWhiteSpace(text))
+                        // 原生层为相同内容沿用同一个条目 ID，按 ID 查找即可
+                        var existing = null as ClipboardItem;
+                        foreach (var item in ClipboardHistory)
+                        {
+                            if (e.EntryId != 0 ? item.EntryId == e.EntryId : item.Content == text) { existing = item; break; }
+                        }
+
+                        if (existing != null)
+                        {
+                            ClipboardHistory.Move(ClipboardHistory.IndexOf(existing), 0);
+                            existing.Timestamp = DateTime.Now; // Update Time
+                        }
+                        else
                         {
-                            // Check for duplicates (simple check)
-                            // Move to top if exists?
-                            var existing = null as ClipboardItem;
-                            foreach (var item in ClipboardHistory) { if (item.Content == text) { existing = item; break; } }
-
-                            if (existing != null)
-                            {
-                                ClipboardHistory.Move(ClipboardHistory.IndexOf(existing), 0);
-                                existing.Timestamp = DateTime.Now; // Update Time
-                            }
-                            else
-                            {
-                                ClipboardHistory.Insert(0, new ClipboardItem { Content = text, Timestamp = DateTime.Now });
-                                if (ClipboardHistory.Count > 50) ClipboardHistory.RemoveAt(ClipboardHistory.Count - 1);
-                            }
+                            ClipboardHistory.Insert(0, new ClipboardItem { EntryId = e.EntryId, Content = text, Timestamp = DateTime.Now });
+                            if (ClipboardHistory.Count > 50) ClipboardHistory.RemoveAt(ClipboardHistory.Count - 1);
                         }
                     }
                 }
@@ -117,6 +173,22 @@ namespace IronSight.App.UI.ViewModels
             });
         }
 
+        private void ApplyAutoTrim()
+        {
+            if (!_configService.CurrentConfig.IsAutoTrimEnabled)
+            {
+                MemoryPressureMethods.MemoryPressure_Stop();
+                return;
+            }
+
+            // 全部参数取原生层默认值 (水位 10% / 20%，单次上限 256 MB)
+            var options = new MemoryPressureOptions();
+            if (!MemoryPressureMethods.MemoryPressure_Start(in options))
+            {
+                LoggerService.Log(LogLevel.Warn, "Memory pressure watcher failed to start");
+            }
+        }
+
         private void ExecuteCleanMemory()
         {
             StatusMessage = "Optimizing Memory...";
@@ -153,6 +225,9 @@ namespace IronSight.App.UI.ViewModels
 
         public void Dispose()
         {
+            // 写完已排队的帧再退出；回收线程在进行中的回收完成后退出
+            FlightRecorderMethods.FlightRecorder_Stop();
+            MemoryPressureMethods.MemoryPressure_Stop();
             _systemMonitor?.Dispose();
             _clipboardService?.Dispose();
         }
@@ -160,6 +235,7 @@ namespace IronSight.App.UI.ViewModels
 
     public class ClipboardItem
     {
+        public ulong EntryId { get; set; }
         public string Content { get; set; } = "";
         public DateTime Timestamp { get; set; }
         public string DisplayText => Content.Length > 50 ? Content.Substring(0, 50).Replace("\n", " ") + "..." : Content.Replace("\n", " ");
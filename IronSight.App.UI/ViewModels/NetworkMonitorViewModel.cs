@@ -2,7 +2,6 @@ using System.Collections.ObjectModel;
 using System.ComponentModel;
 using System.Diagnostics;
 using System.Runtime.CompilerServices;
-using System.Windows.Threading;
 using IronSight.Interop.Native.Network;
 using IronSight.Interop.Services;
 
@@ -35,11 +34,11 @@ namespace IronSight.App.UI.ViewModels
 
     /// <summary>
     /// 网络监控器ViewModel
+    /// 自动刷新由原生采样调度器完成，新一代连接表就绪后只读取快照，不再重复刷新
     /// </summary>
     public sealed class NetworkMonitorViewModel : BaseViewModel, IDisposable
     {
         private readonly NetworkService _monitor;
-        private readonly DispatcherTimer _refreshTimer;
         private readonly Dictionary<uint, string> _processNameCache;
         private readonly object _lockObject = new();
 
@@ -53,6 +52,7 @@ namespace IronSight.App.UI.ViewModels
         private bool _showTcp = true;
         private bool _showUdp = true;
         private string _filterText = string.Empty;
+        private bool _isRunning;
         private bool _disposed;
 
         public NetworkMonitorViewModel()
@@ -61,11 +61,7 @@ namespace IronSight.App.UI.ViewModels
             _connections = new ObservableCollection<NetworkConnectionDisplayModel>();
             _processNameCache = new Dictionary<uint, string>();
 
-            _refreshTimer = new DispatcherTimer
-            {
-                Interval = TimeSpan.FromMilliseconds(_refreshInterval)
-            };
-            _refreshTimer.Tick += OnRefreshTimerTick;
+            _monitor.SnapshotReady += OnSnapshotReady;
         }
 
         #region Properties
@@ -137,7 +133,7 @@ namespace IronSight.App.UI.ViewModels
                 if (Math.Abs(_refreshInterval - value) > 0.001)
                 {
                     _refreshInterval = Math.Max(100, value);
-                    _refreshTimer.Interval = TimeSpan.FromMilliseconds(_refreshInterval);
+                    ApplyTickRate();
                     OnPropertyChanged();
                 }
             }
@@ -153,10 +149,7 @@ namespace IronSight.App.UI.ViewModels
             {
                 if (SetProperty(ref _isAutoRefreshEnabled, value))
                 {
-                    if (value)
-                        _refreshTimer.Start();
-                    else
-                        _refreshTimer.Stop();
+                    ApplyTickRate();
                 }
             }
         }
@@ -215,10 +208,8 @@ namespace IronSight.App.UI.ViewModels
         /// </summary>
         public void Start()
         {
-            if (_isAutoRefreshEnabled)
-            {
-                _refreshTimer.Start();
-            }
+            _isRunning = true;
+            ApplyTickRate();
 
             _ = RefreshAsync();
         }
@@ -228,13 +219,16 @@ namespace IronSight.App.UI.ViewModels
         /// </summary>
         public void Stop()
         {
-            _refreshTimer.Stop();
+            _isRunning = false;
+            ApplyTickRate();
         }
 
         /// <summary>
         /// 手动刷新
         /// </summary>
-        public async Task RefreshAsync()
+        public Task RefreshAsync() => LoadConnectionsAsync(refreshFirst: true);
+
+        private async Task LoadConnectionsAsync(bool refreshFirst)
         {
             if (_disposed || IsRefreshing) return;
 
@@ -246,7 +240,7 @@ namespace IronSight.App.UI.ViewModels
                 {
                     lock (_lockObject)
                     {
-                        _monitor.Refresh();
+                        if (refreshFirst) _monitor.Refresh();
                         return _monitor.GetConnectionsList();
                     }
                 });
@@ -274,12 +268,26 @@ namespace IronSight.App.UI.ViewModels
 
         #region Private Methods
 
-        private void OnRefreshTimerTick(object? sender, EventArgs e)
+        private void ApplyTickRate()
         {
-            _ = RefreshAsync();
+            if (_disposed) return;
+
+            // 后台刷新只在监控运行且启用自动刷新时进行，TimeSpan.Zero 停止后台刷新
+            _monitor.UpdateTickRate(_isRunning && _isAutoRefreshEnabled
+                ? TimeSpan.FromMilliseconds(_refreshInterval)
+                : TimeSpan.Zero);
+        }
+
+        private void OnSnapshotReady(object? sender, ulong generation)
+        {
+            // 在原生采样线程上触发：连接表已由后台刷新，切换到 UI 线程后只读取新快照
+            System.Windows.Application.Current?.Dispatcher.InvokeAsync(() =>
+            {
+                _ = LoadConnectionsAsync(refreshFirst: false);
+            });
         }
 
-        private void UpdateConnections(List<NetworkConnectionInfo> connections)
+        private void UpdateConnections(List<NetworkConnectionEntry> connections)
         {
             var displayModels = new List<NetworkConnectionDisplayModel>();
 
@@ -414,7 +422,7 @@ namespace IronSight.App.UI.ViewModels
             if (_disposed) return;
 
             _disposed = true;
-            _refreshTimer.Stop();
+            _monitor.SnapshotReady -= OnSnapshotReady;
             _monitor.Dispose();
         }
 
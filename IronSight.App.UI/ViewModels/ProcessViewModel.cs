@@ -1,5 +1,6 @@
 using IronSight.App.UI.Core;
 using IronSight.Interop.Core;
+using IronSight.Interop.Native.Metrics;
 using IronSight.Interop.Native.System;
 using IronSight.Interop.Services;
 using System;
@@ -12,6 +13,7 @@ using System.Text;
 using System.Windows;
 using System.Windows.Data;
 using System.Windows.Input;
+using System.Windows.Media;
 
 namespace IronSight.App.UI.ViewModels
 {
@@ -26,6 +28,12 @@ namespace IronSight.App.UI.ViewModels
         private ProcessDetailInfo? _selectedProcess;
         private uint _processCount;
         private uint _totalHandleCount;
+        private PointCollection _selectedCpuHistory = new();
+
+        // 状态栏迷你折线图：选中进程最近 5 分钟的 CPU 占用 (原生历史存储按 1 秒聚合)
+        private static readonly TimeSpan HistoryWindow = TimeSpan.FromMinutes(5);
+        private const double HistoryWidth = 160;
+        private const double HistoryHeight = 24;
 
         // 关键：操作锁。
         // 当弹出 MessageBox 或执行同步阻塞操作时，防止后台服务更新集合导致选中的对象在内存中位移或失效。
@@ -60,7 +68,7 @@ namespace IronSight.App.UI.ViewModels
 
             // 初始化监控服务，采样频率 2000ms
             _monitorService = new SystemMonitorServiceEx(2000);
-            _monitorService.ProcessListUpdated += OnProcessListUpdated;
+            _monitorService.ProcessChangesUpdated += OnProcessChangesUpdated;
             _monitorService.GlobalSnapshotUpdated += OnGlobalSnapshotUpdated;
 
             _monitorService.Start();
@@ -85,14 +93,25 @@ namespace IronSight.App.UI.ViewModels
             get => _selectedProcess;
             set
             {
+                uint? previousPid = _selectedProcess?.Pid;
                 if (SetProperty(ref _selectedProcess, value))
                 {
                     // 统一触发所有依赖选中项的命令状态检查
                     RefreshAllCommands();
+                    if (value?.Pid != previousPid) RefreshSelectedHistory();
                 }
             }
         }
 
+        /// <summary>
+        /// 选中进程的 CPU 历史折线 (坐标已按 HistoryWidth x HistoryHeight 缩放，0% 在底部)
+        /// </summary>
+        public PointCollection SelectedCpuHistory
+        {
+            get => _selectedCpuHistory;
+            private set => SetProperty(ref _selectedCpuHistory, value);
+        }
+
         public uint ProcessCount
         {
             get => _processCount;
@@ -168,12 +187,10 @@ namespace IronSight.App.UI.ViewModels
         {
             if (SelectedProcess == null) return;
 
-            var pathBuffer = new StringBuilder(260);
-            if (SystemMethods.GetProcessFullPath(SelectedProcess.Value.Pid, pathBuffer, (uint)pathBuffer.Capacity))
+            if (SystemMethods.TryGetProcessPath(SelectedProcess.Value.Pid, out string path))
             {
                 try
                 {
-                    string path = pathBuffer.ToString();
                     System.Diagnostics.Process.Start("explorer.exe", $"/select,\"{path}\"");
                 }
                 catch (Exception ex)
@@ -219,10 +236,9 @@ namespace IronSight.App.UI.ViewModels
         private void ExecuteShowProperties()
         {
             if (SelectedProcess == null) return;
-            var pathBuffer = new StringBuilder(260);
-            if (SystemMethods.GetProcessFullPath(SelectedProcess.Value.Pid, pathBuffer, (uint)pathBuffer.Capacity))
+            if (SystemMethods.TryGetProcessPath(SelectedProcess.Value.Pid, out string path))
             {
-                SystemMethods.ShowFileProperties(pathBuffer.ToString());
+                SystemMethods.ShowFileProperties(path);
             }
         }
 
@@ -230,40 +246,76 @@ namespace IronSight.App.UI.ViewModels
 
         #region 后台回调处理
 
-        private void OnProcessListUpdated(object? sender, List<ProcessDetailInfo> newList)
+        private void OnProcessChangesUpdated(object? sender, ProcessChangeSet changes)
         {
-            if (_isActionLocked) return;
+            // 变更集是增量的，丢弃一次后本地列表即与原生端不一致，需要请求一次完整重置
+            if (_isActionLocked)
+            {
+                _monitorService.RequestProcessResync();
+                return;
+            }
 
             Application.Current.Dispatcher.Invoke(() =>
             {
                 uint? savedSelectedPid = SelectedProcess?.Pid;
-                var newPids = new HashSet<uint>(newList.Select(p => p.Pid));
 
                 // A. 移除
-                for (int i = _processes.Count - 1; i >= 0; i--)
+                if (changes.IsReset)
                 {
-                    if (!newPids.Contains(_processes[i].Pid)) _processes.RemoveAt(i);
+                    _processes.Clear();
                 }
-
-                // B. 更新或添加
-                foreach (var newItem in newList)
+                else if (changes.Exited.Length > 0)
                 {
-                    var existingIndex = _processes.Cast<ProcessDetailInfo?>().Select((p, idx) => new { p, idx }).FirstOrDefault(x => x.p?.Pid == newItem.Pid)?.idx ?? -1;
+                    var exitedPids = new HashSet<uint>(changes.Exited);
+                    for (int i = _processes.Count - 1; i >= 0; i--)
+                    {
+                        if (exitedPids.Contains(_processes[i].Pid)) _processes.RemoveAt(i);
+                    }
+                }
 
-                    if (existingIndex >= 0)
+                var indexByPid = new Dictionary<uint, int>(_processes.Count + changes.Added.Length);
+                for (int i = 0; i < _processes.Count; i++) indexByPid[_processes[i].Pid] = i;
+
+                // B. 添加新进程或覆盖静态字段
+                foreach (var record in changes.Added)
+                {
+                    if (indexByPid.TryGetValue(record.Pid, out int index))
                     {
-                        if (_processes[existingIndex].IsVisuallyDifferent(newItem))
-                        {
-                            _processes[existingIndex] = newItem;
-                        }
+                        var item = _processes[index];
+                        item.NameId = record.NameId;
+                        item.PriorityClass = record.PriorityClass;
+                        _processes[index] = item;
                     }
                     else
                     {
-                        _processes.Add(newItem);
+                        indexByPid[record.Pid] = _processes.Count;
+                        _processes.Add(new ProcessDetailInfo { Pid = record.Pid, NameId = record.NameId, PriorityClass = record.PriorityClass });
+                    }
+                }
+
+                // C. 就地更新动态字段
+                foreach (var update in changes.Updated)
+                {
+                    if (!indexByPid.TryGetValue(update.Pid, out int index)) continue;
+
+                    var current = _processes[index];
+                    var item = current;
+                    item.MemoryMB = update.MemoryMB;
+                    item.CpuUsage = update.CpuUsage;
+                    item.DiskReadRateMS = update.DiskReadRateMS;
+                    item.DiskWriteRateMS = update.DiskWriteRateMS;
+                    item.ThreadCount = update.ThreadCount;
+                    item.HandleCount = update.HandleCount;
+
+                    if (current.IsVisuallyDifferent(item) ||
+                        current.ThreadCount != item.ThreadCount ||
+                        current.HandleCount != item.HandleCount)
+                    {
+                        _processes[index] = item;
                     }
                 }
 
-                ProcessCount = (uint)newList.Count;
+                ProcessCount = (uint)changes.ProcessCount;
 
                 // 恢复选中
                 if (savedSelectedPid.HasValue)
@@ -271,6 +323,8 @@ namespace IronSight.App.UI.ViewModels
                     var updatedSelection = _processes.FirstOrDefault(p => p.Pid == savedSelectedPid.Value);
                     if (updatedSelection.Pid != 0) SelectedProcess = updatedSelection;
                 }
+
+                RefreshSelectedHistory();
             });
         }
 
@@ -290,6 +344,29 @@ namespace IronSight.App.UI.ViewModels
                   (info.Name.Contains(SearchText, StringComparison.OrdinalIgnoreCase) || info.Pid.ToString().Contains(SearchText));
         }
 
+        private void RefreshSelectedHistory()
+        {
+            var line = new PointCollection();
+
+            if (SelectedProcess is ProcessDetailInfo process)
+            {
+                var now = DateTimeOffset.UtcNow;
+                var from = now - HistoryWindow;
+                var points = MetricsMethods.Query(MetricKind.ProcessCpu, process.Pid, MetricResolution.Second, from, now, (int)HistoryWindow.TotalSeconds);
+
+                long fromMs = from.ToUnixTimeMilliseconds();
+                foreach (var point in points)
+                {
+                    double x = (point.TimestampMs - fromMs) / HistoryWindow.TotalMilliseconds * HistoryWidth;
+                    double y = HistoryHeight - Math.Clamp(point.Avg, 0, 100) / 100.0 * HistoryHeight;
+                    line.Add(new Point(x, y));
+                }
+            }
+
+            line.Freeze();
+            SelectedCpuHistory = line;
+        }
+
         private bool CanExecuteOnSelected() => SelectedProcess != null && SelectedProcess.Value.Pid > 4;
 
         private void RefreshAllCommands()
@@ -304,7 +381,7 @@ namespace IronSight.App.UI.ViewModels
 
         public void Dispose()
         {
-            _monitorService.ProcessListUpdated -= OnProcessListUpdated;
+            _monitorService.ProcessChangesUpdated -= OnProcessChangesUpdated;
             _monitorService.GlobalSnapshotUpdated -= OnGlobalSnapshotUpdated;
             _monitorService.Stop();
             _monitorService.Dispose();
@@ -0,0 +1,83 @@
+﻿#include <pch.h>
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace IronSight::Core::Native::Benchmark
+{
+    namespace
+    {
+        // 只需要计数本身准确，不用于同步其他数据
+        std::atomic<uint64_t> g_allocationCount{ 0 };
+    }
+
+    void* CountedAllocate(size_t size) noexcept
+    {
+        g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size ? size : 1);
+    }
+
+    AllocationScope::AllocationScope() noexcept
+        : _start(g_allocationCount.load(std::memory_order_relaxed))
+    {
+    }
+
+    uint64_t AllocationScope::Count() const noexcept
+    {
+        return g_allocationCount.load(std::memory_order_relaxed) - _start;
+    }
+}
+
+// 替换本程序的全局分配函数 (静态链接的原生核心与标准库容器的分配都会经过这里)，分配本身仍由 CRT 的 malloc/free 完成
+void* operator new(size_t size)
+{
+    void* memory = IronSight::Core::Native::Benchmark::CountedAllocate(size);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return IronSight::Core::Native::Benchmark::CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return IronSight::Core::Native::Benchmark::CountedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
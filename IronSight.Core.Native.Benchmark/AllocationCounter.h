@@ -0,0 +1,30 @@
+﻿#pragma once
+
+namespace IronSight::Core::Native::Benchmark
+{
+	/// <summary>
+	/// 统计作用域内整个进程经由 operator new 发生的堆分配次数
+	/// 计数器是进程级的，工作线程池等其他线程上的分配同样计入；测量期间不应有无关的后台线程在分配
+	/// </summary>
+	class AllocationScope
+	{
+		public:
+		AllocationScope() noexcept;
+
+		AllocationScope(const AllocationScope&) = delete;
+		AllocationScope& operator=(const AllocationScope&) = delete;
+
+		/// <summary>
+		/// 作用域开始以来的分配次数
+		/// </summary>
+		uint64_t Count() const noexcept;
+
+		private:
+		uint64_t _start;
+	};
+
+	/// <summary>
+	/// 计数后通过 malloc 分配 (供本程序替换的全局 operator new 使用)
+	/// </summary>
+	void* CountedAllocate(size_t size) noexcept;
+}
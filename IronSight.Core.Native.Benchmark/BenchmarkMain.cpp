@@ -0,0 +1,34 @@
+﻿#include <pch.h>
+#include "BenchmarkRunner.h"
+#include <cstdlib>
+
+// 用法:
+//   IronSight.Core.Native.Benchmark                                   运行全部场景
+//   IronSight.Core.Native.Benchmark <场景> [行数] [迭代次数] [proc 目录]  运行单个场景
+// 每个场景输出一行 JSON 到标准输出
+int main(int argc, char** argv)
+{
+    using namespace IronSight::Core::Native::Benchmark;
+
+    if (argc < 2)
+    {
+        BenchmarkRunner::RunSuite(stdout);
+        return 0;
+    }
+
+    const char* scenario = argv[1];
+    const uint32_t rowCount = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 10000;
+    const uint32_t iterations = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 0;
+    const char* recordedRoot = argc > 4 ? argv[4] : nullptr;
+
+    BenchmarkResult result;
+    if (!BenchmarkRunner::Run(scenario, rowCount, iterations, recordedRoot, result))
+    {
+        std::fprintf(stderr, "场景不存在或在当前平台不可用: %s\n", scenario);
+        return 1;
+    }
+
+    char line[512];
+    if (BenchmarkRunner::FormatJson(result, line, sizeof(line))) std::fputs(line, stdout);
+    return 0;
+}
@@ -0,0 +1,278 @@
+﻿#include <pch.h>
+#include "BenchmarkRunner.h"
+#include "AllocationCounter.h"
+#include "SyntheticConnectionSource.h"
+#include "SyntheticCpuTimeSource.h"
+#include "Network/NetworkMonitor.h"
+#include "Network/ProcNetConnectionSource.h"
+#include "System/CpuCoreSampler.h"
+#include "System/ProcessCollector.h"
+#include "System/ProcFsProcessBackend.h"
+#include "System/ProcStatCpuTimeSource.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+
+namespace IronSight::Core::Native::Benchmark
+{
+    using namespace IronSight::Core::Native::Network;
+
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr uint32_t WarmupIterations = 3;
+        constexpr uint32_t SuiteRowCounts[] = { 1000, 10000, 100000 };
+        constexpr const char* SuiteScenarios[] = { "network.refresh", "network.refresh.delta", "network.copy" };
+        constexpr uint32_t SuiteCoreCounts[] = { 8, 16, 32, 64, 128, 256 };
+
+        // 未指定迭代次数时让每个场景处理约 200 万行，且不少于 10 次
+        uint32_t DefaultIterations(size_t rows) noexcept
+        {
+            size_t iterations = rows ? 2000000 / rows : 1000;
+            return static_cast<uint32_t>(std::clamp<size_t>(iterations, 10, 1000));
+        }
+
+        // 运行 body 若干次并统计延迟分布与分配次数，body 返回本次处理的行数
+        template <typename Body>
+        void Measure(uint32_t iterations, BenchmarkResult& result, Body&& body)
+        {
+            for (uint32_t i = 0; i < WarmupIterations; ++i) body();
+
+            std::vector<double> samples(iterations);
+            uint64_t allocations = 0;
+            size_t rows = 0;
+
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                AllocationScope scope;
+                auto start = Clock::now();
+                rows = body();
+                auto elapsed = Clock::now() - start;
+
+                samples[i] = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+                allocations += scope.Count();
+            }
+
+            auto percentile = [&](double fraction)
+            {
+                size_t index = (std::min)(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+                std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+                return samples[index];
+            };
+
+            result.Rows = rows;
+            result.Iterations = iterations;
+            result.MeanNs = std::accumulate(samples.begin(), samples.end(), 0.0) / iterations;
+            result.P50Ns = percentile(0.50);
+            result.P99Ns = percentile(0.99);
+            result.NsPerRow = rows ? result.P50Ns / rows : 0;
+            result.AllocationsPerIteration = static_cast<double>(allocations) / iterations;
+        }
+
+        std::unique_ptr<IConnectionSource> CreateSynthetic(uint32_t rowCount)
+        {
+            SyntheticConnectionSource::Options options;
+            options.RowCount = rowCount;
+            return std::make_unique<SyntheticConnectionSource>(options);
+        }
+
+        // 完整刷新：采集、排序、聚合、索引、生命周期跟踪 (可选差量) 与发布
+        void RunRefresh(std::unique_ptr<IConnectionSource> source, bool incremental, uint32_t iterations, BenchmarkResult& result)
+        {
+            NetworkMonitor monitor(std::move(source));
+            monitor.SetIncrementalMode(incremental);
+
+            Measure(iterations, result, [&]()
+                {
+                    monitor.Refresh();
+                    return monitor.AcquireSnapshot()->Connections.Rows.size();
+                });
+        }
+
+        // v1 行格式转换与复制 (快照不变，只测量读取路径)
+        void RunCopy(uint32_t rowCount, uint32_t iterations, BenchmarkResult& result)
+        {
+            NetworkMonitor monitor(CreateSynthetic(rowCount));
+            monitor.Refresh();
+
+            std::vector<NetworkConnectionInfo> buffer(rowCount);
+
+            Measure(iterations, result, [&]()
+                {
+                    return monitor.CopyConnectionsTo(buffer.data(), buffer.size());
+                });
+        }
+
+        // 逐处理器占用率采样：读取数据源、差量与占比内核 (每次迭代处理的行数即处理器数)
+        void RunCpuCores(std::unique_ptr<System::ICpuTimeSource> source, uint32_t iterations, BenchmarkResult& result)
+        {
+            System::CpuCoreSampler sampler(std::move(source));
+            sampler.Sample();
+
+            Measure(iterations, result, [&]()
+                {
+                    sampler.Sample();
+                    return sampler.CoreCount();
+                });
+        }
+    }
+
+    bool BenchmarkRunner::Run(const char* scenario, uint32_t rowCount, uint32_t iterations,
+        const char* recordedRoot, BenchmarkResult& result)
+    {
+        if (!scenario) return false;
+
+        result = {};
+        if (iterations == 0) iterations = DefaultIterations(rowCount);
+
+        if (std::strcmp(scenario, "network.refresh") == 0)
+        {
+            result.Scenario = "network.refresh";
+            result.Source = "synthetic";
+            RunRefresh(CreateSynthetic(rowCount), false, iterations, result);
+            return true;
+        }
+
+        if (std::strcmp(scenario, "network.refresh.delta") == 0)
+        {
+            result.Scenario = "network.refresh.delta";
+            result.Source = "synthetic";
+            RunRefresh(CreateSynthetic(rowCount), true, iterations, result);
+            return true;
+        }
+
+        if (std::strcmp(scenario, "network.copy") == 0)
+        {
+            result.Scenario = "network.copy";
+            result.Source = "synthetic";
+            RunCopy(rowCount, iterations, result);
+            return true;
+        }
+
+#if defined(__linux__)
+        // 回放录制的 /proc/net 表 (目录结构与 /proc 相同，含 net/tcp、net/tcp6 等)
+        if (std::strcmp(scenario, "network.replay") == 0 && recordedRoot)
+        {
+            result.Scenario = "network.replay";
+            result.Source = "recorded";
+            RunRefresh(std::make_unique<ProcNetConnectionSource>(recordedRoot), false, iterations, result);
+            return true;
+        }
+#endif
+
+        // 并行进程采集 (与 GetDetailedProcessList 相同的引擎)；Linux 上可指定录制的 proc 目录
+        if (std::strcmp(scenario, "process.collect") == 0)
+        {
+            std::unique_ptr<System::IProcessBackend> backend;
+            result.Source = "live";
+#if defined(__linux__)
+            System::ProcessHandleCache handles(System::ProcessHandleCache::DefaultCapacity, recordedRoot);
+            if (recordedRoot)
+            {
+                backend = std::make_unique<System::ProcFsProcessBackend>(handles, recordedRoot);
+                result.Source = "recorded";
+            }
+#else
+            System::ProcessHandleCache handles;
+#endif
+            if (!backend) backend = System::IProcessBackend::CreateDefault(handles);
+            if (!backend) return false;
+
+            result.Scenario = "process.collect";
+
+            System::ProcessCollector collector(std::move(backend));
+            std::vector<System::ProcessDetailInfo> buffer(4096);
+            Measure(iterations, result, [&]()
+                {
+                    return static_cast<size_t>(collector.Collect(buffer.data(), static_cast<int>(buffer.size())));
+                });
+            return true;
+        }
+
+        if (std::strcmp(scenario, "cpu.cores") == 0)
+        {
+            result.Scenario = "cpu.cores";
+            result.Source = "synthetic";
+            RunCpuCores(std::make_unique<SyntheticCpuTimeSource>(rowCount ? rowCount : 64), iterations, result);
+            return true;
+        }
+
+        // 实时的逐处理器采样；Linux 上可指定录制的 proc 目录 (回放其中的 stat 文件)
+        if (std::strcmp(scenario, "cpu.cores.live") == 0)
+        {
+            std::unique_ptr<System::ICpuTimeSource> source;
+            result.Source = "live";
+#if defined(__linux__)
+            if (recordedRoot)
+            {
+                source = std::make_unique<System::ProcStatCpuTimeSource>(recordedRoot);
+                result.Source = "recorded";
+            }
+#endif
+            if (!source) source = System::ICpuTimeSource::CreateDefault();
+            if (!source) return false;
+
+            result.Scenario = "cpu.cores.live";
+            RunCpuCores(std::move(source), iterations, result);
+            return true;
+        }
+
+        return false;
+    }
+
+    void BenchmarkRunner::RunSuite(std::FILE* output)
+    {
+        if (!output) return;
+
+        auto append = [&](const BenchmarkResult& result)
+        {
+            char line[512];
+            if (FormatJson(result, line, sizeof(line))) std::fputs(line, output);
+            std::fflush(output);
+        };
+
+        BenchmarkResult result;
+
+        for (const char* scenario : SuiteScenarios)
+        {
+            for (uint32_t rowCount : SuiteRowCounts)
+            {
+                if (Run(scenario, rowCount, 0, nullptr, result)) append(result);
+            }
+        }
+
+        // 每处理器开销应不随处理器数量增长 (nsPerRow 保持平稳)
+        for (uint32_t coreCount : SuiteCoreCounts)
+        {
+            if (Run("cpu.cores", coreCount, 1000, nullptr, result)) append(result);
+        }
+
+        // 实时场景耗时远高于合成场景，迭代次数固定为较小值
+        if (Run("cpu.cores.live", 0, 100, nullptr, result)) append(result);
+        if (Run("process.collect", 0, 20, nullptr, result)) append(result);
+    }
+
+    size_t BenchmarkRunner::FormatJson(const BenchmarkResult& result, char* output, size_t outputSize)
+    {
+        if (!output || outputSize == 0) return 0;
+
+        int written = std::snprintf(output, outputSize,
+            "{\"scenario\":\"%s\",\"source\":\"%s\",\"rows\":%zu,\"iterations\":%u,"
+            "\"nsPerRow\":%.2f,\"p50Ns\":%.0f,\"p99Ns\":%.0f,\"meanNs\":%.0f,\"allocationsPerIteration\":%.2f}\n",
+            result.Scenario ? result.Scenario : "", result.Source ? result.Source : "",
+            result.Rows, result.Iterations, result.NsPerRow, result.P50Ns, result.P99Ns, result.MeanNs,
+            result.AllocationsPerIteration);
+
+        // 缓冲区不足时不输出半行，保持每行都是完整的 JSON
+        if (written < 0 || static_cast<size_t>(written) >= outputSize)
+        {
+            output[0] = '\0';
+            return 0;
+        }
+
+        return static_cast<size_t>(written);
+    }
+}
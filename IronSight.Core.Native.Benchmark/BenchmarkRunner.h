@@ -0,0 +1,54 @@
+﻿#pragma once
+#include <cstdio>
+
+namespace IronSight::Core::Native::Benchmark
+{
+	/// <summary>
+	/// 单个场景的测量结果
+	/// </summary>
+	struct BenchmarkResult
+	{
+		const char* Scenario = nullptr;
+		const char* Source = nullptr;           // synthetic / recorded / live
+		size_t Rows = 0;                        // 每次迭代处理的行数
+		uint32_t Iterations = 0;
+		double P50Ns = 0;
+		double P99Ns = 0;
+		double MeanNs = 0;
+		double NsPerRow = 0;                    // 按 p50 计算
+		double AllocationsPerIteration = 0;
+	};
+
+	/// <summary>
+	/// 原生核心吞吐基准
+	/// 直接驱动 NetworkMonitor 的转换、聚合与复制路径 (合成或录制数据源)、并行进程采集与逐处理器 CPU 采样；
+	/// 结果以 JSON Lines 输出便于比对回归
+	/// </summary>
+	class BenchmarkRunner
+	{
+		public:
+		/// <summary>
+		/// 运行单个场景
+		/// </summary>
+		/// <param name="scenario">场景名 (network.refresh / network.refresh.delta / network.copy / network.replay / process.collect / cpu.cores / cpu.cores.live)</param>
+		/// <param name="rowCount">合成数据的行数 (cpu.cores 为处理器数)，录制与实时场景忽略</param>
+		/// <param name="iterations">测量迭代次数，0 表示按行数自动选择</param>
+		/// <param name="recordedRoot">network.replay / process.collect / cpu.cores.live 使用的录制 proc 目录</param>
+		/// <param name="result">输出：测量结果</param>
+		/// <returns>场景不存在或在当前平台不可用时返回 false</returns>
+		static bool Run(const char* scenario, uint32_t rowCount, uint32_t iterations,
+			const char* recordedRoot, BenchmarkResult& result);
+
+		/// <summary>
+		/// 以 1k / 10k / 100k 行运行全部合成网络场景、以 8 到 256 个处理器运行 cpu.cores，并运行当前平台可用的实时场景
+		/// 每个场景完成后立即写出一行 JSON
+		/// </summary>
+		static void RunSuite(std::FILE* output);
+
+		/// <summary>
+		/// 把结果格式化为一行 JSON (以换行结尾)
+		/// </summary>
+		/// <returns>写入的字节数，缓冲区不足时返回 0</returns>
+		static size_t FormatJson(const BenchmarkResult& result, char* output, size_t outputSize);
+	};
+}
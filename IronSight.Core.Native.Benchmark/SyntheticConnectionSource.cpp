@@ -0,0 +1,101 @@
+﻿#include <pch.h>
+#include "SyntheticConnectionSource.h"
+#include <cstring>
+#include <numeric>
+
+namespace IronSight::Core::Native::Benchmark
+{
+    using namespace IronSight::Core::Native::Network;
+
+    namespace
+    {
+        // SplitMix64：由行号与种子得到稳定的伪随机值
+        inline uint64_t Mix(uint64_t value) noexcept
+        {
+            value += 0x9E3779B97F4A7C15ull;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            return value ^ (value >> 31);
+        }
+    }
+
+    SyntheticConnectionSource::SyntheticConnectionSource(const Options& options)
+        : _options(options)
+    {
+        if (_options.RowsPerProcess == 0) _options.RowsPerProcess = 1;
+
+        // 以与行数互质的步长遍历行号，输出顺序被打乱但每行恰好出现一次
+        if (_options.RowCount > 1)
+        {
+            _stride = 7919 % _options.RowCount;
+            while (_stride == 0 || std::gcd(_stride, _options.RowCount) != 1) ++_stride;
+        }
+    }
+
+    void SyntheticConnectionSource::BeginRefresh()
+    {
+        ++_generation;
+    }
+
+    bool SyntheticConnectionSource::CollectTcp(ConnectionTable& table)
+    {
+        Emit(table, false);
+        return true;
+    }
+
+    bool SyntheticConnectionSource::CollectUdp(ConnectionTable& table)
+    {
+        Emit(table, true);
+        return true;
+    }
+
+    void SyntheticConnectionSource::Emit(ConnectionTable& table, bool udp) const
+    {
+        const uint32_t rowCount = _options.RowCount;
+
+        for (uint32_t n = 0, i = 0; n < rowCount; ++n, i = (i + _stride) % rowCount)
+        {
+            const uint64_t hash = Mix(_options.Seed ^ i);
+            const bool isUdp = (hash % 100) < _options.UdpPercent;
+            if (isUdp != udp) continue;
+
+            const bool isIpv6 = ((hash >> 8) % 100) < _options.Ipv6Percent;
+            const bool churns = ((hash >> 16) % 100) < _options.ChurnPercent;
+            const uint32_t slot = i % _options.RowsPerProcess;
+
+            NetworkConnectionRow row{};
+            row.ProcessId = 1000 + i / _options.RowsPerProcess * 4;
+            row.Protocol = static_cast<uint8_t>(udp ? ProtocolType::Udp : ProtocolType::Tcp);
+            row.LocalPort = static_cast<uint16_t>(1024 + (hash >> 24) % 60000 + (churns ? _generation : 0));
+
+            if (udp)
+            {
+                row.State = static_cast<uint8_t>(ConnectionState::Unknown);
+            }
+            else if (slot == 0)
+            {
+                row.State = static_cast<uint8_t>(ConnectionState::Listen);
+            }
+            else
+            {
+                row.RemotePort = static_cast<uint16_t>(hash >> 40);
+                row.State = static_cast<uint8_t>(slot % 8 == 0 ? ConnectionState::TimeWait : ConnectionState::Established);
+            }
+
+            if (isIpv6)
+            {
+                Ipv6Address local{ { 0x20, 0x01, 0x0D, 0xB8 } };
+                Ipv6Address remote{ { 0x20, 0x01, 0x0D, 0xB8, 0xFF } };
+                std::memcpy(local.Bytes + 8, &row.ProcessId, sizeof(row.ProcessId));
+                std::memcpy(remote.Bytes + 8, &hash, sizeof(hash));
+                table.AppendIpv6(row, local, remote);
+            }
+            else
+            {
+                row.LocalAddress = 0x0100000A;                                      // 10.0.0.1
+                row.RemoteAddress = row.RemotePort ? static_cast<uint32_t>(hash) : 0;
+                table.AppendIpv4(row);
+            }
+        }
+    }
+}
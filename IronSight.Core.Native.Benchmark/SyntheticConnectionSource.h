@@ -0,0 +1,36 @@
+﻿#pragma once
+#include "Network/ConnectionSource.h"
+
+namespace IronSight::Core::Native::Benchmark
+{
+	/// <summary>
+	/// 合成连接数据源：按行号确定性地生成连接表，用于在任意平台上压测网络监控热路径
+	/// 行以打乱的顺序输出 (与真实数据源一样不按连接键有序)，每代有一部分行更换本地端口以产生变动
+	/// </summary>
+	class SyntheticConnectionSource final : public Network::IConnectionSource
+	{
+		public:
+		struct Options
+		{
+			uint32_t RowCount = 1000;           // 每代的行数 (TCP + UDP)
+			uint32_t RowsPerProcess = 16;       // 每个进程的平均行数
+			uint32_t Ipv6Percent = 10;          // IPv6 行占比
+			uint32_t UdpPercent = 10;           // UDP 行占比
+			uint32_t ChurnPercent = 2;          // 每代更换端口 (即一关一开) 的行占比
+			uint64_t Seed = 0x9E3779B97F4A7C15ull;
+		};
+
+		explicit SyntheticConnectionSource(const Options& options);
+
+		void BeginRefresh() override;
+		bool CollectTcp(Network::ConnectionTable& table) override;
+		bool CollectUdp(Network::ConnectionTable& table) override;
+
+		private:
+		void Emit(Network::ConnectionTable& table, bool udp) const;
+
+		Options _options;
+		uint32_t _stride = 1;
+		uint32_t _generation = 0;
+	};
+}
@@ -0,0 +1,48 @@
+﻿#include <pch.h>
+#include "SyntheticCpuTimeSource.h"
+
+namespace IronSight::Core::Native::Benchmark
+{
+    namespace
+    {
+        // xorshift64：只需足够便宜，不影响被测的采样器开销
+        inline uint64_t Next(uint64_t& state) noexcept
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    }
+
+    SyntheticCpuTimeSource::SyntheticCpuTimeSource(uint32_t coreCount)
+    {
+        _times.Resize(coreCount);
+    }
+
+    bool SyntheticCpuTimeSource::Collect(System::CpuTimeColumns& times)
+    {
+        const size_t coreCount = _times.CoreCount();
+        times.Resize(coreCount);
+
+        // 每个处理器每次共增长约 10000 个单位 (1 毫秒，以 100 纳秒计)，忙闲比例随机
+        for (size_t i = 0; i < coreCount; ++i)
+        {
+            const uint64_t random = Next(_state);
+            const double busy = static_cast<double>(random % 10000);
+
+            _times.User[i] += busy * 0.7;
+            _times.System[i] += busy * 0.2;
+            _times.Irq[i] += busy * 0.05;
+            _times.Steal[i] += busy * 0.05;
+            _times.Idle[i] += 10000.0 - busy;
+        }
+
+        times.User = _times.User;
+        times.System = _times.System;
+        times.Idle = _times.Idle;
+        times.Irq = _times.Irq;
+        times.Steal = _times.Steal;
+        return true;
+    }
+}
@@ -0,0 +1,21 @@
+﻿#pragma once
+#include "System/CpuTimeSource.h"
+
+namespace IronSight::Core::Native::Benchmark
+{
+	/// <summary>
+	/// 合成逐处理器时间数据源：每次采集让每个处理器的各类时间按确定性的伪随机量增长，
+	/// 用于在任意机器上测量 8 到 256 个逻辑处理器时采样器的开销
+	/// </summary>
+	class SyntheticCpuTimeSource final : public System::ICpuTimeSource
+	{
+		public:
+		explicit SyntheticCpuTimeSource(uint32_t coreCount);
+
+		bool Collect(System::CpuTimeColumns& times) override;
+
+		private:
+		System::CpuTimeColumns _times;
+		uint64_t _state = 0x9E3779B97F4A7C15ull;
+	};
+}
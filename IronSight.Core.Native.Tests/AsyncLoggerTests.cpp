@@ -0,0 +1,68 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "Logging/Log.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace IronSight::Core::Native;
+
+namespace
+{
+    std::mutex g_mutex;
+    std::condition_variable g_delivered;
+    std::vector<std::string> g_messages;
+
+    void __stdcall Collect(Utils::LogLevel, const char* message)
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            g_messages.emplace_back(message);
+        }
+        g_delivered.notify_all();
+    }
+
+    bool WaitFor(const std::string& message, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(g_mutex);
+        return g_delivered.wait_for(lock, timeout, [&]
+            {
+                for (const std::string& delivered : g_messages) if (delivered == message) return true;
+                return false;
+            });
+    }
+}
+
+IRONSIGHT_TEST(Logging, FirstRecordWakesTheConsumer)
+{
+    Logging::SetCallback(Collect);
+
+    // 消费线程没有轮询间隔，只能靠提交时的唤醒送达
+    std::thread([] { Logging::Log(Utils::LogLevel::Info, "wake %d", 1); }).join();
+    CHECK(WaitFor("wake 1", std::chrono::seconds(5)));
+
+    // 排空后再次提交，唤醒仍然生效
+    std::thread([] { Logging::Log(Utils::LogLevel::Info, "wake %s", "again"); }).join();
+    CHECK(WaitFor("wake again", std::chrono::seconds(5)));
+}
+
+IRONSIGHT_TEST(Logging, ShutdownDeliversPendingRecords)
+{
+    Logging::SetCallback(Collect);
+
+    for (int i = 0; i < 100; ++i) Logging::Log(Utils::LogLevel::Info, "pending %d", i);
+
+    // Shutdown 返回时全部记录都已送达，无需等待
+    Logging::Shutdown();
+    CHECK(WaitFor("pending 99", std::chrono::milliseconds(0)));
+
+    // 之后的记录在 Flush 时送达
+    Logging::Log(Utils::LogLevel::Info, "after %s", "shutdown");
+    Logging::Flush();
+    CHECK(WaitFor("after shutdown", std::chrono::milliseconds(0)));
+
+    Logging::SetCallback(nullptr);
+}
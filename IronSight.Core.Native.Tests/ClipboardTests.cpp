@@ -0,0 +1,148 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "Clipboard/ClipboardCapture.h"
+#include "Clipboard/FakeClipboardSource.h"
+#include <cstring>
+#include <string>
+
+using namespace IronSight::Core::Native::Clipboard;
+
+namespace
+{
+    constexpr int64_t BaseMs = 1700000000000;
+
+    uint64_t AddText(ClipboardHistory& history, std::string_view text, bool& changed)
+    {
+        return history.Add(ClipboardFormat::Text, text, ClipboardHistory::Hash(text), BaseMs, changed);
+    }
+
+    std::string ReadEntry(const ClipboardHistory& history, uint64_t id)
+    {
+        ClipboardEntryInfo info{};
+        const uint8_t* data = nullptr;
+        if (!history.Acquire(id, info, data)) return "(missing)";
+
+        std::string text(reinterpret_cast<const char*>(data), info.Size);
+        history.Release();
+        return text;
+    }
+
+    uint64_t g_lastNotified = 0;
+    uint32_t g_notifications = 0;
+
+    void __stdcall OnChanged(uint64_t entryId)
+    {
+        g_lastNotified = entryId;
+        ++g_notifications;
+    }
+}
+
+IRONSIGHT_TEST(Clipboard, FakeSourceCountsEverySet)
+{
+    FakeClipboardSource source;
+    std::string payload;
+
+    CHECK(source.Read(payload) == ClipboardFormat::None);
+    const uint32_t initial = source.SequenceNumber();
+
+    source.Set(ClipboardFormat::Text, "hello");
+    CHECK(source.Read(payload) == ClipboardFormat::Text);
+    CHECK(payload == "hello");
+
+    // 相同内容再次设置也会推进序列号
+    source.Set(ClipboardFormat::Text, "hello");
+    CHECK_EQ(initial + 2, source.SequenceNumber());
+
+    source.Set(ClipboardFormat::None, "");
+    CHECK(source.Read(payload) == ClipboardFormat::None);
+}
+
+IRONSIGHT_TEST(Clipboard, HistoryReusesIdsForRepeatedContent)
+{
+    ClipboardHistory history;
+    bool changed = false;
+
+    const uint64_t first = AddText(history, "alpha", changed);
+    CHECK(changed);
+    CHECK_EQ(uint64_t{ 1 }, first);
+
+    // 同样的内容紧接着再设置一次：不算变化
+    CHECK_EQ(first, AddText(history, "alpha", changed));
+    CHECK(!changed);
+
+    const uint64_t second = AddText(history, "beta", changed);
+    CHECK(changed);
+    CHECK_EQ(uint64_t{ 2 }, second);
+
+    // 再次复制较早的内容：沿用原 ID，移到最新位置
+    CHECK_EQ(first, AddText(history, "alpha", changed));
+    CHECK(changed);
+
+    ClipboardEntryInfo entries[4];
+    CHECK_EQ(size_t{ 2 }, history.List(entries, 4));
+    CHECK_EQ(first, entries[0].Id);
+    CHECK_EQ(second, entries[1].Id);
+    CHECK(ReadEntry(history, first) == "alpha");
+    CHECK(ReadEntry(history, second) == "beta");
+}
+
+IRONSIGHT_TEST(Clipboard, HistoryEvictsOldestByCountAndBytes)
+{
+    ClipboardHistory byCount(4096, 3);
+    bool changed = false;
+
+    for (int i = 0; i < 5; ++i) AddText(byCount, "entry " + std::to_string(i), changed);
+
+    ClipboardEntryInfo entries[8];
+    CHECK_EQ(size_t{ 3 }, byCount.List(entries, 8));
+    CHECK(ReadEntry(byCount, entries[2].Id) == "entry 2");
+    CHECK(ReadEntry(byCount, 1) == "(missing)");
+
+    // 每条 200 字节、容量 1024：最多同时保留 5 条，回绕后内容仍连续可读
+    ClipboardHistory byBytes(1024, 64);
+    for (int i = 0; i < 12; ++i) AddText(byBytes, std::string(200, static_cast<char>('a' + i)), changed);
+
+    const size_t kept = byBytes.List(entries, 8);
+    CHECK(kept >= 4 && kept <= 5);
+    CHECK(ReadEntry(byBytes, entries[0].Id) == std::string(200, 'l'));
+
+    // 超过容量四分之一的内容不保存，但仍算作变化
+    CHECK_EQ(uint64_t{ 0 }, AddText(byBytes, std::string(300, 'z'), changed));
+    CHECK(changed);
+    CHECK_EQ(uint64_t{ 0 }, AddText(byBytes, std::string(300, 'z'), changed));
+    CHECK(!changed);
+
+    byBytes.Clear();
+    CHECK_EQ(size_t{ 0 }, byBytes.List(entries, 8));
+}
+
+IRONSIGHT_TEST(Clipboard, CaptureNotifiesOnlyWhenContentChanges)
+{
+    auto owned = std::make_unique<FakeClipboardSource>();
+    FakeClipboardSource& source = *owned;
+    ClipboardCapture capture(std::move(owned));
+    capture.SetCallback(OnChanged);
+    g_notifications = 0;
+
+    source.Set(ClipboardFormat::Text, "copied");
+    CHECK(capture.OnClipboardUpdate());
+    CHECK_EQ(1u, g_notifications);
+    CHECK(ReadEntry(capture.History(), g_lastNotified) == "copied");
+
+    // 序列号未变：重复的通知
+    CHECK(!capture.OnClipboardUpdate());
+
+    // 程序再次设置同样的内容：序列号变了，内容没变
+    source.Set(ClipboardFormat::Text, "copied");
+    CHECK(!capture.OnClipboardUpdate());
+    CHECK_EQ(1u, g_notifications);
+
+    // 不受支持的格式 (或剪贴板被占用) 不记录
+    source.Set(ClipboardFormat::None, "");
+    CHECK(!capture.OnClipboardUpdate());
+
+    source.Set(ClipboardFormat::Text, "next");
+    CHECK(capture.OnClipboardUpdate());
+    CHECK_EQ(2u, g_notifications);
+    CHECK(ReadEntry(capture.History(), g_lastNotified) == "next");
+}
@@ -0,0 +1,194 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "FixtureConnectionSource.h"
+#include "Network/ConnectionFilter.h"
+#include "Network/NetworkMonitor.h"
+#include <initializer_list>
+
+using namespace IronSight::Core::Native::Network;
+using IronSight::Core::Native::Tests::FixtureConnectionSource;
+
+namespace
+{
+    // 回放数据第 1 代 (按 PID 排序)：
+    //   100 TCP 0.0.0.0:22 LISTEN                  101 TCP 10.0.0.5:22 -> 10.0.0.9:51000
+    //   200 TCP 127.0.0.1:5432 LISTEN 与 127.0.0.1:5432 -> 127.0.0.1:40000
+    //   300 TCP 127.0.0.1:40000 -> 127.0.0.1:5432  400 TCP [::]:80 LISTEN 与 10.0.0.5:80 -> 10.0.0.7:50500 (IPv4 映射)
+    //   500 TCP [2001:db8::1]:443 -> [2001:db8::2]:60000
+    //   600 UDP 0.0.0.0:53                         601 UDP 127.0.0.1:323
+    struct FilterFixture
+    {
+        NetworkMonitor Monitor;
+        ConnectionSnapshotView Snapshot;
+
+        FilterFixture()
+            : Monitor(std::make_unique<FixtureConnectionSource>("Network/replay")),
+            Snapshot((Monitor.Refresh(), Monitor.AcquireSnapshot()))
+        {
+        }
+
+        // 返回匹配行数，并检查输出下标升序且每一行都通过逐行判断
+        size_t Count(const ConnectionFilter& filter) const
+        {
+            ConnectionFilterEvaluator evaluator(filter);
+            uint32_t indices[32];
+            const size_t count = evaluator.Query(*Snapshot, indices, 32);
+
+            for (size_t i = 0; i < count && i < 32; ++i)
+            {
+                if (i > 0) CHECK(indices[i - 1] < indices[i]);
+                CHECK(evaluator.Matches(Snapshot->Connections.Rows[indices[i]], Snapshot->Connections.Addresses));
+            }
+            return count;
+        }
+    };
+
+    AddressPrefix Ipv4Prefix(std::initializer_list<uint8_t> bytes, uint8_t length)
+    {
+        AddressPrefix prefix{};
+        prefix.Family = AddressFamily::Ipv4;
+        prefix.PrefixLength = length;
+        size_t i = 0;
+        for (uint8_t value : bytes) prefix.Address.Bytes[i++] = value;
+        return prefix;
+    }
+
+    // 2001:db8::<last>
+    AddressPrefix DocumentationPrefix(uint8_t last, uint8_t length)
+    {
+        AddressPrefix prefix{};
+        prefix.Family = AddressFamily::Ipv6;
+        prefix.PrefixLength = length;
+        prefix.Address.Bytes[0] = 0x20;
+        prefix.Address.Bytes[1] = 0x01;
+        prefix.Address.Bytes[2] = 0x0D;
+        prefix.Address.Bytes[3] = 0xB8;
+        prefix.Address.Bytes[15] = last;
+        return prefix;
+    }
+
+    ConnectionFilter LocalPrefixFilter(const AddressPrefix& prefix)
+    {
+        ConnectionFilter filter{};
+        filter.Flags = static_cast<uint32_t>(ConnectionFilterFlags::LocalAddress);
+        filter.LocalPrefix = prefix;
+        return filter;
+    }
+
+    ConnectionFilter RemotePrefixFilter(const AddressPrefix& prefix)
+    {
+        ConnectionFilter filter{};
+        filter.Flags = static_cast<uint32_t>(ConnectionFilterFlags::RemoteAddress);
+        filter.RemotePrefix = prefix;
+        return filter;
+    }
+
+    constexpr uint32_t Bit(ProtocolType protocol) { return 1u << static_cast<int>(protocol); }
+    constexpr uint32_t Bit(ConnectionState state) { return 1u << static_cast<int>(state); }
+}
+
+IRONSIGHT_TEST(Network, FilterWithoutConditionsMatchesEveryRow)
+{
+    FilterFixture fixture;
+    CHECK_EQ(size_t{ 10 }, fixture.Snapshot->Connections.Rows.size());
+    CHECK_EQ(size_t{ 10 }, fixture.Count(ConnectionFilter{}));
+}
+
+IRONSIGHT_TEST(Network, FilterMatchesIpv4Prefixes)
+{
+    FilterFixture fixture;
+
+    CHECK_EQ(size_t{ 4 }, fixture.Count(LocalPrefixFilter(Ipv4Prefix({ 127 }, 8))));
+    CHECK_EQ(size_t{ 2 }, fixture.Count(LocalPrefixFilter(Ipv4Prefix({ 10, 0, 0 }, 24))));
+    CHECK_EQ(size_t{ 2 }, fixture.Count(LocalPrefixFilter(Ipv4Prefix({ 10, 0, 0, 5 }, 32))));
+    CHECK_EQ(size_t{ 0 }, fixture.Count(LocalPrefixFilter(Ipv4Prefix({ 10, 0, 0, 6 }, 32))));
+    CHECK_EQ(size_t{ 1 }, fixture.Count(RemotePrefixFilter(Ipv4Prefix({ 10, 0, 0, 9 }, 32))));
+
+    // 前缀的主机位被忽略：10.0.0.9/30 即 10.0.0.8 ~ 10.0.0.11
+    CHECK_EQ(size_t{ 1 }, fixture.Count(RemotePrefixFilter(Ipv4Prefix({ 10, 0, 0, 9 }, 30))));
+
+    // /0 匹配全部 IPv4 行，地址族不同的 IPv6 行不匹配
+    CHECK_EQ(size_t{ 8 }, fixture.Count(LocalPrefixFilter(Ipv4Prefix({ 192, 168, 1, 1 }, 0))));
+}
+
+IRONSIGHT_TEST(Network, FilterMatchesIpv6Prefixes)
+{
+    FilterFixture fixture;
+
+    CHECK_EQ(size_t{ 1 }, fixture.Count(LocalPrefixFilter(DocumentationPrefix(0, 32))));
+    CHECK_EQ(size_t{ 1 }, fixture.Count(LocalPrefixFilter(DocumentationPrefix(1, 128))));
+    CHECK_EQ(size_t{ 0 }, fixture.Count(LocalPrefixFilter(DocumentationPrefix(2, 128))));
+    CHECK_EQ(size_t{ 1 }, fixture.Count(RemotePrefixFilter(DocumentationPrefix(2, 128))));
+
+    // /127 只忽略最后一位：::1 与 ::0 同属一个前缀，::2 不属于
+    CHECK_EQ(size_t{ 1 }, fixture.Count(LocalPrefixFilter(DocumentationPrefix(0, 127))));
+    CHECK_EQ(size_t{ 0 }, fixture.Count(RemotePrefixFilter(DocumentationPrefix(0, 127))));
+
+    // ::/0 匹配全部 IPv6 行 (未折叠的 [::]:80 监听与 2001:db8::1)；超过 128 的长度按 128 处理
+    CHECK_EQ(size_t{ 2 }, fixture.Count(LocalPrefixFilter(DocumentationPrefix(0, 0))));
+    CHECK_EQ(size_t{ 1 }, fixture.Count(LocalPrefixFilter(DocumentationPrefix(1, 200))));
+}
+
+IRONSIGHT_TEST(Network, FilterMatchesProtocolAndStateMasks)
+{
+    FilterFixture fixture;
+
+    ConnectionFilter filter{};
+    filter.Flags = static_cast<uint32_t>(ConnectionFilterFlags::Protocol);
+    filter.ProtocolMask = Bit(ProtocolType::Udp);
+    CHECK_EQ(size_t{ 2 }, fixture.Count(filter));
+
+    filter.ProtocolMask = Bit(ProtocolType::Tcp) | Bit(ProtocolType::Udp);
+    CHECK_EQ(size_t{ 10 }, fixture.Count(filter));
+
+    filter.Flags |= static_cast<uint32_t>(ConnectionFilterFlags::State);
+    filter.ProtocolMask = Bit(ProtocolType::Tcp);
+    filter.StateMask = Bit(ConnectionState::Listen);
+    CHECK_EQ(size_t{ 3 }, fixture.Count(filter));
+
+    filter.StateMask = Bit(ConnectionState::Established);
+    CHECK_EQ(size_t{ 5 }, fixture.Count(filter));
+
+    filter.StateMask = Bit(ConnectionState::Listen) | Bit(ConnectionState::Established);
+    CHECK_EQ(size_t{ 8 }, fixture.Count(filter));
+
+    // 空掩码不匹配任何行
+    filter.StateMask = 0;
+    CHECK_EQ(size_t{ 0 }, fixture.Count(filter));
+}
+
+IRONSIGHT_TEST(Network, FilterMatchesProcessIdSet)
+{
+    FilterFixture fixture;
+
+    // 无序、重复与不存在的 PID：只输出 200 与 300 的行，下标保持快照行序
+    const uint32_t processIds[] = { 300, 999, 200, 200 };
+    ConnectionFilter filter{};
+    filter.Flags = static_cast<uint32_t>(ConnectionFilterFlags::ProcessId);
+    filter.ProcessIds = processIds;
+    filter.ProcessIdCount = 4;
+    CHECK_EQ(size_t{ 3 }, fixture.Count(filter));
+
+    // 与其他条件为"与"关系
+    filter.Flags |= static_cast<uint32_t>(ConnectionFilterFlags::LocalPort);
+    filter.LocalPortMin = 5432;
+    filter.LocalPortMax = 5432;
+    CHECK_EQ(size_t{ 2 }, fixture.Count(filter));
+
+    // 指定了 PID 条件但集合为空：不匹配任何行
+    ConnectionFilter empty{};
+    empty.Flags = static_cast<uint32_t>(ConnectionFilterFlags::ProcessId);
+    CHECK_EQ(size_t{ 0 }, fixture.Count(empty));
+}
+
+IRONSIGHT_TEST(Network, FilterQueryReportsTotalBeyondCapacity)
+{
+    FilterFixture fixture;
+
+    ConnectionFilterEvaluator evaluator(ConnectionFilter{});
+    uint32_t indices[3] = {};
+    CHECK_EQ(size_t{ 10 }, evaluator.Query(*fixture.Snapshot, indices, 3));
+    CHECK_EQ(0u, indices[0]);
+    CHECK_EQ(2u, indices[2]);
+    CHECK_EQ(size_t{ 10 }, evaluator.Query(*fixture.Snapshot, nullptr, 0));
+}
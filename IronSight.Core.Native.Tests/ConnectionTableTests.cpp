@@ -0,0 +1,55 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "Network/ConnectionTable.h"
+#include <cstring>
+
+using namespace IronSight::Core::Native::Network;
+
+namespace
+{
+    Ipv6Address MakeAddress(uint32_t value)
+    {
+        Ipv6Address address{};
+        address.Bytes[0] = 0x20;
+        address.Bytes[1] = 0x01;
+        for (int i = 0; i < 4; ++i)
+        {
+            address.Bytes[15 - i] = static_cast<uint8_t>(value >> (i * 8));
+        }
+        return address;
+    }
+}
+
+IRONSIGHT_TEST(Network, AddressTableInternsEachAddressOnce)
+{
+    Ipv6AddressTable table;
+
+    // 超过初始槽数，覆盖扩容时的重建
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        CHECK_EQ(i, table.Intern(MakeAddress(i)));
+    }
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        CHECK_EQ(i, table.Intern(MakeAddress(i)));
+    }
+
+    CHECK_EQ(size_t{ 1000 }, table.Size());
+    CHECK(std::memcmp(table[123].Bytes, MakeAddress(123).Bytes, sizeof(Ipv6Address)) == 0);
+}
+
+IRONSIGHT_TEST(Network, AddressTableClearForgetsPreviousGeneration)
+{
+    Ipv6AddressTable table;
+
+    for (uint32_t i = 0; i < 100; ++i) table.Intern(MakeAddress(i));
+    table.Clear();
+    CHECK_EQ(size_t{ 0 }, table.Size());
+
+    // 清空后按新顺序驻留，索引从 0 重新分配，旧代的槽不会被误认为命中
+    CHECK_EQ(0u, table.Intern(MakeAddress(99)));
+    CHECK_EQ(1u, table.Intern(MakeAddress(0)));
+    CHECK_EQ(0u, table.Intern(MakeAddress(99)));
+    CHECK_EQ(size_t{ 2 }, table.Size());
+}
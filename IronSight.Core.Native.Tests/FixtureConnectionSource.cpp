@@ -0,0 +1,70 @@
+﻿#include <pch.h>
+#include "FixtureConnectionSource.h"
+#include "TestFramework.h"
+#include "Network/ProcNetParser.h"
+#include <sstream>
+
+namespace IronSight::Core::Native::Tests
+{
+    using namespace IronSight::Core::Native::Network;
+
+    FixtureConnectionSource::FixtureConnectionSource(std::string directory)
+        : _directory(std::move(directory))
+    {
+    }
+
+    std::string FixtureConnectionSource::GenerationPath(int generation, const char* name) const
+    {
+        return _directory + "/gen" + std::to_string(generation) + "/" + name;
+    }
+
+    void FixtureConnectionSource::BeginRefresh()
+    {
+        std::string content;
+        if (!ReadFixture(GenerationPath(_generation + 1, "owners"), content)) return;
+
+        ++_generation;
+        _owners.clear();
+
+        std::istringstream lines(content);
+        uint64_t inode = 0;
+        uint32_t processId = 0;
+        while (lines >> inode >> processId)
+        {
+            _owners[inode] = processId;
+        }
+    }
+
+    bool FixtureConnectionSource::CollectTcp(ConnectionTable& table)
+    {
+        return Collect("tcp", ProtocolType::Tcp, false, table)
+            && Collect("tcp6", ProtocolType::Tcp, true, table);
+    }
+
+    bool FixtureConnectionSource::CollectUdp(ConnectionTable& table)
+    {
+        return Collect("udp", ProtocolType::Udp, false, table)
+            && Collect("udp6", ProtocolType::Udp, true, table);
+    }
+
+    bool FixtureConnectionSource::Collect(const char* name, ProtocolType protocol, bool isIpv6, ConnectionTable& table)
+    {
+        if (_generation == 0) return false;
+
+        std::string content;
+        if (!ReadFixture(GenerationPath(_generation, name), content)) return true;
+
+        const size_t first = table.Rows.size();
+        _inodes.clear();
+        ProcNetParser::Parse(content.data(), content.size(), protocol, isIpv6, table, _inodes);
+
+        // 与 ProcNetConnectionSource 相同：找不到所属进程的套接字 PID 为 0
+        for (size_t i = 0; i < _inodes.size(); ++i)
+        {
+            auto owner = _owners.find(_inodes[i]);
+            table.Rows[first + i].ProcessId = owner != _owners.end() ? owner->second : 0;
+        }
+
+        return true;
+    }
+}
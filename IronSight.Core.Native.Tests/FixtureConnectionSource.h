@@ -0,0 +1,37 @@
+﻿#pragma once
+#include "Network/ConnectionSource.h"
+#include <string>
+#include <unordered_map>
+
+namespace IronSight::Core::Native::Tests
+{
+	/// <summary>
+	/// 回放录制连接表的数据源
+	/// 每一代是测试数据目录下的一个子目录，包含 /proc/net 格式的 tcp、tcp6、udp、udp6 (缺失视为空表)
+	/// 以及 "inode pid" 格式的 owners；每次 BeginRefresh 前进到下一代，最后一代之后保持不变
+	/// </summary>
+	class FixtureConnectionSource final : public Network::IConnectionSource
+	{
+		public:
+		/// <param name="directory">相对测试数据目录的路径，其下为 gen1、gen2 ... 子目录</param>
+		explicit FixtureConnectionSource(std::string directory);
+
+		void BeginRefresh() override;
+		bool CollectTcp(Network::ConnectionTable& table) override;
+		bool CollectUdp(Network::ConnectionTable& table) override;
+
+		/// <summary>
+		/// 当前回放到的代 (从 1 开始)，尚未刷新时为 0
+		/// </summary>
+		int Generation() const noexcept { return _generation; }
+
+		private:
+		bool Collect(const char* name, Network::ProtocolType protocol, bool isIpv6, Network::ConnectionTable& table);
+		std::string GenerationPath(int generation, const char* name) const;
+
+		std::string _directory;
+		int _generation = 0;
+		std::unordered_map<uint64_t, uint32_t> _owners;
+		std::vector<uint64_t> _inodes;
+	};
+}
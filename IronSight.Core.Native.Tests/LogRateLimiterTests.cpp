@@ -0,0 +1,67 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "Logging/LogRateLimiter.h"
+
+using IronSight::Core::Native::Logging::LogRateLimiter;
+
+namespace
+{
+    constexpr int64_t Interval = LogRateLimiter::Interval.count();
+    constexpr int64_t Start = 1000 * Interval;      // 远离 0，避免初始到达时间影响结果
+
+    // 在同一时刻连续请求，返回放行的条数
+    uint32_t AcquireAll(LogRateLimiter& limiter, int64_t now, uint32_t attempts)
+    {
+        uint32_t accepted = 0;
+        for (uint32_t i = 0; i < attempts; ++i)
+        {
+            uint32_t suppressed = 0;
+            if (limiter.TryAcquire(now, suppressed)) ++accepted;
+        }
+        return accepted;
+    }
+}
+
+// 同一时刻允许突发 Burst 条，之后每过一个 Interval 恢复一条
+IRONSIGHT_TEST(Logging, RateLimiterAllowsBurstThenRefills)
+{
+    LogRateLimiter limiter;
+    CHECK_EQ(LogRateLimiter::Burst, AcquireAll(limiter, Start, 20));
+
+    // 不足一个间隔不恢复
+    CHECK_EQ(0u, AcquireAll(limiter, Start + Interval - 1, 3));
+
+    CHECK_EQ(1u, AcquireAll(limiter, Start + Interval, 3));
+    CHECK_EQ(2u, AcquireAll(limiter, Start + 3 * Interval, 3));
+
+    // 空闲足够久后恢复完整的突发额度，但不会超过 Burst
+    CHECK_EQ(LogRateLimiter::Burst, AcquireAll(limiter, Start + 100 * Interval, 20));
+}
+
+// 被拒绝的条数在下一次放行时一并取出，取出后清零
+IRONSIGHT_TEST(Logging, RateLimiterHandsOffSuppressedCount)
+{
+    LogRateLimiter limiter;
+    uint32_t suppressed = 99;
+
+    for (uint32_t i = 0; i < LogRateLimiter::Burst; ++i)
+    {
+        CHECK(limiter.TryAcquire(Start, suppressed));
+        CHECK_EQ(0u, suppressed);
+    }
+
+    // 拒绝时不写入输出参数
+    suppressed = 99;
+    for (int i = 0; i < 7; ++i) CHECK(!limiter.TryAcquire(Start + i, suppressed));
+    CHECK_EQ(99u, suppressed);
+
+    CHECK(limiter.TryAcquire(Start + Interval, suppressed));
+    CHECK_EQ(7u, suppressed);
+
+    CHECK(!limiter.TryAcquire(Start + Interval, suppressed));
+    CHECK(limiter.TryAcquire(Start + 2 * Interval, suppressed));
+    CHECK_EQ(1u, suppressed);
+
+    CHECK(limiter.TryAcquire(Start + 10 * Interval, suppressed));
+    CHECK_EQ(0u, suppressed);
+}
@@ -0,0 +1,234 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "Memory/MemoryPressureWatcher.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+
+using namespace IronSight::Core::Native::Memory;
+
+namespace
+{
+    constexpr uint64_t MB = 1024ull * 1024;
+    constexpr uint64_t TotalBytes = 1000 * MB;      // 水位 10% / 20% 即 100 MB / 200 MB
+
+    // 监视线程每次 Wait 取一步：等待结果与随后 QueryMemory 返回的可用内存；步骤用完后阻塞到 Wake
+    struct PressureScript
+    {
+        struct Step
+        {
+            PressureWait Result;
+            uint64_t AvailableBytes;
+        };
+
+        std::mutex Mutex;
+        std::condition_variable Changed;
+        std::deque<Step> Steps;
+        std::vector<uint32_t> Timeouts;             // 每次 Wait 请求的超时 (毫秒)
+        uint64_t AvailableBytes = TotalBytes;
+        bool Idle = false;                          // 步骤已用完，监视线程正在等待 Wake
+        bool Woken = false;
+
+        std::vector<TrimOptions> Trims;
+        std::deque<uint64_t> Released;              // 每次回收返回的释放量，用完后按目标全额释放
+
+        void Add(PressureWait result, uint64_t availableMB) { Steps.push_back({ result, availableMB * MB }); }
+
+        // 等待监视线程处理完全部步骤
+        bool WaitIdle()
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            return Changed.wait_for(lock, std::chrono::seconds(10), [&] { return Idle; });
+        }
+
+        TrimResult Trim(const TrimOptions& options)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Trims.push_back(options);
+
+            TrimResult result{};
+            result.ReleasedBytes = options.TargetBytes;
+            if (!Released.empty())
+            {
+                result.ReleasedBytes = Released.front();
+                Released.pop_front();
+            }
+            return result;
+        }
+    };
+
+    class FakePressureSource final : public IPressureSource
+    {
+        public:
+        explicit FakePressureSource(PressureScript& script) : _script(script) {}
+
+        PressureWait Wait(uint32_t timeoutMs, bool) override
+        {
+            std::unique_lock<std::mutex> lock(_script.Mutex);
+            _script.Timeouts.push_back(timeoutMs);
+
+            if (_script.Steps.empty())
+            {
+                _script.Idle = true;
+                _script.Changed.notify_all();
+                _script.Changed.wait(lock, [&] { return _script.Woken; });
+                return PressureWait::Woken;
+            }
+
+            const PressureScript::Step step = _script.Steps.front();
+            _script.Steps.pop_front();
+            _script.AvailableBytes = step.AvailableBytes;
+
+            // 超时按请求的时长真实等待，回收间隔与退避依赖实际时间；超时按毫秒截断，多等 1 毫秒确保到达回收时刻
+            if (step.Result == PressureWait::Timeout)
+            {
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs + 1));
+            }
+            return step.Result;
+        }
+
+        void Wake() override
+        {
+            std::lock_guard<std::mutex> lock(_script.Mutex);
+            _script.Woken = true;
+            _script.Changed.notify_all();
+        }
+
+        bool QueryMemory(uint64_t& availableBytes, uint64_t& totalBytes) override
+        {
+            std::lock_guard<std::mutex> lock(_script.Mutex);
+            availableBytes = _script.AvailableBytes;
+            totalBytes = TotalBytes;
+            return true;
+        }
+
+        bool HasNotifications() const noexcept override { return true; }
+
+        private:
+        PressureScript& _script;
+    };
+
+    MemoryPressureOptions TestOptions()
+    {
+        MemoryPressureOptions options{};
+        options.LowPercent = 10;
+        options.HighPercent = 20;
+        options.MinIntervalMs = 20;
+        options.PollIntervalMs = 1;
+        options.StepBytes = 64 * MB;
+        options.MinReclaimBytes = 4 * MB;
+        options.MaxConcurrency = 3;
+        return options;
+    }
+
+    // 运行脚本直到全部步骤处理完毕，返回停止前的统计
+    MemoryPressureStats Run(PressureScript& script)
+    {
+        MemoryPressureWatcher watcher(
+            [&script]() { return std::make_unique<FakePressureSource>(script); },
+            [&script](const TrimOptions& options) { return script.Trim(options); });
+
+        CHECK(watcher.Start(TestOptions()));
+        CHECK(script.WaitIdle());
+
+        MemoryPressureStats stats{};
+        watcher.GetStats(stats);
+        watcher.Stop();
+        return stats;
+    }
+}
+
+// 可用内存在两条水位之间且没有通知时不回收；跌破低水位后进入压力状态并立即回收一步
+IRONSIGHT_TEST(Memory, PressureEntersBelowLowWatermark)
+{
+    PressureScript script;
+    script.Add(PressureWait::Timeout, 150);
+    script.Add(PressureWait::Timeout, 101);
+    script.Add(PressureWait::Timeout, 99);
+
+    const MemoryPressureStats stats = Run(script);
+
+    CHECK_EQ(uint64_t{ 1 }, stats.PressureEpisodes);
+    CHECK_EQ(uint8_t{ 1 }, stats.IsUnderPressure);
+    CHECK_EQ(uint64_t{ 1 }, stats.ReclaimSteps);
+    CHECK_EQ(size_t{ 1 }, script.Trims.size());
+    if (!script.Trims.empty())
+    {
+        CHECK_EQ(4 * MB, script.Trims[0].MinReclaimBytes);
+        CHECK_EQ(uint32_t{ 3 }, script.Trims[0].MaxConcurrency);
+    }
+}
+
+// 系统通知只要求可用内存低于高水位即进入压力状态
+IRONSIGHT_TEST(Memory, PressureNotificationEntersBelowHighWatermark)
+{
+    PressureScript script;
+    script.Add(PressureWait::Pressure, 250);
+    script.Add(PressureWait::Pressure, 150);
+
+    const MemoryPressureStats stats = Run(script);
+
+    CHECK_EQ(uint64_t{ 2 }, stats.Notifications);
+    CHECK_EQ(uint64_t{ 1 }, stats.PressureEpisodes);
+    CHECK_EQ(size_t{ 1 }, script.Trims.size());
+}
+
+// 迟滞：回升到低水位以上仍在压力状态，到达高水位 (含) 才退出，退出后在两条水位之间不再回收
+IRONSIGHT_TEST(Memory, PressureLeavesAtHighWatermark)
+{
+    PressureScript script;
+    script.Add(PressureWait::Timeout, 90);
+    script.Add(PressureWait::Timeout, 150);
+    script.Add(PressureWait::Timeout, 200);
+    script.Add(PressureWait::Timeout, 150);
+    script.Add(PressureWait::Timeout, 150);
+
+    const MemoryPressureStats stats = Run(script);
+
+    CHECK_EQ(uint64_t{ 1 }, stats.PressureEpisodes);
+    CHECK_EQ(uint8_t{ 0 }, stats.IsUnderPressure);
+    CHECK_EQ(size_t{ 2 }, script.Trims.size());
+}
+
+// 每步回收目标为距高水位的缺口，且不超过 StepBytes
+IRONSIGHT_TEST(Memory, PressureStepIsGapToHighWatermarkCappedByStepBytes)
+{
+    PressureScript script;
+    script.Add(PressureWait::Timeout, 50);
+    script.Add(PressureWait::Timeout, 99);
+    script.Add(PressureWait::Timeout, 180);
+
+    Run(script);
+
+    CHECK_EQ(size_t{ 3 }, script.Trims.size());
+    if (script.Trims.size() == 3)
+    {
+        CHECK_EQ(64 * MB, script.Trims[0].TargetBytes);
+        CHECK_EQ(64 * MB, script.Trims[1].TargetBytes);
+        CHECK_EQ(20 * MB, script.Trims[2].TargetBytes);
+    }
+}
+
+// 释放量不到目标的四分之一时回收间隔加倍 (最多 8 倍)，收效恢复后回到原间隔
+IRONSIGHT_TEST(Memory, PressureBacksOffWhenReclaimIsSmall)
+{
+    PressureScript script;
+    for (int i = 0; i < 6; ++i) script.Add(PressureWait::Timeout, 50);
+    script.Released = { 1 * MB, 1 * MB, 1 * MB, 1 * MB, 64 * MB };
+
+    Run(script);
+
+    CHECK_EQ(size_t{ 6 }, script.Trims.size());
+
+    // Timeouts[0] 是进入压力状态前的轮询，此后每次 Wait 都等到下一次允许回收的时刻
+    const uint32_t interval = TestOptions().MinIntervalMs;
+    const uint32_t expected[] = { 2, 4, 8, 8, 1, 1 };
+    CHECK_EQ(size_t{ 7 }, script.Timeouts.size());
+    for (size_t i = 0; i < 6 && i + 1 < script.Timeouts.size(); ++i)
+    {
+        const uint32_t timeout = script.Timeouts[i + 1];
+        CHECK(timeout <= interval * expected[i]);
+        CHECK(timeout > interval * expected[i] / 2);
+    }
+}
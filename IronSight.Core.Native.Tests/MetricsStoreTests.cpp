@@ -0,0 +1,70 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "Metrics/MetricsStore.h"
+
+using namespace IronSight::Core::Native::Metrics;
+
+namespace
+{
+    constexpr int64_t BaseMs = 1700000000000;
+
+    size_t QuerySeconds(const MetricsStore& store, MetricKind kind, uint32_t id, MetricPoint* points, size_t maxCount)
+    {
+        return store.Query(kind, id, MetricResolution::Second, BaseMs - 3600000, BaseMs + 3600000, points, maxCount);
+    }
+}
+
+IRONSIGHT_TEST(Metrics, ReusedPidStartsAFreshHistory)
+{
+    MetricsStore store;
+    MetricPoint points[16];
+
+    store.Record(MetricKind::ProcessCpu, 42, BaseMs, 10.0, 1111);
+    store.Record(MetricKind::ProcessCpu, 42, BaseMs + 1000, 20.0, 1111);
+    CHECK_EQ(size_t{ 2 }, QuerySeconds(store, MetricKind::ProcessCpu, 42, points, 16));
+
+    // 同一 PID、不同创建时间：旧进程的两个点不再出现
+    store.Record(MetricKind::ProcessCpu, 42, BaseMs + 2000, 70.0, 2222);
+    CHECK_EQ(size_t{ 1 }, QuerySeconds(store, MetricKind::ProcessCpu, 42, points, 16));
+    CHECK_EQ(BaseMs + 2000, points[0].TimestampMs);
+    CHECK(points[0].Avg == 70.0f);
+    CHECK_EQ(size_t{ 1 }, store.SeriesCount());
+}
+
+IRONSIGHT_TEST(Metrics, CapGrowsWithLiveSeries)
+{
+    MetricsStore store(8);
+
+    // 每秒一批 20 个存活进程：全部保留，上限随之增长
+    for (int64_t tick = 0; tick < 3; ++tick)
+    {
+        store.RecordBatch(BaseMs + tick * 1000, [](auto record)
+            {
+                for (uint32_t pid = 1; pid <= 20; ++pid) record(MetricKind::ProcessMemory, pid, pid, uint64_t{ pid });
+            });
+    }
+
+    CHECK_EQ(size_t{ 20 }, store.SeriesCount());
+    CHECK(store.MaxSeries() >= 20);
+
+    MetricPoint points[4];
+    CHECK_EQ(size_t{ 3 }, QuerySeconds(store, MetricKind::ProcessMemory, 1, points, 4));
+}
+
+IRONSIGHT_TEST(Metrics, StaleSeriesAreEvictedAtCapacity)
+{
+    MetricsStore store(4);
+
+    for (uint32_t pid = 1; pid <= 4; ++pid) store.Record(MetricKind::ProcessCpu, pid, BaseMs, 1.0, pid);
+
+    // 1 分钟后 2、3、4 仍在更新，1 已停止：新序列淘汰 1 而不扩容
+    for (uint32_t pid = 2; pid <= 4; ++pid) store.Record(MetricKind::ProcessCpu, pid, BaseMs + 60000, 1.0, pid);
+    store.Record(MetricKind::ProcessCpu, 5, BaseMs + 60000, 1.0, 5);
+
+    MetricPoint points[4];
+    CHECK_EQ(size_t{ 4 }, store.SeriesCount());
+    CHECK_EQ(size_t{ 4 }, store.MaxSeries());
+    CHECK_EQ(size_t{ 0 }, QuerySeconds(store, MetricKind::ProcessCpu, 1, points, 4));
+    CHECK_EQ(size_t{ 2 }, QuerySeconds(store, MetricKind::ProcessCpu, 2, points, 4));
+    CHECK_EQ(size_t{ 1 }, QuerySeconds(store, MetricKind::ProcessCpu, 5, points, 4));
+}
@@ -0,0 +1,492 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "FixtureConnectionSource.h"
+#include "Network/ConnectionDiff.h"
+#include "Network/ConnectionIndex.h"
+#include "Network/ConnectionLifetime.h"
+#include "Network/NetworkMonitor.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <tuple>
+
+using namespace IronSight::Core::Native::Network;
+using IronSight::Core::Native::Tests::FixtureConnectionSource;
+
+namespace
+{
+    using Address = std::array<uint8_t, 16>;
+
+    // 连接键：PID + 协议 + 地址族 + 五元组 (与 ConnectionDiff::CompareKey 一致，不含状态)
+    using ConnectionKey = std::tuple<uint32_t, uint8_t, uint8_t, Address, uint16_t, Address, uint16_t>;
+    using ConnectionModel = std::map<ConnectionKey, uint8_t>;
+
+    Address ResolveAddress(const NetworkConnectionRow& row, uint32_t value, const Ipv6AddressTable& addresses)
+    {
+        Address address{};
+        if (row.Family == AddressFamily::Ipv6)
+        {
+            std::memcpy(address.data(), addresses[value].Bytes, address.size());
+        }
+        else
+        {
+            std::memcpy(address.data(), &value, sizeof(value));
+        }
+        return address;
+    }
+
+    ConnectionKey KeyOf(const NetworkConnectionRow& row, const Ipv6AddressTable& addresses)
+    {
+        return { row.ProcessId, row.Protocol, static_cast<uint8_t>(row.Family),
+            ResolveAddress(row, row.LocalAddress, addresses), row.LocalPort,
+            ResolveAddress(row, row.RemoteAddress, addresses), row.RemotePort };
+    }
+
+    ConnectionModel ModelOf(const ConnectionSnapshot& snapshot)
+    {
+        ConnectionModel model;
+        for (const auto& row : snapshot.Connections.Rows)
+        {
+            model[KeyOf(row, snapshot.Connections.Addresses)] = row.State;
+        }
+        return model;
+    }
+
+    struct DeltaCounts
+    {
+        size_t Added = 0;
+        size_t Removed = 0;
+        size_t StateChanged = 0;
+    };
+
+    DeltaCounts CountDelta(const ConnectionSnapshot& snapshot)
+    {
+        DeltaCounts counts;
+        for (const auto& change : snapshot.Delta)
+        {
+            switch (static_cast<ConnectionChangeKind>(change.Kind))
+            {
+            case ConnectionChangeKind::Added: ++counts.Added; break;
+            case ConnectionChangeKind::Removed: ++counts.Removed; break;
+            case ConnectionChangeKind::StateChanged: ++counts.StateChanged; break;
+            }
+        }
+        return counts;
+    }
+
+    std::unique_ptr<NetworkMonitor> CreateReplayMonitor()
+    {
+        return std::make_unique<NetworkMonitor>(std::make_unique<FixtureConnectionSource>("Network/replay"));
+    }
+}
+
+// 把每一代的增量应用到上一代，必须恰好得到这一代的连接表
+IRONSIGHT_TEST(Network, ReplayDeltaReproducesEachGeneration)
+{
+    auto monitor = CreateReplayMonitor();
+    monitor->SetIncrementalMode(true);
+
+    ConnectionModel model;
+
+    for (uint64_t generation = 1; generation <= 3; ++generation)
+    {
+        CHECK(monitor->Refresh());
+
+        ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+        CHECK_EQ(generation, snapshot->Version);
+
+        for (const auto& change : snapshot->Delta)
+        {
+            const ConnectionKey key = KeyOf(change.Connection, snapshot->Connections.Addresses);
+            const auto existing = model.find(key);
+
+            switch (static_cast<ConnectionChangeKind>(change.Kind))
+            {
+            case ConnectionChangeKind::Added:
+                CHECK(existing == model.end());
+                CHECK_EQ(static_cast<uint8_t>(ConnectionState::Unknown), change.PreviousState);
+                model[key] = change.Connection.State;
+                break;
+            case ConnectionChangeKind::Removed:
+                CHECK(existing != model.end());
+                model.erase(key);
+                break;
+            case ConnectionChangeKind::StateChanged:
+                CHECK(existing != model.end());
+                if (existing != model.end())
+                {
+                    CHECK_EQ(existing->second, change.PreviousState);
+                }
+                model[key] = change.Connection.State;
+                break;
+            default:
+                CHECK(!"未知的变更类型");
+                break;
+            }
+        }
+
+        CHECK(model == ModelOf(*snapshot));
+    }
+}
+
+IRONSIGHT_TEST(Network, ReplayDeltaKinds)
+{
+    auto monitor = CreateReplayMonitor();
+    monitor->SetIncrementalMode(true);
+
+    // 第 1 代：以空表为基线，全部为 Added (tcp6 中的 IPv4 映射连接折叠为 IPv4 行)
+    CHECK(monitor->Refresh());
+    {
+        ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+        const DeltaCounts counts = CountDelta(*snapshot);
+        CHECK_EQ(size_t{ 10 }, snapshot->Connections.Rows.size());
+        CHECK_EQ(size_t{ 10 }, counts.Added);
+        CHECK_EQ(size_t{ 8 }, monitor->GetDeltaCount());
+    }
+
+    // 第 2 代：新 SSH 会话与 DHCP 端点出现，本机数据库连接与 NTP 端点消失，
+    // 旧 SSH 会话进入 CLOSE_WAIT，IPv6 HTTPS 连接进入 FIN_WAIT1
+    CHECK(monitor->Refresh());
+    {
+        ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+        const DeltaCounts counts = CountDelta(*snapshot);
+        CHECK_EQ(size_t{ 2 }, counts.Added);
+        CHECK_EQ(size_t{ 3 }, counts.Removed);
+        CHECK_EQ(size_t{ 2 }, counts.StateChanged);
+
+        // v1 接口只包含 IPv4 行，代数与同一快照一致
+        NetworkConnectionDelta buffer[16];
+        uint64_t generation = 0;
+        CHECK_EQ(size_t{ 6 }, monitor->CopyDeltaTo(buffer, 16, &generation));
+        CHECK_EQ(snapshot->Version, generation);
+    }
+
+    // 第 3 代：内容不变，增量为空
+    CHECK(monitor->Refresh());
+    {
+        ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+        CHECK_EQ(size_t{ 0 }, snapshot->Delta.size());
+        CHECK_EQ(size_t{ 9 }, snapshot->Connections.Rows.size());
+    }
+}
+
+IRONSIGHT_TEST(Network, NoDeltaWithoutIncrementalMode)
+{
+    auto monitor = CreateReplayMonitor();
+
+    CHECK(monitor->Refresh());
+    CHECK(monitor->Refresh());
+
+    ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+    CHECK_EQ(uint64_t{ 2 }, snapshot->Version);
+    CHECK_EQ(size_t{ 0 }, snapshot->Delta.size());
+}
+
+// 中途开启增量模式时没有基线，首个增量是全量同步
+IRONSIGHT_TEST(Network, EnablingIncrementalModeStartsWithFullSync)
+{
+    auto monitor = CreateReplayMonitor();
+
+    CHECK(monitor->Refresh());
+    monitor->SetIncrementalMode(true);
+    CHECK(monitor->Refresh());
+
+    ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+    const DeltaCounts counts = CountDelta(*snapshot);
+    CHECK_EQ(snapshot->Connections.Rows.size(), counts.Added);
+    CHECK_EQ(size_t{ 0 }, counts.Removed);
+}
+
+// 部分刷新沿用另一协议的上一代行：增量中不会出现该协议的虚假 Removed，之后的完整刷新也不会把它们重新报告为 Added
+IRONSIGHT_TEST(Network, TcpOnlyRefreshKeepsUdpRows)
+{
+    auto monitor = CreateReplayMonitor();
+    monitor->SetIncrementalMode(true);
+
+    CHECK(monitor->Refresh());
+
+    // 第 2 代只刷新 TCP：新 SSH 会话出现，本机数据库连接 (两行) 消失，两条连接状态变化
+    CHECK(monitor->RefreshTcp());
+    {
+        ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+        const DeltaCounts counts = CountDelta(*snapshot);
+        CHECK_EQ(size_t{ 1 }, counts.Added);
+        CHECK_EQ(size_t{ 2 }, counts.Removed);
+        CHECK_EQ(size_t{ 2 }, counts.StateChanged);
+
+        for (const auto& change : snapshot->Delta)
+        {
+            CHECK_EQ(static_cast<uint8_t>(ProtocolType::Tcp), change.Connection.Protocol);
+        }
+
+        // 第 1 代的两个 UDP 端点仍在快照中
+        const auto udpRows = std::count_if(snapshot->Connections.Rows.begin(), snapshot->Connections.Rows.end(),
+            [](const NetworkConnectionRow& row) { return row.Protocol == static_cast<uint8_t>(ProtocolType::Udp); });
+        CHECK_EQ(2, static_cast<int>(udpRows));
+        CHECK_EQ(size_t{ 9 }, snapshot->Connections.Rows.size());
+    }
+
+    // 第 3 代完整刷新：只有 UDP 的真实变化 (NTP 端点消失，DHCP 端点出现)
+    CHECK(monitor->Refresh());
+    {
+        ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+        const DeltaCounts counts = CountDelta(*snapshot);
+        CHECK_EQ(size_t{ 1 }, counts.Added);
+        CHECK_EQ(size_t{ 1 }, counts.Removed);
+        CHECK_EQ(size_t{ 0 }, counts.StateChanged);
+    }
+}
+
+// 第 1 代的进程汇总：每个进程的行连续存放，计数、监听端口与远程端点按进程聚合
+IRONSIGHT_TEST(Network, ReplayAggregatesPerProcess)
+{
+    auto monitor = CreateReplayMonitor();
+    CHECK(monitor->Refresh());
+
+    ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+    const auto& rows = snapshot->Connections.Rows;
+    const auto& processes = snapshot->Processes;
+
+    const uint32_t expectedPids[] = { 100, 101, 200, 300, 400, 500, 600, 601 };
+    CHECK_EQ(size_t{ 8 }, processes.size());
+    CHECK_EQ(size_t{ 8 }, monitor->GetProcessCount());
+
+    size_t nextRow = 0;
+    for (size_t i = 0; i < processes.size() && i < 8; ++i)
+    {
+        const ProcessConnectionSummary& summary = processes[i];
+        CHECK_EQ(expectedPids[i], summary.ProcessId);
+        CHECK_EQ(nextRow, static_cast<size_t>(summary.FirstRow));
+
+        for (uint32_t row = summary.FirstRow; row < summary.FirstRow + summary.ConnectionCount; ++row)
+        {
+            CHECK_EQ(summary.ProcessId, rows[row].ProcessId);
+        }
+        nextRow += summary.ConnectionCount;
+    }
+    CHECK_EQ(rows.size(), nextRow);
+
+    auto find = [&](uint32_t pid) -> const ProcessConnectionSummary&
+    {
+        return *std::find_if(processes.begin(), processes.end(),
+            [pid](const ProcessConnectionSummary& summary) { return summary.ProcessId == pid; });
+    };
+
+    // 数据库服务：监听 5432，另有一条来自本机客户端的连接
+    const ProcessConnectionSummary& database = find(200);
+    CHECK_EQ(2u, database.ConnectionCount);
+    CHECK_EQ(2u, database.TcpCount);
+    CHECK_EQ(0u, database.UdpCount);
+    CHECK_EQ(1u, database.RemoteEndpointCount);
+    CHECK_EQ(1u, database.StateCounts[static_cast<int>(ConnectionState::Listen)]);
+    CHECK_EQ(1u, database.StateCounts[static_cast<int>(ConnectionState::Established)]);
+    CHECK_EQ(1u, database.ListeningPortCount);
+    CHECK_EQ(uint16_t{ 5432 }, snapshot->ListeningPorts[database.ListeningPortOffset]);
+
+    // Web 服务：[::]:80 监听为 IPv6 行，IPv4 映射的连接折叠为 IPv4 行
+    const ProcessConnectionSummary& web = find(400);
+    CHECK_EQ(2u, web.ConnectionCount);
+    CHECK_EQ(1u, web.Ipv6Count);
+    CHECK_EQ(1u, web.RemoteEndpointCount);
+    CHECK_EQ(1u, web.ListeningPortCount);
+    CHECK_EQ(uint16_t{ 80 }, snapshot->ListeningPorts[web.ListeningPortOffset]);
+
+    // UDP 端点既不监听也没有远程端点
+    const ProcessConnectionSummary& dns = find(600);
+    CHECK_EQ(1u, dns.UdpCount);
+    CHECK_EQ(0u, dns.TcpCount);
+    CHECK_EQ(0u, dns.RemoteEndpointCount);
+    CHECK_EQ(0u, dns.ListeningPortCount);
+    CHECK_EQ(1u, dns.StateCounts[static_cast<int>(ConnectionState::Unknown)]);
+
+    // 导出接口复制同一份汇总
+    ProcessConnectionSummary copied[16];
+    CHECK_EQ(size_t{ 8 }, monitor->CopyProcessSummariesTo(copied, 16));
+    CHECK_EQ(200u, copied[2].ProcessId);
+    CHECK_EQ(2u, copied[2].ConnectionCount);
+}
+
+// 本地端口索引：同一端口的行按行序连续，查询不扫描连接表
+IRONSIGHT_TEST(Network, ReplayIndexesLocalPorts)
+{
+    auto monitor = CreateReplayMonitor();
+    CHECK(monitor->Refresh());
+
+    ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+    const auto& rows = snapshot->Connections.Rows;
+    CHECK_EQ(rows.size(), snapshot->LocalPortIndex.size());
+
+    uint32_t indices[8] = {};
+    CHECK_EQ(size_t{ 2 }, ConnectionIndex::FindByLocalPort(*snapshot, 5432, indices, 8));
+    CHECK(indices[0] < indices[1]);
+    for (int i = 0; i < 2; ++i)
+    {
+        CHECK_EQ(uint16_t{ 5432 }, rows[indices[i]].LocalPort);
+        CHECK_EQ(200u, rows[indices[i]].ProcessId);
+    }
+
+    // 容量不足时仍返回总数
+    CHECK_EQ(size_t{ 2 }, ConnectionIndex::FindByLocalPort(*snapshot, 22, indices, 1));
+    CHECK_EQ(100u, rows[indices[0]].ProcessId);
+    CHECK_EQ(size_t{ 0 }, ConnectionIndex::FindByLocalPort(*snapshot, 1, indices, 8));
+
+    CHECK(ConnectionIndex::FindProcess(*snapshot, 500) != nullptr);
+    CHECK(ConnectionIndex::FindProcess(*snapshot, 501) == nullptr);
+}
+
+IRONSIGHT_TEST(Network, ReplayFindsPortOwner)
+{
+    auto monitor = CreateReplayMonitor();
+    CHECK(monitor->Refresh());
+
+    uint32_t owner = 0;
+    CHECK(monitor->FindPortOwner(5432, ProtocolType::Tcp, &owner));
+    CHECK_EQ(200u, owner);
+    CHECK(monitor->FindPortOwner(22, ProtocolType::Tcp, &owner));
+    CHECK_EQ(100u, owner);
+    CHECK(monitor->FindPortOwner(53, ProtocolType::Udp, &owner));
+    CHECK_EQ(600u, owner);
+    CHECK(!monitor->FindPortOwner(53, ProtocolType::Tcp, &owner));
+
+    // 没有监听行时退而取使用该端口的连接
+    CHECK(monitor->FindPortOwner(40000, ProtocolType::Tcp, &owner));
+    CHECK_EQ(300u, owner);
+}
+
+// ports 数据：PID 50 持有本地端口 8080 上的已建立连接，排在监听 8080 的 PID 70 之前；
+// PID 60 绑定 UDP 8080；PID 80 只有一条本地端口 9000 的连接
+IRONSIGHT_TEST(Network, PortOwnerPrefersListeningTcpRow)
+{
+    NetworkMonitor monitor(std::make_unique<FixtureConnectionSource>("Network/ports"));
+    CHECK(monitor.Refresh());
+
+    uint32_t owner = 0;
+    CHECK(monitor.FindPortOwner(8080, ProtocolType::Tcp, &owner));
+    CHECK_EQ(70u, owner);
+    CHECK(monitor.FindPortOwner(8080, ProtocolType::Udp, &owner));
+    CHECK_EQ(60u, owner);
+    CHECK(monitor.FindPortOwner(9000, ProtocolType::Tcp, &owner));
+    CHECK_EQ(80u, owner);
+    CHECK(!monitor.FindPortOwner(9001, ProtocolType::Tcp, &owner));
+
+    // 端口索引中 8080 的三行按行序排列，已建立的连接在监听行之前
+    ConnectionSnapshotView snapshot = monitor.AcquireSnapshot();
+    uint32_t indices[4] = {};
+    CHECK_EQ(size_t{ 3 }, ConnectionIndex::FindByLocalPort(*snapshot, 8080, indices, 4));
+    CHECK_EQ(50u, snapshot->Connections.Rows[indices[0]].ProcessId);
+}
+
+// 延续的连接继承首次观察时间；消失的连接按序号退役到历史，新连接与关闭按进程计入变动
+IRONSIGHT_TEST(Network, ReplayTracksConnectionLifetimes)
+{
+    auto monitor = CreateReplayMonitor();
+
+    CHECK(monitor->Refresh());
+    uint64_t firstTimestamp = 0;
+    {
+        ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+        firstTimestamp = snapshot->Timestamp;
+        CHECK_EQ(snapshot->Connections.Rows.size(), snapshot->FirstSeen.size());
+        for (uint64_t firstSeen : snapshot->FirstSeen) CHECK_EQ(firstTimestamp, firstSeen);
+
+        // 首次刷新没有可比较的上一代，不计为打开
+        CHECK_EQ(size_t{ 0 }, snapshot->Churn.size());
+    }
+
+    // 时间戳为毫秒，隔开两代
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    CHECK(monitor->Refresh());
+
+    ConnectionSnapshotView snapshot = monitor->AcquireSnapshot();
+    CHECK(snapshot->Timestamp > firstTimestamp);
+
+    size_t carried = 0;
+    for (size_t i = 0; i < snapshot->Connections.Rows.size(); ++i)
+    {
+        const uint32_t pid = snapshot->Connections.Rows[i].ProcessId;
+        const bool isNew = pid == 102 || pid == 602;
+        CHECK_EQ(isNew ? snapshot->Timestamp : firstTimestamp, snapshot->FirstSeen[i]);
+        if (!isNew) ++carried;
+    }
+    CHECK_EQ(size_t{ 7 }, carried);
+
+    // 变动按 PID 升序：新 SSH 会话与 DHCP 端点打开，两条数据库连接与 NTP 端点关闭
+    const ProcessConnectionChurn expected[] = { { 102, 1, 0 }, { 200, 0, 1 }, { 300, 0, 1 }, { 601, 0, 1 }, { 602, 1, 0 } };
+    CHECK_EQ(size_t{ 5 }, snapshot->Churn.size());
+    for (size_t i = 0; i < 5 && i < snapshot->Churn.size(); ++i)
+    {
+        CHECK_EQ(expected[i].ProcessId, snapshot->Churn[i].ProcessId);
+        CHECK_EQ(expected[i].Opened, snapshot->Churn[i].Opened);
+        CHECK_EQ(expected[i].Closed, snapshot->Churn[i].Closed);
+    }
+
+    ClosedConnectionRecord closed[8];
+    CHECK_EQ(size_t{ 3 }, monitor->CopyClosedConnectionsTo(closed, 8, 0));
+    for (uint64_t i = 0; i < 3; ++i)
+    {
+        CHECK_EQ(i + 1, closed[i].Sequence);
+        CHECK_EQ(firstTimestamp, closed[i].FirstSeen);
+        CHECK_EQ(firstTimestamp, closed[i].LastSeen);
+    }
+
+    // NTP 端点 127.0.0.1:323 (PID 601)，地址内联在记录中
+    CHECK_EQ(601u, closed[2].ProcessId);
+    CHECK_EQ(static_cast<uint8_t>(ProtocolType::Udp), closed[2].Protocol);
+    CHECK_EQ(uint16_t{ 323 }, closed[2].LocalPort);
+    CHECK_EQ(uint8_t{ 127 }, closed[2].LocalAddress.Bytes[0]);
+    CHECK_EQ(uint8_t{ 1 }, closed[2].LocalAddress.Bytes[3]);
+
+    CHECK_EQ(size_t{ 0 }, monitor->CopyClosedConnectionsTo(closed, 8, 3));
+}
+
+// 历史为固定容量的环：写满后覆盖最早的记录，落后的读者从仍保留的最早序号开始
+IRONSIGHT_TEST(Network, LifetimeHistoryRetiresOldestWhenFull)
+{
+    constexpr uint32_t ConnectionCount = 3000;
+    ConnectionLifetimeTracker tracker;
+
+    auto fill = [](ConnectionSnapshot& snapshot)
+    {
+        for (uint32_t i = 0; i < ConnectionCount; ++i)
+        {
+            NetworkConnectionRow row{};
+            row.ProcessId = 1000 + i / 10;
+            row.LocalAddress = 0x0100007F;
+            row.LocalPort = static_cast<uint16_t>(20000 + i);
+            row.RemoteAddress = 0x0100007F;
+            row.RemotePort = 443;
+            row.State = static_cast<uint8_t>(ConnectionState::Established);
+            row.Protocol = static_cast<uint8_t>(ProtocolType::Tcp);
+            snapshot.Connections.AppendIpv4(row);
+        }
+        ConnectionDiff::SortByKey(snapshot.Connections);
+    };
+
+    // 打开 3000 条连接后全部关闭，重复两轮：共退役 6000 条，环中只保留最近的 4096 条
+    ConnectionSnapshot generations[5];
+    fill(generations[1]);
+    fill(generations[3]);
+    for (int i = 1; i < 5; ++i) tracker.Update(generations[i - 1], generations[i], true, true);
+
+    constexpr uint64_t Retired = 2ull * ConnectionCount;
+    constexpr uint64_t Capacity = ConnectionLifetimeTracker::DefaultHistoryCapacity;
+
+    std::vector<ClosedConnectionRecord> records(Retired);
+    CHECK_EQ(static_cast<size_t>(Capacity), tracker.CopyClosedTo(records.data(), records.size(), 0));
+    for (uint64_t i = 0; i < Capacity; ++i)
+    {
+        CHECK_EQ(Retired - Capacity + 1 + i, records[i].Sequence);
+    }
+
+    // 最后退役的是第二轮排序后的最后一行
+    const NetworkConnectionRow& last = generations[3].Connections.Rows.back();
+    CHECK_EQ(last.LocalPort, records[Capacity - 1].LocalPort);
+    CHECK_EQ(generations[3].Timestamp, records[Capacity - 1].LastSeen);
+
+    // 未落后的读者从上次的序号继续
+    CHECK_EQ(size_t{ 500 }, tracker.CopyClosedTo(records.data(), records.size(), Retired - 500));
+    CHECK_EQ(Retired - 499, records[0].Sequence);
+}
@@ -0,0 +1,172 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "System/ProcessChangeTracker.h"
+#include <algorithm>
+#include <map>
+
+using namespace IronSight::Core::Native::System;
+
+namespace
+{
+    // 返回预设进程集合的数据源，测试在两次采集之间直接修改 Processes
+    class FakeProcessBackend final : public IProcessBackend
+    {
+        public:
+        std::vector<ProcessSample> Processes;
+
+        bool Enumerate(std::vector<ProcessSample>& samples, size_t maxCount) override
+        {
+            samples.assign(Processes.begin(), Processes.begin() + static_cast<ptrdiff_t>((std::min)(maxCount, Processes.size())));
+            return true;
+        }
+
+        void Query(ProcessSample& sample) override { sample.HasCounters = true; }
+
+        // 系统时间稳定前进而进程时间不变，CPU 占用始终为 0
+        uint64_t QuerySystemTime() override { return _systemTime += 1000; }
+
+        private:
+        uint64_t _systemTime = 0;
+    };
+
+    ProcessSample MakeProcess(uint32_t pid, uint64_t createTime, uint32_t nameId, uint32_t threads = 1)
+    {
+        ProcessSample sample;
+        sample.Pid = pid;
+        sample.CreateTime = createTime;
+        sample.NameId = nameId;
+        sample.ThreadCount = threads;
+        sample.PriorityClass = 32;
+        return sample;
+    }
+
+    // 按 ProcessChangeSetInfo 约定的顺序应用变更集的消费方模型
+    struct ConsumerModel
+    {
+        std::map<uint32_t, ProcessStaticRecord> Statics;
+        std::map<uint32_t, ProcessUpdateRecord> Updates;
+
+        void Apply(const ProcessChangeTracker& tracker)
+        {
+            const ProcessChangeSetInfo& info = tracker.Info();
+            std::vector<ProcessStaticRecord> added(info.AddedCount);
+            std::vector<ProcessUpdateRecord> updated(info.UpdatedCount);
+            std::vector<uint32_t> exited(info.ExitedCount);
+            CHECK(tracker.CopyTo(added.data(), added.size(), updated.data(), updated.size(), exited.data(), exited.size()));
+
+            if (info.IsReset)
+            {
+                Statics.clear();
+                Updates.clear();
+            }
+            for (uint32_t pid : exited)
+            {
+                Statics.erase(pid);
+                Updates.erase(pid);
+            }
+            for (const auto& record : added) Statics[record.Pid] = record;
+            for (const auto& record : updated) Updates[record.Pid] = record;
+        }
+    };
+
+    struct TrackerFixture
+    {
+        FakeProcessBackend* Backend;
+        ProcessCollector Collector;
+        ProcessChangeTracker Tracker;
+
+        TrackerFixture()
+            : Backend(new FakeProcessBackend()),
+            Collector(std::unique_ptr<IProcessBackend>(Backend), 1)
+        {
+        }
+
+        uint64_t Update(uint64_t baseVersion) { return Tracker.Update(Collector, 64, baseVersion); }
+    };
+}
+
+// baseVersion 不是上一次生成的版本时 (消费方丢弃过变更集) 重新发送全部进程
+IRONSIGHT_TEST(System, ChangeTrackerResetsOnStaleBaseVersion)
+{
+    TrackerFixture fixture;
+    fixture.Backend->Processes = { MakeProcess(1, 10, 1), MakeProcess(2, 20, 2) };
+
+    const uint64_t first = fixture.Update(0);
+    CHECK_EQ(uint8_t{ 1 }, fixture.Tracker.Info().IsReset);
+    CHECK_EQ(uint32_t{ 2 }, fixture.Tracker.Info().AddedCount);
+
+    const uint64_t second = fixture.Update(first);
+    CHECK_EQ(uint8_t{ 0 }, fixture.Tracker.Info().IsReset);
+    CHECK_EQ(first, fixture.Tracker.Info().BaseVersion);
+    CHECK_EQ(uint32_t{ 0 }, fixture.Tracker.Info().AddedCount);
+    CHECK_EQ(uint32_t{ 0 }, fixture.Tracker.Info().UpdatedCount);
+
+    // 再次基于 first 请求：first 已不是最新版本，生成重置变更集，且不逐个报告退出
+    fixture.Backend->Processes.pop_back();
+    const uint64_t third = fixture.Update(first);
+    const ProcessChangeSetInfo& info = fixture.Tracker.Info();
+    CHECK(third > second);
+    CHECK_EQ(uint8_t{ 1 }, info.IsReset);
+    CHECK_EQ(uint64_t{ 0 }, info.BaseVersion);
+    CHECK_EQ(uint32_t{ 1 }, info.ProcessCount);
+    CHECK_EQ(uint32_t{ 1 }, info.AddedCount);
+    CHECK_EQ(uint32_t{ 1 }, info.UpdatedCount);
+    CHECK_EQ(uint32_t{ 0 }, info.ExitedCount);
+}
+
+// PID 被新进程复用：同一 PID 同时出现在退出与新增中，按先退出后新增的顺序应用后只剩新进程
+IRONSIGHT_TEST(System, ChangeTrackerReportsPidReuseAsExitThenAdd)
+{
+    TrackerFixture fixture;
+    fixture.Backend->Processes = { MakeProcess(7, 100, 1), MakeProcess(42, 500, 2) };
+
+    ConsumerModel model;
+    uint64_t version = fixture.Update(0);
+    model.Apply(fixture.Tracker);
+
+    fixture.Backend->Processes[1] = MakeProcess(42, 900, 3);
+    version = fixture.Update(version);
+    model.Apply(fixture.Tracker);
+
+    const ProcessChangeSetInfo& info = fixture.Tracker.Info();
+    CHECK_EQ(uint8_t{ 0 }, info.IsReset);
+    CHECK_EQ(uint32_t{ 1 }, info.ExitedCount);
+    CHECK_EQ(uint32_t{ 1 }, info.AddedCount);
+    CHECK_EQ(uint32_t{ 1 }, info.UpdatedCount);
+
+    CHECK_EQ(size_t{ 2 }, model.Statics.size());
+    CHECK_EQ(uint64_t{ 900 }, model.Statics[42].CreateTime);
+    CHECK_EQ(uint32_t{ 3 }, model.Statics[42].NameId);
+    CHECK_EQ(uint64_t{ 100 }, model.Statics[7].CreateTime);
+    CHECK(model.Updates.count(42) == 1);
+}
+
+// 只有动态字段变化的进程出现在更新中；名称或优先级变化作为静态记录重新发送
+IRONSIGHT_TEST(System, ChangeTrackerSendsOnlyChangedProcesses)
+{
+    TrackerFixture fixture;
+    fixture.Backend->Processes = { MakeProcess(1, 10, 1), MakeProcess(2, 20, 2), MakeProcess(3, 30, 3) };
+
+    ConsumerModel model;
+    uint64_t version = fixture.Update(0);
+    model.Apply(fixture.Tracker);
+
+    fixture.Backend->Processes[1].ThreadCount = 8;
+    fixture.Backend->Processes[2].PriorityClass = 128;
+    version = fixture.Update(version);
+    model.Apply(fixture.Tracker);
+
+    const ProcessChangeSetInfo& info = fixture.Tracker.Info();
+    CHECK_EQ(uint32_t{ 3 }, info.ProcessCount);
+    CHECK_EQ(uint32_t{ 1 }, info.UpdatedCount);
+    CHECK_EQ(uint32_t{ 1 }, info.AddedCount);
+    CHECK_EQ(uint32_t{ 0 }, info.ExitedCount);
+    CHECK_EQ(uint32_t{ 8 }, model.Updates[2].ThreadCount);
+    CHECK_EQ(128, model.Statics[3].PriorityClass);
+
+    // 进程集合与字段都不变：变更集为空
+    fixture.Update(version);
+    CHECK_EQ(uint32_t{ 0 }, fixture.Tracker.Info().AddedCount);
+    CHECK_EQ(uint32_t{ 0 }, fixture.Tracker.Info().UpdatedCount);
+    CHECK_EQ(uint32_t{ 0 }, fixture.Tracker.Info().ExitedCount);
+}
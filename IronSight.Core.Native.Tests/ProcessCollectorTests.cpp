@@ -0,0 +1,158 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "System/ProcessCollector.h"
+#include "System/ProcFsProcessBackend.h"
+#include "Text/StringPool.h"
+
+#if defined(__linux__)
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <unistd.h>
+
+using namespace IronSight::Core::Native::System;
+using IronSight::Core::Native::Text::StringPool;
+
+namespace
+{
+    const std::string FixtureProcRoot = std::string(IRONSIGHT_FIXTURE_DIR) + "/Proc";
+
+    uint64_t TicksTo100ns()
+    {
+        return 10000000ull / static_cast<uint64_t>(sysconf(_SC_CLK_TCK));
+    }
+
+    uint64_t PageSize()
+    {
+        return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    // 临时的 proc 目录：进程 i 的线程数为 i、驻留页为 10 * i，用于校验并行查询写入的槽位
+    class GeneratedProcRoot
+    {
+        public:
+        explicit GeneratedProcRoot(uint32_t processCount)
+            : _path(std::filesystem::temp_directory_path() / ("ironsight-collector-" + std::to_string(getpid())))
+        {
+            std::filesystem::remove_all(_path);
+            for (uint32_t pid = 1; pid <= processCount; ++pid)
+            {
+                const auto directory = _path / std::to_string(1000 + pid);
+                std::filesystem::create_directories(directory);
+                std::ofstream(directory / "stat") << (1000 + pid) << " (worker " << pid
+                    << ") S 1 1 1 0 -1 0 0 0 0 0 0 0 0 0 20 0 " << pid << " 0 " << pid << " 0 0\n";
+                std::ofstream(directory / "statm") << 100 * pid << ' ' << 10 * pid << " 0 0 0 0 0\n";
+            }
+            std::ofstream(_path / "stat") << "cpu  100 0 100 800 0 0 0 0 0 0\n";
+        }
+
+        ~GeneratedProcRoot() { std::filesystem::remove_all(_path); }
+
+        std::string Path() const { return _path.string(); }
+
+        private:
+        std::filesystem::path _path;
+    };
+}
+
+// 工作线程各自写入枚举下标对应的槽位，缓冲区的每一行都必须属于同一下标的采样
+IRONSIGHT_TEST(System, CollectorKeepsEnumerationOrderAcrossWorkers)
+{
+    constexpr uint32_t ProcessCount = 100;
+    GeneratedProcRoot root(ProcessCount);
+    ProcessHandleCache handles(ProcessHandleCache::DefaultCapacity, root.Path().c_str());
+    ProcessCollector collector(std::make_unique<ProcFsProcessBackend>(handles, root.Path().c_str()), 4);
+
+    std::vector<ProcessDetailInfo> buffer(128);
+    CHECK_EQ(static_cast<int>(ProcessCount), collector.Collect(buffer.data(), static_cast<int>(buffer.size())));
+
+    const auto& samples = collector.Samples();
+    CHECK_EQ(size_t{ ProcessCount }, samples.size());
+
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const uint32_t index = samples[i].Pid - 1000;
+        CHECK_EQ(samples[i].Pid, buffer[i].Pid);
+        CHECK_EQ(index, buffer[i].ThreadCount);
+        CHECK_EQ(10 * index * PageSize(), samples[i].WorkingSetBytes);
+        CHECK(StringPool::Shared().Get(buffer[i].NameId) == "worker " + std::to_string(index));
+    }
+}
+
+IRONSIGHT_TEST(System, CollectorParsesProcFixture)
+{
+    ProcessHandleCache handles(ProcessHandleCache::DefaultCapacity, FixtureProcRoot.c_str());
+    ProcessCollector collector(std::make_unique<ProcFsProcessBackend>(handles, FixtureProcRoot.c_str()), 2);
+
+    ProcessDetailInfo buffer[8]{};
+    CHECK_EQ(3, collector.Collect(buffer, 8));
+
+    std::map<uint32_t, size_t> slots;
+    for (size_t i = 0; i < collector.Samples().size(); ++i)
+    {
+        CHECK_EQ(collector.Samples()[i].Pid, buffer[i].Pid);
+        slots[buffer[i].Pid] = i;
+    }
+    CHECK_EQ(size_t{ 3 }, slots.size());
+    if (slots.size() != 3) return;
+
+    const uint64_t ticks = TicksTo100ns();
+    const uint64_t page = PageSize();
+
+    // 普通进程：stat 的 utime/stime/num_threads/starttime，statm 驻留页 2500、共享页 1000，io 的读写字节数
+    {
+        const size_t slot = slots[101];
+        const ProcessSample& sample = collector.Samples()[slot];
+        CHECK(sample.HasCounters);
+        CHECK(StringPool::Shared().Get(buffer[slot].NameId) == "systemd");
+        CHECK_EQ(250 * ticks, sample.UserTime);
+        CHECK_EQ(130 * ticks, sample.KernelTime);
+        CHECK_EQ(15 * ticks, sample.CreateTime);
+        CHECK_EQ(uint32_t{ 1 }, buffer[slot].ThreadCount);
+        CHECK_EQ(2500 * page, sample.WorkingSetBytes);
+        CHECK_EQ(1500 * page, sample.PrivateBytes);
+        CHECK_EQ(1500 * page / (1024.0 * 1024.0), buffer[slot].MemoryMB);
+        CHECK_EQ(uint64_t{ 65536 }, sample.ReadBytes);
+        CHECK_EQ(uint64_t{ 8192 }, sample.WriteBytes);
+    }
+
+    // 进程名含空格；io 中的 cancelled_write_bytes 不能被当作 write_bytes
+    {
+        const size_t slot = slots[2048];
+        const ProcessSample& sample = collector.Samples()[slot];
+        CHECK(StringPool::Shared().Get(buffer[slot].NameId) == "tmux: server");
+        CHECK_EQ(1200 * ticks, sample.UserTime);
+        CHECK_EQ(340 * ticks, sample.KernelTime);
+        CHECK_EQ(98765 * ticks, sample.CreateTime);
+        CHECK_EQ(uint32_t{ 3 }, buffer[slot].ThreadCount);
+        CHECK_EQ(3000 * page, sample.WorkingSetBytes);
+        CHECK_EQ(2500 * page, sample.PrivateBytes);
+        CHECK_EQ(uint64_t{ 1048576 }, sample.WriteBytes);
+    }
+
+    // 进程名含 ')'：从最后一个 ')' 之后解析；驻留页全部共享时私有内存为 0；没有 io 文件时读写字节数为 0
+    {
+        const size_t slot = slots[4100];
+        const ProcessSample& sample = collector.Samples()[slot];
+        CHECK(sample.HasCounters);
+        CHECK(StringPool::Shared().Get(buffer[slot].NameId) == "weird) name");
+        CHECK_EQ(7 * ticks, sample.UserTime);
+        CHECK_EQ(3 * ticks, sample.KernelTime);
+        CHECK_EQ(123456 * ticks, sample.CreateTime);
+        CHECK_EQ(uint32_t{ 12 }, buffer[slot].ThreadCount);
+        CHECK_EQ(256 * page, sample.WorkingSetBytes);
+        CHECK_EQ(uint64_t{ 0 }, sample.PrivateBytes);
+        CHECK_EQ(uint64_t{ 0 }, sample.ReadBytes);
+        CHECK_EQ(uint64_t{ 0 }, sample.WriteBytes);
+    }
+
+    // 录制数据不变：第二次采集的 CPU 与磁盘速率均为 0
+    CHECK_EQ(3, collector.Collect(buffer, 8));
+    for (int i = 0; i < 3; ++i)
+    {
+        CHECK_EQ(0.0, buffer[i].CpuUsage);
+        CHECK_EQ(0.0, buffer[i].DiskReadRateMS);
+        CHECK_EQ(0.0, buffer[i].DiskWriteRateMS);
+    }
+}
+#endif
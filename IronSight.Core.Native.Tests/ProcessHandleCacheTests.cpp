@@ -0,0 +1,82 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "System/ProcessHandleCache.h"
+
+#if defined(__linux__)
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+using namespace IronSight::Core::Native::System;
+
+namespace
+{
+    // 临时的 proc 目录，每个 PID 只含打开句柄所需的 stat 文件
+    class TemporaryProcRoot
+    {
+        public:
+        explicit TemporaryProcRoot(uint32_t processCount)
+            : _path(std::filesystem::temp_directory_path() / ("ironsight-proc-" + std::to_string(getpid())))
+        {
+            std::filesystem::remove_all(_path);
+            for (uint32_t pid = 1; pid <= processCount; ++pid)
+            {
+                std::filesystem::create_directories(_path / std::to_string(pid));
+                std::ofstream(_path / std::to_string(pid) / "stat") << pid << " (test) S 0\n";
+            }
+        }
+
+        ~TemporaryProcRoot() { std::filesystem::remove_all(_path); }
+
+        std::string Path() const { return _path.string(); }
+
+        private:
+        std::filesystem::path _path;
+    };
+}
+
+IRONSIGHT_TEST(System, HandleCacheSweepClosesProcessesNotSeenThisRound)
+{
+    TemporaryProcRoot root(4);
+    ProcessHandleCache cache(8, root.Path().c_str());
+
+    cache.BeginSweep();
+    for (uint32_t pid = 1; pid <= 4; ++pid) CHECK(cache.Acquire(pid) != nullptr);
+    cache.Sweep();
+    CHECK_EQ(size_t{ 4 }, cache.Size());
+
+    cache.BeginSweep();
+    ProcessHandle* second = cache.Acquire(2);
+    cache.Acquire(4);
+    cache.Sweep();
+
+    CHECK_EQ(size_t{ 2 }, cache.Size());
+    CHECK(cache.Acquire(2) == second);
+}
+
+IRONSIGHT_TEST(System, HandleCacheEvictsLeastRecentlyUsedOverCapacity)
+{
+    TemporaryProcRoot root(4);
+    ProcessHandleCache cache(2, root.Path().c_str());
+
+    cache.BeginSweep();
+    cache.Acquire(1);
+    cache.Acquire(2);
+    cache.Sweep();
+
+    // 新一轮中 1 被再次使用，插入 3 时淘汰上一轮之后未使用的 2
+    cache.BeginSweep();
+    ProcessHandle* first = cache.Acquire(1);
+    cache.Acquire(3);
+    CHECK_EQ(size_t{ 2 }, cache.Size());
+
+    // 本轮已发出的句柄不淘汰，暂时超出容量；再次使用 1 后由 Sweep 裁剪掉最久未使用的 3
+    cache.Acquire(4);
+    CHECK_EQ(size_t{ 3 }, cache.Size());
+    CHECK(cache.Acquire(1) == first);
+
+    cache.Sweep();
+    CHECK_EQ(size_t{ 2 }, cache.Size());
+    CHECK(cache.Acquire(1) == first);
+}
+#endif
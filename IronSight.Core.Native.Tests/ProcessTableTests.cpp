@@ -0,0 +1,88 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "System/ProcessTable.h"
+
+using namespace IronSight::Core::Native::System;
+
+// 进程退出后 PID 被新进程复用：新进程从空历史开始，旧进程的历史在 Sweep 时丢弃
+IRONSIGHT_TEST(System, ProcessTableDoesNotReuseHistoryAcrossPidReuse)
+{
+    ProcessTable<uint64_t> table;
+    bool inserted = false;
+
+    table.BeginSweep();
+    table.Touch(42, 1000, inserted) = 7;
+    CHECK(inserted);
+    table.Sweep();
+
+    table.BeginSweep();
+    uint64_t& reused = table.Touch(42, 2000, inserted);
+    CHECK(inserted);
+    CHECK_EQ(uint64_t{ 0 }, reused);
+    reused = 9;
+
+    uint32_t removedPid = 0;
+    uint64_t removedValue = 0;
+    table.Sweep([&](uint32_t pid, uint64_t, uint64_t& value)
+        {
+            removedPid = pid;
+            removedValue = value;
+        });
+
+    CHECK_EQ(uint32_t{ 42 }, removedPid);
+    CHECK_EQ(uint64_t{ 7 }, removedValue);
+    CHECK_EQ(size_t{ 1 }, table.Size());
+    CHECK(table.Find(42, 1000) == nullptr);
+
+    const uint64_t* current = table.Find(42, 2000);
+    CHECK(current != nullptr);
+    if (current) CHECK_EQ(uint64_t{ 9 }, *current);
+}
+
+// 就地删除后，探测序列上被前移的项仍然可以找到
+IRONSIGHT_TEST(System, ProcessTableSweepKeepsSurvivorsReachable)
+{
+    ProcessTable<uint64_t> table(64);
+    bool inserted = false;
+
+    table.BeginSweep();
+    for (uint32_t pid = 1; pid <= 2000; ++pid) table.Touch(pid, pid * 10ull, inserted) = pid;
+    table.Sweep();
+    CHECK_EQ(size_t{ 2000 }, table.Size());
+
+    // 进程数回落：只有 3 的倍数存活
+    table.BeginSweep();
+    for (uint32_t pid = 3; pid <= 2000; pid += 3)
+    {
+        table.Touch(pid, pid * 10ull, inserted);
+        CHECK(!inserted);
+    }
+
+    size_t removed = 0;
+    table.Sweep([&](uint32_t pid, uint64_t, uint64_t&) { CHECK(pid % 3 != 0); ++removed; });
+
+    CHECK_EQ(size_t{ 1334 }, removed);
+    CHECK_EQ(size_t{ 666 }, table.Size());
+
+    for (uint32_t pid = 1; pid <= 2000; ++pid)
+    {
+        const uint64_t* value = table.Find(pid, pid * 10ull);
+        if (pid % 3 == 0)
+        {
+            CHECK(value != nullptr);
+            if (value) CHECK_EQ(uint64_t{ pid }, *value);
+        }
+        else
+        {
+            CHECK(value == nullptr);
+        }
+    }
+
+    // 删除不留墓碑：此后的插入与存活检测照常工作
+    table.BeginSweep();
+    for (uint32_t pid = 3; pid <= 2000; pid += 3) table.Touch(pid, pid * 10ull, inserted);
+    table.Touch(5000, 1, inserted);
+    CHECK(inserted);
+    table.Sweep();
+    CHECK_EQ(size_t{ 667 }, table.Size());
+}
@@ -0,0 +1,297 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "Recorder/FlightRecorder.h"
+#include "Recorder/FlightRecordReader.h"
+#include "Text/StringPool.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+using namespace IronSight::Core::Native;
+using namespace IronSight::Core::Native::Recorder;
+
+namespace
+{
+    System::SystemPerformanceSnapshot MakeSnapshot(int tick)
+    {
+        System::SystemPerformanceSnapshot snapshot{};
+        snapshot.CpuUsage = 12.5 + tick;
+        snapshot.CpuTemperature = 0.0;
+        snapshot.MemoryUsagePercent = 40.0 + tick * 0.25;
+        snapshot.TotalPhysicalMemoryMB = 16384.0;
+        snapshot.AvailablePhysicalMemoryMB = 9000.0 - tick;
+        snapshot.ProcessCount = 300 + tick;
+        snapshot.ThreadCount = 4000;
+        snapshot.HandleCount = 90000 - tick;
+        snapshot.CommittedBytesMB = 12000.5;
+        return snapshot;
+    }
+
+    std::vector<System::ProcessDetailInfo> MakeProcesses(uint32_t count, int tick)
+    {
+        std::vector<System::ProcessDetailInfo> rows(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            System::ProcessDetailInfo& row = rows[i];
+            row.Pid = (count - i) * 4;      // 逆序：编码器内部按 PID 排序
+            row.MemoryMB = 10.0 + i + (i % 3 == 0 ? tick : 0);
+            row.CpuUsage = (i + tick) % 7 == 0 ? 1.5 * tick : 0.0;
+            row.DiskReadRateMS = 0.0;
+            row.DiskWriteRateMS = i == 0 ? 0.125 * tick : 0.0;
+            row.ThreadCount = 4 + i % 5;
+            row.HandleCount = 100 + i;
+            row.PriorityClass = 32;
+            row.NameId = 0;
+        }
+        return rows;
+    }
+
+    void FillConnections(Network::ConnectionTable& table, uint32_t count, int tick)
+    {
+        table.Clear();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Network::NetworkConnectionRow row{};
+            row.LocalPort = static_cast<uint16_t>(1000 + i);
+            row.RemotePort = 443;
+            row.ProcessId = 100 + i % 10;
+            row.State = static_cast<uint8_t>(i == 3 ? 2 + tick % 2 : 5);
+            row.Protocol = 0;
+
+            if (i % 4 == 0)
+            {
+                Network::Ipv6Address local{};
+                Network::Ipv6Address remote{};
+                local.Bytes[0] = 0x20;
+                local.Bytes[15] = 1;
+                remote.Bytes[0] = 0x20;
+                remote.Bytes[15] = static_cast<uint8_t>(i);
+                table.AppendIpv6(row, local, remote);
+            }
+            else
+            {
+                row.LocalAddress = 0x0100007F;
+                row.RemoteAddress = 0x08080808 + i;
+                table.AppendIpv4(row);
+            }
+        }
+    }
+
+    bool SameRows(const Network::NetworkConnectionRow& a, const Network::NetworkConnectionRow& b)
+    {
+        return a.LocalAddress == b.LocalAddress && a.RemoteAddress == b.RemoteAddress &&
+            a.LocalPort == b.LocalPort && a.RemotePort == b.RemotePort && a.ProcessId == b.ProcessId &&
+            a.State == b.State && a.Protocol == b.Protocol && a.Family == b.Family;
+    }
+
+    bool SameProcesses(const std::vector<System::ProcessDetailInfo>& sorted, std::vector<System::ProcessDetailInfo> expected)
+    {
+        std::sort(expected.begin(), expected.end(),
+            [](const auto& a, const auto& b) { return a.Pid < b.Pid; });
+        if (sorted.size() != expected.size()) return false;
+
+        for (size_t i = 0; i < sorted.size(); ++i)
+        {
+            const System::ProcessDetailInfo& a = sorted[i];
+            const System::ProcessDetailInfo& b = expected[i];
+            if (a.Pid != b.Pid || a.MemoryMB != b.MemoryMB || a.CpuUsage != b.CpuUsage ||
+                a.DiskReadRateMS != b.DiskReadRateMS || a.DiskWriteRateMS != b.DiskWriteRateMS ||
+                a.ThreadCount != b.ThreadCount || a.HandleCount != b.HandleCount ||
+                a.PriorityClass != b.PriorityClass || a.NameId != b.NameId)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 编码一帧后立即用同一顺序解码，返回解码是否成功且未越界
+    template <typename Encode, typename Decode>
+    bool RoundTrip(BitWriter& writer, Encode&& encode, Decode&& decode)
+    {
+        writer.Clear();
+        encode(writer);
+        const std::vector<uint8_t>& bytes = writer.Finish();
+
+        BitReader reader(bytes.data(), bytes.size());
+        return decode(reader) && !reader.Overrun();
+    }
+
+    // 每个测试独占的录制目录
+    class TemporaryDirectory
+    {
+        public:
+        explicit TemporaryDirectory(const char* name)
+            : _path(std::filesystem::temp_directory_path() / name)
+        {
+            std::filesystem::remove_all(_path);
+        }
+
+        ~TemporaryDirectory()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(_path, error);
+        }
+
+        const std::filesystem::path& Path() const noexcept { return _path; }
+
+        private:
+        std::filesystem::path _path;
+    };
+}
+
+IRONSIGHT_TEST(Recorder, SystemFramesRoundTrip)
+{
+    FrameEncoder encoder;
+    FrameDecoder decoder;
+    BitWriter writer;
+
+    for (int tick = 0; tick < 10; ++tick)
+    {
+        const bool keyframe = tick % 4 == 0;
+        const System::SystemPerformanceSnapshot snapshot = MakeSnapshot(tick);
+
+        CHECK(RoundTrip(writer,
+            [&](BitWriter& w) { encoder.EncodeSystem(snapshot, keyframe, w); },
+            [&](BitReader& r) { return decoder.DecodeSystem(r, keyframe); }));
+        CHECK(std::memcmp(&decoder.System(), &snapshot, sizeof(snapshot)) == 0);
+    }
+}
+
+IRONSIGHT_TEST(Recorder, ProcessFramesRoundTripAcrossExitsAndStarts)
+{
+    FrameEncoder encoder;
+    FrameDecoder decoder;
+    BitWriter writer;
+
+    for (int tick = 0; tick < 6; ++tick)
+    {
+        // 进程数在帧之间变化：尾部 PID 退出、新 PID 出现
+        std::vector<System::ProcessDetailInfo> rows = MakeProcesses(200 - tick * 10, tick);
+        System::ProcessDetailInfo started = rows[0];
+        started.Pid = 100000 + tick;
+        rows.push_back(started);
+
+        const bool keyframe = tick == 0;
+        CHECK(RoundTrip(writer,
+            [&](BitWriter& w) { encoder.EncodeProcesses(rows.data(), rows.size(), keyframe, w); },
+            [&](BitReader& r) { return decoder.DecodeProcesses(r, keyframe); }));
+        CHECK(SameProcesses(decoder.Processes(), rows));
+    }
+}
+
+IRONSIGHT_TEST(Recorder, ConnectionFramesRoundTrip)
+{
+    FrameEncoder encoder;
+    FrameDecoder decoder;
+    BitWriter writer;
+    Network::ConnectionTable table;
+
+    for (int tick = 0; tick < 4; ++tick)
+    {
+        FillConnections(table, 64 + tick, tick);
+
+        const bool keyframe = tick == 0;
+        CHECK(RoundTrip(writer,
+            [&](BitWriter& w) { encoder.EncodeConnections(table, keyframe, w); },
+            [&](BitReader& r) { return decoder.DecodeConnections(r, keyframe); }));
+
+        const Network::ConnectionTable& decoded = decoder.Connections();
+        CHECK_EQ(table.Rows.size(), decoded.Rows.size());
+        if (decoded.Rows.size() != table.Rows.size()) continue;
+
+        for (size_t i = 0; i < table.Rows.size(); ++i)
+        {
+            const Network::NetworkConnectionRow& row = decoded.Rows[i];
+            if (row.Family == Network::AddressFamily::Ipv6)
+            {
+                // IPv6 行引用各自的地址表，比较地址本身
+                CHECK(std::memcmp(&decoded.Addresses[row.RemoteAddress], &table.Addresses[table.Rows[i].RemoteAddress], sizeof(Network::Ipv6Address)) == 0);
+                CHECK(row.LocalPort == table.Rows[i].LocalPort && row.State == table.Rows[i].State);
+            }
+            else
+            {
+                CHECK(SameRows(row, table.Rows[i]));
+            }
+        }
+    }
+}
+
+IRONSIGHT_TEST(Recorder, StringFramesRoundTrip)
+{
+    BitWriter writer;
+    const std::vector<std::pair<uint32_t, std::string_view>> strings = { { 7, "explorer.exe" }, { 9, "" }, { 12, "svchost.exe" } };
+    std::vector<std::pair<uint32_t, std::string>> decoded;
+
+    CHECK(RoundTrip(writer,
+        [&](BitWriter& w) { FrameEncoder::EncodeStrings(strings, w); },
+        [&](BitReader& r) { return FrameDecoder::DecodeStrings(r, decoded); }));
+
+    CHECK_EQ(strings.size(), decoded.size());
+    for (size_t i = 0; i < decoded.size() && i < strings.size(); ++i)
+    {
+        CHECK_EQ(strings[i].first, decoded[i].first);
+        CHECK(decoded[i].second == strings[i].second);
+    }
+}
+
+IRONSIGHT_TEST(Recorder, RecordingReadsBackAfterStop)
+{
+    TemporaryDirectory directory("ironsight-recorder-readback");
+    FlightRecorder recorder;
+
+    CHECK(recorder.Start(directory.Path(), 0, 0));
+
+    const uint32_t nameId = Text::StringPool::Shared().Intern(std::string_view("recorder-test.exe"));
+    std::vector<System::ProcessDetailInfo> rows;
+    for (int tick = 0; tick < 20; ++tick)
+    {
+        const int64_t timestampMs = 1700000000000 + tick * 1000;
+        rows = MakeProcesses(50, tick);
+        rows[10].NameId = nameId;
+
+        recorder.RecordSystem(timestampMs, MakeSnapshot(tick));
+        recorder.RecordProcesses(timestampMs, rows.data(), rows.size());
+    }
+
+    // Stop 等待写线程写完排队的帧
+    recorder.Stop();
+    const FlightRecorderStats stats = recorder.GetStats();
+    CHECK_EQ(uint64_t{ 41 }, stats.FramesWritten);     // 20 系统帧 + 20 进程帧 + 1 字符串表帧
+    CHECK_EQ(1u, stats.SegmentCount);
+
+    FlightRecordReader reader;
+    CHECK(reader.Open(directory.Path()));
+    CHECK_EQ(int64_t{ 1700000000000 + 19 * 1000 }, reader.Seek(reader.LastTimestamp()));
+
+    const System::SystemPerformanceSnapshot last = MakeSnapshot(19);
+    CHECK(reader.HasSystem() && std::memcmp(&reader.System(), &last, sizeof(last)) == 0);
+    CHECK(SameProcesses(reader.Processes(), rows));
+}
+
+IRONSIGHT_TEST(Recorder, RotationKeepsOnlyTheNewestSegments)
+{
+    TemporaryDirectory directory("ironsight-recorder-rotation");
+    FlightRecorder recorder;
+
+    // 分段大小取下限 64 KB，每帧都是关键帧大小的进程表，很快写满多个分段
+    CHECK(recorder.Start(directory.Path(), 1, 2));
+
+    for (int tick = 0; tick < 400; ++tick)
+    {
+        const std::vector<System::ProcessDetailInfo> rows = MakeProcesses(100, tick * 31);
+        recorder.RecordProcesses(1700000000000 + tick * 1000, rows.data(), rows.size());
+    }
+    recorder.Stop();
+
+    CHECK_EQ(size_t{ 2 }, FlightRecorder::ListSegments(directory.Path()).size());
+    CHECK_EQ(2u, recorder.GetStats().SegmentCount);
+
+    // 重新开始录制时接着已有的序号，之前的分段照常参与轮转
+    CHECK(recorder.Start(directory.Path(), 1, 2));
+    recorder.Stop();
+    CHECK_EQ(size_t{ 2 }, FlightRecorder::ListSegments(directory.Path()).size());
+
+    FlightRecordReader reader;
+    CHECK(reader.Open(directory.Path()));
+}
@@ -0,0 +1,119 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "Text/StringPool.h"
+#include <string>
+#include <vector>
+
+using IronSight::Core::Native::Text::StringPool;
+
+namespace
+{
+    // 按码点构造宽字符串：wchar_t 为 16 位时把非 BMP 码点拆成代理对
+    std::wstring Wide(std::initializer_list<char32_t> codePoints)
+    {
+        std::wstring wide;
+        for (char32_t codePoint : codePoints)
+        {
+            if (sizeof(wchar_t) == 2 && codePoint >= 0x10000)
+            {
+                wide.push_back(static_cast<wchar_t>(0xD800 + ((codePoint - 0x10000) >> 10)));
+                wide.push_back(static_cast<wchar_t>(0xDC00 + ((codePoint - 0x10000) & 0x3FF)));
+            }
+            else
+            {
+                wide.push_back(static_cast<wchar_t>(codePoint));
+            }
+        }
+        return wide;
+    }
+}
+
+IRONSIGHT_TEST(Text, InternReturnsSameIdForSameContent)
+{
+    StringPool pool;
+    CHECK_EQ(size_t{ 1 }, pool.Count());
+
+    const uint32_t first = pool.Intern(std::string_view("svchost.exe"));
+    const uint32_t second = pool.Intern(std::string_view("explorer.exe"));
+    CHECK(first != 0);
+    CHECK(first != second);
+
+    // 内容相同即同一 ID，与传入的缓冲区无关
+    const std::string copy = "svchost.exe";
+    CHECK_EQ(first, pool.Intern(std::string_view(copy)));
+    CHECK_EQ(size_t{ 3 }, pool.Count());
+
+    // 宽字符串与 UTF-8 共享同一条目
+    CHECK_EQ(first, pool.Intern(std::wstring_view(L"svchost.exe")));
+    CHECK_EQ(second, pool.Intern(std::wstring_view(L"explorer.exe")));
+    CHECK_EQ(size_t{ 3 }, pool.Count());
+
+    // 空字符串固定为 ID 0，无效 ID 返回空字符串
+    CHECK_EQ(0u, pool.Intern(std::string_view()));
+    CHECK_EQ(0u, pool.Intern(std::wstring_view()));
+    CHECK(pool.Get(0).empty());
+    CHECK(pool.Get(1000).empty());
+    CHECK(pool.Get(first) == "svchost.exe");
+}
+
+IRONSIGHT_TEST(Text, InternConvertsWideToUtf8)
+{
+    StringPool pool;
+
+    // 2 字节 (é)、3 字节 (中) 与 4 字节 (U+1F600，UTF-16 下为代理对) 的编码
+    const std::wstring mixed = Wide({ U'a', 0xE9, 0x4E2D, 0x1F600 });
+    const uint32_t id = pool.Intern(std::wstring_view(mixed));
+    CHECK(pool.Get(id) == "a\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80");
+    CHECK_EQ(id, pool.Intern(std::string_view("a\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80")));
+
+    // 第二次驻留走宽字符索引，结果不变
+    CHECK_EQ(id, pool.Intern(std::wstring_view(mixed)));
+
+    // 辅助平面的最大码点
+    const uint32_t last = pool.Intern(std::wstring_view(Wide({ 0x10FFFF })));
+    CHECK(pool.Get(last) == "\xF4\x8F\xBF\xBF");
+
+    // 孤立的代理项替换为 U+FFFD
+    const uint32_t lone = pool.Intern(std::wstring_view(Wide({ U'x', 0xD800, U'y' })));
+    CHECK(pool.Get(lone) == "x\xEF\xBF\xBD" "y");
+}
+
+IRONSIGHT_TEST(Text, GetViewsStayValidAcrossChunks)
+{
+    StringPool pool;
+
+    // 每条 100 字节，约 650 条填满一个 64 KB 内存块；驻留 3000 条跨越多个块，并触发索引扩容
+    constexpr uint32_t StringCount = 3000;
+    auto text = [](uint32_t i)
+    {
+        std::string value = "process-" + std::to_string(i);
+        value.resize(100, '.');
+        return value;
+    };
+
+    std::vector<uint32_t> ids;
+    std::vector<std::string_view> views;
+    for (uint32_t i = 0; i < StringCount; ++i)
+    {
+        ids.push_back(pool.Intern(std::string_view(text(i))));
+        views.push_back(pool.Get(ids.back()));
+    }
+
+    // 超过块大小的字符串独占一个块，不影响之后的追加
+    const std::string large(100 * 1024, 'L');
+    const uint32_t largeId = pool.Intern(std::string_view(large));
+    const uint32_t after = pool.Intern(std::string_view("after-large"));
+
+    CHECK_EQ(size_t{ StringCount + 3 }, pool.Count());
+    CHECK(pool.Get(largeId) == large);
+    CHECK(pool.Get(after) == "after-large");
+
+    // 先前取得的视图仍指向原位置，内容未被后续追加覆盖，且以 0 结尾
+    for (uint32_t i = 0; i < StringCount; ++i)
+    {
+        CHECK_EQ(i + 1, ids[i]);
+        CHECK(views[i].data() == pool.Get(ids[i]).data());
+        CHECK(views[i] == text(i));
+        CHECK(views[i].data()[views[i].size()] == '\0');
+    }
+}
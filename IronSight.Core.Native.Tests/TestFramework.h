@@ -0,0 +1,56 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace IronSight::Core::Native::Tests
+{
+	/// <summary>
+	/// 已注册的测试用例 (名称形如 "模块.用例")
+	/// </summary>
+	struct TestCase
+	{
+		const char* Name;
+		void (*Run)();
+	};
+
+	std::vector<TestCase>& Registry();
+
+	/// <summary>
+	/// 记录一次断言失败，测试继续执行，结束后以失败计
+	/// </summary>
+	void ReportFailure(const char* file, int line, const std::string& message);
+
+	struct TestRegistrar
+	{
+		TestRegistrar(const char* name, void (*run)())
+		{
+			Registry().push_back({ name, run });
+		}
+	};
+
+	/// <summary>
+	/// 读取测试数据目录 (IRONSIGHT_FIXTURE_DIR) 下的文件
+	/// </summary>
+	/// <returns>文件不存在时返回 false</returns>
+	bool ReadFixture(const std::string& relativePath, std::string& content);
+}
+
+#define IRONSIGHT_TEST(suite, name) \
+	static void suite##_##name(); \
+	static ::IronSight::Core::Native::Tests::TestRegistrar suite##_##name##_registrar(#suite "." #name, suite##_##name); \
+	static void suite##_##name()
+
+#define CHECK(expression) \
+	do { if (!(expression)) ::IronSight::Core::Native::Tests::ReportFailure(__FILE__, __LINE__, #expression); } while (0)
+
+#define CHECK_EQ(expected, actual) \
+	do { \
+		const auto& check_expected_ = (expected); \
+		const auto& check_actual_ = (actual); \
+		if (!(check_expected_ == check_actual_)) \
+			::IronSight::Core::Native::Tests::ReportFailure(__FILE__, __LINE__, \
+				std::string(#actual " == " #expected ": 实际为 ") + std::to_string(check_actual_) + \
+				"，期望 " + std::to_string(check_expected_)); \
+	} while (0)
@@ -0,0 +1,62 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace IronSight::Core::Native::Tests
+{
+    namespace
+    {
+        int g_failures = 0;
+    }
+
+    std::vector<TestCase>& Registry()
+    {
+        static std::vector<TestCase> tests;
+        return tests;
+    }
+
+    void ReportFailure(const char* file, int line, const std::string& message)
+    {
+        ++g_failures;
+        std::fprintf(stderr, "%s:%d: 断言失败: %s\n", file, line, message.c_str());
+    }
+
+    bool ReadFixture(const std::string& relativePath, std::string& content)
+    {
+        std::ifstream file(std::string(IRONSIGHT_FIXTURE_DIR) + "/" + relativePath, std::ios::binary);
+        if (!file) return false;
+
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        content = buffer.str();
+        return true;
+    }
+}
+
+// 用法: IronSight.Core.Native.Tests [名称前缀]，不带参数时运行全部测试
+int main(int argc, char** argv)
+{
+    using namespace IronSight::Core::Native::Tests;
+
+    const char* prefix = argc > 1 ? argv[1] : "";
+    int run = 0;
+    int failed = 0;
+
+    for (const TestCase& test : Registry())
+    {
+        if (std::strncmp(test.Name, prefix, std::strlen(prefix)) != 0) continue;
+
+        const int before = g_failures;
+        test.Run();
+        ++run;
+
+        const bool passed = g_failures == before;
+        if (!passed) ++failed;
+        std::printf("[%s] %s\n", passed ? "  OK  " : " FAIL ", test.Name);
+    }
+
+    std::printf("%d 个测试，%d 个失败\n", run, failed);
+    return run == 0 || failed != 0 ? 1 : 0;
+}
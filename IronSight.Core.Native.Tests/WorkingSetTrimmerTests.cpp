@@ -0,0 +1,148 @@
+﻿#include <pch.h>
+#include "TestFramework.h"
+#include "Memory/WorkingSetTrimmer.h"
+#include "Text/StringPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace IronSight::Core::Native;
+using namespace IronSight::Core::Native::Memory;
+
+namespace
+{
+    constexpr uint64_t MB = 1024ull * 1024;
+
+    // 回收顺序与并发度都由它记录；Trim 按预计回收量返回释放的字节
+    class FakeTrimBackend : public ITrimBackend
+    {
+        public:
+        std::vector<System::ProcessSample> Samples;
+        std::vector<uint32_t> FailingPids;
+        uint32_t HoldMs = 0;                // 每次回收持续的时间，用于观察并发
+
+        std::mutex Mutex;
+        std::vector<uint32_t> Order;        // 实际回收的 PID，按开始顺序
+        std::atomic<uint32_t> InFlight{ 0 };
+        std::atomic<uint32_t> MaxInFlight{ 0 };
+
+        void Add(uint32_t pid, uint64_t workingSetMB, uint64_t privateMB, uint32_t nameId = 0)
+        {
+            System::ProcessSample sample{};
+            sample.Pid = pid;
+            sample.NameId = nameId;
+            sample.CreateTime = 1000 + pid;
+            sample.WorkingSetBytes = workingSetMB * MB;
+            sample.PrivateBytes = privateMB * MB;
+            sample.HasCounters = true;
+            Samples.push_back(sample);
+        }
+
+        bool Enumerate(std::vector<System::ProcessSample>& samples) override
+        {
+            samples = Samples;
+            return true;
+        }
+
+        bool Trim(const TrimCandidate& candidate, uint64_t& releasedBytes) override
+        {
+            const uint32_t inFlight = InFlight.fetch_add(1) + 1;
+            uint32_t observed = MaxInFlight.load();
+            while (inFlight > observed && !MaxInFlight.compare_exchange_weak(observed, inFlight)) {}
+
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                Order.push_back(candidate.Pid);
+            }
+
+            if (HoldMs != 0) std::this_thread::sleep_for(std::chrono::milliseconds(HoldMs));
+            InFlight.fetch_sub(1);
+
+            if (std::find(FailingPids.begin(), FailingPids.end(), candidate.Pid) != FailingPids.end()) return false;
+
+            releasedBytes = candidate.ExpectedBytes;
+            return true;
+        }
+    };
+
+    TrimOptions Options(uint32_t maxConcurrency, uint64_t targetBytes = 0)
+    {
+        TrimOptions options{};
+        options.MinReclaimBytes = 8 * MB;
+        options.TargetBytes = targetBytes;
+        options.MaxConcurrency = maxConcurrency;
+        return options;
+    }
+}
+
+IRONSIGHT_TEST(Memory, TrimmerReclaimsLargestPrivateResidentFirst)
+{
+    FakeTrimBackend backend;
+    const uint32_t protectedName = Text::StringPool::Shared().Intern(std::string_view("trim-test-protected.exe"));
+
+    backend.Add(0, 500, 500);                   // 空闲进程，不计入
+    backend.Add(10, 100, 20);                   // 预计 20 MB (私有内存较小)
+    backend.Add(11, 30, 300);                   // 预计 30 MB (工作集较小)
+    backend.Add(12, 4, 4);                      // 低于阈值
+    backend.Add(13, 900, 900, protectedName);   // 受保护
+    backend.Add(14, 60, 60);                    // 预计 60 MB
+    backend.Add(15, 30, 40);                    // 与 11 相同，PID 小者优先
+
+    WorkingSetTrimmer trimmer(backend);
+    trimmer.Protect("trim-test-protected.exe");
+
+    const TrimResult result = trimmer.Run(Options(1));
+
+    const std::vector<uint32_t> expected = { 14, 11, 15, 10 };
+    CHECK(backend.Order == expected);
+    CHECK_EQ(4u, result.TrimmedProcesses);
+    CHECK_EQ(2u, result.SkippedProcesses);
+    CHECK_EQ(0u, result.FailedProcesses);
+    CHECK_EQ(140 * MB, result.ExpectedBytes);
+    CHECK_EQ(140 * MB, result.ReleasedBytes);
+}
+
+IRONSIGHT_TEST(Memory, TrimmerStopsStartingOnceTargetIsReached)
+{
+    FakeTrimBackend backend;
+    for (uint32_t pid = 1; pid <= 5; ++pid) backend.Add(pid, 100, 10 * pid);
+    backend.FailingPids = { 4 };
+
+    WorkingSetTrimmer trimmer(backend);
+    const TrimResult result = trimmer.Run(Options(1, 80 * MB));
+
+    // 50 MB 的进程回收后未达目标，40 MB 的进程失败，30 MB 的进程回收后达到目标，其余跳过
+    const std::vector<uint32_t> expected = { 5, 4, 3 };
+    CHECK(backend.Order == expected);
+    CHECK_EQ(2u, result.TrimmedProcesses);
+    CHECK_EQ(1u, result.FailedProcesses);
+    CHECK_EQ(2u, result.SkippedProcesses);
+    CHECK_EQ(80 * MB, result.ReleasedBytes);
+}
+
+IRONSIGHT_TEST(Memory, TrimmerRunsUpToMaxConcurrencyInParallel)
+{
+    FakeTrimBackend backend;
+    for (uint32_t pid = 1; pid <= 24; ++pid) backend.Add(pid, 64, 64);
+    backend.HoldMs = 5;
+
+    WorkingSetTrimmer trimmer(backend);
+    const TrimResult result = trimmer.Run(Options(3));
+
+    CHECK_EQ(24u, result.TrimmedProcesses);
+    CHECK_EQ(size_t{ 24 }, backend.Order.size());
+    CHECK(backend.MaxInFlight.load() > 1);
+    CHECK(backend.MaxInFlight.load() <= 3);
+
+    // 每个进程只回收一次
+    std::vector<uint32_t> sorted = backend.Order;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+
+    // 并发上限改为 1 时回到调用线程上串行执行
+    backend.Order.clear();
+    backend.MaxInFlight = 0;
+    trimmer.Run(Options(1));
+    CHECK_EQ(1u, backend.MaxInFlight.load());
+}
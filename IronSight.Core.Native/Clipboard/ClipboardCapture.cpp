@@ -0,0 +1,72 @@
+﻿#include <pch.h>
+#include "ClipboardCapture.h"
+#include <chrono>
+
+namespace IronSight::Core::Native::Clipboard
+{
+    ClipboardCapture::ClipboardCapture(std::unique_ptr<IClipboardSource> source)
+        : _source(std::move(source))
+    {
+    }
+
+    ClipboardCapture& ClipboardCapture::Shared()
+    {
+        static ClipboardCapture* capture = new ClipboardCapture(IClipboardSource::CreateDefault());
+        return *capture;
+    }
+
+    bool ClipboardCapture::OnClipboardUpdate()
+    {
+        if (!_source) return false;
+
+        // 序列号未变：重复的更新通知，不必打开剪贴板
+        const uint32_t sequence = _source->SequenceNumber();
+        if (_hasSequence && sequence == _lastSequence) return false;
+
+        const ClipboardFormat format = _source->Read(_payload);
+
+        // 不记录序列号：剪贴板被占用时，下一次通知可以重试 (不含文本时检查格式的代价很小)
+        if (format == ClipboardFormat::None) return false;
+
+        _lastSequence = sequence;
+        _hasSequence = true;
+
+        const int64_t timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        bool changed = false;
+        const uint64_t id = _history.Add(format, _payload, ClipboardHistory::Hash(_payload), timestampMs, changed);
+
+        if (changed)
+        {
+            if (OnClipboardChangedCallback callback = _callback.load(std::memory_order_acquire)) callback(id);
+        }
+
+        return changed;
+    }
+
+    extern "C"
+    {
+        bool ClipboardHistory_Acquire(uint64_t id, ClipboardEntryInfo* info, const uint8_t** data)
+        {
+            if (!info || !data) return false;
+            return ClipboardCapture::Shared().History().Acquire(id, *info, *data);
+        }
+
+        void ClipboardHistory_Release()
+        {
+            ClipboardCapture::Shared().History().Release();
+        }
+
+        size_t ClipboardHistory_List(ClipboardEntryInfo* buffer, size_t maxCount)
+        {
+            if (!buffer) return 0;
+            return ClipboardCapture::Shared().History().List(buffer, maxCount);
+        }
+
+        void ClipboardHistory_Clear()
+        {
+            ClipboardCapture::Shared().History().Clear();
+        }
+    }
+}
@@ -0,0 +1,64 @@
+﻿#pragma once
+#include "ClipboardHistory.h"
+
+// 剪贴板内容变化回调：entryId 为历史条目 ID (内容过大未保存时为 0)
+typedef void(__stdcall* OnClipboardChangedCallback)(uint64_t entryId);
+
+namespace IronSight::Core::Native::Clipboard
+{
+	/// <summary>
+	/// 剪贴板内容捕获
+	/// 每次剪贴板更新时在监听线程上读取内容、计算哈希并写入历史；
+	/// 只有内容与上一次捕获不同时才通知托管层，程序反复设置相同内容不会触发回调
+	/// </summary>
+	class ClipboardCapture
+	{
+		public:
+		explicit ClipboardCapture(std::unique_ptr<IClipboardSource> source);
+
+		ClipboardCapture(const ClipboardCapture&) = delete;
+		ClipboardCapture& operator=(const ClipboardCapture&) = delete;
+
+		/// <summary>
+		/// 使用当前平台默认剪贴板的全局实例
+		/// </summary>
+		static ClipboardCapture& Shared();
+
+		/// <summary>
+		/// 剪贴板已更新 (只在监听线程上调用)
+		/// </summary>
+		/// <returns>内容发生变化时返回true</returns>
+		bool OnClipboardUpdate();
+
+		void SetCallback(OnClipboardChangedCallback callback) noexcept { _callback.store(callback, std::memory_order_release); }
+
+		ClipboardHistory& History() noexcept { return _history; }
+
+		private:
+		std::unique_ptr<IClipboardSource> _source;
+		ClipboardHistory _history;
+		std::string _payload;               // 跨调用复用的读取缓冲区
+		uint32_t _lastSequence = 0;
+		bool _hasSequence = false;
+		std::atomic<OnClipboardChangedCallback> _callback{ nullptr };
+	};
+
+	extern "C"
+	{
+		/// <summary>
+		/// 按 ID 取剪贴板历史条目，data 直接指向原生内存 (不复制)
+		/// 成功时必须在读取完毕后调用 ClipboardHistory_Release，期间新的捕获会等待
+		/// </summary>
+		__declspec(dllexport) bool ClipboardHistory_Acquire(uint64_t id, ClipboardEntryInfo* info, const uint8_t** data);
+
+		__declspec(dllexport) void ClipboardHistory_Release();
+
+		/// <summary>
+		/// 按最近复制时间从新到旧列出历史条目
+		/// </summary>
+		/// <returns>写入的条目数</returns>
+		__declspec(dllexport) size_t ClipboardHistory_List(ClipboardEntryInfo* buffer, size_t maxCount);
+
+		__declspec(dllexport) void ClipboardHistory_Clear();
+	}
+}
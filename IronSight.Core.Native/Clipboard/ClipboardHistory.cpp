@@ -0,0 +1,181 @@
+﻿#include <pch.h>
+#include "ClipboardHistory.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace IronSight::Core::Native::Clipboard
+{
+    namespace
+    {
+        constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t Prime3 = 0x165667B19E3779F9ull;
+
+        inline uint64_t RotateLeft(uint64_t value, int bits) noexcept
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        inline uint64_t MixLane(uint64_t lane) noexcept
+        {
+            return RotateLeft(lane * Prime2, 31) * Prime1;
+        }
+    }
+
+    ClipboardHistory::ClipboardHistory(size_t capacityBytes, size_t maxEntries)
+        : _arena(std::make_unique<uint8_t[]>(capacityBytes)), _capacity(capacityBytes), _maxEntries((std::max)(maxEntries, size_t{ 1 }))
+    {
+    }
+
+    uint64_t ClipboardHistory::Hash(std::string_view payload) noexcept
+    {
+        const char* p = payload.data();
+        size_t remaining = payload.size();
+        uint64_t hash = Prime3 ^ (static_cast<uint64_t>(payload.size()) * Prime1);
+
+        while (remaining >= sizeof(uint64_t))
+        {
+            uint64_t lane;
+            std::memcpy(&lane, p, sizeof(lane));
+            hash = RotateLeft(hash ^ MixLane(lane), 27) * Prime1 + Prime3;
+            p += sizeof(lane);
+            remaining -= sizeof(lane);
+        }
+
+        if (remaining > 0)
+        {
+            uint64_t lane = 0;
+            std::memcpy(&lane, p, remaining);
+            hash ^= MixLane(lane);
+        }
+
+        // 末尾雪崩，使相近的内容也得到差异很大的哈希
+        hash ^= hash >> 33;
+        hash *= Prime2;
+        hash ^= hash >> 29;
+        hash *= Prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    uint64_t ClipboardHistory::Add(ClipboardFormat format, std::string_view payload, uint64_t hash, int64_t timestampMs, bool& changed)
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+
+        const uint32_t size = static_cast<uint32_t>(payload.size());
+
+        auto matches = [&](const Entry& entry)
+            {
+                return entry.Info.Hash == hash && entry.Info.Size == size && entry.Info.Format == format &&
+                    std::memcmp(Data(entry), payload.data(), size) == 0;
+            };
+
+        // 与上一次捕获相同：程序重复设置了同样的内容，不算变化
+        if (_hasLast && _lastHash == hash && _lastSize == size)
+        {
+            if (_lastId == 0)
+            {
+                changed = false;
+                return 0;
+            }
+
+            if (!_entries.empty() && _entries.back().Info.Id == _lastId && matches(_entries.back()))
+            {
+                changed = false;
+                return _lastId;
+            }
+        }
+
+        changed = true;
+        _hasLast = true;
+        _lastHash = hash;
+        _lastSize = size;
+        _lastId = 0;
+
+        if (payload.size() > _capacity / 4) return 0;
+
+        // 再次复制已有内容：沿用原 ID，内容重新写到最新位置
+        uint64_t id = 0;
+        auto existing = std::find_if(_entries.begin(), _entries.end(), matches);
+        if (existing != _entries.end())
+        {
+            id = existing->Info.Id;
+            _entries.erase(existing);
+        }
+        else
+        {
+            id = _nextId++;
+        }
+
+        const uint64_t position = Allocate(size);
+        if (size > 0) std::memcpy(_arena.get() + position % _capacity, payload.data(), size);
+
+        _entries.push_back(Entry{ ClipboardEntryInfo{ id, hash, timestampMs, size, format }, position });
+        _head = position + size;
+        _lastId = id;
+        return id;
+    }
+
+    uint64_t ClipboardHistory::Allocate(size_t size)
+    {
+        for (;;)
+        {
+            // 末尾放不下时跳到内存区开头，内容始终连续存放
+            const size_t offset = static_cast<size_t>(_head % _capacity);
+            const uint64_t position = _capacity - offset < size ? _head + (_capacity - offset) : _head;
+            const uint64_t oldest = _entries.empty() ? position : _entries.front().Position;
+
+            if (position + size - oldest <= _capacity && _entries.size() < _maxEntries) return position;
+
+            _entries.pop_front();
+        }
+    }
+
+    bool ClipboardHistory::Acquire(uint64_t id, ClipboardEntryInfo& info, const uint8_t*& data) const
+    {
+        if (id == 0) return false;
+
+        _mutex.lock_shared();
+
+        for (const Entry& entry : _entries)
+        {
+            if (entry.Info.Id == id)
+            {
+                info = entry.Info;
+                data = Data(entry);
+                return true;
+            }
+        }
+
+        _mutex.unlock_shared();
+        return false;
+    }
+
+    void ClipboardHistory::Release() const
+    {
+        _mutex.unlock_shared();
+    }
+
+    size_t ClipboardHistory::List(ClipboardEntryInfo* buffer, size_t maxCount) const
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+
+        size_t count = 0;
+        for (auto it = _entries.rbegin(); it != _entries.rend() && count < maxCount; ++it)
+        {
+            buffer[count++] = it->Info;
+        }
+        return count;
+    }
+
+    void ClipboardHistory::Clear()
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+
+        _entries.clear();
+        _head = 0;
+        _hasLast = false;
+        _lastId = 0;
+    }
+}
@@ -0,0 +1,95 @@
+﻿#pragma once
+#include "ClipboardSource.h"
+#include <deque>
+#include <shared_mutex>
+#include <string_view>
+
+namespace IronSight::Core::Native::Clipboard
+{
+#pragma pack(push, 8)
+	/// <summary>
+	/// 历史中的一条剪贴板内容
+	/// </summary>
+	struct ClipboardEntryInfo
+	{
+		uint64_t Id;                // 从 1 开始递增，同一内容再次复制时沿用原 ID
+		uint64_t Hash;
+		int64_t TimestampMs;        // 最近一次复制的时间 (Unix 毫秒)
+		uint32_t Size;              // 内容字节数
+		ClipboardFormat Format;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(ClipboardEntryInfo) == 32, "ClipboardEntryInfo size mismatch");
+
+	/// <summary>
+	/// 有界的剪贴板历史
+	/// 内容存放在一块固定大小的环形内存区中，按写入顺序排列，空间或条数不足时淘汰最旧的条目；
+	/// 再次复制已有内容时把它移到最新位置并沿用原 ID。条目最多几百条，按哈希线性查找即可
+	/// </summary>
+	class ClipboardHistory
+	{
+		public:
+		static constexpr size_t DefaultCapacityBytes = 4 * 1024 * 1024;
+		static constexpr size_t DefaultMaxEntries = 128;
+
+		explicit ClipboardHistory(size_t capacityBytes = DefaultCapacityBytes, size_t maxEntries = DefaultMaxEntries);
+
+		ClipboardHistory(const ClipboardHistory&) = delete;
+		ClipboardHistory& operator=(const ClipboardHistory&) = delete;
+
+		/// <summary>
+		/// 64 位非加密哈希 (每次处理 8 字节)，用于快速判断内容是否变化
+		/// </summary>
+		static uint64_t Hash(std::string_view payload) noexcept;
+
+		/// <summary>
+		/// 记录一次捕获
+		/// 超过容量四分之一的内容不保存 (返回 0)，但仍参与是否变化的判断
+		/// </summary>
+		/// <param name="changed">内容与上一次捕获不同时为 true</param>
+		/// <returns>条目 ID，未保存时为 0</returns>
+		uint64_t Add(ClipboardFormat format, std::string_view payload, uint64_t hash, int64_t timestampMs, bool& changed);
+
+		/// <summary>
+		/// 按 ID 取条目，data 直接指向环形内存区 (不复制)
+		/// 成功时持有共享锁，读取完毕后必须调用 Release；期间新的捕获会等待
+		/// </summary>
+		bool Acquire(uint64_t id, ClipboardEntryInfo& info, const uint8_t*& data) const;
+		void Release() const;
+
+		/// <summary>
+		/// 按最近复制时间从新到旧列出条目
+		/// </summary>
+		/// <returns>写入的条目数</returns>
+		size_t List(ClipboardEntryInfo* buffer, size_t maxCount) const;
+
+		void Clear();
+
+		private:
+		struct Entry
+		{
+			ClipboardEntryInfo Info;
+			uint64_t Position;          // 在环形内存区中的单调位置 (对容量取模得到偏移)
+		};
+
+		// 淘汰最旧的条目，直到能在写入位置放下 size 字节且条数未满，返回写入位置
+		uint64_t Allocate(size_t size);
+
+		const uint8_t* Data(const Entry& entry) const noexcept { return _arena.get() + entry.Position % _capacity; }
+
+		mutable std::shared_mutex _mutex;
+		std::unique_ptr<uint8_t[]> _arena;
+		size_t _capacity;
+		size_t _maxEntries;
+		std::deque<Entry> _entries;     // 按写入顺序，最旧的在前
+		uint64_t _head = 0;
+		uint64_t _nextId = 1;
+
+		// 上一次捕获 (可能因过大而未保存)
+		uint64_t _lastHash = 0;
+		uint32_t _lastSize = 0;
+		uint64_t _lastId = 0;
+		bool _hasLast = false;
+	};
+}
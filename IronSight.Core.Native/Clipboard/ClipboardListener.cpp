@@ -17,10 +17,8 @@ namespace IronSight::Core::Native::Clipboard
 			return 0;
 
 		case WM_CLIPBOARDUPDATE:
-			if (_callback)
-			{
-				_callback();
-			}
+			// 读取、去重并写入历史，内容确实变化时才回调托管层
+			ClipboardCapture::Shared().OnClipboardUpdate();
 			return 0;
 
 		case WM_DESTROY:
@@ -65,7 +63,7 @@ namespace IronSight::Core::Native::Clipboard
 	{
 		if (_isRunning) return true;
 
-		_callback = callback;
+		ClipboardCapture::Shared().SetCallback(callback);
 		_isRunning = true;
 		_listenerThread = std::thread(ListenerThreadProc);
 		_listenerThread.detach(); // Let it run independently
@@ -87,7 +85,7 @@ namespace IronSight::Core::Native::Clipboard
 			PostMessage(_hMessageWindow, WM_DESTROY, 0, 0);
 
 			_isRunning = false;
-			_callback = nullptr;
+			ClipboardCapture::Shared().SetCallback(nullptr);
 		}
 	}
 }
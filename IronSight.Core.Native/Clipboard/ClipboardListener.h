@@ -1,18 +1,14 @@
 ﻿#pragma once
+#include "ClipboardCapture.h"
 
-
-typedef void(__stdcall* OnClipboardChangedCallback)();
 namespace IronSight::Core::Native::Clipboard
 {
     class ClipboardListener
     {
-        // Callback type: void(int formatId) - simplified, or just void()
-        // The requirement says "Push updates". We can just notify "Changed" and let C# read the clipboard (easier for marshaling complex data).
-        // Or we can pass data. RPD says "C++ listening ... via callback push to WPF".
-        // Let's pass a simple signal first. "Something changed".
+        // 剪贴板内容由 ClipboardCapture 在监听线程上捕获并去重，回调只携带历史条目 ID，
+        // 托管层按 ID 从原生历史中读取内容，不必再次打开剪贴板
 
         private:
-        inline static OnClipboardChangedCallback _callback = nullptr;
         inline static HWND _hMessageWindow = nullptr;
         inline static std::thread _listenerThread;
         inline static std::atomic<bool> _isRunning;
@@ -34,7 +30,7 @@ namespace IronSight::Core::Native::Clipboard
         /// <summary>
         /// 启动剪贴板监听器并注册回调，用于在剪贴板内容变化时接收通知。
         /// </summary>
-        /// <param name="callback">当剪贴板内容发生变化时调用的回调函数（类型为 OnClipboardChangedCallback）。</param>
+        /// <param name="callback">当剪贴板内容发生变化时调用的回调函数（类型为 OnClipboardChangedCallback），参数为历史条目 ID。相同内容被重复设置时不会调用。</param>
         /// <returns>如果监听器成功启动并注册回调则返回 true，否则返回 false。</returns>
         static bool StartClipboardListener(OnClipboardChangedCallback callback);
         /// <summary>
@@ -0,0 +1,20 @@
+﻿#include <pch.h>
+#include "ClipboardSource.h"
+
+#if defined(_WIN32)
+#include "WinClipboardSource.h"
+#else
+#include "FakeClipboardSource.h"
+#endif
+
+namespace IronSight::Core::Native::Clipboard
+{
+    std::unique_ptr<IClipboardSource> IClipboardSource::CreateDefault()
+    {
+#if defined(_WIN32)
+        return std::make_unique<WinClipboardSource>();
+#else
+        return std::make_unique<FakeClipboardSource>();
+#endif
+    }
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+
+namespace IronSight::Core::Native::Clipboard
+{
+	/// <summary>
+	/// 捕获的剪贴板内容格式
+	/// </summary>
+	enum class ClipboardFormat : uint32_t
+	{
+		None = 0,
+		Text = 1            // UTF-8 文本 (不含结尾的 '\0')
+	};
+
+	/// <summary>
+	/// 剪贴板内容的平台接口 (只在剪贴板监听线程上调用)
+	/// </summary>
+	class IClipboardSource
+	{
+		public:
+		virtual ~IClipboardSource() = default;
+
+		/// <summary>
+		/// 剪贴板序列号，内容每被设置一次递增一次 (与内容是否相同无关)
+		/// 与上次读取时相同说明剪贴板没有被重新设置，可以跳过读取
+		/// </summary>
+		virtual uint32_t SequenceNumber() = 0;
+
+		/// <summary>
+		/// 读取当前剪贴板内容到 payload (复用其容量)
+		/// </summary>
+		/// <returns>读到受支持的格式时返回该格式，剪贴板为空、被占用或格式不受支持时返回 None</returns>
+		virtual ClipboardFormat Read(std::string& payload) = 0;
+
+		/// <summary>
+		/// 创建当前平台的默认实现
+		/// Windows 读取系统剪贴板；其余平台没有系统剪贴板，使用内存中的 FakeClipboardSource
+		/// </summary>
+		static std::unique_ptr<IClipboardSource> CreateDefault();
+	};
+}
@@ -0,0 +1,26 @@
+﻿#include <pch.h>
+#include "FakeClipboardSource.h"
+
+namespace IronSight::Core::Native::Clipboard
+{
+    void FakeClipboardSource::Set(ClipboardFormat format, std::string_view payload)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _format = format;
+        _payload.assign(payload.data(), payload.size());
+        ++_sequence;
+    }
+
+    uint32_t FakeClipboardSource::SequenceNumber()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _sequence;
+    }
+
+    ClipboardFormat FakeClipboardSource::Read(std::string& payload)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        payload.assign(_payload);
+        return _format;
+    }
+}
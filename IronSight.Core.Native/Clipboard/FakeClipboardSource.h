@@ -0,0 +1,28 @@
+﻿#pragma once
+#include "ClipboardSource.h"
+#include <mutex>
+
+namespace IronSight::Core::Native::Clipboard
+{
+	/// <summary>
+	/// 内存中的剪贴板 (没有系统剪贴板的平台与测试使用)
+	/// 每次 Set 都像真实剪贴板一样递增序列号，即使内容与上次相同
+	/// </summary>
+	class FakeClipboardSource final : public IClipboardSource
+	{
+		public:
+		/// <summary>
+		/// 设置剪贴板内容 (可在任意线程上调用)；format 为 None 时相当于清空剪贴板
+		/// </summary>
+		void Set(ClipboardFormat format, std::string_view payload);
+
+		uint32_t SequenceNumber() override;
+		ClipboardFormat Read(std::string& payload) override;
+
+		private:
+		std::mutex _mutex;
+		std::string _payload;
+		ClipboardFormat _format = ClipboardFormat::None;
+		uint32_t _sequence = 0;
+	};
+}
@@ -0,0 +1,70 @@
+﻿#include <pch.h>
+#include "WinClipboardSource.h"
+#include "Utilities.h"
+
+#if defined(_WIN32)
+
+namespace IronSight::Core::Native::Clipboard
+{
+    namespace
+    {
+        constexpr int OpenAttempts = 5;
+        constexpr DWORD OpenRetryDelayMs = 10;
+
+        bool OpenWithRetry()
+        {
+            for (int attempt = 0; attempt < OpenAttempts; ++attempt)
+            {
+                if (OpenClipboard(nullptr)) return true;
+                Sleep(OpenRetryDelayMs);
+            }
+
+            LOG_WARN("无法打开剪贴板，错误代码: %lu", GetLastError());
+            return false;
+        }
+    }
+
+    uint32_t WinClipboardSource::SequenceNumber()
+    {
+        return GetClipboardSequenceNumber();
+    }
+
+    ClipboardFormat WinClipboardSource::Read(std::string& payload)
+    {
+        payload.clear();
+
+        // 不含文本时不必打开剪贴板
+        if (!IsClipboardFormatAvailable(CF_UNICODETEXT)) return ClipboardFormat::None;
+        if (!OpenWithRetry()) return ClipboardFormat::None;
+
+        ClipboardFormat format = ClipboardFormat::None;
+
+        if (HANDLE data = GetClipboardData(CF_UNICODETEXT))
+        {
+            if (const wchar_t* text = static_cast<const wchar_t*>(GlobalLock(data)))
+            {
+                // 以全局内存块大小为上限查找结尾，不信任内容一定以 '\0' 结束
+                const size_t capacity = GlobalSize(data) / sizeof(wchar_t);
+                const size_t length = wcsnlen(text, capacity);
+
+                if (length > 0 && length <= static_cast<size_t>(INT_MAX))
+                {
+                    const int bytes = WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length), nullptr, 0, nullptr, nullptr);
+                    if (bytes > 0)
+                    {
+                        payload.resize(static_cast<size_t>(bytes));
+                        WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length), payload.data(), bytes, nullptr, nullptr);
+                        format = ClipboardFormat::Text;
+                    }
+                }
+
+                GlobalUnlock(data);
+            }
+        }
+
+        CloseClipboard();
+        return format;
+    }
+}
+
+#endif
@@ -0,0 +1,16 @@
+﻿#pragma once
+#include "ClipboardSource.h"
+
+namespace IronSight::Core::Native::Clipboard
+{
+	/// <summary>
+	/// Windows 系统剪贴板 (CF_UNICODETEXT 转为 UTF-8)
+	/// 其他程序正持有剪贴板时 OpenClipboard 会失败，短暂重试几次后放弃本次读取
+	/// </summary>
+	class WinClipboardSource final : public IClipboardSource
+	{
+		public:
+		uint32_t SequenceNumber() override;
+		ClipboardFormat Read(std::string& payload) override;
+	};
+}
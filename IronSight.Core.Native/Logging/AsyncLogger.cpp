@@ -0,0 +1,480 @@
+﻿#include <pch.h>
+#include "AsyncLogger.h"
+#include "Log.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace IronSight::Core::Native::Logging
+{
+    namespace
+    {
+        using Callback = void(__stdcall*)(Utils::LogLevel level, const char* message);
+
+        // 一条已格式化的消息 (文本位于批次的共享缓冲区中)
+        struct Entry
+        {
+            int64_t Timestamp;
+            uint32_t Level;
+            size_t Offset;
+        };
+
+        struct LoggerState
+        {
+            std::mutex RingsMutex;                  // 保护 Rings、Started 与 Consumer
+            std::vector<LogRing*> Rings;            // 环形缓冲区不释放，线程退出后留给新线程复用
+            bool Started = false;
+            std::thread Consumer;
+
+            std::mutex DrainMutex;                  // 同一时刻只有一个消费者 (后台线程或 Flush)
+            std::vector<LogRing*> Snapshot;
+            std::vector<Entry> Entries;
+            std::string Text;
+            uint64_t ReportedDropped = 0;
+
+            std::atomic<Callback> Dispatch{ nullptr };
+
+            std::mutex WakeMutex;                   // 保护 Pending 与 Stopping
+            std::condition_variable Wakeup;
+            bool Pending = false;                   // 有缓冲区从空变为非空
+            bool Stopping = false;
+        };
+
+        LoggerState& State()
+        {
+            static LoggerState* state = new LoggerState();
+            return *state;
+        }
+
+        // 本线程的 thread_local 已开始析构 (平凡类型，线程结束前一直可读)
+        thread_local bool ThreadExiting = false;
+
+        // 线程退出时把缓冲区标记为可复用；此后本线程 (其他 thread_local 的析构函数中) 的日志直接丢弃，
+        // 不能继续写入已交还的缓冲区
+        struct RingOwner
+        {
+            LogRing* Ring = nullptr;
+            ~RingOwner()
+            {
+                ThreadExiting = true;
+                Detail::ThreadRing = nullptr;
+                if (Ring) Ring->Abandoned.store(true, std::memory_order_release);
+            }
+        };
+
+        template <typename T>
+        T ReadValue(const uint8_t*& p) noexcept
+        {
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return value;
+        }
+
+        // 按格式说明符追加一个值 (snprintf 需要时扩容重试)
+        template <typename T>
+        void AppendFormatted(std::string& out, const char* spec, T value)
+        {
+            const size_t start = out.size();
+            out.resize(start + 64);
+            int written = std::snprintf(&out[start], 64, spec, value);
+            if (written < 0)
+            {
+                out.resize(start);
+                return;
+            }
+
+            if (static_cast<size_t>(written) >= 64)
+            {
+                out.resize(start + written + 1);
+                std::snprintf(&out[start], written + 1, spec, value);
+            }
+            out.resize(start + written);
+        }
+
+        // 记录中的一个参数
+        struct Arg
+        {
+            ArgKind Kind;
+            uint32_t Bytes;             // 整数的原始字节数
+            uint64_t Bits;
+            const void* Text;           // 字符串参数的内联副本
+        };
+
+        bool ReadArg(const uint8_t*& p, Arg& arg) noexcept
+        {
+            const uint8_t tag = *p++;
+            arg.Kind = static_cast<ArgKind>(tag & 0x0F);
+            arg.Bytes = tag >> 4;
+            arg.Text = nullptr;
+            arg.Bits = 0;
+
+            switch (arg.Kind)
+            {
+                case ArgKind::String:
+                {
+                    const uint16_t length = ReadValue<uint16_t>(p);
+                    arg.Text = p;
+                    p += length + 1;
+                    return true;
+                }
+                case ArgKind::WideString:
+                {
+                    const uint16_t length = ReadValue<uint16_t>(p);
+                    arg.Text = p;
+                    p += (length + 1) * sizeof(wchar_t);
+                    return true;
+                }
+                case ArgKind::Int:
+                case ArgKind::UInt:
+                case ArgKind::Double:
+                case ArgKind::Pointer:
+                    arg.Bits = ReadValue<uint64_t>(p);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // 整数按原宽度截断后再按转换符的符号解释，与 printf 对原始参数的处理一致
+        uint64_t Truncate(const Arg& arg) noexcept
+        {
+            return arg.Bytes == 0 || arg.Bytes >= 8 ? arg.Bits : arg.Bits & ((1ull << (arg.Bytes * 8)) - 1);
+        }
+
+        int64_t SignExtend(const Arg& arg) noexcept
+        {
+            if (arg.Bytes == 0 || arg.Bytes >= 8) return static_cast<int64_t>(arg.Bits);
+            const unsigned shift = 64 - arg.Bytes * 8;
+            return static_cast<int64_t>(arg.Bits << shift) >> shift;
+        }
+
+        double AsDouble(const Arg& arg) noexcept
+        {
+            switch (arg.Kind)
+            {
+                case ArgKind::Double: { double value; std::memcpy(&value, &arg.Bits, sizeof(value)); return value; }
+                case ArgKind::Int: return static_cast<double>(static_cast<int64_t>(arg.Bits));
+                default: return static_cast<double>(arg.Bits);
+            }
+        }
+
+        // 在消费线程上格式化一条记录：逐个解析格式说明符，去掉长度修饰后以参数的实际类型调用 snprintf
+        // 参数缺失或类型与说明符不兼容时输出占位符，不会像 printf 那样读取错误的栈内容
+        void FormatRecord(const RecordHeader& header, const uint8_t* args, std::string& out)
+        {
+            Arg values[255];
+            uint32_t count = 0;
+            for (; count < header.ArgCount; ++count)
+            {
+                if (!ReadArg(args, values[count])) break;
+            }
+
+            // 已格式化的消息 (DebugPrintEx)
+            if (!header.Format)
+            {
+                if (count > 0 && values[0].Kind == ArgKind::String) out.append(static_cast<const char*>(values[0].Text));
+                return;
+            }
+
+            uint32_t next = 0;
+            const char* f = header.Format;
+
+            while (*f)
+            {
+                if (*f != '%')
+                {
+                    const char* literal = f;
+                    while (*f && *f != '%') ++f;
+                    out.append(literal, f - literal);
+                    continue;
+                }
+
+                if (f[1] == '%')
+                {
+                    out.push_back('%');
+                    f += 2;
+                    continue;
+                }
+
+                // %[flags][width][.precision][length]conversion，'*' 宽度与精度从参数中取出并内联
+                char spec[64];
+                size_t length = 0;
+                spec[length++] = *f++;
+
+                auto appendStar = [&]()
+                    {
+                        long long value = next < count ? SignExtend(values[next]) : 0;
+                        ++next;
+                        length += std::snprintf(spec + length, 21, "%lld", value);
+                    };
+
+                // 各部分限长 (标志 5、宽度与精度各 20)，加上长度修饰与转换符不超过 spec 的容量
+                while (*f && std::strchr("-+ #0", *f) && length < 6) spec[length++] = *f++;
+                if (*f == '*') { appendStar(); ++f; }
+                else for (size_t digits = 0; *f >= '0' && *f <= '9'; ++f) if (digits++ < 10) spec[length++] = *f;
+
+                if (*f == '.')
+                {
+                    spec[length++] = *f++;
+                    if (*f == '*') { appendStar(); ++f; }
+                    else for (size_t digits = 0; *f >= '0' && *f <= '9'; ++f) if (digits++ < 10) spec[length++] = *f;
+                }
+
+                // 长度修饰：参数已按实际类型记录，只保留区分宽字符串所需的 l / w
+                bool wide = false;
+                while (*f && std::strchr("hlLqjztwI", *f))
+                {
+                    if (*f == 'l' || *f == 'w') wide = true;
+                    if (*f == 'I') { ++f; while (*f >= '0' && *f <= '9') ++f; continue; }
+                    ++f;
+                }
+
+                const char conversion = *f;
+                if (!conversion) break;
+                ++f;
+
+                if (next >= count)
+                {
+                    out.append("(missing)");
+                    continue;
+                }
+
+                const Arg& arg = values[next++];
+                const bool numeric = arg.Kind == ArgKind::Int || arg.Kind == ArgKind::UInt || arg.Kind == ArgKind::Pointer;
+
+                switch (conversion)
+                {
+                    case 'd': case 'i':
+                        if (!numeric) { out.append("(?)"); break; }
+                        std::memcpy(spec + length, "lld", 4);
+                        AppendFormatted(out, spec, static_cast<long long>(arg.Kind == ArgKind::Int ? SignExtend(arg) : static_cast<int64_t>(Truncate(arg))));
+                        break;
+
+                    case 'u': case 'x': case 'X': case 'o':
+                        if (!numeric) { out.append("(?)"); break; }
+                        spec[length] = 'l'; spec[length + 1] = 'l'; spec[length + 2] = conversion; spec[length + 3] = 0;
+                        AppendFormatted(out, spec, static_cast<unsigned long long>(Truncate(arg)));
+                        break;
+
+                    case 'c':
+                        if (!numeric) { out.append("(?)"); break; }
+                        spec[length] = 'c'; spec[length + 1] = 0;
+                        AppendFormatted(out, spec, static_cast<int>(arg.Bits));
+                        break;
+
+                    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                        if (arg.Kind == ArgKind::String || arg.Kind == ArgKind::WideString) { out.append("(?)"); break; }
+                        spec[length] = conversion; spec[length + 1] = 0;
+                        AppendFormatted(out, spec, AsDouble(arg));
+                        break;
+
+                    case 'p':
+                        spec[length] = 'p'; spec[length + 1] = 0;
+                        AppendFormatted(out, spec, reinterpret_cast<const void*>(static_cast<uintptr_t>(arg.Bits)));
+                        break;
+
+                    case 's': case 'S':
+                        // MSVC 的 %S 与 %ls 表示宽字符串
+                        if (arg.Kind == ArgKind::WideString && (wide || conversion == 'S'))
+                        {
+                            std::memcpy(spec + length, "ls", 3);
+                            AppendFormatted(out, spec, static_cast<const wchar_t*>(arg.Text));
+                        }
+                        else if (arg.Kind == ArgKind::String)
+                        {
+                            spec[length] = 's'; spec[length + 1] = 0;
+                            AppendFormatted(out, spec, static_cast<const char*>(arg.Text));
+                        }
+                        else
+                        {
+                            out.append("(?)");
+                        }
+                        break;
+
+                    default:
+                        // %n 等不支持的转换符原样跳过
+                        break;
+                }
+            }
+        }
+
+        void Deliver(LoggerState& state, uint32_t level, const char* message)
+        {
+#if defined(_WIN32)
+            OutputDebugStringA(message);
+#endif
+            if (Callback callback = state.Dispatch.load(std::memory_order_acquire))
+            {
+                callback(static_cast<Utils::LogLevel>(level), message);
+            }
+        }
+
+        // 调用方持有 DrainMutex
+        void DrainLocked(LoggerState& state)
+        {
+            {
+                std::lock_guard<std::mutex> lock(state.RingsMutex);
+                state.Snapshot = state.Rings;
+            }
+
+            state.Entries.clear();
+            state.Text.clear();
+            uint64_t dropped = 0;
+
+            for (LogRing* ring : state.Snapshot)
+            {
+                dropped += ring->Dropped();
+                ring->Drain([&](const uint8_t* record)
+                    {
+                        RecordHeader header;
+                        std::memcpy(&header, record, sizeof(header));
+
+                        const size_t offset = state.Text.size();
+                        FormatRecord(header, record + sizeof(header), state.Text);
+                        state.Text.push_back('\0');
+                        state.Entries.push_back({ header.Timestamp, header.Level, offset });
+                    });
+            }
+
+            // 各线程的记录各自有序，合并后按时间排序，保持跨线程的先后关系
+            std::stable_sort(state.Entries.begin(), state.Entries.end(), [](const Entry& a, const Entry& b)
+                {
+                    return a.Timestamp < b.Timestamp;
+                });
+
+            for (const Entry& entry : state.Entries)
+            {
+                Deliver(state, entry.Level, state.Text.data() + entry.Offset);
+            }
+
+            if (dropped > state.ReportedDropped)
+            {
+                char message[128];
+                std::snprintf(message, sizeof(message), "日志缓冲区已满，丢弃了 %llu 条日志",
+                    static_cast<unsigned long long>(dropped - state.ReportedDropped));
+                state.ReportedDropped = dropped;
+                Deliver(state, static_cast<uint32_t>(Utils::LogLevel::Warn), message);
+            }
+        }
+
+        void ConsumerProc()
+        {
+            LoggerState& state = State();
+
+            while (true)
+            {
+                bool stopping = false;
+                {
+                    std::unique_lock<std::mutex> lock(state.WakeMutex);
+                    state.Wakeup.wait(lock, [&state] { return state.Pending || state.Stopping; });
+                    state.Pending = false;
+                    stopping = state.Stopping;
+                }
+
+                std::lock_guard<std::mutex> lock(state.DrainMutex);
+                DrainLocked(state);
+
+                if (stopping) return;
+            }
+        }
+    }
+
+    LogRing* RegisterCurrentThread()
+    {
+        if (ThreadExiting) return nullptr;
+
+        thread_local RingOwner owner;
+        if (owner.Ring) return owner.Ring;
+
+        LoggerState& state = State();
+        std::lock_guard<std::mutex> lock(state.RingsMutex);
+
+        // 优先复用已退出线程留下的空缓冲区，线程池反复创建线程时内存不会增长
+        for (LogRing* ring : state.Rings)
+        {
+            if (ring->Abandoned.load(std::memory_order_acquire) && ring->IsEmpty())
+            {
+                ring->Abandoned.store(false, std::memory_order_relaxed);
+                owner.Ring = ring;
+                break;
+            }
+        }
+
+        if (!owner.Ring)
+        {
+            owner.Ring = new (std::nothrow) LogRing();
+            if (!owner.Ring) return nullptr;
+            state.Rings.push_back(owner.Ring);
+        }
+
+        // 首条日志可能来自 DllMain，此时只创建线程而不等待它；线程由 Shutdown (托管端进程退出时) 停止并等待
+        if (!state.Started)
+        {
+            state.Started = true;
+            state.Consumer = std::thread(ConsumerProc);
+        }
+
+        Detail::ThreadRing = owner.Ring;
+        return owner.Ring;
+    }
+
+    void WakeConsumer()
+    {
+        LoggerState& state = State();
+        {
+            std::lock_guard<std::mutex> lock(state.WakeMutex);
+            state.Pending = true;
+        }
+        state.Wakeup.notify_one();
+    }
+
+    void Flush()
+    {
+        LoggerState& state = State();
+        std::lock_guard<std::mutex> lock(state.DrainMutex);
+        DrainLocked(state);
+    }
+
+    void Shutdown()
+    {
+        LoggerState& state = State();
+
+        std::thread consumer;
+        {
+            std::lock_guard<std::mutex> lock(state.RingsMutex);
+            consumer = std::move(state.Consumer);
+        }
+
+        if (consumer.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(state.WakeMutex);
+                state.Stopping = true;
+            }
+            state.Wakeup.notify_one();
+            consumer.join();
+        }
+
+        // 消费线程最后一次排空之后提交的记录
+        Flush();
+    }
+
+    void SetCallback(Callback callback)
+    {
+        State().Dispatch.store(callback, std::memory_order_release);
+    }
+
+    uint64_t DroppedCount()
+    {
+        LoggerState& state = State();
+        std::lock_guard<std::mutex> lock(state.RingsMutex);
+
+        uint64_t dropped = 0;
+        for (const LogRing* ring : state.Rings) dropped += ring->Dropped();
+        return dropped;
+    }
+}
@@ -0,0 +1,385 @@
+﻿#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cwchar>
+#include <type_traits>
+#include "LogRateLimiter.h"
+
+// 编译期最低日志级别 (Utils::LogLevel 的数值)：低于它的 LOG_* 调用点连同参数求值一起被编译掉
+// 未定义时 Debug 构建保留全部级别，Release 构建从 Info 开始
+#ifndef IRONSIGHT_LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define IRONSIGHT_LOG_MIN_LEVEL 0
+#else
+#define IRONSIGHT_LOG_MIN_LEVEL 2
+#endif
+#endif
+
+namespace Utils
+{
+	enum class LogLevel : uint32_t;
+}
+
+namespace IronSight::Core::Native::Logging
+{
+	/// <summary>
+	/// 记录中参数的类型 (低 4 位) 与原始整数字节数 (高 4 位)
+	/// </summary>
+	enum class ArgKind : uint8_t
+	{
+		Int = 1,            // 有符号整数 (按原宽度符号扩展为 int64)
+		UInt = 2,           // 无符号整数
+		Double = 3,
+		Pointer = 4,
+		String = 5,         // UTF-8 / ANSI 字符串，内联复制 (uint16 长度 + 字节 + '\0')
+		WideString = 6      // 宽字符串，内联复制 (uint16 字符数 + 字符 + L'\0')
+	};
+
+	/// <summary>
+	/// 环形缓冲区中的一条日志记录头，之后依次是各参数 (1 字节类型 + 负载)
+	/// Size 为 0 表示缓冲区末尾的回绕标记
+	/// </summary>
+	struct RecordHeader
+	{
+		uint32_t Size;              // 含头部与对齐填充的总字节数
+		uint8_t Level;
+		uint8_t ArgCount;
+		uint16_t Reserved;
+		const char* Format;         // 静态存储期的格式串；为空时唯一的字符串参数即为已格式化的消息
+		int64_t Timestamp;          // steady_clock 计数，合并多个线程的记录时排序用
+	};
+
+	/// <summary>
+	/// 单生产者单消费者的日志环形缓冲区 (每个线程一个)
+	/// 生产者只写 _head，消费者只写 _tail，二者都不加锁；空间不足时丢弃记录并计数，从不阻塞调用线程
+	/// 消费者开始排空后的第一条记录负责唤醒消费线程，之后的记录只写缓冲区，直到下一次排空
+	/// </summary>
+	class LogRing
+	{
+		public:
+		static constexpr size_t Capacity = 64 * 1024;
+		static constexpr size_t Mask = Capacity - 1;
+
+		/// <summary>
+		/// 预留 size 字节 (已按 8 字节对齐) 的连续空间，空间不足时返回 nullptr
+		/// </summary>
+		uint8_t* Reserve(size_t size) noexcept
+		{
+			const uint64_t head = _head.load(std::memory_order_relaxed);
+			const uint64_t tail = _tail.load(std::memory_order_acquire);
+
+			const size_t offset = static_cast<size_t>(head & Mask);
+			const size_t contiguous = Capacity - offset;
+			const size_t needed = size <= contiguous ? size : contiguous + size;
+
+			if (size > Capacity / 2 || head + needed - tail > Capacity)
+			{
+				_dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			if (size > contiguous)
+			{
+				// 末尾放不下整条记录：写入回绕标记，从头开始
+				const uint32_t marker = 0;
+				std::memcpy(_buffer + offset, &marker, sizeof(marker));
+				_pending = head + contiguous + size;
+				return _buffer;
+			}
+
+			_pending = head + size;
+			return _buffer + offset;
+		}
+
+		/// <summary>
+		/// 发布最近一次 Reserve 的记录
+		/// </summary>
+		/// <returns>是否为上次排空后的第一条记录 (调用方需唤醒消费线程)</returns>
+		bool Commit() noexcept
+		{
+			// 与 Drain 中先清标记、再读 _head 的顺序配对 (均为顺序一致)：
+			// 消费者要么读到这条记录，要么在此之前已清除标记，由本次 exchange 负责唤醒
+			_head.store(_pending, std::memory_order_seq_cst);
+			return !_signaled.exchange(true, std::memory_order_seq_cst);
+		}
+
+		/// <summary>
+		/// 消费者：依次处理已发布的记录，返回处理的条数
+		/// </summary>
+		template <typename Callback>
+		size_t Drain(Callback&& callback)
+		{
+			_signaled.store(false, std::memory_order_seq_cst);
+
+			uint64_t tail = _tail.load(std::memory_order_relaxed);
+			const uint64_t head = _head.load(std::memory_order_seq_cst);
+			size_t count = 0;
+
+			while (tail != head)
+			{
+				const size_t offset = static_cast<size_t>(tail & Mask);
+
+				uint32_t size = 0;
+				std::memcpy(&size, _buffer + offset, sizeof(size));
+
+				if (size == 0)
+				{
+					tail += Capacity - offset;
+					continue;
+				}
+
+				callback(_buffer + offset);
+				tail += size;
+				++count;
+			}
+
+			_tail.store(tail, std::memory_order_release);
+			return count;
+		}
+
+		/// <summary>
+		/// 累计丢弃的记录数 (只增不减)
+		/// </summary>
+		uint64_t Dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+
+		bool IsEmpty() const noexcept
+		{
+			return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// 所属线程已退出 (缓冲区排空后由消费者回收)
+		/// </summary>
+		std::atomic<bool> Abandoned{ false };
+
+		private:
+		alignas(64) std::atomic<uint64_t> _head{ 0 };
+		uint64_t _pending = 0;
+		std::atomic<uint64_t> _dropped{ 0 };
+		std::atomic<bool> _signaled{ false };   // 上次排空后已有记录发出唤醒
+		alignas(64) std::atomic<uint64_t> _tail{ 0 };
+		alignas(64) uint8_t _buffer[Capacity];
+	};
+
+	/// <summary>
+	/// 当前线程的环形缓冲区 (首次调用时创建并登记，同时确保后台消费线程已启动)
+	/// 线程的 thread_local 析构开始后返回 nullptr：缓冲区已交还，可能正被其他线程复用
+	/// </summary>
+	LogRing* RegisterCurrentThread();
+
+	namespace Detail
+	{
+		// 当前线程已登记的缓冲区，缓冲区交还时由登记方清空
+		inline thread_local LogRing* ThreadRing = nullptr;
+	}
+
+	inline LogRing* CurrentRing()
+	{
+		LogRing* ring = Detail::ThreadRing;
+		return ring ? ring : RegisterCurrentThread();
+	}
+
+	/// <summary>
+	/// 唤醒后台消费线程 (LogRing::Commit 返回 true 时调用)
+	/// </summary>
+	void WakeConsumer();
+
+	/// <summary>
+	/// 同步处理所有线程中已提交的记录 (在调用线程上格式化与分发)
+	/// </summary>
+	void Flush();
+
+	/// <summary>
+	/// 停止并等待后台消费线程，再同步处理剩余的记录。不能在 DllMain 中调用 (持有加载器锁时无法等待线程)
+	/// 之后的日志只在 Flush 时送达
+	/// </summary>
+	void Shutdown();
+
+	/// <summary>
+	/// 设置分发回调 (在消费线程上调用，为空时只输出到调试器)
+	/// </summary>
+	void SetCallback(void(__stdcall* callback)(Utils::LogLevel level, const char* message));
+
+	/// <summary>
+	/// 累计丢弃的记录数
+	/// </summary>
+	uint64_t DroppedCount();
+
+	/// <summary>
+	/// 级别是否被编译进来 (LOG_* 宏以 if constexpr 判断)
+	/// </summary>
+	constexpr bool IsCompiledIn(Utils::LogLevel level) noexcept
+	{
+		return static_cast<uint32_t>(level) >= IRONSIGHT_LOG_MIN_LEVEL;
+	}
+
+	namespace Detail
+	{
+		// 字符串参数内联复制的上限 (与 DebugPrintEx 的格式化缓冲区相同)，超出部分截断
+		constexpr size_t MaxStringBytes = 4096;
+		constexpr const char* NullText = "(null)";
+
+		template <typename T>
+		struct DependentFalse : std::false_type {};
+
+		template <typename T>
+		constexpr bool IsNarrowString = std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+		template <typename T>
+		constexpr bool IsWideString = std::is_same_v<T, const wchar_t*> || std::is_same_v<T, wchar_t*>;
+
+		// 参数编码后的字节数 (字符串需要 strlen)
+		template <typename T>
+		inline size_t ArgSize(const T& value) noexcept
+		{
+			if constexpr (IsNarrowString<T>)
+			{
+				const size_t length = (std::min)(std::strlen(value ? value : NullText), MaxStringBytes);
+				return 1 + sizeof(uint16_t) + length + 1;
+			}
+			else if constexpr (IsWideString<T>)
+			{
+				const size_t length = value ? (std::min)(std::wcslen(value), MaxStringBytes / sizeof(wchar_t)) : 0;
+				return 1 + sizeof(uint16_t) + (length + 1) * sizeof(wchar_t);
+			}
+			else
+			{
+				return 1 + sizeof(uint64_t);
+			}
+		}
+
+		inline uint8_t* WriteKind(uint8_t* p, ArgKind kind, size_t bytes) noexcept
+		{
+			*p = static_cast<uint8_t>(static_cast<uint8_t>(kind) | (bytes << 4));
+			return p + 1;
+		}
+
+		template <typename T>
+		inline uint8_t* WriteArg(uint8_t* p, const T& value) noexcept
+		{
+			if constexpr (IsNarrowString<T>)
+			{
+				const char* text = value ? value : NullText;
+				const uint16_t length = static_cast<uint16_t>((std::min)(std::strlen(text), MaxStringBytes));
+				p = WriteKind(p, ArgKind::String, 0);
+				std::memcpy(p, &length, sizeof(length));
+				std::memcpy(p + sizeof(length), text, length);
+				p[sizeof(length) + length] = 0;
+				return p + sizeof(length) + length + 1;
+			}
+			else if constexpr (IsWideString<T>)
+			{
+				const uint16_t length = static_cast<uint16_t>(value ? (std::min)(std::wcslen(value), MaxStringBytes / sizeof(wchar_t)) : 0);
+				const wchar_t terminator = 0;
+				p = WriteKind(p, ArgKind::WideString, 0);
+				std::memcpy(p, &length, sizeof(length));
+				if (length > 0) std::memcpy(p + sizeof(length), value, length * sizeof(wchar_t));
+				std::memcpy(p + sizeof(length) + length * sizeof(wchar_t), &terminator, sizeof(terminator));
+				return p + sizeof(length) + (length + 1) * sizeof(wchar_t);
+			}
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				const double number = static_cast<double>(value);
+				p = WriteKind(p, ArgKind::Double, sizeof(double));
+				std::memcpy(p, &number, sizeof(number));
+				return p + sizeof(number);
+			}
+			else if constexpr (std::is_enum_v<T>)
+			{
+				return WriteArg(p, static_cast<std::underlying_type_t<T>>(value));
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				const uint64_t bits = std::is_signed_v<T>
+					? static_cast<uint64_t>(static_cast<int64_t>(value))
+					: static_cast<uint64_t>(value);
+				p = WriteKind(p, std::is_signed_v<T> ? ArgKind::Int : ArgKind::UInt, sizeof(T));
+				std::memcpy(p, &bits, sizeof(bits));
+				return p + sizeof(bits);
+			}
+			else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+			{
+				const uint64_t bits = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(static_cast<const void*>(value)));
+				p = WriteKind(p, ArgKind::Pointer, sizeof(void*));
+				std::memcpy(p, &bits, sizeof(bits));
+				return p + sizeof(bits);
+			}
+			else
+			{
+				static_assert(DependentFalse<T>::value, "Unsupported log argument type");
+				return p;
+			}
+		}
+
+		// 字符数组 (字面量) 退化为指针，其余参数按值传递
+		template <typename T>
+		inline auto Decay(const T& value) noexcept
+		{
+			if constexpr (std::is_array_v<T>) return static_cast<const std::remove_extent_t<T>*>(value);
+			else return value;
+		}
+
+		inline int64_t Now() noexcept
+		{
+			return static_cast<int64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+		}
+
+		inline std::atomic<uint32_t> MinimumLevel{ 0 };
+	}
+
+	/// <summary>
+	/// 设置运行时最低级别：低于它的日志在求值参数、写入缓冲区之前即被丢弃
+	/// </summary>
+	inline void SetMinimumLevel(Utils::LogLevel level) noexcept
+	{
+		Detail::MinimumLevel.store(static_cast<uint32_t>(level), std::memory_order_relaxed);
+	}
+
+	inline bool IsEnabled(Utils::LogLevel level) noexcept
+	{
+		return static_cast<uint32_t>(level) >= Detail::MinimumLevel.load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// 异步记录一条日志：只把级别、时间、格式串指针与原始参数写入当前线程的环形缓冲区，
+	/// 格式化、输出到调试器与调用托管回调都在后台消费线程上批量进行。缓冲区已满时丢弃并计数
+	/// format 必须是字符串字面量 (消费线程稍后才读取它)
+	/// </summary>
+	template <typename... Args>
+	inline void Log(Utils::LogLevel level, const char* format, const Args&... args) noexcept
+	{
+		static_assert(sizeof...(Args) < 256, "Too many log arguments");
+
+		LogRing* ring = CurrentRing();
+		if (!ring) return;
+
+		size_t size = sizeof(RecordHeader);
+		((size += Detail::ArgSize(Detail::Decay(args))), ...);
+		size = (size + 7) & ~static_cast<size_t>(7);
+
+		uint8_t* p = ring->Reserve(size);
+		if (!p) return;
+
+		RecordHeader header{ static_cast<uint32_t>(size), static_cast<uint8_t>(level), static_cast<uint8_t>(sizeof...(Args)), 0, format, Detail::Now() };
+		std::memcpy(p, &header, sizeof(header));
+		p += sizeof(header);
+		((p = Detail::WriteArg(p, Detail::Decay(args))), ...);
+
+		if (ring->Commit()) WakeConsumer();
+	}
+
+	/// <summary>
+	/// 经调用点限流器放行后记录一条日志；若此前有记录被抑制，先补一条汇总 (含原格式串以标明调用点)
+	/// </summary>
+	template <typename... Args>
+	inline void LogLimited(LogRateLimiter& limiter, Utils::LogLevel level, const char* format, const Args&... args) noexcept
+	{
+		uint32_t suppressed = 0;
+		if (!limiter.TryAcquire(Detail::Now(), suppressed)) return;
+
+		if (suppressed != 0) Log(level, "以下位置的日志过于频繁，已抑制 %u 条: %s", suppressed, format);
+		Log(level, format, args...);
+	}
+}
@@ -0,0 +1,44 @@
+﻿#pragma once
+
+// 日志级别、回调签名与 LOG_* 宏 (不依赖平台头文件，跨平台模块包含此文件而不是 Utilities.h)
+namespace Utils
+{
+	// 显式继承 uint32_t 确保与 C# UInt32 对齐
+	enum class LogLevel : uint32_t
+	{
+		Trace = 0,
+		Debug = 1,
+		Info = 2,
+		Warn = 3,
+		Error = 4,
+		Fatal = 5
+	};
+
+	// 回调签名：使用 __stdcall (WinAPI 标准) 确保堆栈平衡
+	typedef void(__stdcall* LogDispatcherCallback)(LogLevel level, const char* message);
+}
+
+#include "AsyncLogger.h"
+
+// 定义便捷宏，方便在 C++ 内部调用
+// 只把格式串指针与原始参数写入当前线程的日志缓冲区，格式化与分发在后台日志线程上进行 (fmt 必须是字符串字面量)
+// 级别先经编译期 (IRONSIGHT_LOG_MIN_LEVEL) 与运行时 (SetLogLevel) 过滤，未启用时不求值参数；
+// 每个调用点各有一个令牌桶限流器，持续触发的调用点 (如每个采样周期都失败的计数器) 不会淹没托管回调
+#define IRONSIGHT_LOG_AT(level, fmt, ...) \
+	do \
+	{ \
+		if constexpr (IronSight::Core::Native::Logging::IsCompiledIn(level)) \
+		{ \
+			static IronSight::Core::Native::Logging::LogRateLimiter logSiteLimiter_; \
+			if (IronSight::Core::Native::Logging::IsEnabled(level)) \
+				IronSight::Core::Native::Logging::LogLimited(logSiteLimiter_, level, fmt, ##__VA_ARGS__); \
+		} \
+	} while (0)
+
+#define LOG_TRACE(fmt, ...) IRONSIGHT_LOG_AT(Utils::LogLevel::Trace, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...) IRONSIGHT_LOG_AT(Utils::LogLevel::Debug, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  IRONSIGHT_LOG_AT(Utils::LogLevel::Info,  fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  IRONSIGHT_LOG_AT(Utils::LogLevel::Warn,  fmt, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) IRONSIGHT_LOG_AT(Utils::LogLevel::Error, fmt, ##__VA_ARGS__)
+// 致命错误不过滤、不限流；之后进程可能随即终止，立即同步分发
+#define LOG_FATAL(fmt, ...) (IronSight::Core::Native::Logging::Log(Utils::LogLevel::Fatal, fmt, ##__VA_ARGS__), IronSight::Core::Native::Logging::Flush())
@@ -0,0 +1,51 @@
+﻿#pragma once
+#include <atomic>
+#include <chrono>
+
+namespace IronSight::Core::Native::Logging
+{
+	/// <summary>
+	/// 单个日志调用点的令牌桶限流器 (LOG_* 宏为每个调用点定义一个静态实例)
+	/// 以 GCRA 形式实现：只保存一个 "理论到达时间"，CAS 更新，无锁且可常量初始化。
+	/// 允许突发 Burst 条，之后每 Interval 恢复一条；被拒绝的次数累计，在下一条放行时一并取出用于汇总
+	/// </summary>
+	class LogRateLimiter
+	{
+		public:
+		static constexpr uint32_t Burst = 5;
+		static constexpr std::chrono::steady_clock::duration Interval = std::chrono::seconds(10);
+
+		constexpr LogRateLimiter() noexcept = default;
+
+		/// <summary>
+		/// 尝试放行一条日志
+		/// </summary>
+		/// <param name="now">当前 steady_clock 计数</param>
+		/// <param name="suppressed">放行时返回自上次放行以来被抑制的条数</param>
+		bool TryAcquire(int64_t now, uint32_t& suppressed) noexcept
+		{
+			constexpr int64_t interval = Interval.count();
+			constexpr int64_t tolerance = interval * (Burst - 1);
+
+			int64_t arrival = _arrival.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				const int64_t next = (arrival > now ? arrival : now) + interval;
+				if (next - now > tolerance + interval)
+				{
+					_suppressed.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+
+				if (_arrival.compare_exchange_weak(arrival, next, std::memory_order_relaxed)) break;
+			}
+
+			suppressed = _suppressed.load(std::memory_order_relaxed) != 0 ? _suppressed.exchange(0, std::memory_order_relaxed) : 0;
+			return true;
+		}
+
+		private:
+		std::atomic<int64_t> _arrival{ 0 };
+		std::atomic<uint32_t> _suppressed{ 0 };
+	};
+}
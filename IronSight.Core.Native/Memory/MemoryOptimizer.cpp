@@ -1,107 +1,140 @@
 ﻿#include <pch.h>
 #include "MemoryOptimizer.h"
+#include "MemoryPressureWatcher.h"
 #include "Utilities.h"
+#include "System/SystemProcessSnapshot.h"
 #include <algorithm>
+#include <mutex>
 
 namespace IronSight::Core::Native::Memory
 {
-	CleanupResult MemoryOptimizer::ExecuteGlobalCleanup()
+	namespace
 	{
-		LOG_INFO("--- 开始全局内存优化任务 ---");
-		CleanupResult result = { 0, 0 };
-		DWORD processes[2048], cbNeeded;
+		// 与性能快照、进程列表共享的枚举结果在此时长内直接复用
+		constexpr uint32_t SnapshotMaxAgeMs = 500;
+
+		// 排名状态：速率基准与跨调用复用的缓冲 (刻意不析构)
+		struct RankingState
+		{
+			std::mutex Mutex;
+			TopConsumerRanking Ranking;
+			uint64_t Generation = 0;
+		};
 
-		if (!EnumProcesses(processes, sizeof(processes), &cbNeeded))
+		RankingState& SharedRanking()
 		{
-			LOG_ERROR("无法获取进程列表，错误代码: %lu", GetLastError());
-			return result;
+			static RankingState* state = new RankingState();
+			return *state;
 		}
 
-		DWORD count = cbNeeded / sizeof(DWORD);
-		for (DWORD i = 0; i < count; i++)
+		// 回收这些进程的工作集只会立即引起缺页 (界面卡顿、音频断续)，却释放不了多少内存
+		constexpr const char* DefaultProtectedNames[] =
 		{
-			if (processes[i] == 0) continue;
+			"System", "Registry", "Memory Compression", "csrss.exe", "dwm.exe", "audiodg.exe"
+		};
 
-			HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_SET_QUOTA, FALSE, processes[i]);
-			if (hProcess)
-			{
-				PROCESS_MEMORY_COUNTERS pmc;
-				if (GetProcessMemoryInfo(hProcess, &pmc, sizeof(pmc)))
+		// 回收引擎 (刻意不析构)；当前平台没有回收实现时为 nullptr
+		WorkingSetTrimmer* SharedTrimmer()
+		{
+			static WorkingSetTrimmer* trimmer = []() -> WorkingSetTrimmer*
 				{
-					SIZE_T before = pmc.WorkingSetSize;
-
-					if (EmptyWorkingSet(hProcess))
+					ITrimBackend* backend = ITrimBackend::CreateDefault().release();
+					if (!backend)
 					{
-						if (GetProcessMemoryInfo(hProcess, &pmc, sizeof(pmc)))
-						{
-							SIZE_T released = (before > pmc.WorkingSetSize) ? (before - pmc.WorkingSetSize) : 0;
-
-							// 策略：只有释放超过 1MB 的进程才记录 DEBUG 详情，避免刷屏
-							if (released > 1024 * 1024)
-							{
-								LOG_DEBUG("大幅优化进程 PID: %u, 释放: %.2f MB", processes[i], released / (1024.0 * 1024.0));
-							}
-
-							result.TotalBytesReleased += released;
-							result.ProcessedProcesses++;
-						}
+						LOG_ERROR("当前平台不支持工作集回收");
+						return nullptr;
 					}
-				}
-				CloseHandle(hProcess);
-			}
-		} // 循环在这里结束
 
-		  // --- 修复：移出循环外，只在真正完成后打印一次 ---
-		LOG_INFO("优化完成。处理进程: %u, 总释放: %.2f MB",
-			result.ProcessedProcesses,
-			result.TotalBytesReleased / (1024.0 * 1024.0));
+					auto* created = new WorkingSetTrimmer(*backend);
+					for (const char* name : DefaultProtectedNames) created->Protect(name);
+					return created;
+				}();
+			return trimmer;
+		}
+	}
+
+	CleanupResult MemoryOptimizer::ExecuteGlobalCleanup()
+	{
+		TrimResult trim = TrimWorkingSets(TrimOptions{});
+		return { trim.TrimmedProcesses, static_cast<long long>(trim.ReleasedBytes) };
+	}
+
+	TrimResult MemoryOptimizer::TrimWorkingSets(const TrimOptions& options)
+	{
+		LOG_INFO("--- 开始全局内存优化任务 ---");
+
+		WorkingSetTrimmer* trimmer = SharedTrimmer();
+		if (!trimmer) return TrimResult{};
+
+		TrimResult result = trimmer->Run(options);
+
+		LOG_INFO("优化完成。处理进程: %u, 跳过: %u, 失败: %u, 总释放: %.2f MB (预计 %.2f MB), 耗时 %.1f ms",
+			result.TrimmedProcesses,
+			result.SkippedProcesses,
+			result.FailedProcesses,
+			result.ReleasedBytes / (1024.0 * 1024.0),
+			result.ExpectedBytes / (1024.0 * 1024.0),
+			result.ElapsedMicroseconds / 1000.0);
 
 		return result;
 	}
 
+	void MemoryOptimizer::ProtectProcess(std::string_view name)
+	{
+		if (WorkingSetTrimmer* trimmer = SharedTrimmer()) trimmer->Protect(name);
+	}
+
+	void MemoryOptimizer::ClearProtectedProcesses()
+	{
+		if (WorkingSetTrimmer* trimmer = SharedTrimmer()) trimmer->ClearProtected();
+	}
+
+	// 监视器本身与平台无关；全局实例在此绑定平台默认的压力数据源与 MemoryOptimizer 的回收
+	MemoryPressureWatcher& MemoryPressureWatcher::Shared()
+	{
+		static MemoryPressureWatcher* watcher = new MemoryPressureWatcher(&IPressureSource::CreateDefault, &MemoryOptimizer::TrimWorkingSets);
+		return *watcher;
+	}
+
 	std::vector<ProcessInfo> MemoryOptimizer::GetTopMemoryConsumers(int topN)
 	{
 		std::vector<ProcessInfo> v;
-		DWORD processes[1024], cbNeeded;
+		if (topN <= 0) return v;
 
-		if (!EnumProcesses(processes, sizeof(processes), &cbNeeded)) return v;
+		std::vector<ConsumerInfo> consumers(static_cast<size_t>(topN));
+		int count = GetTopConsumers(ConsumerMetric::WorkingSet, consumers.data(), topN);
 
-		DWORD count = cbNeeded / sizeof(DWORD);
-		for (DWORD i = 0; i < count; i++)
+		v.reserve(count);
+		for (int i = 0; i < count; i++)
 		{
-			if (processes[i] == 0) continue;
-
-			HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processes[i]);
-			if (hProcess)
-			{
-				ProcessInfo info;
-				info.Pid = processes[i];
+			v.push_back({ consumers[i].Pid, consumers[i].NameId, consumers[i].WorkingSetMB });
+		}
+		return v;
+	}
 
-				PROCESS_MEMORY_COUNTERS pmc;
-				if (GetProcessMemoryInfo(hProcess, &pmc, sizeof(pmc)))
-				{
-					info.WorkingSetMB = pmc.WorkingSetSize / (1024.0 * 1024.0);
+	int MemoryOptimizer::GetTopConsumers(ConsumerMetric metric, ConsumerInfo* buffer, int maxCount)
+	{
+		if (!buffer || maxCount <= 0) return 0;
 
-					// 获取进程名
-					if (GetModuleBaseNameA(hProcess, NULL, info.Name, sizeof(info.Name)) == 0)
-					{
-						strcpy_s(info.Name, "Unknown");
-					}
-					v.push_back(info);
-				}
-				CloseHandle(hProcess);
-			}
-		}
+		RankingState& state = SharedRanking();
+		std::lock_guard<std::mutex> lock(state.Mutex);
 
-		// 排序：从大到小
-		std::sort(v.begin(), v.end(), [](const ProcessInfo& a, const ProcessInfo& b)
+		// 一次系统调用取得全部进程的内存、CPU 与 IO 计数器及名称，不再逐进程打开句柄，也没有固定的进程数上限
+		// 在快照锁内就地排名：只保留入选的 (指标, 下标) 键，不复制整张进程表
+		size_t count = 0;
+		const bool visited = System::SystemProcessSnapshot::Shared().VisitSamples(SnapshotMaxAgeMs, state.Generation,
+			[&](const std::vector<System::ProcessSample>& samples, const System::SystemProcessSummary& summary)
 			{
-				return a.WorkingSetMB > b.WorkingSetMB;
+				state.Generation = summary.Generation;
+				count = state.Ranking.Rank(samples, summary.SystemTime, summary.SampleTick, metric, buffer, static_cast<size_t>(maxCount));
 			});
 
-		// 只保留前 topN 个
-		if (v.size() > (size_t)topN) v.resize(topN);
-		return v;
+		if (!visited)
+		{
+			LOG_ERROR("无法获取进程快照");
+			return 0;
+		}
+		return static_cast<int>(count);
 	}
 
 	extern "C"
@@ -112,6 +145,21 @@ namespace IronSight::Core::Native::Memory
 			return MemoryOptimizer::ExecuteGlobalCleanup();
 		}
 
+		TrimResult TrimSystemMemory(const TrimOptions* options)
+		{
+			return MemoryOptimizer::TrimWorkingSets(options ? *options : TrimOptions{});
+		}
+
+		void AddTrimProtectedName(const char* name)
+		{
+			if (name && *name) MemoryOptimizer::ProtectProcess(name);
+		}
+
+		void ClearTrimProtectedNames()
+		{
+			MemoryOptimizer::ClearProtectedProcesses();
+		}
+
 		int GetTopMemoryConsumers(ProcessInfo buffer[], int maxCount)
 		{
 			if (!buffer || maxCount <= 0) return 0;
@@ -127,5 +175,25 @@ namespace IronSight::Core::Native::Memory
 			LOG_TRACE("原生层：已填充 %d 个进程数据到缓冲区", actualCount);
 			return actualCount;
 		}
+
+		int GetTopConsumers(ConsumerMetric metric, ConsumerInfo buffer[], int maxCount)
+		{
+			return MemoryOptimizer::GetTopConsumers(metric, buffer, maxCount);
+		}
+
+		bool MemoryPressure_Start(const MemoryPressureOptions* options)
+		{
+			return MemoryPressureWatcher::Shared().Start(options ? *options : MemoryPressureOptions{});
+		}
+
+		void MemoryPressure_Stop()
+		{
+			MemoryPressureWatcher::Shared().Stop();
+		}
+
+		void MemoryPressure_GetStats(MemoryPressureStats* stats)
+		{
+			if (stats) MemoryPressureWatcher::Shared().GetStats(*stats);
+		}
 	}
 }
\ No newline at end of file
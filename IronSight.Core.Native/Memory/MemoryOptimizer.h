@@ -1,4 +1,7 @@
 ﻿#pragma once
+#include "TopConsumerRanking.h"
+#include "WorkingSetTrimmer.h"
+
 namespace IronSight::Core::Native::Memory 
 {
     struct CleanupResult 
@@ -11,8 +14,8 @@ namespace IronSight::Core::Native::Memory
     struct ProcessInfo
     {
         uint32_t Pid;
+        uint32_t NameId;        // 进程名称 (字符串驻留池 ID，StringPool_Get 取 UTF-8 文本)
         double WorkingSetMB;
-        char Name[260];
     };
 #pragma pack(pop)
 
@@ -26,16 +29,38 @@ namespace IronSight::Core::Native::Memory
         /// <returns>包含 ProcessInfo 对象的 std::vector，每个对象表示一个进程的信息。向量按内存使用量降序排列，包含最多 topN 个条目。</returns>
         static std::vector<ProcessInfo> GetTopMemoryConsumers(int topN);
         /// <summary>
-        /// 执行全局内存清理的函数。
+        /// 按指定指标选出前 N 个进程（进程数不受限制，代价 O(n log N)）。
+        /// CPU 与磁盘速率相对于上一次调用计算，首次调用时为 0。
+        /// </summary>
+        /// <returns>写入 buffer 的进程数，按指标降序排列；枚举失败返回 0。</returns>
+        static int GetTopConsumers(ConsumerMetric metric, ConsumerInfo* buffer, int maxCount);
+        /// <summary>
+        /// 执行全局内存清理的函数（默认回收参数）。
         /// </summary>
         /// <returns>清理的进程以及释放的内存结果。</returns>
         static CleanupResult ExecuteGlobalCleanup();
+        /// <summary>
+        /// 按预计回收量从大到小并行回收各进程的工作集，跳过低于阈值与受保护的进程，达到目标回收量后停止。
+        /// </summary>
+        static TrimResult TrimWorkingSets(const TrimOptions& options);
+        /// <summary>
+        /// 把进程名加入回收保护列表（默认已包含系统关键进程）。
+        /// </summary>
+        static void ProtectProcess(std::string_view name);
+        /// <summary>
+        /// 清空回收保护列表（包括默认项）。
+        /// </summary>
+        static void ClearProtectedProcesses();
     };
 
     extern "C" 
     {
         // C# 最终调用的平铺接口
         __declspec(dllexport) CleanupResult CleanSystemMemory();
+        __declspec(dllexport) TrimResult TrimSystemMemory(const TrimOptions* options);
+        __declspec(dllexport) void AddTrimProtectedName(const char* name);
+        __declspec(dllexport) void ClearTrimProtectedNames();
         __declspec(dllexport) int GetTopMemoryConsumers(ProcessInfo buffer[], int maxCount);
+        __declspec(dllexport) int GetTopConsumers(ConsumerMetric metric, ConsumerInfo buffer[], int maxCount);
     }
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+﻿#include <pch.h>
+#include "MemoryPressureWatcher.h"
+#include "Logging/Log.h"
+#include <algorithm>
+#include <chrono>
+
+namespace IronSight::Core::Native::Memory
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        uint32_t RemainingMs(Clock::time_point deadline, Clock::time_point now)
+        {
+            if (deadline <= now) return 0;
+            return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count());
+        }
+    }
+
+    MemoryPressureWatcher::MemoryPressureWatcher(SourceFactory createSource, TrimFunction trim)
+        : _createSource(std::move(createSource)),
+        _trim(std::move(trim))
+    {
+    }
+
+    MemoryPressureWatcher::~MemoryPressureWatcher()
+    {
+        Stop();
+    }
+
+    MemoryPressureOptions MemoryPressureWatcher::Normalize(const MemoryPressureOptions& options)
+    {
+        MemoryPressureOptions normalized = options;
+        if (normalized.LowPercent == 0) normalized.LowPercent = DefaultLowPercent;
+        if (normalized.HighPercent == 0) normalized.HighPercent = DefaultHighPercent;
+        if (normalized.MinIntervalMs == 0) normalized.MinIntervalMs = DefaultMinIntervalMs;
+        if (normalized.PollIntervalMs == 0) normalized.PollIntervalMs = DefaultPollIntervalMs;
+        if (normalized.StepBytes == 0) normalized.StepBytes = DefaultStepBytes;
+        if (normalized.MinReclaimBytes == 0) normalized.MinReclaimBytes = DefaultMinReclaimBytes;
+        if (normalized.MaxConcurrency == 0) normalized.MaxConcurrency = DefaultMaxConcurrency;
+
+        // 两条水位线重合时没有迟滞，回收后立刻退出又立刻进入
+        normalized.LowPercent = (std::min)(normalized.LowPercent, 99u);
+        normalized.HighPercent = (std::min)((std::max)(normalized.HighPercent, normalized.LowPercent + 1), 100u);
+        return normalized;
+    }
+
+    bool MemoryPressureWatcher::Start(const MemoryPressureOptions& options)
+    {
+        std::lock_guard<std::mutex> control(_controlMutex);
+
+        if (_thread.joinable())
+        {
+            _running.store(false);
+            _source->Wake();
+            _thread.join();
+        }
+
+        _source = _createSource ? _createSource() : nullptr;
+        if (!_source || !_trim) return false;
+
+        {
+            std::lock_guard<std::mutex> lock(_statsMutex);
+            _stats = {};
+            _stats.IsRunning = 1;
+            _stats.HasNotifications = _source->HasNotifications() ? 1 : 0;
+        }
+
+        const MemoryPressureOptions normalized = Normalize(options);
+        _running.store(true);
+        _thread = std::thread(&MemoryPressureWatcher::ThreadProc, this, normalized);
+
+        LOG_INFO("内存压力监视已启动：水位 %u%% / %u%%，回收间隔 %u ms，单次上限 %.0f MB",
+            normalized.LowPercent, normalized.HighPercent, normalized.MinIntervalMs, normalized.StepBytes / (1024.0 * 1024.0));
+        return true;
+    }
+
+    void MemoryPressureWatcher::Stop()
+    {
+        std::lock_guard<std::mutex> control(_controlMutex);
+        if (!_thread.joinable()) return;
+
+        _running.store(false);
+        _source->Wake();
+        _thread.join();
+        _source.reset();
+
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        _stats.IsRunning = 0;
+        _stats.IsUnderPressure = 0;
+
+        LOG_INFO("内存压力监视已停止");
+    }
+
+    void MemoryPressureWatcher::GetStats(MemoryPressureStats& stats) const
+    {
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        stats = _stats;
+    }
+
+    void MemoryPressureWatcher::ThreadProc(MemoryPressureOptions options)
+    {
+        IPressureSource& source = *_source;
+        const auto minInterval = std::chrono::milliseconds(options.MinIntervalMs);
+
+        bool underPressure = false;
+        uint32_t backoff = 1;
+        Clock::time_point nextReclaim{};
+        Clock::time_point rearmAt{};
+
+        while (_running.load(std::memory_order_relaxed))
+        {
+            Clock::time_point now = Clock::now();
+
+            // 压力期间只等到下一次允许回收的时刻；平时等待通知，被忽略的电平触发通知在一个轮询间隔内不再等待
+            const bool armed = !underPressure && now >= rearmAt;
+            const uint32_t timeoutMs = underPressure
+                ? (std::max)(RemainingMs(nextReclaim, now), 1u)
+                : options.PollIntervalMs;
+
+            const PressureWait wait = source.Wait(timeoutMs, armed);
+            if (wait == PressureWait::Woken || !_running.load(std::memory_order_relaxed)) break;
+
+            uint64_t available = 0, total = 0;
+            if (!source.QueryMemory(available, total) || total == 0) continue;
+
+            const uint64_t highBytes = total / 100 * options.HighPercent;
+            const uint64_t lowBytes = total / 100 * options.LowPercent;
+            now = Clock::now();
+
+            {
+                std::lock_guard<std::mutex> lock(_statsMutex);
+                if (wait == PressureWait::Pressure) _stats.Notifications++;
+                _stats.AvailableBytes = available;
+                _stats.TotalBytes = total;
+            }
+
+            if (!underPressure)
+            {
+                const bool enter = available < lowBytes || (wait == PressureWait::Pressure && available < highBytes);
+                if (!enter)
+                {
+                    if (wait == PressureWait::Pressure) rearmAt = now + std::chrono::milliseconds(options.PollIntervalMs);
+                    continue;
+                }
+
+                underPressure = true;
+                backoff = 1;
+                nextReclaim = now;
+
+                std::lock_guard<std::mutex> lock(_statsMutex);
+                _stats.PressureEpisodes++;
+                _stats.IsUnderPressure = 1;
+                LOG_INFO("进入内存压力状态：可用 %.0f / %.0f MB", available / (1024.0 * 1024.0), total / (1024.0 * 1024.0));
+            }
+
+            if (available >= highBytes)
+            {
+                underPressure = false;
+                rearmAt = now;
+
+                std::lock_guard<std::mutex> lock(_statsMutex);
+                _stats.IsUnderPressure = 0;
+                LOG_INFO("内存压力已解除：可用 %.0f MB", available / (1024.0 * 1024.0));
+                continue;
+            }
+
+            if (now < nextReclaim) continue;
+
+            // 小步回收：只补足到高水位的缺口，且只碰预计收益较大的进程
+            TrimOptions trim{};
+            trim.MinReclaimBytes = options.MinReclaimBytes;
+            trim.TargetBytes = (std::min)(highBytes - available, options.StepBytes);
+            trim.MaxConcurrency = options.MaxConcurrency;
+
+            const TrimResult result = _trim(trim);
+
+            // 收效甚微时 (没有可换出的私有内存、没有交换区) 继续按原间隔回收只会徒增缺页
+            backoff = result.ReleasedBytes < trim.TargetBytes / 4 ? (std::min)(backoff * 2, MaxBackoffFactor) : 1;
+            nextReclaim = Clock::now() + minInterval * backoff;
+
+            std::lock_guard<std::mutex> lock(_statsMutex);
+            _stats.ReclaimSteps++;
+            _stats.ReleasedBytes += result.ReleasedBytes;
+        }
+
+        _running.store(false);
+    }
+}
@@ -0,0 +1,124 @@
+﻿#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include "PressureSource.h"
+#include "WorkingSetTrimmer.h"
+
+namespace IronSight::Core::Native::Memory
+{
+#pragma pack(push, 8)
+	/// <summary>
+	/// 内存压力监视参数 (字段为 0 时使用默认值)
+	/// </summary>
+	struct MemoryPressureOptions
+	{
+		uint32_t LowPercent;            // 可用内存低于此百分比时进入压力状态 (默认 10)
+		uint32_t HighPercent;           // 可用内存回升到此百分比时退出压力状态 (默认 20)；收到系统通知时低于此值即进入
+		uint32_t MinIntervalMs;         // 两次回收之间的最短间隔 (默认 10 秒)
+		uint32_t PollIntervalMs;        // 检查可用内存的间隔，系统通知只会让检查提前 (默认 5 秒)
+		uint64_t StepBytes;             // 单次回收的目标上限 (默认 256 MB)
+		uint64_t MinReclaimBytes;       // 单个进程的预计回收量阈值 (默认 32 MB)
+		uint32_t MaxConcurrency;        // 同时回收的进程数上限 (默认 2)
+		uint32_t Reserved;
+	};
+
+	/// <summary>
+	/// 内存压力监视统计
+	/// </summary>
+	struct MemoryPressureStats
+	{
+		uint64_t Notifications;         // 收到的系统通知次数
+		uint64_t PressureEpisodes;      // 进入压力状态的次数
+		uint64_t ReclaimSteps;          // 执行的回收次数
+		uint64_t ReleasedBytes;         // 回收释放的字节数合计
+		uint64_t AvailableBytes;        // 最近一次检查时的可用内存
+		uint64_t TotalBytes;
+		uint8_t IsRunning;
+		uint8_t IsUnderPressure;
+		uint8_t HasNotifications;       // 为 0 时系统通知不可用，只按轮询间隔检查
+		uint8_t Reserved[5];
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(MemoryPressureOptions) == 40, "MemoryPressureOptions size mismatch");
+	static_assert(sizeof(MemoryPressureStats) == 56, "MemoryPressureStats size mismatch");
+
+	/// <summary>
+	/// 内存压力驱动的自动回收
+	/// 后台线程等待系统内存压力通知 (或轮询超时) 后检查可用内存，按两条水位线实现迟滞：
+	/// 低于 LowPercent (或收到通知且低于 HighPercent) 时进入压力状态，回升到 HighPercent 以上才退出。
+	/// 压力期间每隔 MinIntervalMs 通过 MemoryOptimizer 做一次小步回收，目标为距高水位的缺口 (不超过 StepBytes)，
+	/// 只回收预计收益较大的进程；一步回收的效果不到目标的四分之一时 (例如没有交换区) 间隔加倍，最多退避到 8 倍
+	/// 压力数据源与回收函数由构造时注入，策略本身与平台无关
+	/// </summary>
+	class MemoryPressureWatcher
+	{
+		public:
+		using SourceFactory = std::function<std::unique_ptr<IPressureSource>()>;
+		using TrimFunction = std::function<TrimResult(const TrimOptions&)>;
+
+		/// <summary>
+		/// 创建监视器
+		/// </summary>
+		/// <param name="createSource">每次 Start 时创建压力数据源</param>
+		/// <param name="trim">在监视线程上执行一次小步回收</param>
+		MemoryPressureWatcher(SourceFactory createSource, TrimFunction trim);
+		~MemoryPressureWatcher();
+
+		MemoryPressureWatcher(const MemoryPressureWatcher&) = delete;
+		MemoryPressureWatcher& operator=(const MemoryPressureWatcher&) = delete;
+
+		/// <summary>
+		/// 获取使用平台默认数据源与 MemoryOptimizer 回收的全局监视器实例 (刻意不析构：DLL 卸载时无法安全地 join 线程)
+		/// </summary>
+		static MemoryPressureWatcher& Shared();
+
+		/// <summary>
+		/// 启动监视 (已在运行时以新参数重新启动)
+		/// </summary>
+		bool Start(const MemoryPressureOptions& options);
+
+		void Stop();
+
+		bool IsRunning() const noexcept { return _running.load(std::memory_order_relaxed); }
+
+		void GetStats(MemoryPressureStats& stats) const;
+
+		static constexpr uint32_t DefaultLowPercent = 10;
+		static constexpr uint32_t DefaultHighPercent = 20;
+		static constexpr uint32_t DefaultMinIntervalMs = 10000;
+		static constexpr uint32_t DefaultPollIntervalMs = 5000;
+		static constexpr uint64_t DefaultStepBytes = 256ull * 1024 * 1024;
+		static constexpr uint64_t DefaultMinReclaimBytes = 32ull * 1024 * 1024;
+		static constexpr uint32_t DefaultMaxConcurrency = 2;
+		static constexpr uint32_t MaxBackoffFactor = 8;
+
+		private:
+		static MemoryPressureOptions Normalize(const MemoryPressureOptions& options);
+
+		void ThreadProc(MemoryPressureOptions options);
+
+		SourceFactory _createSource;
+		TrimFunction _trim;
+		std::mutex _controlMutex;                       // 串行化 Start / Stop
+		std::thread _thread;
+		std::unique_ptr<IPressureSource> _source;
+		std::atomic<bool> _running{ false };
+
+		mutable std::mutex _statsMutex;
+		MemoryPressureStats _stats{};
+	};
+
+	extern "C"
+	{
+		/// <summary>
+		/// 启动内存压力监视，options 为空时使用默认参数
+		/// </summary>
+		__declspec(dllexport) bool MemoryPressure_Start(const MemoryPressureOptions* options);
+
+		__declspec(dllexport) void MemoryPressure_Stop();
+
+		__declspec(dllexport) void MemoryPressure_GetStats(MemoryPressureStats* stats);
+	}
+}
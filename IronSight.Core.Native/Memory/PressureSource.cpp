@@ -0,0 +1,22 @@
+﻿#include <pch.h>
+#include "PressureSource.h"
+
+#if defined(_WIN32)
+#include "WinPressureSource.h"
+#elif defined(__linux__)
+#include "PsiPressureSource.h"
+#endif
+
+namespace IronSight::Core::Native::Memory
+{
+    std::unique_ptr<IPressureSource> IPressureSource::CreateDefault()
+    {
+#if defined(_WIN32)
+        return std::make_unique<WinPressureSource>();
+#elif defined(__linux__)
+        return std::make_unique<PsiPressureSource>();
+#else
+        return nullptr;
+#endif
+    }
+}
@@ -0,0 +1,49 @@
+﻿#pragma once
+
+namespace IronSight::Core::Native::Memory
+{
+	/// <summary>
+	/// 一次等待的结果
+	/// </summary>
+	enum class PressureWait
+	{
+		Timeout,        // 超时
+		Pressure,       // 系统发出了内存压力通知
+		Woken           // 被 Wake 唤醒
+	};
+
+	/// <summary>
+	/// 内存压力通知的平台接口
+	/// Wait 只在监视线程上调用；Wake 可以在任意线程上调用，用于让监视线程及时退出
+	/// </summary>
+	class IPressureSource
+	{
+		public:
+		virtual ~IPressureSource() = default;
+
+		/// <summary>
+		/// 等待内存压力通知或 Wake，最长 timeoutMs 毫秒
+		/// </summary>
+		/// <param name="armed">为 false 时不等待压力通知 (Windows 的低内存通知是电平触发，压力持续期间会一直处于触发状态)</param>
+		virtual PressureWait Wait(uint32_t timeoutMs, bool armed) = 0;
+
+		virtual void Wake() = 0;
+
+		/// <summary>
+		/// 查询可用与总物理内存 (字节)
+		/// </summary>
+		/// <returns>成功返回true</returns>
+		virtual bool QueryMemory(uint64_t& availableBytes, uint64_t& totalBytes) = 0;
+
+		/// <summary>
+		/// 是否能收到系统通知 (不能时只按轮询间隔检查可用内存)
+		/// </summary>
+		virtual bool HasNotifications() const noexcept = 0;
+
+		/// <summary>
+		/// 创建当前平台的默认实现
+		/// Windows 使用低内存资源通知，Linux 使用 PSI (/proc/pressure/memory) 触发器
+		/// </summary>
+		static std::unique_ptr<IPressureSource> CreateDefault();
+	};
+}
@@ -0,0 +1,179 @@
+﻿#include <pch.h>
+#include "ProcFsTrimBackend.h"
+
+#if defined(__linux__)
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// 较旧的内核头文件没有这些定义 (系统调用号在各架构上统一)
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_process_madvise
+#define SYS_process_madvise 440
+#endif
+#ifndef MADV_PAGEOUT
+#define MADV_PAGEOUT 21
+#endif
+
+namespace IronSight::Core::Native::Memory
+{
+    namespace
+    {
+        // process_madvise 单次调用的区间数上限 (UIO_MAXIOV)
+        constexpr size_t MaxRangesPerCall = 1024;
+
+        size_t ReadSmallFile(const char* path, char* buffer, size_t size) noexcept
+        {
+            int fd = open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return 0;
+
+            ssize_t n = read(fd, buffer, size - 1);
+            close(fd);
+
+            if (n <= 0) return 0;
+            buffer[n] = '\0';
+            return static_cast<size_t>(n);
+        }
+
+        // stat 的第 22 个字段 starttime (时钟滴答)，进程名可能包含空格，从最后一个 ')' 之后解析
+        bool ReadStartTime(uint32_t pid, uint64_t& startTime) noexcept
+        {
+            char path[64];
+            std::snprintf(path, sizeof(path), "/proc/%u/stat", pid);
+
+            char buffer[1024];
+            if (ReadSmallFile(path, buffer, sizeof(buffer)) == 0) return false;
+
+            const char* p = std::strrchr(buffer, ')');
+            if (!p) return false;
+
+            // ')' 之后第 1 个字段是第 3 个字段 state
+            for (int field = 2; field < 22; ++field)
+            {
+                while (*p == ' ') ++p;
+                while (*p && *p != ' ') ++p;
+            }
+
+            startTime = std::strtoull(p, nullptr, 10);
+            return true;
+        }
+
+        bool ReadResidentPages(uint32_t pid, uint64_t& resident) noexcept
+        {
+            char path[64];
+            std::snprintf(path, sizeof(path), "/proc/%u/statm", pid);
+
+            char buffer[256];
+            unsigned long long size = 0, pages = 0;
+            if (ReadSmallFile(path, buffer, sizeof(buffer)) == 0 || std::sscanf(buffer, "%llu %llu", &size, &pages) != 2) return false;
+
+            resident = pages;
+            return true;
+        }
+
+        // 收集私有可写映射 (堆、栈、匿名内存与写时复制的数据段)
+        // 只读的代码段与共享映射不换出：它们不属于预计回收量，换出后只会引起缺页
+        bool CollectPrivateRanges(uint32_t pid, std::vector<iovec>& ranges)
+        {
+            char path[64];
+            std::snprintf(path, sizeof(path), "/proc/%u/maps", pid);
+
+            FILE* maps = std::fopen(path, "re");
+            if (!maps) return false;
+
+            char* line = nullptr;
+            size_t capacity = 0;
+            while (getline(&line, &capacity, maps) > 0)
+            {
+                unsigned long long begin = 0, end = 0;
+                char perms[8] = {};
+                int pathOffset = 0;
+                if (std::sscanf(line, "%llx-%llx %7s %*s %*s %*s %n", &begin, &end, perms, &pathOffset) < 3) continue;
+                if (perms[1] != 'w' || perms[3] != 'p' || end <= begin) continue;
+
+                // [vvar]、[vsyscall] 等特殊映射不支持换出，只保留 [heap] 与 [stack]
+                const char* name = line + pathOffset;
+                if (name[0] == '[' && std::strncmp(name, "[heap]", 6) != 0 && std::strncmp(name, "[stack]", 7) != 0) continue;
+
+                ranges.push_back({ reinterpret_cast<void*>(static_cast<uintptr_t>(begin)), static_cast<size_t>(end - begin) });
+            }
+
+            std::free(line);
+            std::fclose(maps);
+            return true;
+        }
+    }
+
+    ProcFsTrimBackend::ProcFsTrimBackend()
+        : _backend(_handles)
+    {
+        long ticks = sysconf(_SC_CLK_TCK);
+        long pageSize = sysconf(_SC_PAGESIZE);
+        if (ticks > 0) _ticksTo100ns = 10000000ull / static_cast<uint64_t>(ticks);
+        if (pageSize > 0) _pageSize = static_cast<uint64_t>(pageSize);
+    }
+
+    bool ProcFsTrimBackend::Enumerate(std::vector<System::ProcessSample>& samples)
+    {
+        if (!_backend.Enumerate(samples, SIZE_MAX)) return false;
+
+        _backend.Prepare(samples);
+        for (System::ProcessSample& sample : samples)
+        {
+            _backend.Query(sample);
+        }
+        _backend.Complete(samples);
+
+        return true;
+    }
+
+    bool ProcFsTrimBackend::Trim(const TrimCandidate& candidate, uint64_t& releasedBytes)
+    {
+        releasedBytes = 0;
+
+        // pidfd 固定进程：打开之后 PID 即使被复用，process_madvise 也只会作用于原进程 (已退出时返回 ESRCH)
+        int pidfd = static_cast<int>(syscall(SYS_pidfd_open, candidate.Pid, 0));
+        if (pidfd < 0) return false;
+
+        // 打开 pidfd 之前 PID 可能已被复用，以启动时间确认仍是枚举时的进程
+        uint64_t startTime = 0, before = 0, after = 0;
+        if (!ReadStartTime(candidate.Pid, startTime) || startTime * _ticksTo100ns != candidate.CreateTime ||
+            !ReadResidentPages(candidate.Pid, before))
+        {
+            close(pidfd);
+            return false;
+        }
+
+        std::vector<iovec> ranges;
+        bool trimmed = CollectPrivateRanges(candidate.Pid, ranges) && !ranges.empty();
+
+        for (size_t offset = 0; trimmed && offset < ranges.size(); offset += MaxRangesPerCall)
+        {
+            const size_t count = (std::min)(MaxRangesPerCall, ranges.size() - offset);
+
+            // 区间在读取 maps 之后被解除映射时返回 ENOMEM (本批余下的区间被跳过)，继续下一批
+            if (syscall(SYS_process_madvise, pidfd, ranges.data() + offset, count, MADV_PAGEOUT, 0u) < 0 && errno != ENOMEM)
+            {
+                trimmed = false;
+            }
+        }
+
+        close(pidfd);
+
+        if (trimmed && ReadResidentPages(candidate.Pid, after) && before > after)
+        {
+            releasedBytes = (before - after) * _pageSize;
+        }
+        return trimmed;
+    }
+}
+#endif
@@ -0,0 +1,27 @@
+﻿#pragma once
+#include "TrimBackend.h"
+#include "System/ProcFsProcessBackend.h"
+
+namespace IronSight::Core::Native::Memory
+{
+	/// <summary>
+	/// Linux 工作集回收
+	/// 候选进程来自 /proc 进程数据源；回收时以 pidfd 固定进程，对其私有可写映射调用 process_madvise(MADV_PAGEOUT)，
+	/// 效果与 Windows 的 EmptyWorkingSet 相当 (页面换出到交换区或丢弃干净页，之后按需缺页调回)。
+	/// 需要 Linux 5.10+，并且对目标进程有 ptrace 权限与 CAP_SYS_NICE，否则 Trim 返回 false
+	/// </summary>
+	class ProcFsTrimBackend final : public ITrimBackend
+	{
+		public:
+		ProcFsTrimBackend();
+
+		bool Enumerate(std::vector<System::ProcessSample>& samples) override;
+		bool Trim(const TrimCandidate& candidate, uint64_t& releasedBytes) override;
+
+		private:
+		System::ProcessHandleCache _handles;
+		System::ProcFsProcessBackend _backend;
+		uint64_t _ticksTo100ns = 100000;    // USER_HZ = 100
+		uint64_t _pageSize = 4096;
+	};
+}
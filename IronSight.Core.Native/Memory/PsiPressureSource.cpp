@@ -0,0 +1,106 @@
+﻿#include <pch.h>
+#include "PsiPressureSource.h"
+#include "Logging/Log.h"
+
+#if defined(__linux__)
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace IronSight::Core::Native::Memory
+{
+    namespace
+    {
+        // some <停顿微秒> <窗口微秒>
+        constexpr const char* TriggerSpec = "some 150000 2000000";
+    }
+
+    PsiPressureSource::PsiPressureSource()
+    {
+        _wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        _trigger = open("/proc/pressure/memory", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (_trigger >= 0 && write(_trigger, TriggerSpec, std::strlen(TriggerSpec) + 1) < 0)
+        {
+            close(_trigger);
+            _trigger = -1;
+        }
+
+        if (_trigger < 0)
+        {
+            LOG_WARN("无法注册 PSI 内存压力触发器 (%s)，改为按间隔检查可用内存", std::strerror(errno));
+        }
+    }
+
+    PsiPressureSource::~PsiPressureSource()
+    {
+        if (_trigger >= 0) close(_trigger);
+        if (_wake >= 0) close(_wake);
+    }
+
+    PressureWait PsiPressureSource::Wait(uint32_t timeoutMs, bool armed)
+    {
+        pollfd fds[2] = { { _wake, POLLIN, 0 }, { _trigger, POLLPRI, 0 } };
+        nfds_t count = armed && _trigger >= 0 ? 2 : 1;
+
+        int ready = poll(fds, count, static_cast<int>((std::min)(timeoutMs, 0x7FFFFFFFu)));
+        if (ready <= 0) return PressureWait::Timeout;
+
+        if (fds[0].revents & POLLIN)
+        {
+            uint64_t value = 0;
+            ssize_t drained = read(_wake, &value, sizeof(value));
+            (void)drained;
+            return PressureWait::Woken;
+        }
+
+        // 触发器所在的 cgroup 被移除等情况下返回 POLLERR，此后不再等待 PSI
+        if (count == 2 && (fds[1].revents & (POLLERR | POLLNVAL)))
+        {
+            LOG_WARN("PSI 内存压力触发器失效，改为按间隔检查可用内存");
+            close(_trigger);
+            _trigger = -1;
+            return PressureWait::Timeout;
+        }
+
+        return count == 2 && (fds[1].revents & POLLPRI) ? PressureWait::Pressure : PressureWait::Timeout;
+    }
+
+    void PsiPressureSource::Wake()
+    {
+        if (_wake < 0) return;
+
+        uint64_t value = 1;
+        ssize_t written = write(_wake, &value, sizeof(value));
+        (void)written;
+    }
+
+    bool PsiPressureSource::QueryMemory(uint64_t& availableBytes, uint64_t& totalBytes)
+    {
+        FILE* meminfo = std::fopen("/proc/meminfo", "re");
+        if (!meminfo) return false;
+
+        // 单位为 kB；MemAvailable 估算了不换出即可回收的内存 (含可丢弃的页缓存)
+        unsigned long long total = 0, available = 0;
+        bool hasTotal = false, hasAvailable = false;
+        char line[256];
+        while ((!hasTotal || !hasAvailable) && std::fgets(line, sizeof(line), meminfo))
+        {
+            if (std::sscanf(line, "MemTotal: %llu", &total) == 1) hasTotal = true;
+            else if (std::sscanf(line, "MemAvailable: %llu", &available) == 1) hasAvailable = true;
+        }
+        std::fclose(meminfo);
+
+        if (!hasTotal || !hasAvailable) return false;
+
+        availableBytes = available * 1024;
+        totalBytes = total * 1024;
+        return true;
+    }
+}
+#endif
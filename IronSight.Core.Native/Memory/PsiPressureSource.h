@@ -0,0 +1,29 @@
+﻿#pragma once
+#include "PressureSource.h"
+
+namespace IronSight::Core::Native::Memory
+{
+	/// <summary>
+	/// Linux 内存压力通知
+	/// 向 /proc/pressure/memory 写入触发器 (每 2 秒窗口内至少有 150 毫秒部分任务因内存不足而停顿)，
+	/// 满足条件时 poll 返回 POLLPRI；非特权进程的窗口须为 2 秒的整数倍。内核不支持 PSI 时只按间隔检查 MemAvailable
+	/// </summary>
+	class PsiPressureSource final : public IPressureSource
+	{
+		public:
+		PsiPressureSource();
+		~PsiPressureSource() override;
+
+		PsiPressureSource(const PsiPressureSource&) = delete;
+		PsiPressureSource& operator=(const PsiPressureSource&) = delete;
+
+		PressureWait Wait(uint32_t timeoutMs, bool armed) override;
+		void Wake() override;
+		bool QueryMemory(uint64_t& availableBytes, uint64_t& totalBytes) override;
+		bool HasNotifications() const noexcept override { return _trigger >= 0; }
+
+		private:
+		int _trigger = -1;
+		int _wake = -1;
+	};
+}
@@ -0,0 +1,113 @@
+﻿#include <pch.h>
+#include "TopConsumerRanking.h"
+#include <algorithm>
+
+namespace IronSight::Core::Native::Memory
+{
+    namespace
+    {
+        constexpr double BytesPerMB = 1024.0 * 1024.0;
+
+        // 堆比较：a 排在 b 之前 (指标更大，相同时 PID 更小)
+        // 以此为比较器时堆顶是当前入选者中最差的一个，新进程只需与堆顶比较
+        template <typename Key>
+        bool Outranks(const Key& a, const Key& b) noexcept
+        {
+            return a.Value > b.Value || (a.Value == b.Value && a.Pid < b.Pid);
+        }
+    }
+
+    size_t TopConsumerRanking::Rank(const std::vector<System::ProcessSample>& samples, uint64_t systemTime, uint64_t sampleTick,
+        ConsumerMetric metric, ConsumerInfo* buffer, size_t maxCount)
+    {
+        const size_t count = samples.size();
+        const uint64_t systemDelta = systemTime - _lastSystemTime;
+        const double seconds = (sampleTick - _lastSampleTick) / 1000.0;
+        const bool hasBase = _lastSampleTick != 0 && sampleTick > _lastSampleTick && systemTime > _lastSystemTime;
+
+        _heap.clear();
+        _heap.reserve((std::min)(maxCount, count));
+
+        auto outranks = [](const RankKey& a, const RankKey& b) { return Outranks(a, b); };
+
+        _history.BeginSweep();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const System::ProcessSample& sample = samples[i];
+
+            // 空闲进程的 "CPU 时间" 实为空闲时间，不参与排名
+            if (sample.Pid == 0) continue;
+
+            float cpu = 0.0f;
+            float io = 0.0f;
+
+            if (sample.HasCounters)
+            {
+                // 复用了旧 PID 的新进程从空基准开始，不会算出异常速率
+                bool inserted = false;
+                Counters& counters = _history.Touch(sample.Pid, sample.CreateTime, inserted);
+
+                const uint64_t cpuTime = sample.KernelTime + sample.UserTime;
+                const uint64_t ioBytes = sample.ReadBytes + sample.WriteBytes;
+
+                if (!inserted && hasBase)
+                {
+                    if (cpuTime >= counters.CpuTime) cpu = static_cast<float>(static_cast<double>(cpuTime - counters.CpuTime) / systemDelta * 100.0);
+                    if (ioBytes >= counters.IoBytes) io = static_cast<float>((ioBytes - counters.IoBytes) / BytesPerMB / seconds);
+                }
+
+                counters.CpuTime = cpuTime;
+                counters.IoBytes = ioBytes;
+            }
+
+            if (maxCount == 0) continue;
+
+            double value = 0;
+            switch (metric)
+            {
+                case ConsumerMetric::WorkingSet: value = static_cast<double>(sample.WorkingSetBytes); break;
+                case ConsumerMetric::PrivateBytes: value = static_cast<double>(sample.PrivateBytes); break;
+                case ConsumerMetric::Cpu: value = cpu; break;
+                case ConsumerMetric::IoRate: value = io; break;
+            }
+
+            const RankKey key{ value, sample.Pid, static_cast<uint32_t>(i), cpu, io };
+
+            if (_heap.size() < maxCount)
+            {
+                _heap.push_back(key);
+                std::push_heap(_heap.begin(), _heap.end(), outranks);
+            }
+            else if (Outranks(key, _heap.front()))
+            {
+                std::pop_heap(_heap.begin(), _heap.end(), outranks);
+                _heap.back() = key;
+                std::push_heap(_heap.begin(), _heap.end(), outranks);
+            }
+        }
+
+        _history.Sweep();
+        _lastSystemTime = systemTime;
+        _lastSampleTick = sampleTick;
+
+        // 只对入选的 N 个键排序并填充完整结果
+        std::sort_heap(_heap.begin(), _heap.end(), outranks);
+
+        for (size_t i = 0; i < _heap.size(); ++i)
+        {
+            const RankKey& key = _heap[i];
+            const System::ProcessSample& sample = samples[key.Index];
+
+            ConsumerInfo& info = buffer[i];
+            info.Pid = sample.Pid;
+            info.NameId = sample.NameId;
+            info.WorkingSetMB = sample.WorkingSetBytes / BytesPerMB;
+            info.PrivateMB = sample.PrivateBytes / BytesPerMB;
+            info.CpuUsage = key.Cpu;
+            info.IoRateMBs = key.Io;
+        }
+
+        return _heap.size();
+    }
+}
@@ -0,0 +1,75 @@
+﻿#pragma once
+#include "System/ProcessTable.h"
+#include "System/ProcessTypes.h"
+
+namespace IronSight::Core::Native::Memory
+{
+	/// <summary>
+	/// 进程排名依据
+	/// </summary>
+	enum class ConsumerMetric : uint32_t
+	{
+		WorkingSet = 0,     // 工作集
+		PrivateBytes = 1,   // 私有内存
+		Cpu = 2,            // CPU 占用
+		IoRate = 3          // 磁盘读写合计 MB/s
+	};
+
+#pragma pack(push, 8)
+	/// <summary>
+	/// 排名结果中的一个进程 (四项指标全部填充，与排名依据无关)
+	/// </summary>
+	struct ConsumerInfo
+	{
+		uint32_t Pid;
+		uint32_t NameId;        // 进程名称 (字符串驻留池 ID，StringPool_Get 取 UTF-8 文本)
+		double WorkingSetMB;
+		double PrivateMB;
+		double CpuUsage;        // CPU 占用 (%)
+		double IoRateMBs;       // 磁盘读写合计 MB/s
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(ConsumerInfo) == 40, "ConsumerInfo size mismatch");
+
+	/// <summary>
+	/// 流式 Top-N 排名
+	/// 单次遍历采样，只在大小为 N 的小根堆中保留 (指标, 下标) 键 (连同该进程的速率)，总代价 O(n log N)；
+	/// 不复制、不排序完整的进程表，也不分配与进程数成比例的缓冲，只为最终入选的 N 个进程填充完整结果。
+	/// CPU 与磁盘速率以上一次调用的计数器为基准，每次调用都会更新全部进程的基准，切换排名依据不影响速率
+	/// </summary>
+	class TopConsumerRanking
+	{
+		public:
+		/// <summary>
+		/// 按 metric 降序选出前 maxCount 个进程写入 buffer (指标相同时 PID 小者优先)
+		/// </summary>
+		/// <param name="samples">一次枚举的全部进程 (顺序任意)</param>
+		/// <param name="systemTime">枚举时刻的系统累计 CPU 时间 (100 纳秒，含空闲)</param>
+		/// <param name="sampleTick">枚举时刻 (毫秒，单调时钟)</param>
+		/// <returns>写入的进程数</returns>
+		size_t Rank(const std::vector<System::ProcessSample>& samples, uint64_t systemTime, uint64_t sampleTick,
+			ConsumerMetric metric, ConsumerInfo* buffer, size_t maxCount);
+
+		private:
+		struct Counters
+		{
+			uint64_t CpuTime = 0;       // 内核态 + 用户态
+			uint64_t IoBytes = 0;       // 读取 + 写入
+		};
+
+		struct RankKey
+		{
+			double Value;
+			uint32_t Pid;
+			uint32_t Index;             // 在 samples 中的下标
+			float Cpu;                  // 本次调用算出的速率 (计数器基准在遍历中即被覆盖，入选后无法再算)
+			float Io;
+		};
+
+		System::ProcessTable<Counters> _history;
+		uint64_t _lastSystemTime = 0;
+		uint64_t _lastSampleTick = 0;
+		std::vector<RankKey> _heap;     // 跨调用复用
+	};
+}
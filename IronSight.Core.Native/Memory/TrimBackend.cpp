@@ -0,0 +1,22 @@
+﻿#include <pch.h>
+#include "TrimBackend.h"
+
+#if defined(_WIN32)
+#include "WinTrimBackend.h"
+#elif defined(__linux__)
+#include "ProcFsTrimBackend.h"
+#endif
+
+namespace IronSight::Core::Native::Memory
+{
+    std::unique_ptr<ITrimBackend> ITrimBackend::CreateDefault()
+    {
+#if defined(_WIN32)
+        return std::make_unique<WinTrimBackend>();
+#elif defined(__linux__)
+        return std::make_unique<ProcFsTrimBackend>();
+#else
+        return nullptr;
+#endif
+    }
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+#include "System/ProcessTypes.h"
+
+namespace IronSight::Core::Native::Memory
+{
+	/// <summary>
+	/// 一个待回收的进程 (由回收策略从枚举结果中选出)
+	/// </summary>
+	struct TrimCandidate
+	{
+		uint32_t Pid;
+		uint32_t NameId;                // 进程名称 (字符串驻留池 ID)
+		uint64_t CreateTime;            // 枚举时的创建时间，回收前据此识别 PID 复用
+		uint64_t WorkingSetBytes;       // 枚举时的工作集
+		uint64_t ExpectedBytes;         // 预计可回收的字节数 (驻留的私有内存)
+	};
+
+	/// <summary>
+	/// 工作集回收的平台接口
+	/// Enumerate 在调用线程上执行；Trim 会被多个工作线程并发调用 (每次针对不同的进程)，实现必须线程安全
+	/// </summary>
+	class ITrimBackend
+	{
+		public:
+		virtual ~ITrimBackend() = default;
+
+		/// <summary>
+		/// 枚举当前进程，至少填充 Pid、CreateTime、NameId、WorkingSetBytes 与 PrivateBytes
+		/// </summary>
+		/// <returns>成功返回true</returns>
+		virtual bool Enumerate(std::vector<System::ProcessSample>& samples) = 0;
+
+		/// <summary>
+		/// 回收单个进程的工作集
+		/// </summary>
+		/// <param name="releasedBytes">输出：回收前后驻留内存的差值</param>
+		/// <returns>进程无法访问、已退出或 PID 已被复用时返回 false</returns>
+		virtual bool Trim(const TrimCandidate& candidate, uint64_t& releasedBytes) = 0;
+
+		/// <summary>
+		/// 创建当前平台的默认实现
+		/// Windows 使用共享的系统进程快照与 EmptyWorkingSet，Linux 使用 /proc 与 process_madvise(MADV_PAGEOUT)
+		/// </summary>
+		static std::unique_ptr<ITrimBackend> CreateDefault();
+	};
+}
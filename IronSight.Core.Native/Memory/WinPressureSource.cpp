@@ -0,0 +1,56 @@
+﻿#include <pch.h>
+#include "WinPressureSource.h"
+#include "Logging/Log.h"
+
+#if defined(_WIN32)
+
+namespace IronSight::Core::Native::Memory
+{
+    WinPressureSource::WinPressureSource()
+    {
+        _wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
+        _lowMemory = CreateMemoryResourceNotification(LowMemoryResourceNotification);
+        if (!_lowMemory)
+        {
+            LOG_WARN("无法创建低内存资源通知，错误代码: %lu，改为按间隔检查可用内存", GetLastError());
+        }
+    }
+
+    WinPressureSource::~WinPressureSource()
+    {
+        if (_lowMemory) CloseHandle(_lowMemory);
+        if (_wake) CloseHandle(_wake);
+    }
+
+    PressureWait WinPressureSource::Wait(uint32_t timeoutMs, bool armed)
+    {
+        HANDLE handles[2] = { _wake, _lowMemory };
+        DWORD count = armed && _lowMemory ? 2 : 1;
+
+        // 唤醒事件排在前面：两者同时触发时优先响应退出
+        switch (WaitForMultipleObjects(count, handles, FALSE, timeoutMs))
+        {
+            case WAIT_OBJECT_0: return PressureWait::Woken;
+            case WAIT_OBJECT_0 + 1: return PressureWait::Pressure;
+            default: return PressureWait::Timeout;
+        }
+    }
+
+    void WinPressureSource::Wake()
+    {
+        if (_wake) SetEvent(_wake);
+    }
+
+    bool WinPressureSource::QueryMemory(uint64_t& availableBytes, uint64_t& totalBytes)
+    {
+        MEMORYSTATUSEX status;
+        status.dwLength = sizeof(status);
+        if (!GlobalMemoryStatusEx(&status)) return false;
+
+        availableBytes = status.ullAvailPhys;
+        totalBytes = status.ullTotalPhys;
+        return true;
+    }
+}
+#endif
@@ -0,0 +1,28 @@
+﻿#pragma once
+#include "PressureSource.h"
+
+namespace IronSight::Core::Native::Memory
+{
+	/// <summary>
+	/// Windows 内存压力通知
+	/// 低内存资源通知在可用内存低于系统确定的阈值时处于触发状态，恢复后自动复位
+	/// </summary>
+	class WinPressureSource final : public IPressureSource
+	{
+		public:
+		WinPressureSource();
+		~WinPressureSource() override;
+
+		WinPressureSource(const WinPressureSource&) = delete;
+		WinPressureSource& operator=(const WinPressureSource&) = delete;
+
+		PressureWait Wait(uint32_t timeoutMs, bool armed) override;
+		void Wake() override;
+		bool QueryMemory(uint64_t& availableBytes, uint64_t& totalBytes) override;
+		bool HasNotifications() const noexcept override { return _lowMemory != nullptr; }
+
+		private:
+		HANDLE _lowMemory = nullptr;
+		HANDLE _wake = nullptr;
+	};
+}
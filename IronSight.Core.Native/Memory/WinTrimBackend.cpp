@@ -0,0 +1,46 @@
+﻿#include <pch.h>
+#include "WinTrimBackend.h"
+
+#if defined(_WIN32)
+#include "System/SystemProcessSnapshot.h"
+
+namespace IronSight::Core::Native::Memory
+{
+    bool WinTrimBackend::Enumerate(std::vector<System::ProcessSample>& samples)
+    {
+        System::SystemProcessSummary summary{};
+        return System::SystemProcessSnapshot::Shared().CopySamples(samples, SIZE_MAX, SnapshotMaxAgeMs, 0, summary);
+    }
+
+    bool WinTrimBackend::Trim(const TrimCandidate& candidate, uint64_t& releasedBytes)
+    {
+        releasedBytes = 0;
+
+        // 受限查询权限即可读取内存计数器与调用 EmptyWorkingSet，比 PROCESS_QUERY_INFORMATION 能打开更多进程
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_SET_QUOTA, FALSE, candidate.Pid);
+        if (!process) return false;
+
+        bool trimmed = false;
+
+        // 持有句柄期间 PID 不会被复用；创建时间与快照不同说明快照之后原进程已退出
+        FILETIME createTime, exitTime, kernelTime, userTime;
+        if (GetProcessTimes(process, &createTime, &exitTime, &kernelTime, &userTime) &&
+            (static_cast<uint64_t>(createTime.dwHighDateTime) << 32 | createTime.dwLowDateTime) == candidate.CreateTime)
+        {
+            PROCESS_MEMORY_COUNTERS before;
+            if (GetProcessMemoryInfo(process, &before, sizeof(before)) && EmptyWorkingSet(process))
+            {
+                PROCESS_MEMORY_COUNTERS after;
+                if (GetProcessMemoryInfo(process, &after, sizeof(after)) && before.WorkingSetSize > after.WorkingSetSize)
+                {
+                    releasedBytes = before.WorkingSetSize - after.WorkingSetSize;
+                }
+                trimmed = true;
+            }
+        }
+
+        CloseHandle(process);
+        return trimmed;
+    }
+}
+#endif
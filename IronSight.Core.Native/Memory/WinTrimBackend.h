@@ -0,0 +1,20 @@
+﻿#pragma once
+#include "TrimBackend.h"
+
+namespace IronSight::Core::Native::Memory
+{
+	/// <summary>
+	/// Windows 工作集回收
+	/// 候选进程来自共享的系统进程快照 (一次系统调用，不逐进程打开句柄)，只为入选的进程打开句柄并调用 EmptyWorkingSet
+	/// </summary>
+	class WinTrimBackend final : public ITrimBackend
+	{
+		public:
+		bool Enumerate(std::vector<System::ProcessSample>& samples) override;
+		bool Trim(const TrimCandidate& candidate, uint64_t& releasedBytes) override;
+
+		private:
+		// 与性能快照、进程列表共享的枚举结果在此时长内直接复用
+		static constexpr uint32_t SnapshotMaxAgeMs = 500;
+	};
+}
@@ -0,0 +1,118 @@
+﻿#include <pch.h>
+#include "WorkingSetTrimmer.h"
+#include "Text/StringPool.h"
+#include "Logging/Log.h"
+#include <algorithm>
+#include <chrono>
+
+namespace IronSight::Core::Native::Memory
+{
+    TrimResult WorkingSetTrimmer::Run(const TrimOptions& options)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        TrimResult result{};
+        const auto started = std::chrono::steady_clock::now();
+
+        if (!_backend.Enumerate(_samples))
+        {
+            LOG_ERROR("无法枚举进程，工作集回收取消");
+            return result;
+        }
+
+        const uint64_t minReclaim = options.MinReclaimBytes != 0 ? options.MinReclaimBytes : DefaultMinReclaimBytes;
+
+        _candidates.clear();
+        for (const System::ProcessSample& sample : _samples)
+        {
+            if (sample.Pid == 0) continue;
+
+            const uint64_t expected = (std::min)(sample.WorkingSetBytes, sample.PrivateBytes);
+            if (expected < minReclaim || IsProtected(sample.NameId))
+            {
+                result.SkippedProcesses++;
+                continue;
+            }
+
+            _candidates.push_back({ sample.Pid, sample.NameId, sample.CreateTime, sample.WorkingSetBytes, expected });
+            result.ExpectedBytes += expected;
+        }
+
+        // 收益最大的进程最先回收，达到目标时剩下的都是收益较小的进程
+        std::sort(_candidates.begin(), _candidates.end(), [](const TrimCandidate& a, const TrimCandidate& b)
+            {
+                return a.ExpectedBytes > b.ExpectedBytes || (a.ExpectedBytes == b.ExpectedBytes && a.Pid < b.Pid);
+            });
+
+        // 调用线程也参与回收，另需 (上限 - 1) 个工作线程
+        const uint32_t concurrency = (std::min)(options.MaxConcurrency != 0 ? options.MaxConcurrency : DefaultMaxConcurrency, MaxConcurrencyLimit);
+        const unsigned workers = concurrency - 1;
+        if (workers == 0) _pool.reset();
+        else if (!_pool || _pool->WorkerCount() != workers) _pool = std::make_unique<Threading::WorkerPool>(workers);
+
+        std::atomic<uint64_t> released{ 0 };
+        std::atomic<uint32_t> trimmed{ 0 }, failed{ 0 }, skipped{ 0 };
+
+        auto body = [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const TrimCandidate& candidate = _candidates[i];
+
+                    if (options.TargetBytes != 0 && released.load(std::memory_order_relaxed) >= options.TargetBytes)
+                    {
+                        skipped.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    uint64_t bytes = 0;
+                    if (!_backend.Trim(candidate, bytes))
+                    {
+                        failed.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    released.fetch_add(bytes, std::memory_order_relaxed);
+                    trimmed.fetch_add(1, std::memory_order_relaxed);
+
+                    // 只有释放超过 1MB 的进程才记录 DEBUG 详情，避免刷屏
+                    if (bytes > 1024 * 1024)
+                    {
+                        LOG_DEBUG("大幅优化进程 PID: %u, 释放: %.2f MB", candidate.Pid, bytes / (1024.0 * 1024.0));
+                    }
+                }
+            };
+
+        // 每次领取一个进程，各线程始终处理剩余收益最大的候选
+        if (_pool) _pool->ParallelFor(_candidates.size(), 1, body);
+        else body(0, _candidates.size());
+
+        result.TrimmedProcesses = trimmed.load();
+        result.FailedProcesses = failed.load();
+        result.SkippedProcesses += skipped.load();
+        result.ReleasedBytes = released.load();
+        result.ElapsedMicroseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count());
+        return result;
+    }
+
+    void WorkingSetTrimmer::Protect(std::string_view name)
+    {
+        const uint32_t nameId = Text::StringPool::Shared().Intern(name);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = std::lower_bound(_protected.begin(), _protected.end(), nameId);
+        if (it == _protected.end() || *it != nameId) _protected.insert(it, nameId);
+    }
+
+    void WorkingSetTrimmer::ClearProtected()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _protected.clear();
+    }
+
+    bool WorkingSetTrimmer::IsProtected(uint32_t nameId) const noexcept
+    {
+        return std::binary_search(_protected.begin(), _protected.end(), nameId);
+    }
+}
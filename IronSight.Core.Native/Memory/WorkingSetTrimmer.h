@@ -0,0 +1,81 @@
+﻿#pragma once
+#include <mutex>
+#include <string_view>
+#include "TrimBackend.h"
+#include "Threading/WorkerPool.h"
+
+namespace IronSight::Core::Native::Memory
+{
+#pragma pack(push, 8)
+	/// <summary>
+	/// 工作集回收参数 (字段为 0 时使用默认值)
+	/// </summary>
+	struct TrimOptions
+	{
+		uint64_t MinReclaimBytes;       // 预计回收量低于此值的进程跳过 (默认 8 MB)
+		uint64_t TargetBytes;           // 累计回收达到此值后不再开始新的回收 (默认不限)
+		uint32_t MaxConcurrency;        // 同时回收的进程数上限 (默认 4)
+		uint32_t Reserved;
+	};
+
+	/// <summary>
+	/// 一次工作集回收的结果
+	/// </summary>
+	struct TrimResult
+	{
+		uint32_t TrimmedProcesses;      // 成功回收的进程数
+		uint32_t SkippedProcesses;      // 低于阈值、受保护或因已达目标而未回收的进程数
+		uint32_t FailedProcesses;       // 无法访问或已退出的进程数
+		uint32_t Reserved;
+		uint64_t ReleasedBytes;         // 回收前后驻留内存的差值合计
+		uint64_t ExpectedBytes;         // 入选进程的预计回收量合计
+		uint64_t ElapsedMicroseconds;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(TrimOptions) == 24, "TrimOptions size mismatch");
+	static_assert(sizeof(TrimResult) == 40, "TrimResult size mismatch");
+
+	/// <summary>
+	/// 按预计收益排序的并行工作集回收
+	/// 预计回收量取驻留的私有内存 (工作集与私有内存的较小者)：共享的映像页被移出工作集并不释放物理内存。
+	/// 低于阈值与受保护的进程不回收，其余进程按预计回收量从大到小依次领取，同时回收的进程数不超过上限；
+	/// 累计回收量达到目标后不再开始新的回收 (已在进行的回收照常完成，因此最多超出上限 - 1 个进程的回收量)
+	/// 平台相关的枚举与回收由 ITrimBackend 实现，策略本身与平台无关
+	/// </summary>
+	class WorkingSetTrimmer
+	{
+		public:
+		explicit WorkingSetTrimmer(ITrimBackend& backend) : _backend(backend) {}
+
+		WorkingSetTrimmer(const WorkingSetTrimmer&) = delete;
+		WorkingSetTrimmer& operator=(const WorkingSetTrimmer&) = delete;
+
+		/// <summary>
+		/// 执行一次回收，多个调用方并发调用时依次执行
+		/// </summary>
+		TrimResult Run(const TrimOptions& options);
+
+		/// <summary>
+		/// 把进程名 (须与枚举结果中的名称完全一致，如 "dwm.exe") 加入保护列表
+		/// </summary>
+		void Protect(std::string_view name);
+
+		void ClearProtected();
+
+		static constexpr uint64_t DefaultMinReclaimBytes = 8ull * 1024 * 1024;
+		static constexpr uint32_t DefaultMaxConcurrency = 4;
+		static constexpr uint32_t MaxConcurrencyLimit = 16;
+
+		private:
+		bool IsProtected(uint32_t nameId) const noexcept;
+
+		ITrimBackend& _backend;
+
+		std::mutex _mutex;
+		std::vector<uint32_t> _protected;                   // 受保护的名称 ID (有序)
+		std::vector<System::ProcessSample> _samples;        // 跨调用复用
+		std::vector<TrimCandidate> _candidates;
+		std::unique_ptr<Threading::WorkerPool> _pool;       // 按需创建，工作线程数 = 并发上限 - 1
+	};
+}
@@ -0,0 +1,314 @@
+﻿#include <pch.h>
+#include "MetricsStore.h"
+#include <algorithm>
+#include <chrono>
+
+namespace IronSight::Core::Native::Metrics
+{
+    namespace
+    {
+        // 向下取整的除法：1970 年之前的时间戳 (负数) 也落在正确的桶中
+        inline int64_t FloorDivide(int64_t value, int64_t divisor) noexcept
+        {
+            int64_t quotient = value / divisor;
+            return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+        }
+
+        inline bool IsSystemKind(MetricKind kind) noexcept
+        {
+            return kind == MetricKind::SystemCpu || kind == MetricKind::SystemMemory ||
+                kind == MetricKind::DiskRead || kind == MetricKind::DiskWrite;
+        }
+    }
+
+    MetricsStore& MetricsStore::Shared()
+    {
+        static MetricsStore* store = new MetricsStore();
+        return *store;
+    }
+
+    MetricsStore::MetricsStore(size_t maxSeries)
+        : _maxSeries((std::max)(maxSeries, static_cast<size_t>(1)))
+    {
+    }
+
+    void MetricsStore::Record(MetricKind kind, uint32_t id, int64_t timestampMs, double value, uint64_t instance)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        RecordLocked(kind, id, timestampMs, value, instance);
+        PruneLocked(timestampMs);
+    }
+
+    void MetricsStore::RecordLocked(MetricKind kind, uint32_t id, int64_t timestampMs, double value, uint64_t instance)
+    {
+        const uint64_t key = MakeKey(kind, id);
+
+        Series* series = nullptr;
+        auto it = _series.find(key);
+        if (it != _series.end())
+        {
+            series = &it->second;
+            Unlink(*series);
+        }
+        else
+        {
+            series = &CreateSeries(kind, key, timestampMs);
+            series->Instance = instance;
+        }
+
+        // PID 已被新进程复用：旧进程的历史不属于它，清空后重新开始 (缓冲区原样复用)
+        if (series->Instance != instance)
+        {
+            for (Tier& tier : series->Tiers) tier.Filled = 0;
+            series->Instance = instance;
+        }
+
+        const float sample = static_cast<float>(value);
+        for (size_t tier = 0; tier < 3; ++tier)
+        {
+            series->Tiers[tier].Add(FloorDivide(timestampMs, ResolutionMs[tier]), sample);
+        }
+
+        series->LastUpdateMs = (std::max)(series->LastUpdateMs, timestampMs);
+        LinkNewest(*series);
+    }
+
+    MetricsStore::Series& MetricsStore::CreateSeries(MetricKind kind, uint64_t key, int64_t timestampMs)
+    {
+        SeriesMap::node_type node;
+
+        if (_series.size() >= _maxSeries)
+        {
+            // 最久未更新的序列仍然存活说明存活序列多于上限：按存活数量扩容，避免每个周期互相淘汰
+            if (timestampMs - _oldest->LastUpdateMs < LiveWindowMs && _maxSeries < MaxSeriesLimit)
+            {
+                _maxSeries = (std::min)(_maxSeries * 2, MaxSeriesLimit);
+            }
+            else
+            {
+                Series& oldest = *_oldest;
+                Unlink(oldest);
+                node = _series.extract(oldest.Key);
+            }
+        }
+
+        if (node.empty() && !_spare.empty())
+        {
+            node = std::move(_spare.back());
+            _spare.pop_back();
+        }
+
+        // 复用淘汰或清理下来的节点：只改键并重置环，不重新分配；没有可复用的节点时才分配
+        Series* series = nullptr;
+        if (!node.empty())
+        {
+            node.key() = key;
+            series = &_series.insert(std::move(node)).position->second;
+        }
+        else
+        {
+            series = &_series.try_emplace(key).first->second;
+        }
+
+        const size_t* capacity = IsSystemKind(kind) ? SystemCapacity : ProcessCapacity;
+        for (size_t tier = 0; tier < 3; ++tier)
+        {
+            Tier& ring = series->Tiers[tier];
+            if (ring.Buckets.size() != capacity[tier]) ring.Buckets.assign(capacity[tier], Bucket{});
+            ring.Filled = 0;
+            ring.Newest = 0;
+        }
+
+        series->Key = key;
+        series->LastUpdateMs = timestampMs;
+        series->Instance = 0;
+        series->Older = nullptr;
+        series->Newer = nullptr;
+        return *series;
+    }
+
+    void MetricsStore::Tier::Add(int64_t index, float value) noexcept
+    {
+        const size_t capacity = Buckets.size();
+
+        if (Filled == 0)
+        {
+            Newest = index;
+            Filled = 1;
+            Buckets[SlotOf(index)] = {};
+        }
+        else if (index > Newest)
+        {
+            // 清空新进入窗口的桶 (包括没有样本的间隙)，最多清空整个环
+            const int64_t advance = (std::min)(index - Newest, static_cast<int64_t>(capacity));
+            for (int64_t n = index - advance + 1; n <= index; ++n)
+            {
+                Buckets[SlotOf(n)] = {};
+            }
+
+            Filled = (std::min)(Filled + static_cast<size_t>(index - Newest), capacity);
+            Newest = index;
+        }
+        else if (Newest - index >= static_cast<int64_t>(Filled))
+        {
+            // 早于窗口的迟到样本 (例如系统时间被回拨) 直接丢弃
+            return;
+        }
+
+        Bucket& bucket = Buckets[SlotOf(index)];
+        if (bucket.Count == 0)
+        {
+            bucket.Min = value;
+            bucket.Max = value;
+            bucket.Sum = value;
+        }
+        else
+        {
+            bucket.Min = (std::min)(bucket.Min, value);
+            bucket.Max = (std::max)(bucket.Max, value);
+            bucket.Sum += value;
+        }
+        ++bucket.Count;
+    }
+
+    size_t MetricsStore::Query(MetricKind kind, uint32_t id, MetricResolution resolution,
+        int64_t fromMs, int64_t toMs, MetricPoint* buffer, size_t maxCount) const
+    {
+        const size_t tierIndex = static_cast<size_t>(resolution);
+        if (!buffer || maxCount == 0 || tierIndex >= 3 || fromMs > toMs) return 0;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _series.find(MakeKey(kind, id));
+        if (it == _series.end()) return 0;
+
+        const Tier& tier = it->second.Tiers[tierIndex];
+        if (tier.Filled == 0) return 0;
+
+        const int64_t width = ResolutionMs[tierIndex];
+        const int64_t oldest = tier.Newest - static_cast<int64_t>(tier.Filled) + 1;
+
+        // 把时间窗口换算为桶序号并裁剪到环中实际保存的范围
+        int64_t first = (std::max)(oldest, FloorDivide(fromMs + width - 1, width));
+        const int64_t last = (std::min)(tier.Newest, FloorDivide(toMs, width));
+        if (first > last) return 0;
+
+        // 超出容量时保留最新的部分：先从后往前数出 maxCount 个非空桶
+        size_t nonEmpty = 0;
+        for (int64_t n = last; n >= first; --n)
+        {
+            if (tier.Buckets[tier.SlotOf(n)].Count == 0) continue;
+            if (++nonEmpty == maxCount)
+            {
+                first = n;
+                break;
+            }
+        }
+
+        size_t count = 0;
+        for (int64_t n = first; n <= last && count < maxCount; ++n)
+        {
+            const Bucket& bucket = tier.Buckets[tier.SlotOf(n)];
+            if (bucket.Count == 0) continue;
+
+            MetricPoint& point = buffer[count++];
+            point.TimestampMs = n * width;
+            point.Min = bucket.Min;
+            point.Max = bucket.Max;
+            point.Avg = bucket.Sum / static_cast<float>(bucket.Count);
+            point.Count = bucket.Count;
+        }
+
+        return count;
+    }
+
+    size_t MetricsStore::SeriesCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _series.size();
+    }
+
+    size_t MetricsStore::MaxSeries() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _maxSeries;
+    }
+
+    void MetricsStore::Clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _series.clear();
+        _spare.clear();
+        _oldest = nullptr;
+        _newest = nullptr;
+    }
+
+    void MetricsStore::PruneLocked(int64_t nowMs)
+    {
+        if (nowMs - _lastPruneMs < PruneIntervalMs) return;
+        _lastPruneMs = nowMs;
+
+        // 从最久未更新的一端开始，遇到仍在逐进程窗口 (最短的保留时长) 内更新过的序列即可停止
+        const int64_t shortestRetentionMs = static_cast<int64_t>(ProcessCapacity[2]) * ResolutionMs[2];
+
+        for (Series* series = _oldest; series && nowMs - series->LastUpdateMs > shortestRetentionMs;)
+        {
+            Series* next = series->Newer;
+
+            // 最粗分辨率的窗口就是序列可查询的最长时间
+            const int64_t retentionMs = static_cast<int64_t>(series->Tiers[2].Buckets.size()) * ResolutionMs[2];
+            if (nowMs - series->LastUpdateMs > retentionMs) Retire(_series.find(series->Key));
+
+            series = next;
+        }
+    }
+
+    void MetricsStore::Retire(SeriesMap::iterator it)
+    {
+        Unlink(it->second);
+
+        if (_spare.size() < MaxSpareSeries) _spare.push_back(_series.extract(it));
+        else _series.erase(it);
+    }
+
+    void MetricsStore::Unlink(Series& series) noexcept
+    {
+        (series.Older ? series.Older->Newer : _oldest) = series.Newer;
+        (series.Newer ? series.Newer->Older : _newest) = series.Older;
+        series.Older = nullptr;
+        series.Newer = nullptr;
+    }
+
+    void MetricsStore::LinkNewest(Series& series) noexcept
+    {
+        series.Older = _newest;
+        series.Newer = nullptr;
+        (_newest ? _newest->Newer : _oldest) = &series;
+        _newest = &series;
+    }
+
+    int64_t MetricsStore::NowMs() noexcept
+    {
+        return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    extern "C"
+    {
+        uint32_t Metrics_Query(MetricKind kind, uint32_t id, MetricResolution resolution,
+            int64_t fromMs, int64_t toMs, MetricPoint* buffer, uint32_t maxCount)
+        {
+            return static_cast<uint32_t>(MetricsStore::Shared().Query(kind, id, resolution, fromMs, toMs, buffer, maxCount));
+        }
+
+        uint32_t Metrics_GetSeriesCount()
+        {
+            return static_cast<uint32_t>(MetricsStore::Shared().SeriesCount());
+        }
+
+        void Metrics_Clear()
+        {
+            MetricsStore::Shared().Clear();
+        }
+    }
+}
@@ -0,0 +1,223 @@
+﻿#pragma once
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace IronSight::Core::Native::Metrics
+{
+	/// <summary>
+	/// 指标类型 (与 C# MetricKind 保持同步)
+	/// </summary>
+	enum class MetricKind : uint32_t
+	{
+		SystemCpu = 1,          // 系统 CPU 使用率 (%)
+		SystemMemory = 2,       // 系统内存占用率 (%)
+		DiskRead = 3,           // 磁盘读取 (字节/秒)
+		DiskWrite = 4,          // 磁盘写入 (字节/秒)
+		ProcessCpu = 5,         // 进程 CPU 占用 (%)，Id 为 PID
+		ProcessMemory = 6,      // 进程私有内存 (MB)，Id 为 PID
+		ConnectionCount = 7     // 进程连接数，Id 为 PID
+	};
+
+	/// <summary>
+	/// 聚合分辨率 (与 C# MetricResolution 保持同步)
+	/// </summary>
+	enum class MetricResolution : uint32_t
+	{
+		Second = 0,             // 1 秒
+		TenSeconds = 1,         // 10 秒
+		Minute = 2              // 1 分钟
+	};
+
+#pragma pack(push, 8)
+	/// <summary>
+	/// 一个聚合桶：桶起始时间与桶内样本的最小/最大/平均值
+	/// </summary>
+	struct MetricPoint
+	{
+		int64_t TimestampMs;    // 桶起始时间 (Unix 毫秒)
+		float Min;
+		float Max;
+		float Avg;
+		uint32_t Count;         // 桶内样本数
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(MetricPoint) == 24,
+		"MetricPoint size mismatch");
+
+	/// <summary>
+	/// 原生内存时间序列存储
+	/// 每个序列 (指标类型 + Id) 按 1 秒、10 秒、1 分钟三种分辨率各持有一个固定容量的环形缓冲区，
+	/// 每个样本同时累加到三个分辨率的当前桶，无需单独的降采样任务；桶时间由环中位置隐式确定，每桶只占 16 字节。
+	/// 序列按最近更新排成侵入式链表：达到上限时若最久未更新的序列仍在更新 (存活序列多于上限) 则上限随之增长，
+	/// 否则淘汰它并复用其节点与环形缓冲区；长时间停止更新的序列定期清理，因此内存占用只取决于存活的序列数。
+	/// 进程级序列记录进程实例 (创建时间)，PID 被新进程复用时清空旧历史而不是与之合并
+	/// </summary>
+	class MetricsStore
+	{
+		public:
+		/// <summary>
+		/// 获取全局共享的存储 (刻意不析构，与采样线程的退出顺序无关)
+		/// </summary>
+		static MetricsStore& Shared();
+
+		explicit MetricsStore(size_t maxSeries = DefaultMaxSeries);
+
+		MetricsStore(const MetricsStore&) = delete;
+		MetricsStore& operator=(const MetricsStore&) = delete;
+
+		/// <summary>
+		/// 记录一个样本
+		/// </summary>
+		/// <param name="instance">进程级指标为进程创建时间，与序列记录的不同时先清空旧历史；系统级指标为 0</param>
+		void Record(MetricKind kind, uint32_t id, int64_t timestampMs, double value, uint64_t instance = 0);
+
+		/// <summary>
+		/// 在一次加锁内记录一批同一时刻的样本 (例如整张进程表)
+		/// fill 接收一个可调用对象 record(kind, id, value [, instance])
+		/// </summary>
+		template <typename Fill>
+		void RecordBatch(int64_t timestampMs, Fill&& fill)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			fill([&](MetricKind kind, uint32_t id, double value, uint64_t instance = 0) { RecordLocked(kind, id, timestampMs, value, instance); });
+			PruneLocked(timestampMs);
+		}
+
+		/// <summary>
+		/// 查询 [fromMs, toMs] 内起始的非空桶，按时间升序写入 buffer (含尚未结束的当前桶)
+		/// 窗口超出 buffer 容量时保留最新的部分；进程级序列只含当前使用该 PID 的进程的历史
+		/// </summary>
+		/// <returns>写入的点数</returns>
+		size_t Query(MetricKind kind, uint32_t id, MetricResolution resolution,
+			int64_t fromMs, int64_t toMs, MetricPoint* buffer, size_t maxCount) const;
+
+		/// <summary>
+		/// 当前序列数量
+		/// </summary>
+		size_t SeriesCount() const;
+
+		/// <summary>
+		/// 删除全部序列
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// 当前 Unix 时间 (毫秒)
+		/// </summary>
+		static int64_t NowMs() noexcept;
+
+		/// <summary>
+		/// 当前的序列数量上限 (随存活序列数增长)
+		/// </summary>
+		size_t MaxSeries() const;
+
+		static constexpr size_t DefaultMaxSeries = 2048;
+
+		// 存活序列再多也不超过的上限 (逐进程序列约 16 KB)
+		static constexpr size_t MaxSeriesLimit = 32768;
+
+		private:
+		struct Bucket
+		{
+			float Min;
+			float Max;
+			float Sum;
+			uint32_t Count;     // 0 表示空桶
+		};
+
+		// 环形缓冲区：Newest 为最新桶的绝对序号 (时间 / 分辨率)，序号 n 存放在 n % 容量处
+		struct Tier
+		{
+			std::vector<Bucket> Buckets;
+			int64_t Newest = 0;
+			size_t Filled = 0;
+
+			void Add(int64_t index, float value) noexcept;
+
+			size_t SlotOf(int64_t index) const noexcept
+			{
+				const int64_t capacity = static_cast<int64_t>(Buckets.size());
+				return static_cast<size_t>((index % capacity + capacity) % capacity);
+			}
+		};
+
+		struct Series
+		{
+			Tier Tiers[3];
+			int64_t LastUpdateMs = 0;
+			uint64_t Key = 0;
+			uint64_t Instance = 0;      // 进程创建时间 (系统级序列为 0)
+			Series* Older = nullptr;    // 按最近更新排序的链表：更早更新的相邻项
+			Series* Newer = nullptr;
+		};
+
+		using SeriesMap = std::unordered_map<uint64_t, Series>;
+
+		static uint64_t MakeKey(MetricKind kind, uint32_t id) noexcept
+		{
+			return (static_cast<uint64_t>(kind) << 32) | id;
+		}
+
+		static MetricKind KindOf(uint64_t key) noexcept
+		{
+			return static_cast<MetricKind>(key >> 32);
+		}
+
+		// 以下函数要求调用方已持有锁
+		void RecordLocked(MetricKind kind, uint32_t id, int64_t timestampMs, double value, uint64_t instance);
+		Series& CreateSeries(MetricKind kind, uint64_t key, int64_t timestampMs);
+		void PruneLocked(int64_t nowMs);
+		void Retire(SeriesMap::iterator it);
+		void Unlink(Series& series) noexcept;
+		void LinkNewest(Series& series) noexcept;
+
+		mutable std::mutex _mutex;
+		SeriesMap _series;                          // 节点地址在重新散列时不变，链表直接保存 Series 指针
+		std::vector<SeriesMap::node_type> _spare;   // 已清理序列的节点 (连同环形缓冲区) 留给新序列复用
+		Series* _oldest = nullptr;
+		Series* _newest = nullptr;
+		size_t _maxSeries;
+		int64_t _lastPruneMs = 0;
+
+		// 各分辨率的桶宽 (毫秒)
+		static constexpr int64_t ResolutionMs[3] = { 1000, 10000, 60000 };
+
+		// 系统级序列：1 小时 / 6 小时 / 24 小时
+		static constexpr size_t SystemCapacity[3] = { 3600, 2160, 1440 };
+
+		// 逐进程序列数量多，窗口更短：5 分钟 / 1 小时 / 6 小时
+		static constexpr size_t ProcessCapacity[3] = { 300, 360, 360 };
+
+		// 超过最长窗口仍未更新的序列 (通常是已退出的进程) 不会再有可查询的数据
+		static constexpr int64_t PruneIntervalMs = 60000;
+
+		// 达到上限时，最久未更新的序列在这段时间内仍有更新则视为存活，扩大上限而不是淘汰它
+		// (远大于采样间隔，同一批次中稍后才会更新的序列不会被误判为可淘汰)
+		static constexpr int64_t LiveWindowMs = 30000;
+
+		// 保留的空闲节点数，多出的直接释放
+		static constexpr size_t MaxSpareSeries = 256;
+	};
+
+	extern "C"
+	{
+		/// <summary>
+		/// 查询一个序列在 [fromMs, toMs] 内的聚合点 (Unix 毫秒)，按时间升序
+		/// </summary>
+		/// <returns>写入的点数</returns>
+		__declspec(dllexport) uint32_t Metrics_Query(MetricKind kind, uint32_t id, MetricResolution resolution,
+			int64_t fromMs, int64_t toMs, MetricPoint* buffer, uint32_t maxCount);
+
+		/// <summary>
+		/// 当前序列数量
+		/// </summary>
+		__declspec(dllexport) uint32_t Metrics_GetSeriesCount();
+
+		/// <summary>
+		/// 删除全部历史
+		/// </summary>
+		__declspec(dllexport) void Metrics_Clear();
+	}
+}
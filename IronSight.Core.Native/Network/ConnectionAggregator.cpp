@@ -0,0 +1,99 @@
+﻿#include <pch.h>
+#include "ConnectionAggregator.h"
+#include <algorithm>
+
+namespace IronSight::Core::Native::Network
+{
+    namespace
+    {
+        // 远程端点键：地址族 | 地址 (IPv4 地址或 IPv6 地址表索引) | 端口
+        // 同一快照内 IPv6 地址已驻留，索引相同即地址相同，可以直接作为键
+        inline uint64_t RemoteEndpointKey(const NetworkConnectionRow& row) noexcept
+        {
+            return (static_cast<uint64_t>(row.Family == AddressFamily::Ipv6) << 48) |
+                (static_cast<uint64_t>(row.RemoteAddress) << 16) |
+                row.RemotePort;
+        }
+
+        // 排序去重并返回不同元素的数量
+        template <typename T>
+        inline size_t SortUnique(T* first, T* last)
+        {
+            std::sort(first, last);
+            return static_cast<size_t>(std::unique(first, last) - first);
+        }
+    }
+
+    void ConnectionAggregator::Build(ConnectionSnapshot& snapshot)
+    {
+        auto& summaries = snapshot.Processes;
+        auto& listeningPorts = snapshot.ListeningPorts;
+        auto& portIndex = snapshot.LocalPortIndex;
+
+        summaries.clear();
+        listeningPorts.clear();
+        portIndex.clear();
+        _remoteEndpoints.clear();
+
+        const auto& rows = snapshot.Connections.Rows;
+        ProcessConnectionSummary* current = nullptr;
+
+        // 结束当前进程：对本进程的端口与端点段原地去重
+        auto finish = [&]()
+        {
+            if (!current) return;
+
+            uint16_t* ports = listeningPorts.data() + current->ListeningPortOffset;
+            current->ListeningPortCount = static_cast<uint32_t>(SortUnique(ports, ports + current->ListeningPortCount));
+            listeningPorts.resize(current->ListeningPortOffset + current->ListeningPortCount);
+
+            current->RemoteEndpointCount = static_cast<uint32_t>(
+                SortUnique(_remoteEndpoints.data(), _remoteEndpoints.data() + _remoteEndpoints.size()));
+            _remoteEndpoints.clear();
+        };
+
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            const auto& row = rows[i];
+
+            if (!current || current->ProcessId != row.ProcessId)
+            {
+                finish();
+
+                summaries.push_back({});
+                current = &summaries.back();
+                current->ProcessId = row.ProcessId;
+                current->FirstRow = static_cast<uint32_t>(i);
+                current->ListeningPortOffset = static_cast<uint32_t>(listeningPorts.size());
+            }
+
+            ++current->ConnectionCount;
+
+            if (row.Protocol == static_cast<uint8_t>(ProtocolType::Tcp)) ++current->TcpCount;
+            else if (row.Protocol == static_cast<uint8_t>(ProtocolType::Udp)) ++current->UdpCount;
+
+            if (row.Family == AddressFamily::Ipv6) ++current->Ipv6Count;
+
+            if (row.State < ConnectionStateCount) ++current->StateCounts[row.State];
+
+            if (row.State == static_cast<uint8_t>(ConnectionState::Listen))
+            {
+                listeningPorts.push_back(row.LocalPort);
+                ++current->ListeningPortCount;
+            }
+
+            // 远程端口为 0 表示未连接 (监听 / UDP)，不计入远程端点
+            if (row.RemotePort != 0)
+            {
+                _remoteEndpoints.push_back(RemoteEndpointKey(row));
+            }
+
+            portIndex.push_back((static_cast<uint64_t>(row.LocalPort) << 32) | i);
+        }
+
+        finish();
+
+        // 键的高位为端口、低位为行下标：排序后同一端口的行连续且保持行序
+        std::sort(portIndex.begin(), portIndex.end());
+    }
+}
@@ -0,0 +1,24 @@
+﻿#pragma once
+#include "ConnectionSnapshot.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// 按进程聚合连接表，并在同一次扫描中收集本地端口索引
+	/// 要求行已按连接键排序 (PID 在最前)，同一进程的行连续存放，一次线性扫描即可完成；
+	/// 输出与临时缓冲区均复用容量，稳态下不产生新分配
+	/// </summary>
+	class ConnectionAggregator
+	{
+		public:
+		/// <summary>
+		/// 根据快照的连接表 (已排序) 构建进程汇总、监听端口与本地端口索引
+		/// </summary>
+		/// <param name="snapshot">待发布的快照，Processes / ListeningPorts / LocalPortIndex 会被重建</param>
+		void Build(ConnectionSnapshot& snapshot);
+
+		private:
+		// 当前进程的远程端点键，用于去重计数
+		std::vector<uint64_t> _remoteEndpoints;
+	};
+}
@@ -0,0 +1,130 @@
+﻿#include <pch.h>
+#include "ConnectionDiff.h"
+#include <algorithm>
+#include <cstring>
+
+namespace IronSight::Core::Native::Network
+{
+    namespace
+    {
+        inline int CompareAddress(AddressFamily family,
+            uint32_t a, const Ipv6AddressTable& aAddresses,
+            uint32_t b, const Ipv6AddressTable& bAddresses) noexcept
+        {
+            if (family == AddressFamily::Ipv4)
+            {
+                return a == b ? 0 : (a < b ? -1 : 1);
+            }
+
+            // 同一张地址表内索引相同即地址相同，省去一次 16 字节比较
+            if (&aAddresses == &bAddresses && a == b) return 0;
+            return std::memcmp(aAddresses[a].Bytes, bAddresses[b].Bytes, sizeof(Ipv6Address::Bytes));
+        }
+
+        inline NetworkConnectionRowDelta MakeDelta(const NetworkConnectionRow& row,
+            ConnectionChangeKind kind, uint8_t previousState) noexcept
+        {
+            NetworkConnectionRowDelta delta{};
+            delta.Connection = row;
+            delta.Kind = static_cast<uint8_t>(kind);
+            delta.PreviousState = previousState;
+            return delta;
+        }
+
+        // 上一代的行改为引用本代地址表
+        inline NetworkConnectionRow Rebase(NetworkConnectionRow row,
+            const Ipv6AddressTable& from, Ipv6AddressTable& to)
+        {
+            if (row.Family == AddressFamily::Ipv6)
+            {
+                row.LocalAddress = to.Intern(from[row.LocalAddress]);
+                row.RemoteAddress = to.Intern(from[row.RemoteAddress]);
+            }
+            return row;
+        }
+    }
+
+    int ConnectionDiff::CompareKey(const NetworkConnectionRow& a, const Ipv6AddressTable& aAddresses,
+        const NetworkConnectionRow& b, const Ipv6AddressTable& bAddresses) noexcept
+    {
+        // PID 放在最前面：同一进程的连接在表中连续存放
+        if (a.ProcessId != b.ProcessId) return a.ProcessId < b.ProcessId ? -1 : 1;
+        if (a.Protocol != b.Protocol) return a.Protocol < b.Protocol ? -1 : 1;
+        if (a.Family != b.Family) return a.Family < b.Family ? -1 : 1;
+
+        int result = CompareAddress(a.Family, a.LocalAddress, aAddresses, b.LocalAddress, bAddresses);
+        if (result != 0) return result;
+        if (a.LocalPort != b.LocalPort) return a.LocalPort < b.LocalPort ? -1 : 1;
+
+        result = CompareAddress(a.Family, a.RemoteAddress, aAddresses, b.RemoteAddress, bAddresses);
+        if (result != 0) return result;
+        if (a.RemotePort != b.RemotePort) return a.RemotePort < b.RemotePort ? -1 : 1;
+        return 0;
+    }
+
+    void ConnectionDiff::SortByKey(ConnectionTable& table)
+    {
+        const Ipv6AddressTable& addresses = table.Addresses;
+
+        std::sort(table.Rows.begin(), table.Rows.end(),
+            [&addresses](const NetworkConnectionRow& a, const NetworkConnectionRow& b)
+            {
+                return CompareKey(a, addresses, b, addresses) < 0;
+            });
+    }
+
+    void ConnectionDiff::Compute(const ConnectionTable& previous,
+        ConnectionTable& current,
+        std::vector<NetworkConnectionRowDelta>& delta)
+    {
+        delta.clear();
+
+        const auto& oldRows = previous.Rows;
+        const auto& newRows = current.Rows;
+        const auto Unknown = static_cast<uint8_t>(ConnectionState::Unknown);
+
+        size_t i = 0;
+        size_t j = 0;
+
+        // 两代表均已排序，一次线性归并即可得到全部变更
+        while (i < oldRows.size() && j < newRows.size())
+        {
+            const auto& oldRow = oldRows[i];
+            const auto& newRow = newRows[j];
+
+            int order = CompareKey(oldRow, previous.Addresses, newRow, current.Addresses);
+
+            if (order < 0)
+            {
+                delta.push_back(MakeDelta(Rebase(oldRow, previous.Addresses, current.Addresses),
+                    ConnectionChangeKind::Removed, oldRow.State));
+                ++i;
+            }
+            else if (order > 0)
+            {
+                delta.push_back(MakeDelta(newRow, ConnectionChangeKind::Added, Unknown));
+                ++j;
+            }
+            else
+            {
+                if (oldRow.State != newRow.State)
+                {
+                    delta.push_back(MakeDelta(newRow, ConnectionChangeKind::StateChanged, oldRow.State));
+                }
+                ++i;
+                ++j;
+            }
+        }
+
+        for (; i < oldRows.size(); ++i)
+        {
+            delta.push_back(MakeDelta(Rebase(oldRows[i], previous.Addresses, current.Addresses),
+                ConnectionChangeKind::Removed, oldRows[i].State));
+        }
+
+        for (; j < newRows.size(); ++j)
+        {
+            delta.push_back(MakeDelta(newRows[j], ConnectionChangeKind::Added, Unknown));
+        }
+    }
+}
@@ -0,0 +1,37 @@
+﻿#pragma once
+#include "ConnectionTable.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// 连接表差量计算器
+	/// 只依赖标准库，录制下来的连接表可以在任意平台上回放验证
+	/// </summary>
+	class ConnectionDiff
+	{
+		public:
+		/// <summary>
+		/// 连接键比较：PID + 协议 + 地址族 + 五元组，不包含状态
+		/// IPv6 行按地址值比较 (只有 IPv6 行才会访问地址表)，因此可以跨两代快照比较
+		/// </summary>
+		/// <returns>a 小于 b 返回负数，相等返回 0，大于返回正数</returns>
+		static int CompareKey(const NetworkConnectionRow& a, const Ipv6AddressTable& aAddresses,
+			const NetworkConnectionRow& b, const Ipv6AddressTable& bAddresses) noexcept;
+
+		/// <summary>
+		/// 按连接键对连接表排序，Compute 要求两代表都已排序
+		/// </summary>
+		static void SortByKey(ConnectionTable& table);
+
+		/// <summary>
+		/// 归并两代已排序的连接表，仅输出新增、移除与状态变化的行
+		/// Removed 行引用的 IPv6 地址会驻留到本代地址表，增量中的索引均相对于 current
+		/// </summary>
+		/// <param name="previous">上一代连接表 (已排序)</param>
+		/// <param name="current">本代连接表 (已排序)，地址表可能被追加</param>
+		/// <param name="delta">输出的增量记录，调用前会被清空</param>
+		static void Compute(const ConnectionTable& previous,
+			ConnectionTable& current,
+			std::vector<NetworkConnectionRowDelta>& delta);
+	};
+}
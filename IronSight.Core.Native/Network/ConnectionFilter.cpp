@@ -0,0 +1,118 @@
+﻿#include <pch.h>
+#include "ConnectionFilter.h"
+#include <algorithm>
+#include <cstring>
+
+namespace IronSight::Core::Native::Network
+{
+    namespace
+    {
+        inline bool HasFlag(uint32_t flags, ConnectionFilterFlags flag) noexcept
+        {
+            return (flags & static_cast<uint32_t>(flag)) != 0;
+        }
+    }
+
+    ConnectionFilterEvaluator::ConnectionFilterEvaluator(const ConnectionFilter& filter)
+    {
+        uint32_t flags = filter.Flags;
+
+        if (HasFlag(flags, ConnectionFilterFlags::Protocol)) _protocolMask = filter.ProtocolMask;
+        if (HasFlag(flags, ConnectionFilterFlags::State)) _stateMask = filter.StateMask;
+
+        if (HasFlag(flags, ConnectionFilterFlags::LocalPort))
+        {
+            _localPortMin = filter.LocalPortMin;
+            _localPortMax = filter.LocalPortMax;
+        }
+
+        if (HasFlag(flags, ConnectionFilterFlags::RemotePort))
+        {
+            _remotePortMin = filter.RemotePortMin;
+            _remotePortMax = filter.RemotePortMax;
+        }
+
+        if (HasFlag(flags, ConnectionFilterFlags::LocalAddress)) _localPrefix = CompilePrefix(filter.LocalPrefix);
+        if (HasFlag(flags, ConnectionFilterFlags::RemoteAddress)) _remotePrefix = CompilePrefix(filter.RemotePrefix);
+
+        if (HasFlag(flags, ConnectionFilterFlags::ProcessId))
+        {
+            // 排序去重后按 PID 升序定位行段，输出自然保持快照的行序
+            _filterProcessIds = true;
+            if (filter.ProcessIds && filter.ProcessIdCount > 0)
+            {
+                _processIds.assign(filter.ProcessIds, filter.ProcessIds + filter.ProcessIdCount);
+                std::sort(_processIds.begin(), _processIds.end());
+                _processIds.erase(std::unique(_processIds.begin(), _processIds.end()), _processIds.end());
+            }
+        }
+    }
+
+    ConnectionFilterEvaluator::CompiledPrefix ConnectionFilterEvaluator::CompilePrefix(const AddressPrefix& prefix) noexcept
+    {
+        CompiledPrefix compiled;
+        compiled.Enabled = true;
+        compiled.Family = prefix.Family;
+
+        size_t addressBits = prefix.Family == AddressFamily::Ipv6 ? 128 : 32;
+        size_t prefixBits = (std::min)(static_cast<size_t>(prefix.PrefixLength), addressBits);
+
+        // 按字节构造掩码，再按内存顺序装入 64 位字，与网络字节序的地址直接相与
+        uint8_t mask[16] = {};
+        for (size_t i = 0; i < prefixBits / 8; ++i) mask[i] = 0xFF;
+        if (prefixBits % 8 != 0) mask[prefixBits / 8] = static_cast<uint8_t>(0xFF << (8 - prefixBits % 8));
+
+        std::memcpy(compiled.Mask, mask, sizeof(mask));
+        std::memcpy(compiled.Value, prefix.Address.Bytes, sizeof(prefix.Address.Bytes));
+        compiled.Value[0] &= compiled.Mask[0];
+        compiled.Value[1] &= compiled.Mask[1];
+
+        return compiled;
+    }
+
+    bool ConnectionFilterEvaluator::MatchesPrefix(const CompiledPrefix& prefix, const NetworkConnectionRow& row,
+        uint32_t address, const Ipv6AddressTable& addresses) noexcept
+    {
+        if (!prefix.Enabled) return true;
+        if (row.Family != prefix.Family) return false;
+
+        uint64_t words[2] = {};
+        if (row.Family == AddressFamily::Ipv6)
+        {
+            std::memcpy(words, addresses[address].Bytes, sizeof(words));
+        }
+        else
+        {
+            std::memcpy(words, &address, sizeof(address));
+        }
+
+        return (words[0] & prefix.Mask[0]) == prefix.Value[0] &&
+            (words[1] & prefix.Mask[1]) == prefix.Value[1];
+    }
+
+    bool ConnectionFilterEvaluator::Matches(const NetworkConnectionRow& row, const Ipv6AddressTable& addresses) const noexcept
+    {
+        // 先做最便宜的掩码与范围判断，地址前缀放在最后
+        if (!((_protocolMask >> (row.Protocol & 31)) & 1)) return false;
+        if (!((_stateMask >> (row.State & 31)) & 1)) return false;
+        if (row.LocalPort < _localPortMin || row.LocalPort > _localPortMax) return false;
+        if (row.RemotePort < _remotePortMin || row.RemotePort > _remotePortMax) return false;
+
+        return MatchesPrefix(_localPrefix, row, row.LocalAddress, addresses) &&
+            MatchesPrefix(_remotePrefix, row, row.RemoteAddress, addresses);
+    }
+
+    size_t ConnectionFilterEvaluator::Query(const ConnectionSnapshot& snapshot, uint32_t* indices, size_t capacity) const
+    {
+        size_t count = 0;
+
+        ForEachMatch(snapshot, [&](size_t index, const NetworkConnectionRow&)
+            {
+                if (indices && count < capacity) indices[count] = static_cast<uint32_t>(index);
+                ++count;
+                return true;
+            });
+
+        return count;
+    }
+}
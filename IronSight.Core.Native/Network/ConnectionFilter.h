@@ -0,0 +1,87 @@
+﻿#pragma once
+#include "ConnectionIndex.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// 预编译的连接过滤器
+	/// 构造时把 ConnectionFilter 转换为掩码与已排序的 PID 集合，逐行匹配只做整数比较；
+	/// 指定了 PID 集合时利用快照的进程汇总直接定位各进程的连续行段，不扫描其余行
+	/// </summary>
+	class ConnectionFilterEvaluator
+	{
+		public:
+		explicit ConnectionFilterEvaluator(const ConnectionFilter& filter);
+
+		/// <summary>
+		/// 判断单行是否满足全部条件 (PID 条件除外，由 ForEachMatch 按行段处理)
+		/// </summary>
+		bool Matches(const NetworkConnectionRow& row, const Ipv6AddressTable& addresses) const noexcept;
+
+		/// <summary>
+		/// 按行序对快照中每个匹配行调用 callback(index, row)，callback 返回 false 时提前结束
+		/// </summary>
+		template <typename Callback>
+		void ForEachMatch(const ConnectionSnapshot& snapshot, Callback&& callback) const
+		{
+			const auto& rows = snapshot.Connections.Rows;
+			const auto& addresses = snapshot.Connections.Addresses;
+
+			auto scan = [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+				{
+					if (Matches(rows[i], addresses) && !callback(i, rows[i])) return false;
+				}
+				return true;
+			};
+
+			if (!_filterProcessIds)
+			{
+				scan(0, rows.size());
+				return;
+			}
+
+			for (uint32_t pid : _processIds)
+			{
+				const ProcessConnectionSummary* summary = ConnectionIndex::FindProcess(snapshot, pid);
+				if (!summary) continue;
+
+				if (!scan(summary->FirstRow, static_cast<size_t>(summary->FirstRow) + summary->ConnectionCount)) return;
+			}
+		}
+
+		/// <summary>
+		/// 查询快照中的匹配行
+		/// </summary>
+		/// <param name="indices">输出：匹配行在快照行数组中的下标 (升序)，可为空</param>
+		/// <param name="capacity">indices 容量</param>
+		/// <returns>匹配行总数 (可能大于 capacity，调用方可扩容后对同一快照重试)</returns>
+		size_t Query(const ConnectionSnapshot& snapshot, uint32_t* indices, size_t capacity) const;
+
+		private:
+		struct CompiledPrefix
+		{
+			bool Enabled = false;
+			AddressFamily Family = AddressFamily::Ipv4;
+			uint64_t Mask[2] = {};      // 按内存顺序 (网络字节序) 的掩码
+			uint64_t Value[2] = {};     // 已与掩码相与的前缀
+		};
+
+		static CompiledPrefix CompilePrefix(const AddressPrefix& prefix) noexcept;
+		static bool MatchesPrefix(const CompiledPrefix& prefix, const NetworkConnectionRow& row,
+			uint32_t address, const Ipv6AddressTable& addresses) noexcept;
+
+		uint32_t _protocolMask = ~0u;
+		uint32_t _stateMask = ~0u;
+		uint16_t _localPortMin = 0;
+		uint16_t _localPortMax = 0xFFFF;
+		uint16_t _remotePortMin = 0;
+		uint16_t _remotePortMax = 0xFFFF;
+		CompiledPrefix _localPrefix;
+		CompiledPrefix _remotePrefix;
+
+		bool _filterProcessIds = false;
+		std::vector<uint32_t> _processIds;
+	};
+}
@@ -0,0 +1,82 @@
+﻿#include <pch.h>
+#include "ConnectionIndex.h"
+#include <algorithm>
+
+namespace IronSight::Core::Native::Network
+{
+    namespace
+    {
+        // 端口索引中某个端口对应的键区间
+        inline std::pair<const uint64_t*, const uint64_t*> PortRange(const ConnectionSnapshot& snapshot, uint16_t port) noexcept
+        {
+            const auto& index = snapshot.LocalPortIndex;
+            const uint64_t first = static_cast<uint64_t>(port) << 32;
+            const uint64_t last = first | 0xFFFFFFFFull;
+
+            const uint64_t* begin = std::lower_bound(index.data(), index.data() + index.size(), first);
+            const uint64_t* end = std::upper_bound(begin, index.data() + index.size(), last);
+            return { begin, end };
+        }
+
+        inline uint32_t RowOf(uint64_t key) noexcept
+        {
+            return static_cast<uint32_t>(key);
+        }
+    }
+
+    const ProcessConnectionSummary* ConnectionIndex::FindProcess(const ConnectionSnapshot& snapshot, uint32_t processId) noexcept
+    {
+        const auto& processes = snapshot.Processes;
+
+        auto it = std::lower_bound(processes.begin(), processes.end(), processId,
+            [](const ProcessConnectionSummary& summary, uint32_t value) { return summary.ProcessId < value; });
+
+        return (it != processes.end() && it->ProcessId == processId) ? &*it : nullptr;
+    }
+
+    size_t ConnectionIndex::FindByLocalPort(const ConnectionSnapshot& snapshot, uint16_t port,
+        uint32_t* indices, size_t capacity) noexcept
+    {
+        auto [begin, end] = PortRange(snapshot, port);
+        size_t count = static_cast<size_t>(end - begin);
+
+        if (indices)
+        {
+            size_t copyCount = (std::min)(count, capacity);
+            for (size_t i = 0; i < copyCount; ++i) indices[i] = RowOf(begin[i]);
+        }
+
+        return count;
+    }
+
+    bool ConnectionIndex::FindPortOwner(const ConnectionSnapshot& snapshot, uint16_t port,
+        ProtocolType protocol, uint32_t& processId) noexcept
+    {
+        const auto& rows = snapshot.Connections.Rows;
+        const auto wanted = static_cast<uint8_t>(protocol);
+        const auto listen = static_cast<uint8_t>(ConnectionState::Listen);
+
+        auto [begin, end] = PortRange(snapshot, port);
+        const NetworkConnectionRow* fallback = nullptr;
+
+        for (const uint64_t* it = begin; it != end; ++it)
+        {
+            const auto& row = rows[RowOf(*it)];
+            if (row.Protocol != wanted) continue;
+
+            if (protocol != ProtocolType::Tcp || row.State == listen)
+            {
+                processId = row.ProcessId;
+                return true;
+            }
+
+            // 没有监听行时 (例如仅剩已建立的连接) 退而取第一条使用该端口的行
+            if (!fallback) fallback = &row;
+        }
+
+        if (!fallback) return false;
+
+        processId = fallback->ProcessId;
+        return true;
+    }
+}
@@ -0,0 +1,36 @@
+﻿#pragma once
+#include "ConnectionSnapshot.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// 快照二级索引上的点查询
+	/// 进程索引即按 PID 升序的进程汇总 (每个进程的行连续)，端口索引为按本地端口排序的行下标，
+	/// 两者都在发布快照时构建，查询只需二分查找
+	/// </summary>
+	class ConnectionIndex
+	{
+		public:
+		/// <summary>
+		/// 查找进程汇总
+		/// </summary>
+		/// <returns>进程没有套接字时返回 nullptr</returns>
+		static const ProcessConnectionSummary* FindProcess(const ConnectionSnapshot& snapshot, uint32_t processId) noexcept;
+
+		/// <summary>
+		/// 查找使用指定本地端口的行
+		/// </summary>
+		/// <param name="indices">输出：行下标 (升序)，可为空</param>
+		/// <param name="capacity">indices 容量</param>
+		/// <returns>匹配行总数 (可能大于 capacity)</returns>
+		static size_t FindByLocalPort(const ConnectionSnapshot& snapshot, uint16_t port,
+			uint32_t* indices, size_t capacity) noexcept;
+
+		/// <summary>
+		/// 查找占用端口的进程：TCP 优先取监听中的行，UDP 取绑定该端口的端点
+		/// </summary>
+		/// <returns>找到返回 true</returns>
+		static bool FindPortOwner(const ConnectionSnapshot& snapshot, uint16_t port,
+			ProtocolType protocol, uint32_t& processId) noexcept;
+	};
+}
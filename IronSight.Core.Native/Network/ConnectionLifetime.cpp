@@ -0,0 +1,156 @@
+﻿#include <pch.h>
+#include "ConnectionLifetime.h"
+#include "ConnectionDiff.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace IronSight::Core::Native::Network
+{
+    namespace
+    {
+        inline uint64_t UnixTimeMilliseconds() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        inline void CopyAddress(Ipv6Address& target, const NetworkConnectionRow& row, uint32_t value,
+            const Ipv6AddressTable& addresses) noexcept
+        {
+            if (row.Family == AddressFamily::Ipv6)
+            {
+                target = addresses[value];
+            }
+            else
+            {
+                target = {};
+                std::memcpy(target.Bytes, &value, sizeof(value));
+            }
+        }
+    }
+
+    ConnectionLifetimeTracker::ConnectionLifetimeTracker(size_t historyCapacity)
+        : _history((std::max)(historyCapacity, size_t{ 1 }))
+    {
+    }
+
+    void ConnectionLifetimeTracker::Update(const ConnectionSnapshot& previous, ConnectionSnapshot& current,
+        bool trackTcp, bool trackUdp)
+    {
+        const auto& previousRows = previous.Connections.Rows;
+        const auto& currentRows = current.Connections.Rows;
+
+        current.Timestamp = UnixTimeMilliseconds();
+        current.FirstSeen.resize(currentRows.size());
+        current.Churn.clear();
+        _retired.clear();
+
+        auto tracked = [&](const NetworkConnectionRow& row)
+        {
+            return row.Protocol == static_cast<uint8_t>(ProtocolType::Tcp) ? trackTcp : trackUdp;
+        };
+
+        // 没有上一代可比较的协议 (从未采集过)，新出现的行只是"首次看到"而不是"打开"
+        auto counted = [&](const NetworkConnectionRow& row)
+        {
+            return row.Protocol == static_cast<uint8_t>(ProtocolType::Tcp) ? _previousTcp : _previousUdp;
+        };
+
+        // 两代表都按 PID 优先排序，归并输出的 PID 单调不减，变动记录可以顺序追加
+        auto churnOf = [&](uint32_t processId) -> ProcessConnectionChurn&
+        {
+            if (current.Churn.empty() || current.Churn.back().ProcessId != processId)
+            {
+                current.Churn.push_back({ processId, 0, 0 });
+            }
+            return current.Churn.back();
+        };
+
+        size_t i = 0;
+        size_t j = 0;
+
+        while (i < previousRows.size() || j < currentRows.size())
+        {
+            int cmp;
+            if (i == previousRows.size()) cmp = 1;
+            else if (j == currentRows.size()) cmp = -1;
+            else cmp = ConnectionDiff::CompareKey(previousRows[i], previous.Connections.Addresses,
+                currentRows[j], current.Connections.Addresses);
+
+            if (cmp == 0)
+            {
+                current.FirstSeen[j++] = previous.FirstSeen[i++];
+            }
+            else if (cmp < 0)
+            {
+                const auto& row = previousRows[i];
+                if (tracked(row))
+                {
+                    Retire(row, previous.Connections.Addresses, previous.FirstSeen[i], previous.Timestamp);
+                    churnOf(row.ProcessId).Closed++;
+                }
+                ++i;
+            }
+            else
+            {
+                const auto& row = currentRows[j];
+                current.FirstSeen[j++] = current.Timestamp;
+                if (counted(row)) churnOf(row.ProcessId).Opened++;
+            }
+        }
+
+        // 部分刷新沿用了未采集协议的上一代行，采集过一次的协议此后始终有可比较的基线
+        _previousTcp = _previousTcp || trackTcp;
+        _previousUdp = _previousUdp || trackUdp;
+
+        if (_retired.empty()) return;
+
+        std::lock_guard<std::mutex> lock(_historyMutex);
+
+        for (auto& record : _retired)
+        {
+            record.Sequence = _nextSequence++;
+            _history[(record.Sequence - 1) % _history.size()] = record;
+        }
+    }
+
+    void ConnectionLifetimeTracker::Retire(const NetworkConnectionRow& row, const Ipv6AddressTable& addresses,
+        uint64_t firstSeen, uint64_t lastSeen)
+    {
+        ClosedConnectionRecord record{};
+        record.FirstSeen = firstSeen;
+        record.LastSeen = lastSeen;
+        CopyAddress(record.LocalAddress, row, row.LocalAddress, addresses);
+        CopyAddress(record.RemoteAddress, row, row.RemoteAddress, addresses);
+        record.LocalPort = row.LocalPort;
+        record.RemotePort = row.RemotePort;
+        record.ProcessId = row.ProcessId;
+        record.State = row.State;
+        record.Protocol = row.Protocol;
+        record.Family = row.Family;
+
+        _retired.push_back(record);
+    }
+
+    size_t ConnectionLifetimeTracker::CopyClosedTo(ClosedConnectionRecord* buffer, size_t bufferSize,
+        uint64_t afterSequence) const
+    {
+        if (buffer == nullptr) return 0;
+
+        std::lock_guard<std::mutex> lock(_historyMutex);
+
+        // 仍保留在缓冲区中的序号区间为 [oldest, _nextSequence)
+        const uint64_t retained = (std::min)(_nextSequence - 1, static_cast<uint64_t>(_history.size()));
+        const uint64_t oldest = _nextSequence - retained;
+
+        size_t copyCount = 0;
+        for (uint64_t sequence = (std::max)(afterSequence + 1, oldest);
+            sequence < _nextSequence && copyCount < bufferSize; ++sequence)
+        {
+            buffer[copyCount++] = _history[(sequence - 1) % _history.size()];
+        }
+
+        return copyCount;
+    }
+}
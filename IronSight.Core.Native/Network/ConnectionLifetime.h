@@ -0,0 +1,58 @@
+﻿#pragma once
+#include <mutex>
+#include "ConnectionSnapshot.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// 连接生命周期跟踪器
+	/// 归并相邻两代已排序的快照：延续的行继承首次观察时间，新行记为本周期打开，
+	/// 消失的行记为关闭并退役到固定容量的环形缓冲区，内存占用与连接变动速率无关
+	/// </summary>
+	class ConnectionLifetimeTracker
+	{
+		public:
+		explicit ConnectionLifetimeTracker(size_t historyCapacity = DefaultHistoryCapacity);
+
+		// 禁止拷贝
+		ConnectionLifetimeTracker(const ConnectionLifetimeTracker&) = delete;
+		ConnectionLifetimeTracker& operator=(const ConnectionLifetimeTracker&) = delete;
+
+		/// <summary>
+		/// 为待发布的快照打时间戳并填充 FirstSeen 与 Churn，同时退役已关闭的连接
+		/// 只由刷新线程调用；部分刷新时未采集的协议既不退役也不计数
+		/// </summary>
+		/// <param name="previous">当前已发布的快照 (已排序)</param>
+		/// <param name="current">待发布的快照 (已排序)</param>
+		/// <param name="trackTcp">本次刷新是否采集了 TCP</param>
+		/// <param name="trackUdp">本次刷新是否采集了 UDP</param>
+		void Update(const ConnectionSnapshot& previous, ConnectionSnapshot& current, bool trackTcp, bool trackUdp);
+
+		/// <summary>
+		/// 复制序号大于 afterSequence 的已关闭连接 (按序号升序)
+		/// 读者落后超过缓冲区容量时从仍保留的最早记录开始，调用方可由序号的间断检测丢失
+		/// </summary>
+		/// <param name="buffer">目标缓冲区</param>
+		/// <param name="bufferSize">缓冲区大小(元素数量)</param>
+		/// <param name="afterSequence">上次读取到的最后序号，首次读取传 0</param>
+		/// <returns>实际复制的数量</returns>
+		size_t CopyClosedTo(ClosedConnectionRecord* buffer, size_t bufferSize, uint64_t afterSequence) const;
+
+		static constexpr size_t DefaultHistoryCapacity = 4096;
+
+		private:
+		void Retire(const NetworkConnectionRow& row, const Ipv6AddressTable& addresses,
+			uint64_t firstSeen, uint64_t lastSeen);
+
+		// 本次更新退役的记录，归并结束后一次性写入环形缓冲区，缩短持锁时间
+		std::vector<ClosedConnectionRecord> _retired;
+
+		// 已采集过的协议：从未采集过的协议首次出现时不计为打开
+		bool _previousTcp = false;
+		bool _previousUdp = false;
+
+		mutable std::mutex _historyMutex;
+		std::vector<ClosedConnectionRecord> _history;
+		uint64_t _nextSequence = 1;
+	};
+}
@@ -0,0 +1,84 @@
+﻿#pragma once
+#include "ConnectionTable.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// 不可变的连接表快照
+	/// 发布之后内容不再修改；只有在不再是当前快照且没有读者固定时才会被刷新线程复用
+	/// </summary>
+	struct ConnectionSnapshot
+	{
+		uint64_t Version = 0;                               // 快照代数，每次刷新递增
+		uint64_t Timestamp = 0;                             // 采集时间 (Unix 毫秒)
+		ConnectionTable Connections;                        // 双栈连接表 (行 + IPv6 地址表)
+		std::vector<NetworkConnectionRowDelta> Delta;       // 相对上一代的增量 (仅增量模式)
+		std::vector<ProcessConnectionSummary> Processes;    // 按 PID 升序的进程汇总
+		std::vector<uint16_t> ListeningPorts;               // 各进程的监听端口 (由 ProcessConnectionSummary 引用)
+		std::vector<uint64_t> LocalPortIndex;               // 本地端口索引：(LocalPort << 32) | 行下标，按端口升序
+		std::vector<uint64_t> FirstSeen;                    // 每行首次观察到的时间 (Unix 毫秒)，与 Connections.Rows 一一对应
+		std::vector<ProcessConnectionChurn> Churn;          // 按 PID 升序的本周期连接变动 (仅包含有变动的进程)
+
+		size_t Ipv4ConnectionCount = 0;                     // v1 接口可见的连接数 (仅 IPv4 行)
+		size_t Ipv4DeltaCount = 0;                          // v1 接口可见的增量数 (仅 IPv4 行)
+
+		mutable std::atomic<uint32_t> Readers{ 0 };         // 固定该快照的读者数量
+	};
+
+	/// <summary>
+	/// 读者持有的快照视图 (RAII)，析构时自动解除固定
+	/// 视图存活期间快照内容保证不变，读取无需任何锁
+	/// </summary>
+	class ConnectionSnapshotView
+	{
+		public:
+		ConnectionSnapshotView() noexcept = default;
+		explicit ConnectionSnapshotView(const ConnectionSnapshot* snapshot) noexcept : _snapshot(snapshot) {}
+		~ConnectionSnapshotView() { Release(); }
+
+		ConnectionSnapshotView(const ConnectionSnapshotView&) = delete;
+		ConnectionSnapshotView& operator=(const ConnectionSnapshotView&) = delete;
+
+		ConnectionSnapshotView(ConnectionSnapshotView&& other) noexcept : _snapshot(other._snapshot)
+		{
+			other._snapshot = nullptr;
+		}
+
+		ConnectionSnapshotView& operator=(ConnectionSnapshotView&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Release();
+				_snapshot = other._snapshot;
+				other._snapshot = nullptr;
+			}
+			return *this;
+		}
+
+		explicit operator bool() const noexcept { return _snapshot != nullptr; }
+		const ConnectionSnapshot* operator->() const noexcept { return _snapshot; }
+		const ConnectionSnapshot& operator*() const noexcept { return *_snapshot; }
+
+		/// <summary>
+		/// 放弃所有权但不解除固定，用于把快照交给 C 接口的调用方
+		/// </summary>
+		const ConnectionSnapshot* Detach() noexcept
+		{
+			const ConnectionSnapshot* snapshot = _snapshot;
+			_snapshot = nullptr;
+			return snapshot;
+		}
+
+		void Release() noexcept
+		{
+			if (_snapshot)
+			{
+				_snapshot->Readers.fetch_sub(1);
+				_snapshot = nullptr;
+			}
+		}
+
+		private:
+		const ConnectionSnapshot* _snapshot = nullptr;
+	};
+}
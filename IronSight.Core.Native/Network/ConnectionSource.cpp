@@ -0,0 +1,22 @@
+﻿#include <pch.h>
+#include "ConnectionSource.h"
+
+#if defined(_WIN32)
+#include "IpHelperConnectionSource.h"
+#elif defined(__linux__)
+#include "ProcNetConnectionSource.h"
+#endif
+
+namespace IronSight::Core::Native::Network
+{
+    std::unique_ptr<IConnectionSource> IConnectionSource::CreateDefault()
+    {
+#if defined(_WIN32)
+        return std::make_unique<IpHelperConnectionSource>();
+#elif defined(__linux__)
+        return std::make_unique<ProcNetConnectionSource>();
+#else
+        return nullptr;
+#endif
+    }
+}
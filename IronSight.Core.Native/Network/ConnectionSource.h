@@ -0,0 +1,38 @@
+﻿#pragma once
+#include "ConnectionTable.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// 连接数据源接口
+	/// NetworkMonitor 只负责代数管理与差量，连接表的获取由具体平台的数据源完成
+	/// </summary>
+	class IConnectionSource
+	{
+		public:
+		virtual ~IConnectionSource() = default;
+
+		/// <summary>
+		/// 每次刷新开始前调用一次，数据源可在此准备本轮共享的数据 (例如 inode 到 PID 的映射)
+		/// </summary>
+		virtual void BeginRefresh() {}
+
+		/// <summary>
+		/// 追加所有 TCP 连接 (IPv4 与 IPv6) 到 table 末尾
+		/// </summary>
+		/// <returns>成功返回true</returns>
+		virtual bool CollectTcp(ConnectionTable& table) = 0;
+
+		/// <summary>
+		/// 追加所有 UDP 端点 (IPv4 与 IPv6) 到 table 末尾
+		/// </summary>
+		/// <returns>成功返回true</returns>
+		virtual bool CollectUdp(ConnectionTable& table) = 0;
+
+		/// <summary>
+		/// 创建当前平台的默认数据源
+		/// Windows 使用 IP Helper API，Linux 使用 /proc/net
+		/// </summary>
+		static std::unique_ptr<IConnectionSource> CreateDefault();
+	};
+}
@@ -0,0 +1,112 @@
+﻿#include <pch.h>
+#include "ConnectionTable.h"
+#include <algorithm>
+#include <cstring>
+
+namespace IronSight::Core::Native::Network
+{
+    size_t Ipv6AddressTable::Hash(const Ipv6Address& address) noexcept
+    {
+        uint64_t high = 0;
+        uint64_t low = 0;
+        std::memcpy(&high, address.Bytes, sizeof(high));
+        std::memcpy(&low, address.Bytes + sizeof(high), sizeof(low));
+
+        // 接口标识 (低 64 位) 区分度最高，混合后折叠为一个字
+        uint64_t hash = low * 0x9E3779B97F4A7C15ull ^ high;
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+
+    Ipv6AddressTable::Slot& Ipv6AddressTable::Probe(const Ipv6Address& address) noexcept
+    {
+        const size_t mask = _slots.size() - 1;
+
+        for (size_t index = Hash(address) & mask;; index = (index + 1) & mask)
+        {
+            Slot& slot = _slots[index];
+            if (slot.Generation != _generation) return slot;
+            if (std::memcmp(_addresses[slot.Index].Bytes, address.Bytes, sizeof(address.Bytes)) == 0) return slot;
+        }
+    }
+
+    void Ipv6AddressTable::Grow()
+    {
+        _slots.assign((std::max)(MinimumSlots, _slots.size() * 2), Slot{});
+        _generation = 1;
+
+        for (uint32_t i = 0; i < _addresses.size(); ++i)
+        {
+            Probe(_addresses[i]) = { _generation, i };
+        }
+    }
+
+    uint32_t Ipv6AddressTable::Intern(const Ipv6Address& address)
+    {
+        // 负载因子不超过 1/2，保证探测序列很短
+        if ((_addresses.size() + 1) * 2 > _slots.size()) Grow();
+
+        Slot& slot = Probe(address);
+        if (slot.Generation == _generation) return slot.Index;
+
+        slot = { _generation, static_cast<uint32_t>(_addresses.size()) };
+        _addresses.push_back(address);
+        return slot.Index;
+    }
+
+    void Ipv6AddressTable::Clear() noexcept
+    {
+        _addresses.clear();
+
+        // 递增代数即清空全部槽；回绕到 0 时才需要真正清零
+        if (++_generation == 0)
+        {
+            std::fill(_slots.begin(), _slots.end(), Slot{});
+            _generation = 1;
+        }
+    }
+
+    void ConnectionTable::AppendIpv4(NetworkConnectionRow row)
+    {
+        row.Family = AddressFamily::Ipv4;
+        Rows.push_back(row);
+    }
+
+    void ConnectionTable::AppendIpv6(NetworkConnectionRow row, const Ipv6Address& local, const Ipv6Address& remote)
+    {
+        uint32_t localIpv4 = 0;
+        uint32_t remoteIpv4 = 0;
+
+        // 对端为映射地址或未指定 (监听 / UDP) 时，整行都可以用 IPv4 表示
+        if (TryGetMappedIpv4(local, localIpv4) &&
+            (TryGetMappedIpv4(remote, remoteIpv4) || IsUnspecified(remote)))
+        {
+            row.Family = AddressFamily::Ipv4;
+            row.LocalAddress = localIpv4;
+            row.RemoteAddress = remoteIpv4;
+        }
+        else
+        {
+            row.Family = AddressFamily::Ipv6;
+            row.LocalAddress = Addresses.Intern(local);
+            row.RemoteAddress = Addresses.Intern(remote);
+        }
+
+        Rows.push_back(row);
+    }
+
+    bool ConnectionTable::TryGetMappedIpv4(const Ipv6Address& address, uint32_t& ipv4) noexcept
+    {
+        static constexpr uint8_t MappedPrefix[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF };
+
+        if (std::memcmp(address.Bytes, MappedPrefix, sizeof(MappedPrefix)) != 0) return false;
+
+        std::memcpy(&ipv4, address.Bytes + sizeof(MappedPrefix), sizeof(ipv4));
+        return true;
+    }
+
+    bool ConnectionTable::IsUnspecified(const Ipv6Address& address) noexcept
+    {
+        static constexpr Ipv6Address Unspecified = {};
+        return std::memcmp(address.Bytes, Unspecified.Bytes, sizeof(address.Bytes)) == 0;
+    }
+}
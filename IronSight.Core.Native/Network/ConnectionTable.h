@@ -0,0 +1,83 @@
+﻿#pragma once
+#include <vector>
+#include "NetworkTypes.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// IPv6 地址驻留表
+	/// 同一快照内相同地址只存一份，行中保存其索引；Clear 保留容量供下一代复用
+	/// 索引为开放寻址 + 线性探测的扁平数组，以代数标记有效槽，Clear 只需递增代数，稳态下不产生任何分配
+	/// </summary>
+	class Ipv6AddressTable
+	{
+		public:
+		/// <summary>
+		/// 返回地址在表中的索引，不存在时追加
+		/// </summary>
+		uint32_t Intern(const Ipv6Address& address);
+
+		const Ipv6Address& operator[](uint32_t index) const noexcept { return _addresses[index]; }
+		const Ipv6Address* Data() const noexcept { return _addresses.data(); }
+		size_t Size() const noexcept { return _addresses.size(); }
+
+		void Clear() noexcept;
+
+		private:
+		struct Slot
+		{
+			uint32_t Generation = 0;    // 与 _generation 不同即为空槽
+			uint32_t Index = 0;         // 地址在 _addresses 中的索引
+		};
+
+		static size_t Hash(const Ipv6Address& address) noexcept;
+
+		// 返回地址所在的槽，或探测序列上的第一个空槽
+		Slot& Probe(const Ipv6Address& address) noexcept;
+
+		// 扩容并按地址数组重建索引 (只在地址数超过历史最大值时发生)
+		void Grow();
+
+		std::vector<Ipv6Address> _addresses;
+		std::vector<Slot> _slots;
+		uint32_t _generation = 1;
+
+		static constexpr size_t MinimumSlots = 64;
+	};
+
+	/// <summary>
+	/// 一代双栈连接表：紧凑的行数组 + 行所引用的 IPv6 地址表
+	/// </summary>
+	struct ConnectionTable
+	{
+		std::vector<NetworkConnectionRow> Rows;
+		Ipv6AddressTable Addresses;
+
+		void Clear() noexcept
+		{
+			Rows.clear();
+			Addresses.Clear();
+		}
+
+		/// <summary>
+		/// 追加一行 IPv4 连接
+		/// </summary>
+		/// <param name="row">除地址族外已填好的行，地址为网络字节序</param>
+		void AppendIpv4(NetworkConnectionRow row);
+
+		/// <summary>
+		/// 追加一行 IPv6 连接。双栈套接字上的 IPv4 映射地址 (::ffff:a.b.c.d) 折叠为 IPv4 行
+		/// </summary>
+		/// <param name="row">除地址外已填好的行</param>
+		/// <param name="local">本地地址</param>
+		/// <param name="remote">远程地址</param>
+		void AppendIpv6(NetworkConnectionRow row, const Ipv6Address& local, const Ipv6Address& remote);
+
+		/// <summary>
+		/// 读取 IPv4 映射地址中的 IPv4 部分 (网络字节序)
+		/// </summary>
+		static bool TryGetMappedIpv4(const Ipv6Address& address, uint32_t& ipv4) noexcept;
+
+		static bool IsUnspecified(const Ipv6Address& address) noexcept;
+	};
+}
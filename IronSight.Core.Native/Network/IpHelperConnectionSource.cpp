@@ -0,0 +1,204 @@
+﻿#include <pch.h>
+#include "IpHelperConnectionSource.h"
+
+#if defined(_WIN32)
+#pragma comment(lib, "iphlpapi.lib")
+#pragma comment(lib, "ws2_32.lib")
+
+namespace IronSight::Core::Native::Network
+{
+    IpHelperConnectionSource::IpHelperConnectionSource()
+    {
+        _tcpTableBuffer.resize(InitialBufferSize);
+        _tcp6TableBuffer.resize(InitialBufferSize);
+        _udpTableBuffer.resize(InitialBufferSize);
+        _udp6TableBuffer.resize(InitialBufferSize);
+    }
+
+    bool IpHelperConnectionSource::QueryTcpTable(std::vector<uint8_t>& buffer, ULONG family)
+    {
+        DWORD bufferSize = static_cast<DWORD>(buffer.size());
+        DWORD result = ERROR_SUCCESS;
+
+        // 循环直到缓冲区足够大
+        while (true)
+        {
+            result = GetExtendedTcpTable(
+                buffer.data(),
+                &bufferSize,
+                FALSE,
+                family,
+                TCP_TABLE_OWNER_PID_ALL,
+                0
+            );
+
+            if (result == ERROR_SUCCESS)
+            {
+                return true;
+            }
+            else if (result == ERROR_INSUFFICIENT_BUFFER)
+            {
+                // 扩展缓冲区并重试
+                buffer.resize(bufferSize + 4096);
+            }
+            else
+            {
+                return false;
+            }
+        }
+    }
+
+    bool IpHelperConnectionSource::QueryUdpTable(std::vector<uint8_t>& buffer, ULONG family)
+    {
+        DWORD bufferSize = static_cast<DWORD>(buffer.size());
+        DWORD result = ERROR_SUCCESS;
+
+        while (true)
+        {
+            result = GetExtendedUdpTable(
+                buffer.data(),
+                &bufferSize,
+                FALSE,
+                family,
+                UDP_TABLE_OWNER_PID,
+                0
+            );
+
+            if (result == ERROR_SUCCESS)
+            {
+                return true;
+            }
+            else if (result == ERROR_INSUFFICIENT_BUFFER)
+            {
+                buffer.resize(bufferSize + 4096);
+            }
+            else
+            {
+                return false;
+            }
+        }
+    }
+
+    ConnectionState IpHelperConnectionSource::ConvertTcpState(DWORD state) noexcept
+    {
+        switch (state)
+        {
+        case MIB_TCP_STATE_CLOSED: return ConnectionState::Closed;
+        case MIB_TCP_STATE_LISTEN: return ConnectionState::Listen;
+        case MIB_TCP_STATE_SYN_SENT: return ConnectionState::SynSent;
+        case MIB_TCP_STATE_SYN_RCVD: return ConnectionState::SynReceived;
+        case MIB_TCP_STATE_ESTAB: return ConnectionState::Established;
+        case MIB_TCP_STATE_FIN_WAIT1: return ConnectionState::FinWait1;
+        case MIB_TCP_STATE_FIN_WAIT2: return ConnectionState::FinWait2;
+        case MIB_TCP_STATE_CLOSE_WAIT: return ConnectionState::CloseWait;
+        case MIB_TCP_STATE_CLOSING: return ConnectionState::Closing;
+        case MIB_TCP_STATE_LAST_ACK: return ConnectionState::LastAck;
+        case MIB_TCP_STATE_TIME_WAIT: return ConnectionState::TimeWait;
+        case MIB_TCP_STATE_DELETE_TCB: return ConnectionState::DeleteTcb;
+        default: return ConnectionState::Unknown;
+        }
+    }
+
+    bool IpHelperConnectionSource::CollectTcp(ConnectionTable& table)
+    {
+        // 未安装 IPv6 协议栈时 AF_INET6 查询会失败，只要任一张表可用即视为成功
+        bool ipv4Success = QueryTcpTable(_tcpTableBuffer, AF_INET);
+        bool ipv6Success = QueryTcpTable(_tcp6TableBuffer, AF_INET6);
+
+        auto* tcpTable = ipv4Success ? reinterpret_cast<MIB_TCPTABLE_OWNER_PID*>(_tcpTableBuffer.data()) : nullptr;
+        auto* tcp6Table = ipv6Success ? reinterpret_cast<MIB_TCP6TABLE_OWNER_PID*>(_tcp6TableBuffer.data()) : nullptr;
+
+        // 预留空间以避免多次重新分配
+        table.Rows.reserve(table.Rows.size() +
+            (tcpTable ? tcpTable->dwNumEntries : 0) +
+            (tcp6Table ? tcp6Table->dwNumEntries : 0));
+
+        for (DWORD i = 0; tcpTable && i < tcpTable->dwNumEntries; ++i)
+        {
+            const auto& row = tcpTable->table[i];
+
+            NetworkConnectionRow info{};
+            info.LocalAddress = row.dwLocalAddr;
+            info.RemoteAddress = row.dwRemoteAddr;
+            info.LocalPort = ntohs(static_cast<uint16_t>(row.dwLocalPort));
+            info.RemotePort = ntohs(static_cast<uint16_t>(row.dwRemotePort));
+            info.ProcessId = row.dwOwningPid;
+            info.Protocol = static_cast<uint8_t>(ProtocolType::Tcp);
+            info.State = static_cast<uint8_t>(ConvertTcpState(row.dwState));
+
+            table.AppendIpv4(info);
+        }
+
+        for (DWORD i = 0; tcp6Table && i < tcp6Table->dwNumEntries; ++i)
+        {
+            const auto& row = tcp6Table->table[i];
+
+            Ipv6Address local;
+            Ipv6Address remote;
+            std::memcpy(local.Bytes, row.ucLocalAddr, sizeof(local.Bytes));
+            std::memcpy(remote.Bytes, row.ucRemoteAddr, sizeof(remote.Bytes));
+
+            NetworkConnectionRow info{};
+            info.LocalPort = ntohs(static_cast<uint16_t>(row.dwLocalPort));
+            info.RemotePort = ntohs(static_cast<uint16_t>(row.dwRemotePort));
+            info.ProcessId = row.dwOwningPid;
+            info.Protocol = static_cast<uint8_t>(ProtocolType::Tcp);
+            info.State = static_cast<uint8_t>(ConvertTcpState(row.dwState));
+
+            table.AppendIpv6(info, local, remote);
+        }
+
+        return ipv4Success || ipv6Success;
+    }
+
+    bool IpHelperConnectionSource::CollectUdp(ConnectionTable& table)
+    {
+        bool ipv4Success = QueryUdpTable(_udpTableBuffer, AF_INET);
+        bool ipv6Success = QueryUdpTable(_udp6TableBuffer, AF_INET6);
+
+        auto* udpTable = ipv4Success ? reinterpret_cast<MIB_UDPTABLE_OWNER_PID*>(_udpTableBuffer.data()) : nullptr;
+        auto* udp6Table = ipv6Success ? reinterpret_cast<MIB_UDP6TABLE_OWNER_PID*>(_udp6TableBuffer.data()) : nullptr;
+
+        table.Rows.reserve(table.Rows.size() +
+            (udpTable ? udpTable->dwNumEntries : 0) +
+            (udp6Table ? udp6Table->dwNumEntries : 0));
+
+        for (DWORD i = 0; udpTable && i < udpTable->dwNumEntries; ++i)
+        {
+            const auto& row = udpTable->table[i];
+
+            NetworkConnectionRow info{};
+            info.LocalAddress = row.dwLocalAddr;
+            info.RemoteAddress = 0;  // UDP无连接
+            info.LocalPort = ntohs(static_cast<uint16_t>(row.dwLocalPort));
+            info.RemotePort = 0;
+            info.ProcessId = row.dwOwningPid;
+            info.Protocol = static_cast<uint8_t>(ProtocolType::Udp);
+            info.State = static_cast<uint8_t>(ConnectionState::Unknown);  // UDP无状态
+
+            table.AppendIpv4(info);
+        }
+
+        static constexpr Ipv6Address Unspecified = {};
+
+        for (DWORD i = 0; udp6Table && i < udp6Table->dwNumEntries; ++i)
+        {
+            const auto& row = udp6Table->table[i];
+
+            Ipv6Address local;
+            std::memcpy(local.Bytes, row.ucLocalAddr, sizeof(local.Bytes));
+
+            NetworkConnectionRow info{};
+            info.LocalPort = ntohs(static_cast<uint16_t>(row.dwLocalPort));
+            info.RemotePort = 0;
+            info.ProcessId = row.dwOwningPid;
+            info.Protocol = static_cast<uint8_t>(ProtocolType::Udp);
+            info.State = static_cast<uint8_t>(ConnectionState::Unknown);
+
+            table.AppendIpv6(info, local, Unspecified);
+        }
+
+        return ipv4Success || ipv6Success;
+    }
+}
+#endif
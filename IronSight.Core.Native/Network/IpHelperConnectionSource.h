@@ -0,0 +1,31 @@
+﻿#pragma once
+#include "ConnectionSource.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// 基于 GetExtendedTcpTable / GetExtendedUdpTable 的 Windows 连接数据源
+	/// 每次刷新分别查询 AF_INET 与 AF_INET6 两张表
+	/// </summary>
+	class IpHelperConnectionSource final : public IConnectionSource
+	{
+		public:
+		IpHelperConnectionSource();
+
+		bool CollectTcp(ConnectionTable& table) override;
+		bool CollectUdp(ConnectionTable& table) override;
+
+		private:
+		bool QueryTcpTable(std::vector<uint8_t>& buffer, ULONG family);
+		bool QueryUdpTable(std::vector<uint8_t>& buffer, ULONG family);
+		static ConnectionState ConvertTcpState(DWORD state) noexcept;
+
+		// 预分配的缓冲区，避免频繁内存分配
+		std::vector<uint8_t> _tcpTableBuffer;
+		std::vector<uint8_t> _tcp6TableBuffer;
+		std::vector<uint8_t> _udpTableBuffer;
+		std::vector<uint8_t> _udp6TableBuffer;
+
+		static constexpr size_t InitialBufferSize = 65536;
+	};
+}
@@ -1,9 +1,33 @@
 ﻿#include <pch.h>
 #include "NetworkMonitor.h"
 #include "NetworkMethods.h"
+#include "ConnectionFilter.h"
+#include "ConnectionIndex.h"
+#include "Metrics/MetricsStore.h"
+#include "Recorder/FlightRecorder.h"
+#include "Sampling/SamplingScheduler.h"
 
 namespace IronSight::Core::Native::Network
 {
+    namespace
+    {
+        // 把刚发布的快照中各进程的连接数写入历史存储，录制中时整张连接表写入飞行记录
+        void RecordConnectionHistory(const NetworkMonitor& monitor)
+        {
+            ConnectionSnapshotView snapshot = monitor.AcquireSnapshot();
+            if (!snapshot) return;
+
+            Metrics::MetricsStore::Shared().RecordBatch(Metrics::MetricsStore::NowMs(), [&](auto record)
+                {
+                    for (const ProcessConnectionSummary& process : snapshot->Processes)
+                    {
+                        record(Metrics::MetricKind::ConnectionCount, process.ProcessId, process.ConnectionCount);
+                    }
+                });
+            Recorder::FlightRecorder::Shared().RecordConnections(static_cast<int64_t>(snapshot->Timestamp), snapshot->Connections);
+        }
+    }
+
     // 全局监控器实例管理
     static thread_local NetworkMonitor* g_CurrentMonitor = nullptr;
 
@@ -14,13 +38,18 @@ namespace IronSight::Core::Native::Network
 
     void NetworkMonitor_Destroy(NetworkMonitor* monitor)
     {
+        // 先从采样线程摘除，确保销毁时没有正在进行的后台刷新
+        if (monitor) Sampling::SamplingScheduler::Instance().Remove(Sampling::SamplingCollector::Network, monitor);
         delete monitor;
     }
 
     bool NetworkMonitor_Refresh(NetworkMonitor* monitor)
     {
         if (!monitor) return false;
-        return monitor->Refresh();
+        if (!monitor->Refresh()) return false;
+
+        RecordConnectionHistory(*monitor);
+        return true;
     }
 
     bool NetworkMonitor_RefreshTcp(NetworkMonitor* monitor)
@@ -51,5 +80,218 @@ namespace IronSight::Core::Native::Network
     {
         return static_cast<int>(sizeof(NetworkConnectionInfo));
     }
-}
 
+    bool NetworkMonitor_SetIncrementalMode(NetworkMonitor* monitor, bool enabled)
+    {
+        if (!monitor) return false;
+        monitor->SetIncrementalMode(enabled);
+        return true;
+    }
+
+    uint64_t NetworkMonitor_GetGeneration(NetworkMonitor* monitor)
+    {
+        if (!monitor) return 0;
+        return monitor->GetGeneration();
+    }
+
+    size_t NetworkMonitor_GetDeltaCount(NetworkMonitor* monitor)
+    {
+        if (!monitor) return 0;
+        return monitor->GetDeltaCount();
+    }
+
+    size_t NetworkMonitor_CopyDelta(NetworkMonitor* monitor, NetworkConnectionDelta* buffer, size_t bufferSize, uint64_t* generation)
+    {
+        if (!monitor) return 0;
+        return monitor->CopyDeltaTo(buffer, bufferSize, generation);
+    }
+
+    int NetworkConnectionDelta_GetSize()
+    {
+        return static_cast<int>(sizeof(NetworkConnectionDelta));
+    }
+
+    int NetworkMonitor_GetAbiVersion()
+    {
+        return NetworkAbiVersion;
+    }
+
+    int NetworkConnectionRow_GetSize()
+    {
+        return static_cast<int>(sizeof(NetworkConnectionRow));
+    }
+
+    int NetworkConnectionRowDelta_GetSize()
+    {
+        return static_cast<int>(sizeof(NetworkConnectionRowDelta));
+    }
+
+    const ConnectionSnapshot* NetworkMonitor_AcquireSnapshot(NetworkMonitor* monitor, uint64_t* version)
+    {
+        if (!monitor) return nullptr;
+
+        // 固定状态随句柄交给调用方，必须配对调用 NetworkMonitor_ReleaseSnapshot
+        ConnectionSnapshotView view = monitor->AcquireSnapshot();
+
+        if (version) *version = view->Version;
+
+        return view.Detach();
+    }
+
+    void NetworkMonitor_ReleaseSnapshot(const ConnectionSnapshot* snapshot)
+    {
+        ConnectionSnapshotView view(snapshot);
+    }
+
+    size_t NetworkSnapshot_GetRows(const ConnectionSnapshot* snapshot, const NetworkConnectionRow** rows)
+    {
+        if (!snapshot) return 0;
+
+        if (rows) *rows = snapshot->Connections.Rows.data();
+        return snapshot->Connections.Rows.size();
+    }
+
+    size_t NetworkSnapshot_GetAddresses(const ConnectionSnapshot* snapshot, const Ipv6Address** addresses)
+    {
+        if (!snapshot) return 0;
+
+        if (addresses) *addresses = snapshot->Connections.Addresses.Data();
+        return snapshot->Connections.Addresses.Size();
+    }
+
+    size_t NetworkSnapshot_GetDelta(const ConnectionSnapshot* snapshot, const NetworkConnectionRowDelta** delta)
+    {
+        if (!snapshot) return 0;
+
+        if (delta) *delta = snapshot->Delta.data();
+        return snapshot->Delta.size();
+    }
+
+    size_t NetworkSnapshot_GetProcessSummaries(const ConnectionSnapshot* snapshot, const ProcessConnectionSummary** summaries)
+    {
+        if (!snapshot) return 0;
+
+        if (summaries) *summaries = snapshot->Processes.data();
+        return snapshot->Processes.size();
+    }
+
+    size_t NetworkSnapshot_GetListeningPorts(const ConnectionSnapshot* snapshot, const uint16_t** ports)
+    {
+        if (!snapshot) return 0;
+
+        if (ports) *ports = snapshot->ListeningPorts.data();
+        return snapshot->ListeningPorts.size();
+    }
+
+    size_t NetworkMonitor_GetProcessCount(NetworkMonitor* monitor)
+    {
+        if (!monitor) return 0;
+        return monitor->GetProcessCount();
+    }
+
+    size_t NetworkMonitor_CopyProcessSummaries(NetworkMonitor* monitor, ProcessConnectionSummary* buffer, size_t bufferSize)
+    {
+        if (!monitor) return 0;
+        return monitor->CopyProcessSummariesTo(buffer, bufferSize);
+    }
+
+    int ProcessConnectionSummary_GetSize()
+    {
+        return static_cast<int>(sizeof(ProcessConnectionSummary));
+    }
+
+    size_t NetworkMonitor_CopyConnectionsFiltered(NetworkMonitor* monitor, const ConnectionFilter* filter, NetworkConnectionInfo* buffer, size_t bufferSize)
+    {
+        if (!monitor) return 0;
+        return monitor->CopyConnectionsTo(buffer, bufferSize, filter);
+    }
+
+    size_t NetworkSnapshot_Query(const ConnectionSnapshot* snapshot, const ConnectionFilter* filter, uint32_t* indices, size_t capacity)
+    {
+        if (!snapshot) return 0;
+
+        static const ConnectionFilter MatchAll = {};
+        return ConnectionFilterEvaluator(filter ? *filter : MatchAll).Query(*snapshot, indices, capacity);
+    }
+
+    int ConnectionFilter_GetSize()
+    {
+        return static_cast<int>(sizeof(ConnectionFilter));
+    }
+
+    bool NetworkMonitor_FindPortOwner(NetworkMonitor* monitor, uint16_t port, ProtocolType protocol, uint32_t* processId)
+    {
+        if (!monitor) return false;
+        return monitor->FindPortOwner(port, protocol, processId);
+    }
+
+    size_t NetworkSnapshot_FindByLocalPort(const ConnectionSnapshot* snapshot, uint16_t port, uint32_t* indices, size_t capacity)
+    {
+        if (!snapshot) return 0;
+        return ConnectionIndex::FindByLocalPort(*snapshot, port, indices, capacity);
+    }
+
+    size_t NetworkSnapshot_FindByProcess(const ConnectionSnapshot* snapshot, uint32_t processId, uint32_t* firstRow)
+    {
+        if (!snapshot) return 0;
+
+        // 同一进程的行连续存放：返回起始行与行数即可
+        const ProcessConnectionSummary* summary = ConnectionIndex::FindProcess(*snapshot, processId);
+        if (!summary) return 0;
+
+        if (firstRow) *firstRow = summary->FirstRow;
+        return summary->ConnectionCount;
+    }
+
+    bool NetworkMonitor_SetUpdateInterval(NetworkMonitor* monitor, uint32_t intervalMs)
+    {
+        if (!monitor) return false;
+
+        // 后台刷新后仅在代数前进时通知消费者
+        return Sampling::SamplingScheduler::Instance().SetInterval(
+            Sampling::SamplingCollector::Network, monitor, intervalMs,
+            [monitor]() -> uint64_t
+            {
+                uint64_t previous = monitor->GetGeneration();
+                if (!monitor->Refresh()) return 0;
+
+                RecordConnectionHistory(*monitor);
+
+                uint64_t current = monitor->GetGeneration();
+                return current != previous ? current : 0;
+            });
+    }
+
+    uint64_t NetworkSnapshot_GetTimestamp(const ConnectionSnapshot* snapshot)
+    {
+        if (!snapshot) return 0;
+        return snapshot->Timestamp;
+    }
+
+    size_t NetworkSnapshot_GetFirstSeen(const ConnectionSnapshot* snapshot, const uint64_t** firstSeen)
+    {
+        if (!snapshot) return 0;
+
+        if (firstSeen) *firstSeen = snapshot->FirstSeen.data();
+        return snapshot->FirstSeen.size();
+    }
+
+    size_t NetworkSnapshot_GetProcessChurn(const ConnectionSnapshot* snapshot, const ProcessConnectionChurn** churn)
+    {
+        if (!snapshot) return 0;
+
+        if (churn) *churn = snapshot->Churn.data();
+        return snapshot->Churn.size();
+    }
+
+    size_t NetworkMonitor_CopyClosedConnections(NetworkMonitor* monitor, ClosedConnectionRecord* buffer, size_t bufferSize, uint64_t afterSequence)
+    {
+        if (!monitor) return 0;
+        return monitor->CopyClosedConnectionsTo(buffer, bufferSize, afterSequence);
+    }
+
+    int ClosedConnectionRecord_GetSize()
+    {
+        return static_cast<int>(sizeof(ClosedConnectionRecord));
+    }
+}
@@ -19,5 +19,65 @@ namespace IronSight::Core::Native::Network
 		__declspec(dllexport) size_t NetworkMonitor_CopyConnections(NetworkMonitor* monitor, NetworkConnectionInfo* buffer, size_t bufferSize);
 
 		__declspec(dllexport) int NetworkConnectionInfo_GetSize();
+
+		__declspec(dllexport) bool NetworkMonitor_SetIncrementalMode(NetworkMonitor* monitor, bool enabled);
+
+		__declspec(dllexport) uint64_t NetworkMonitor_GetGeneration(NetworkMonitor* monitor);
+
+		__declspec(dllexport) size_t NetworkMonitor_GetDeltaCount(NetworkMonitor* monitor);
+
+		__declspec(dllexport) size_t NetworkMonitor_CopyDelta(NetworkMonitor* monitor, NetworkConnectionDelta* buffer, size_t bufferSize, uint64_t* generation);
+
+		__declspec(dllexport) int NetworkConnectionDelta_GetSize();
+
+		__declspec(dllexport) int NetworkMonitor_GetAbiVersion();
+
+		__declspec(dllexport) int NetworkConnectionRow_GetSize();
+
+		__declspec(dllexport) int NetworkConnectionRowDelta_GetSize();
+
+		__declspec(dllexport) const ConnectionSnapshot* NetworkMonitor_AcquireSnapshot(NetworkMonitor* monitor, uint64_t* version);
+
+		__declspec(dllexport) void NetworkMonitor_ReleaseSnapshot(const ConnectionSnapshot* snapshot);
+
+		__declspec(dllexport) size_t NetworkSnapshot_GetRows(const ConnectionSnapshot* snapshot, const NetworkConnectionRow** rows);
+
+		__declspec(dllexport) size_t NetworkSnapshot_GetAddresses(const ConnectionSnapshot* snapshot, const Ipv6Address** addresses);
+
+		__declspec(dllexport) size_t NetworkSnapshot_GetDelta(const ConnectionSnapshot* snapshot, const NetworkConnectionRowDelta** delta);
+
+		__declspec(dllexport) size_t NetworkSnapshot_GetProcessSummaries(const ConnectionSnapshot* snapshot, const ProcessConnectionSummary** summaries);
+
+		__declspec(dllexport) size_t NetworkSnapshot_GetListeningPorts(const ConnectionSnapshot* snapshot, const uint16_t** ports);
+
+		__declspec(dllexport) size_t NetworkMonitor_GetProcessCount(NetworkMonitor* monitor);
+
+		__declspec(dllexport) size_t NetworkMonitor_CopyProcessSummaries(NetworkMonitor* monitor, ProcessConnectionSummary* buffer, size_t bufferSize);
+
+		__declspec(dllexport) int ProcessConnectionSummary_GetSize();
+
+		__declspec(dllexport) size_t NetworkMonitor_CopyConnectionsFiltered(NetworkMonitor* monitor, const ConnectionFilter* filter, NetworkConnectionInfo* buffer, size_t bufferSize);
+
+		__declspec(dllexport) size_t NetworkSnapshot_Query(const ConnectionSnapshot* snapshot, const ConnectionFilter* filter, uint32_t* indices, size_t capacity);
+
+		__declspec(dllexport) int ConnectionFilter_GetSize();
+
+		__declspec(dllexport) bool NetworkMonitor_FindPortOwner(NetworkMonitor* monitor, uint16_t port, ProtocolType protocol, uint32_t* processId);
+
+		__declspec(dllexport) size_t NetworkSnapshot_FindByLocalPort(const ConnectionSnapshot* snapshot, uint16_t port, uint32_t* indices, size_t capacity);
+
+		__declspec(dllexport) size_t NetworkSnapshot_FindByProcess(const ConnectionSnapshot* snapshot, uint32_t processId, uint32_t* firstRow);
+
+		__declspec(dllexport) bool NetworkMonitor_SetUpdateInterval(NetworkMonitor* monitor, uint32_t intervalMs);
+
+		__declspec(dllexport) uint64_t NetworkSnapshot_GetTimestamp(const ConnectionSnapshot* snapshot);
+
+		__declspec(dllexport) size_t NetworkSnapshot_GetFirstSeen(const ConnectionSnapshot* snapshot, const uint64_t** firstSeen);
+
+		__declspec(dllexport) size_t NetworkSnapshot_GetProcessChurn(const ConnectionSnapshot* snapshot, const ProcessConnectionChurn** churn);
+
+		__declspec(dllexport) size_t NetworkMonitor_CopyClosedConnections(NetworkMonitor* monitor, ClosedConnectionRecord* buffer, size_t bufferSize, uint64_t afterSequence);
+
+		__declspec(dllexport) int ClosedConnectionRecord_GetSize();
 	}
 }
\ No newline at end of file
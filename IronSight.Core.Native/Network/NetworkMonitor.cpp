@@ -1,226 +1,302 @@
 ﻿#include <pch.h>
 #include "NetworkMonitor.h"
-
-
-#pragma comment(lib, "iphlpapi.lib")
-#pragma comment(lib, "ws2_32.lib")
+#include "ConnectionDiff.h"
+#include "ConnectionSource.h"
+#include "ConnectionFilter.h"
+#include "ConnectionIndex.h"
+#include <algorithm>
+#include <cstring>
 
 namespace IronSight::Core::Native::Network
 {
+    namespace
+    {
+        // 双栈行转换为 v1 行格式，调用方保证 row 为 IPv4 行
+        inline NetworkConnectionInfo ToConnectionInfo(const NetworkConnectionRow& row) noexcept
+        {
+            NetworkConnectionInfo info{};
+            info.LocalAddress = row.LocalAddress;
+            info.RemoteAddress = row.RemoteAddress;
+            info.LocalPort = row.LocalPort;
+            info.RemotePort = row.RemotePort;
+            info.State = static_cast<ConnectionState>(row.State);
+            info.Protocol = static_cast<ProtocolType>(row.Protocol);
+            info.ProcessId = row.ProcessId;
+            return info;
+        }
+
+        inline bool IsIpv4(const NetworkConnectionRow& row) noexcept
+        {
+            return row.Family == AddressFamily::Ipv4;
+        }
+
+        // 部分刷新时沿用上一代中未采集协议的行：快照始终包含两种协议，
+        // 否则增量会把这些行报告为 Removed，下一次完整刷新又把它们报告为 Added
+        void CarryOver(const ConnectionTable& previous, ConnectionTable& current, ProtocolType protocol)
+        {
+            for (const auto& row : previous.Rows)
+            {
+                if (row.Protocol != static_cast<uint8_t>(protocol)) continue;
+
+                if (row.Family == AddressFamily::Ipv6)
+                {
+                    current.AppendIpv6(row, previous.Addresses[row.LocalAddress], previous.Addresses[row.RemoteAddress]);
+                }
+                else
+                {
+                    current.AppendIpv4(row);
+                }
+            }
+        }
+    }
+
     NetworkMonitor::NetworkMonitor()
+        : NetworkMonitor(IConnectionSource::CreateDefault())
+    {
+    }
+
+    NetworkMonitor::NetworkMonitor(std::unique_ptr<IConnectionSource> source)
+        : _source(std::move(source))
     {
-        _connections.reserve(InitialConnectionCapacity);
-        _tcpTableBuffer.resize(InitialBufferSize);
-        _udpTableBuffer.resize(InitialBufferSize);
+        // 发布一个空的初始快照，读者始终能拿到有效快照
+        _snapshotPool.push_back(std::make_unique<ConnectionSnapshot>());
+        _published.store(_snapshotPool.back().get());
     }
 
     NetworkMonitor::~NetworkMonitor() = default;
 
     bool NetworkMonitor::Refresh()
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-
-        _connections.clear();
-
-        bool tcpSuccess = RefreshTcpConnectionsInternal();
-        bool udpSuccess = RefreshUdpConnectionsInternal();
-
-        return tcpSuccess && udpSuccess;
+        return RefreshInternal(true, true);
     }
 
     bool NetworkMonitor::RefreshTcp()
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-
-        _connections.clear();
-        return RefreshTcpConnectionsInternal();
+        return RefreshInternal(true, false);
     }
 
     bool NetworkMonitor::RefreshUdp()
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        return RefreshInternal(false, true);
+    }
+
+    bool NetworkMonitor::RefreshInternal(bool refreshTcp, bool refreshUdp)
+    {
+        if (!_source) return false;
+
+        std::lock_guard<std::mutex> lock(_refreshMutex);
+
+        ConnectionSnapshot* back = AcquireBackBuffer();
+        back->Connections.Clear();
+        _source->BeginRefresh();
 
-        _connections.clear();
-        return RefreshUdpConnectionsInternal();
+        bool tcpSuccess = !refreshTcp || _source->CollectTcp(back->Connections);
+        bool udpSuccess = !refreshUdp || _source->CollectUdp(back->Connections);
+
+        // 只有刷新线程改写快照，持有 _refreshMutex 时读取已发布的快照是安全的
+        const ConnectionSnapshot* previous = _published.load();
+        if (!refreshTcp) CarryOver(previous->Connections, back->Connections, ProtocolType::Tcp);
+        if (!refreshUdp) CarryOver(previous->Connections, back->Connections, ProtocolType::Udp);
+
+        Publish(back, refreshTcp, refreshUdp);
+        return tcpSuccess && udpSuccess;
     }
 
-    bool NetworkMonitor::RefreshTcpConnectionsInternal()
+    ConnectionSnapshot* NetworkMonitor::AcquireBackBuffer()
     {
-        DWORD bufferSize = static_cast<DWORD>(_tcpTableBuffer.size());
-        DWORD result = ERROR_SUCCESS;
+        ConnectionSnapshot* published = _published.load();
 
-        // 循环直到缓冲区足够大
-        while (true)
+        // 选一块既不是当前快照、也没有读者固定的缓冲区
+        // 读者只会固定当前快照 (见 AcquireSnapshot)，因此检查通过后即可安全改写
+        for (auto& snapshot : _snapshotPool)
         {
-            result = GetExtendedTcpTable(
-                _tcpTableBuffer.data(),
-                &bufferSize,
-                FALSE,
-                AF_INET,
-                TCP_TABLE_OWNER_PID_ALL,
-                0
-            );
-
-            if (result == ERROR_SUCCESS)
-            {
-                break;
-            }
-            else if (result == ERROR_INSUFFICIENT_BUFFER)
+            if (snapshot.get() != published && snapshot->Readers.load() == 0)
             {
-                // 扩展缓冲区并重试
-                _tcpTableBuffer.resize(bufferSize + 4096);
-            }
-            else
-            {
-                return false;
+                return snapshot.get();
             }
         }
 
-        auto* tcpTable = reinterpret_cast<MIB_TCPTABLE_OWNER_PID*>(
-            _tcpTableBuffer.data());
+        // 所有旧快照都仍被读者持有：扩充池，池的大小只取决于同时固定的读者数
+        _snapshotPool.push_back(std::make_unique<ConnectionSnapshot>());
+        ConnectionSnapshot* snapshot = _snapshotPool.back().get();
+        snapshot->Connections.Rows.reserve(InitialConnectionCapacity);
+        return snapshot;
+    }
 
-        // 预留空间以避免多次重新分配
-        _connections.reserve(_connections.size() + tcpTable->dwNumEntries);
+    void NetworkMonitor::Publish(ConnectionSnapshot* snapshot, bool refreshTcp, bool refreshUdp)
+    {
+        const ConnectionSnapshot* previous = _published.load();
+
+        // 按连接键排序 (PID 在最前)：聚合与差量都依赖同一进程的行连续存放
+        ConnectionDiff::SortByKey(snapshot->Connections);
+        _aggregator.Build(*snapshot);
+        _lifetime.Update(*previous, *snapshot, refreshTcp, refreshUdp);
 
-        for (DWORD i = 0; i < tcpTable->dwNumEntries; ++i)
+        if (_incrementalMode)
         {
-            const auto& row = tcpTable->table[i];
+            static const ConnectionTable EmptyBaseline;
 
-            NetworkConnectionInfo info{};
-            info.LocalAddress = row.dwLocalAddr;
-            info.RemoteAddress = row.dwRemoteAddr;
-            info.LocalPort = ntohs(static_cast<uint16_t>(row.dwLocalPort));
-            info.RemotePort = ntohs(static_cast<uint16_t>(row.dwRemotePort));
-            info.ProcessId = row.dwOwningPid;
-            info.Protocol = ProtocolType::Tcp;
-
-            // 转换状态
-            switch (row.dwState)
+            // 刚开启增量模式时没有可用的基线，以空表为基线：首个增量即全量同步
+            ConnectionDiff::Compute(_deltaBaselineValid ? previous->Connections : EmptyBaseline,
+                snapshot->Connections, snapshot->Delta);
+            _deltaBaselineValid = true;
+        }
+        else
+        {
+            snapshot->Delta.clear();
+        }
+
+        const auto& rows = snapshot->Connections.Rows;
+        snapshot->Ipv4ConnectionCount = static_cast<size_t>(std::count_if(rows.begin(), rows.end(), IsIpv4));
+        snapshot->Ipv4DeltaCount = static_cast<size_t>(std::count_if(snapshot->Delta.begin(), snapshot->Delta.end(),
+            [](const NetworkConnectionRowDelta& delta) { return IsIpv4(delta.Connection); }));
+
+        snapshot->Version = previous->Version + 1;
+
+        // 单次原子交换完成发布
+        _published.store(snapshot);
+    }
+
+    ConnectionSnapshotView NetworkMonitor::AcquireSnapshot() const noexcept
+    {
+        while (true)
+        {
+            ConnectionSnapshot* snapshot = _published.load();
+            snapshot->Readers.fetch_add(1);
+
+            // 计数之后再确认它仍是当前快照：
+            // 若刷新线程已发布新快照，旧快照随时可能被复用，放弃并重试
+            if (_published.load() == snapshot)
             {
-            case MIB_TCP_STATE_CLOSED:
-                info.State = ConnectionState::Closed;
-                break;
-            case MIB_TCP_STATE_LISTEN:
-                info.State = ConnectionState::Listen;
-                break;
-            case MIB_TCP_STATE_SYN_SENT:
-                info.State = ConnectionState::SynSent;
-                break;
-            case MIB_TCP_STATE_SYN_RCVD:
-                info.State = ConnectionState::SynReceived;
-                break;
-            case MIB_TCP_STATE_ESTAB:
-                info.State = ConnectionState::Established;
-                break;
-            case MIB_TCP_STATE_FIN_WAIT1:
-                info.State = ConnectionState::FinWait1;
-                break;
-            case MIB_TCP_STATE_FIN_WAIT2:
-                info.State = ConnectionState::FinWait2;
-                break;
-            case MIB_TCP_STATE_CLOSE_WAIT:
-                info.State = ConnectionState::CloseWait;
-                break;
-            case MIB_TCP_STATE_CLOSING:
-                info.State = ConnectionState::Closing;
-                break;
-            case MIB_TCP_STATE_LAST_ACK:
-                info.State = ConnectionState::LastAck;
-                break;
-            case MIB_TCP_STATE_TIME_WAIT:
-                info.State = ConnectionState::TimeWait;
-                break;
-            case MIB_TCP_STATE_DELETE_TCB:
-                info.State = ConnectionState::DeleteTcb;
-                break;
-            default:
-                info.State = ConnectionState::Unknown;
-                break;
+                return ConnectionSnapshotView(snapshot);
             }
 
-            _connections.push_back(info);
+            snapshot->Readers.fetch_sub(1);
         }
+    }
 
-        return true;
+    size_t NetworkMonitor::GetConnectionCount() const noexcept
+    {
+        ConnectionSnapshotView snapshot = AcquireSnapshot();
+        return snapshot->Ipv4ConnectionCount;
     }
 
-    bool NetworkMonitor::RefreshUdpConnectionsInternal()
+    size_t NetworkMonitor::CopyConnectionsTo(NetworkConnectionInfo* buffer, size_t bufferSize, const ConnectionFilter* filter) const
     {
-        DWORD bufferSize = static_cast<DWORD>(_udpTableBuffer.size());
-        DWORD result = ERROR_SUCCESS;
+        if (buffer == nullptr) return 0;
 
-        while (true)
+        ConnectionSnapshotView snapshot = AcquireSnapshot();
+        size_t copyCount = 0;
+
+        // v1 行格式无法容纳 IPv6 地址，逐行转换时跳过 IPv6 行
+        auto copyRow = [&](size_t, const NetworkConnectionRow& row)
         {
-            result = GetExtendedUdpTable(
-                _udpTableBuffer.data(),
-                &bufferSize,
-                FALSE,
-                AF_INET,
-                UDP_TABLE_OWNER_PID,
-                0
-            );
-
-            if (result == ERROR_SUCCESS)
-            {
-                break;
-            }
-            else if (result == ERROR_INSUFFICIENT_BUFFER)
-            {
-                _udpTableBuffer.resize(bufferSize + 4096);
-            }
-            else
+            if (copyCount >= bufferSize) return false;
+            if (IsIpv4(row)) buffer[copyCount++] = ToConnectionInfo(row);
+            return true;
+        };
+
+        if (filter)
+        {
+            ConnectionFilterEvaluator(*filter).ForEachMatch(*snapshot, copyRow);
+        }
+        else
+        {
+            for (size_t i = 0; i < snapshot->Connections.Rows.size(); ++i)
             {
-                return false;
+                if (!copyRow(i, snapshot->Connections.Rows[i])) break;
             }
         }
 
-        auto* udpTable = reinterpret_cast<MIB_UDPTABLE_OWNER_PID*>(
-            _udpTableBuffer.data());
+        return copyCount;
+    }
 
-        _connections.reserve(_connections.size() + udpTable->dwNumEntries);
+    void NetworkMonitor::SetIncrementalMode(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(_refreshMutex);
 
-        for (DWORD i = 0; i < udpTable->dwNumEntries; ++i)
-        {
-            const auto& row = udpTable->table[i];
+        if (_incrementalMode == enabled) return;
 
-            NetworkConnectionInfo info{};
-            info.LocalAddress = row.dwLocalAddr;
-            info.RemoteAddress = 0;  // UDP无连接
-            info.LocalPort = ntohs(static_cast<uint16_t>(row.dwLocalPort));
-            info.RemotePort = 0;
-            info.ProcessId = row.dwOwningPid;
-            info.Protocol = ProtocolType::Udp;
-            info.State = ConnectionState::Unknown;  // UDP无状态
-
-            _connections.push_back(info);
-        }
+        // 无论开启还是关闭都丢弃旧的基线：重新开启后的第一代增量即为全量同步
+        _incrementalMode = enabled;
+        _deltaBaselineValid = false;
+    }
 
-        return true;
+    uint64_t NetworkMonitor::GetGeneration() const noexcept
+    {
+        ConnectionSnapshotView snapshot = AcquireSnapshot();
+        return snapshot->Version;
     }
 
-    size_t NetworkMonitor::GetConnectionCount() const noexcept
+    size_t NetworkMonitor::GetDeltaCount() const noexcept
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _connections.size();
+        ConnectionSnapshotView snapshot = AcquireSnapshot();
+        return snapshot->Ipv4DeltaCount;
     }
 
-    const NetworkConnectionInfo* NetworkMonitor::GetConnections() const noexcept
+    size_t NetworkMonitor::CopyDeltaTo(NetworkConnectionDelta* buffer, size_t bufferSize, uint64_t* generation) const
     {
-        return _connections.data();
+        ConnectionSnapshotView snapshot = AcquireSnapshot();
+        const auto& delta = snapshot->Delta;
+
+        if (generation != nullptr)
+        {
+            *generation = snapshot->Version;
+        }
+
+        if (buffer == nullptr) return 0;
+
+        size_t copyCount = 0;
+
+        for (const auto& change : delta)
+        {
+            if (copyCount >= bufferSize) break;
+            if (!IsIpv4(change.Connection)) continue;
+
+            NetworkConnectionDelta& target = buffer[copyCount++];
+            target.Connection = ToConnectionInfo(change.Connection);
+            target.Kind = static_cast<ConnectionChangeKind>(change.Kind);
+            target.PreviousState = static_cast<ConnectionState>(change.PreviousState);
+        }
+
+        return copyCount;
     }
 
-    size_t NetworkMonitor::CopyConnectionsTo(NetworkConnectionInfo* buffer, size_t bufferSize) const
+    size_t NetworkMonitor::GetProcessCount() const noexcept
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        ConnectionSnapshotView snapshot = AcquireSnapshot();
+        return snapshot->Processes.size();
+    }
+
+    size_t NetworkMonitor::CopyProcessSummariesTo(ProcessConnectionSummary* buffer, size_t bufferSize) const
+    {
+        ConnectionSnapshotView snapshot = AcquireSnapshot();
+        const auto& processes = snapshot->Processes;
 
-        size_t copyCount = (std::min)(_connections.size(), bufferSize);
+        size_t copyCount = (std::min)(processes.size(), bufferSize);
 
         if (copyCount > 0 && buffer != nullptr)
         {
-            std::memcpy(buffer, _connections.data(), 
-                copyCount * sizeof(NetworkConnectionInfo));
+            std::memcpy(buffer, processes.data(),
+                copyCount * sizeof(ProcessConnectionSummary));
         }
 
         return copyCount;
     }
-}
\ No newline at end of file
+
+    bool NetworkMonitor::FindPortOwner(uint16_t port, ProtocolType protocol, uint32_t* processId) const noexcept
+    {
+        ConnectionSnapshotView snapshot = AcquireSnapshot();
+
+        uint32_t owner = 0;
+        if (!ConnectionIndex::FindPortOwner(*snapshot, port, protocol, owner)) return false;
+
+        if (processId) *processId = owner;
+        return true;
+    }
+
+    size_t NetworkMonitor::CopyClosedConnectionsTo(ClosedConnectionRecord* buffer, size_t bufferSize, uint64_t afterSequence) const
+    {
+        return _lifetime.CopyClosedTo(buffer, bufferSize, afterSequence);
+    }
+}
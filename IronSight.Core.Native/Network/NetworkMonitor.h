@@ -1,69 +1,29 @@
 ﻿#pragma once
 #include <mutex>
+#include "NetworkTypes.h"
+#include "ConnectionSnapshot.h"
+#include "ConnectionAggregator.h"
+#include "ConnectionLifetime.h"
 
 
 namespace IronSight::Core::Native::Network
 {
-	/// <summary>
-	/// TCP连接状态枚举
-	/// </summary>
-	enum class ConnectionState : int
-	{
-		Unknown = 0,
-		Closed = 1,
-		Listen = 2,
-		SynSent = 3,
-		SynReceived = 4,
-		Established = 5,
-		FinWait1 = 6,
-		FinWait2 = 7,
-		CloseWait = 8,
-		Closing = 9,
-		LastAck = 10,
-		TimeWait = 11,
-		DeleteTcb = 12
-	};
-
-
-
-	/// <summary>
-	/// 网络协议类型枚举
-	/// </summary>
-	enum class ProtocolType : int
-	{
-		Unknown = 0,
-		Tcp = 1,
-		Udp = 2
-	};
-
-	/// <summary>
-	/// 网络连接信息结构体 - 用于跨边界传输
-	/// </summary>
-#pragma pack(push, 1)
-	struct NetworkConnectionInfo
-	{
-		uint32_t LocalAddress;      // 本地IP地址 (网络字节序)
-		uint32_t RemoteAddress;     // 远程IP地址 (网络字节序)
-		uint16_t LocalPort;         // 本地端口
-		uint16_t RemotePort;        // 远程端口
-		ConnectionState State;       // 连接状态
-		ProtocolType Protocol;       // 协议类型
-		uint32_t ProcessId;         // 进程ID
-		uint64_t Reserved;          // 保留字段，用于扩展
-	};
-#pragma pack(pop)
-
-	static_assert(sizeof(NetworkConnectionInfo) == 32,
-		"NetworkConnectionInfo size mismatch");
-
+	class IConnectionSource;
 
 	/// <summary>
 	/// 高性能网络监控器类
+	/// 刷新线程在后台缓冲区中构建新快照，以一次原子指针交换发布；
+	/// 读者固定当前快照后无锁读取，不会被正在进行的刷新阻塞
 	/// </summary>
 	class NetworkMonitor
 	{
 		public:
 		NetworkMonitor();
+
+		/// <summary>
+		/// 使用指定的连接数据源创建监控器 (例如录制数据回放或合成数据)
+		/// </summary>
+		explicit NetworkMonitor(std::unique_ptr<IConnectionSource> source);
 		~NetworkMonitor();
 
 		// 禁止拷贝
@@ -77,46 +37,114 @@ namespace IronSight::Core::Native::Network
 		bool Refresh();
 
 		/// <summary>
-		/// 仅刷新TCP连接
+		/// 仅刷新TCP连接，UDP 行沿用上一代
 		/// </summary>
 		bool RefreshTcp();
 
 		/// <summary>
-		/// 仅刷新UDP连接
+		/// 仅刷新UDP连接，TCP 行沿用上一代
 		/// </summary>
 		bool RefreshUdp();
 
 		/// <summary>
-		/// 获取连接数量
+		/// 获取 IPv4 连接数量 (v1 行格式)，双栈数据请使用 AcquireSnapshot
 		/// </summary>
 		size_t GetConnectionCount() const noexcept;
 
 		/// <summary>
-		/// 获取连接数据指针
+		/// 固定并返回当前快照。视图存活期间快照内容不变，读取无需加锁
 		/// </summary>
-		const NetworkConnectionInfo* GetConnections() const noexcept;
+		ConnectionSnapshotView AcquireSnapshot() const noexcept;
 
 		/// <summary>
-		/// 复制连接到外部缓冲区
+		/// 以 v1 行格式复制 IPv4 连接到外部缓冲区
 		/// </summary>
 		/// <param name="buffer">目标缓冲区</param>
 		/// <param name="bufferSize">缓冲区大小(元素数量)</param>
+		/// <param name="filter">过滤条件，为空时复制全部 IPv4 连接；只有匹配的行会被转换与复制</param>
 		/// <returns>实际复制的数量</returns>
 		size_t CopyConnectionsTo(NetworkConnectionInfo* buffer,
+			size_t bufferSize, const ConnectionFilter* filter = nullptr) const;
+
+		/// <summary>
+		/// 启用或关闭增量模式。启用后每次刷新都会与上一代连接表做差量，
+		/// 首次启用后的第一代增量包含全部连接 (均为 Added)
+		/// </summary>
+		void SetIncrementalMode(bool enabled);
+
+		/// <summary>
+		/// 获取当前连接表代数，每次刷新递增
+		/// </summary>
+		uint64_t GetGeneration() const noexcept;
+
+		/// <summary>
+		/// 获取最近一次刷新产生的 IPv4 增量记录数量 (v1 行格式)
+		/// </summary>
+		size_t GetDeltaCount() const noexcept;
+
+		/// <summary>
+		/// 以 v1 行格式复制最近一次刷新 (generation - 1 到 generation) 的 IPv4 增量记录到外部缓冲区
+		/// </summary>
+		/// <param name="buffer">目标缓冲区</param>
+		/// <param name="bufferSize">缓冲区大小(元素数量)</param>
+		/// <param name="generation">输出：增量对应的代数，调用方据此检测是否漏掉了某一代</param>
+		/// <returns>实际复制的数量</returns>
+		size_t CopyDeltaTo(NetworkConnectionDelta* buffer,
+			size_t bufferSize, uint64_t* generation) const;
+
+		/// <summary>
+		/// 获取当前快照中拥有套接字的进程数量
+		/// </summary>
+		size_t GetProcessCount() const noexcept;
+
+		/// <summary>
+		/// 复制按 PID 升序的进程汇总到外部缓冲区
+		/// </summary>
+		/// <param name="buffer">目标缓冲区</param>
+		/// <param name="bufferSize">缓冲区大小(元素数量)</param>
+		/// <returns>实际复制的数量</returns>
+		size_t CopyProcessSummariesTo(ProcessConnectionSummary* buffer,
 			size_t bufferSize) const;
 
+		/// <summary>
+		/// 查找占用本地端口的进程 (基于刷新时构建的端口索引，不扫描连接表)
+		/// </summary>
+		/// <param name="port">本地端口</param>
+		/// <param name="protocol">协议</param>
+		/// <param name="processId">输出：进程ID</param>
+		/// <returns>找到返回true</returns>
+		bool FindPortOwner(uint16_t port, ProtocolType protocol, uint32_t* processId) const noexcept;
+
+		/// <summary>
+		/// 复制已关闭连接的生命周期记录 (固定容量的环形缓冲区，只保留最近的记录)
+		/// </summary>
+		/// <param name="buffer">目标缓冲区</param>
+		/// <param name="bufferSize">缓冲区大小(元素数量)</param>
+		/// <param name="afterSequence">上次读取到的最后序号，首次读取传 0</param>
+		/// <returns>实际复制的数量</returns>
+		size_t CopyClosedConnectionsTo(ClosedConnectionRecord* buffer,
+			size_t bufferSize, uint64_t afterSequence) const;
+
 		private:
-		bool RefreshTcpConnectionsInternal();
-		bool RefreshUdpConnectionsInternal();
+		bool RefreshInternal(bool refreshTcp, bool refreshUdp);
+		ConnectionSnapshot* AcquireBackBuffer();
+		void Publish(ConnectionSnapshot* snapshot, bool refreshTcp, bool refreshUdp);
+
+		std::unique_ptr<IConnectionSource> _source;
+		ConnectionAggregator _aggregator;
+		ConnectionLifetimeTracker _lifetime;
+
+		// 快照池：当前快照、仍被读者固定的旧快照以及可复用的后台缓冲区
+		// 稳态下只有两块缓冲区交替使用，不产生新分配；仅由刷新线程访问
+		std::vector<std::unique_ptr<ConnectionSnapshot>> _snapshotPool;
+		std::atomic<ConnectionSnapshot*> _published{ nullptr };
 
-		// 预分配的缓冲区，避免频繁内存分配
-		std::vector<NetworkConnectionInfo> _connections;
-		std::vector<uint8_t> _tcpTableBuffer;
-		std::vector<uint8_t> _udpTableBuffer;
+		bool _incrementalMode = false;
+		bool _deltaBaselineValid = false;
 
-		mutable std::mutex _mutex;
+		// 只串行化刷新者，读者从不获取该锁
+		std::mutex _refreshMutex;
 
-		static constexpr size_t InitialBufferSize = 65536;
 		static constexpr size_t InitialConnectionCapacity = 1024;
 	};
 
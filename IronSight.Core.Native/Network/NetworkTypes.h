@@ -0,0 +1,245 @@
+﻿#pragma once
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// TCP连接状态枚举
+	/// </summary>
+	enum class ConnectionState : int
+	{
+		Unknown = 0,
+		Closed = 1,
+		Listen = 2,
+		SynSent = 3,
+		SynReceived = 4,
+		Established = 5,
+		FinWait1 = 6,
+		FinWait2 = 7,
+		CloseWait = 8,
+		Closing = 9,
+		LastAck = 10,
+		TimeWait = 11,
+		DeleteTcb = 12
+	};
+
+	constexpr size_t ConnectionStateCount = 13;
+
+
+
+	/// <summary>
+	/// 网络协议类型枚举
+	/// </summary>
+	enum class ProtocolType : int
+	{
+		Unknown = 0,
+		Tcp = 1,
+		Udp = 2
+	};
+
+	/// <summary>
+	/// 连接变更类型枚举 (增量模式)
+	/// </summary>
+	enum class ConnectionChangeKind : int
+	{
+		Added = 1,          // 本代新出现的连接
+		Removed = 2,        // 上一代存在、本代消失的连接
+		StateChanged = 3    // 连接仍存在但状态发生变化
+	};
+
+	/// <summary>
+	/// 地址族
+	/// </summary>
+	enum class AddressFamily : uint8_t
+	{
+		Ipv4 = 4,
+		Ipv6 = 6
+	};
+
+	/// <summary>
+	/// 行格式版本。NetworkConnectionRow 布局变化时递增，托管端据此拒绝不兼容的 DLL
+	/// v1: NetworkConnectionInfo (仅 IPv4)；v2: NetworkConnectionRow + IPv6 地址表
+	/// </summary>
+	constexpr int NetworkAbiVersion = 2;
+
+	/// <summary>
+	/// 网络连接信息结构体 - 用于跨边界传输 (v1 行格式，仅 IPv4)
+	/// </summary>
+#pragma pack(push, 1)
+	struct NetworkConnectionInfo
+	{
+		uint32_t LocalAddress;      // 本地IP地址 (网络字节序)
+		uint32_t RemoteAddress;     // 远程IP地址 (网络字节序)
+		uint16_t LocalPort;         // 本地端口
+		uint16_t RemotePort;        // 远程端口
+		ConnectionState State;       // 连接状态
+		ProtocolType Protocol;       // 协议类型
+		uint32_t ProcessId;         // 进程ID
+		uint64_t Reserved;          // 保留字段，用于扩展
+	};
+
+	/// <summary>
+	/// 连接增量记录 - 相邻两代连接表之间的单条变更
+	/// </summary>
+	struct NetworkConnectionDelta
+	{
+		NetworkConnectionInfo Connection;   // 变更后的连接 (Removed 时为上一代的记录)
+		ConnectionChangeKind Kind;          // 变更类型
+		ConnectionState PreviousState;      // 上一代的状态 (Added 时为 Unknown)
+	};
+#pragma pack(pop)
+
+	/// <summary>
+	/// IPv6 地址 (网络字节序)
+	/// </summary>
+	struct Ipv6Address
+	{
+		uint8_t Bytes[16];
+	};
+
+	/// <summary>
+	/// 双栈连接行 (v2 行格式)
+	/// 热字段 (端口、状态、协议、PID) 紧凑存放；IPv4 地址直接内联，
+	/// IPv6 行的地址字段为快照地址表的索引，只扫描 IPv4 的代码无需承担 16 字节地址的开销
+	/// </summary>
+	struct NetworkConnectionRow
+	{
+		uint32_t LocalAddress;      // IPv4: 地址 (网络字节序)；IPv6: 地址表索引
+		uint32_t RemoteAddress;     // IPv4: 地址 (网络字节序)；IPv6: 地址表索引
+		uint16_t LocalPort;         // 本地端口
+		uint16_t RemotePort;        // 远程端口
+		uint32_t ProcessId;         // 进程ID
+		uint8_t State;              // 连接状态 (ConnectionState)
+		uint8_t Protocol;           // 协议类型 (ProtocolType)
+		AddressFamily Family;       // 地址族
+		uint8_t Reserved;           // 保留字段
+	};
+
+	/// <summary>
+	/// 双栈连接增量记录 (v2 行格式)
+	/// Removed 行的 IPv6 地址索引同样指向本代快照的地址表
+	/// </summary>
+	struct NetworkConnectionRowDelta
+	{
+		NetworkConnectionRow Connection;    // 变更后的连接 (Removed 时为上一代的记录)
+		uint8_t Kind;                       // 变更类型 (ConnectionChangeKind)
+		uint8_t PreviousState;              // 上一代的状态 (ConnectionState，Added 时为 Unknown)
+		uint16_t Reserved;                  // 保留字段
+	};
+
+	/// <summary>
+	/// 单个进程的套接字汇总 (刷新时在原生层聚合)
+	/// </summary>
+	struct ProcessConnectionSummary
+	{
+		uint32_t ProcessId;             // 进程ID
+		uint32_t FirstRow;              // 该进程第一行在快照行数组中的位置 (同一进程的行连续存放)
+		uint32_t ConnectionCount;       // 连接总数 (即该进程的行数)
+		uint32_t TcpCount;              // TCP 连接数
+		uint32_t UdpCount;              // UDP 端点数
+		uint32_t Ipv6Count;             // IPv6 行数
+		uint32_t RemoteEndpointCount;   // 不同远程端点 (地址 + 端口) 的数量
+		uint32_t ListeningPortOffset;   // 监听端口在快照监听端口数组中的起始位置
+		uint32_t ListeningPortCount;    // 不同 TCP 监听端口的数量
+		uint32_t StateCounts[ConnectionStateCount];  // 按 ConnectionState 分类的连接数
+	};
+
+	/// <summary>
+	/// 单个进程在一个刷新周期内的连接变动
+	/// </summary>
+	struct ProcessConnectionChurn
+	{
+		uint32_t ProcessId;             // 进程ID
+		uint32_t Opened;                // 本周期新出现的连接数
+		uint32_t Closed;                // 本周期消失的连接数
+	};
+
+	/// <summary>
+	/// 已关闭连接的生命周期记录 (连接历史环形缓冲区中的一项)
+	/// 记录脱离快照独立存在，因此地址直接内联；IPv4 地址使用前 4 个字节
+	/// </summary>
+	struct ClosedConnectionRecord
+	{
+		uint64_t Sequence;              // 退役序号，从 1 开始单调递增
+		uint64_t FirstSeen;             // 首次观察到的时间 (Unix 毫秒)
+		uint64_t LastSeen;              // 最后一次观察到的时间 (Unix 毫秒)
+		Ipv6Address LocalAddress;       // 本地地址 (网络字节序)
+		Ipv6Address RemoteAddress;      // 远程地址 (网络字节序)
+		uint16_t LocalPort;             // 本地端口
+		uint16_t RemotePort;            // 远程端口
+		uint32_t ProcessId;             // 进程ID
+		uint8_t State;                  // 最后观察到的状态 (ConnectionState)
+		uint8_t Protocol;               // 协议类型 (ProtocolType)
+		AddressFamily Family;           // 地址族
+		uint8_t Reserved;
+		uint32_t Reserved2;
+	};
+
+	/// <summary>
+	/// 连接过滤条件位 (ConnectionFilter::Flags)，未置位的条件不参与匹配
+	/// </summary>
+	enum class ConnectionFilterFlags : uint32_t
+	{
+		None = 0,
+		Protocol = 1 << 0,          // ProtocolMask
+		State = 1 << 1,             // StateMask
+		LocalPort = 1 << 2,         // LocalPortMin ~ LocalPortMax
+		RemotePort = 1 << 3,        // RemotePortMin ~ RemotePortMax
+		LocalAddress = 1 << 4,      // LocalPrefix
+		RemoteAddress = 1 << 5,     // RemotePrefix
+		ProcessId = 1 << 6          // ProcessIds
+	};
+
+	/// <summary>
+	/// 地址前缀 (CIDR)，IPv4 前缀使用 Address 的前 4 个字节
+	/// </summary>
+	struct AddressPrefix
+	{
+		Ipv6Address Address;        // 前缀地址 (网络字节序)
+		AddressFamily Family;       // 地址族，与行的地址族不同时不匹配
+		uint8_t PrefixLength;       // 前缀长度 (IPv4 0~32，IPv6 0~128)
+		uint16_t Reserved;
+	};
+
+	/// <summary>
+	/// 连接过滤条件 - 用于跨边界传输，各条件之间为"与"关系
+	/// </summary>
+	struct ConnectionFilter
+	{
+		uint32_t Flags;                 // ConnectionFilterFlags 组合
+		uint32_t ProtocolMask;          // 允许的协议集合：1 << ProtocolType
+		uint32_t StateMask;             // 允许的状态集合：1 << ConnectionState
+		uint16_t LocalPortMin;          // 本地端口范围 (闭区间)
+		uint16_t LocalPortMax;
+		uint16_t RemotePortMin;         // 远程端口范围 (闭区间)
+		uint16_t RemotePortMax;
+		AddressPrefix LocalPrefix;      // 本地地址前缀
+		AddressPrefix RemotePrefix;     // 远程地址前缀
+		const uint32_t* ProcessIds;     // 允许的进程ID集合 (无需排序)
+		uint32_t ProcessIdCount;
+		uint32_t Reserved;
+	};
+
+	static_assert(sizeof(NetworkConnectionInfo) == 32,
+		"NetworkConnectionInfo size mismatch");
+
+	static_assert(sizeof(NetworkConnectionDelta) == 40,
+		"NetworkConnectionDelta size mismatch");
+
+	static_assert(sizeof(Ipv6Address) == 16,
+		"Ipv6Address size mismatch");
+
+	static_assert(sizeof(NetworkConnectionRow) == 20,
+		"NetworkConnectionRow size mismatch");
+
+	static_assert(sizeof(NetworkConnectionRowDelta) == 24,
+		"NetworkConnectionRowDelta size mismatch");
+
+	static_assert(sizeof(ProcessConnectionSummary) == 88,
+		"ProcessConnectionSummary size mismatch");
+
+	static_assert(sizeof(ProcessConnectionChurn) == 12,
+		"ProcessConnectionChurn size mismatch");
+
+	static_assert(sizeof(ClosedConnectionRecord) == 72,
+		"ClosedConnectionRecord size mismatch");
+}
@@ -0,0 +1,162 @@
+﻿#include <pch.h>
+#include "ProcNetConnectionSource.h"
+#include "ProcNetParser.h"
+#include <cstring>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace IronSight::Core::Native::Network
+{
+    namespace
+    {
+        constexpr const char* TableNames[] = { "net/tcp", "net/tcp6", "net/udp", "net/udp6" };
+
+        inline bool IsNumeric(const char* name) noexcept
+        {
+            if (!*name) return false;
+            for (; *name; ++name)
+            {
+                if (*name < '0' || *name > '9') return false;
+            }
+            return true;
+        }
+    }
+
+    ProcNetConnectionSource::ProcNetConnectionSource(const char* procRoot)
+        : _procRoot(procRoot ? procRoot : "/proc")
+    {
+        _tcpTableBuffer.resize(InitialBufferSize);
+        _udpTableBuffer.resize(InitialBufferSize);
+
+        for (int i = 0; i < TableCount; ++i)
+        {
+            std::string path = _procRoot + "/" + TableNames[i];
+            _tableFds[i] = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        }
+    }
+
+    ProcNetConnectionSource::~ProcNetConnectionSource()
+    {
+        for (int fd : _tableFds)
+        {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    void ProcNetConnectionSource::BeginRefresh()
+    {
+        RebuildInodeOwners();
+    }
+
+    bool ProcNetConnectionSource::CollectTcp(ConnectionTable& table)
+    {
+        return CollectTables(Tcp, Tcp6, ProtocolType::Tcp, _tcpTableBuffer, table);
+    }
+
+    bool ProcNetConnectionSource::CollectUdp(ConnectionTable& table)
+    {
+        return CollectTables(Udp, Udp6, ProtocolType::Udp, _udpTableBuffer, table);
+    }
+
+    bool ProcNetConnectionSource::ReadTable(int fd, std::vector<uint8_t>& buffer, size_t& length)
+    {
+        length = 0;
+        if (fd < 0) return false;
+
+        // seq_file 支持 pread：从偏移 0 读取即得到一份新的快照
+        while (true)
+        {
+            if (buffer.size() - length < 4096)
+            {
+                buffer.resize(buffer.size() * 2);
+            }
+
+            ssize_t n = pread(fd, buffer.data() + length, buffer.size() - length, static_cast<off_t>(length));
+            if (n < 0) return false;
+            if (n == 0) break;
+            length += static_cast<size_t>(n);
+        }
+
+        return true;
+    }
+
+    bool ProcNetConnectionSource::CollectTables(TableIndex v4, TableIndex v6, ProtocolType protocol,
+        std::vector<uint8_t>& buffer, ConnectionTable& table)
+    {
+        auto& connections = table.Rows;
+        size_t first = connections.size();
+        _inodes.clear();
+
+        bool success = false;
+        size_t length = 0;
+
+        // 两张表依次读入同一块缓冲区，解析完立即复用
+        if (ReadTable(_tableFds[v4], buffer, length))
+        {
+            ProcNetParser::Parse(reinterpret_cast<const char*>(buffer.data()), length,
+                protocol, false, table, _inodes);
+            success = true;
+        }
+
+        if (ReadTable(_tableFds[v6], buffer, length))
+        {
+            ProcNetParser::Parse(reinterpret_cast<const char*>(buffer.data()), length,
+                protocol, true, table, _inodes);
+            success = true;
+        }
+
+        for (size_t i = first; i < connections.size(); ++i)
+        {
+            auto it = _inodeOwners.find(_inodes[i - first]);
+            connections[i].ProcessId = (it != _inodeOwners.end()) ? it->second : 0;
+        }
+
+        return success;
+    }
+
+    void ProcNetConnectionSource::RebuildInodeOwners()
+    {
+        _inodeOwners.clear();
+
+        DIR* procDir = opendir(_procRoot.c_str());
+        if (!procDir) return;
+
+        std::string fdPath;
+        char link[64];
+
+        while (dirent* procEntry = readdir(procDir))
+        {
+            if (!IsNumeric(procEntry->d_name)) continue;
+
+            uint32_t pid = static_cast<uint32_t>(std::strtoul(procEntry->d_name, nullptr, 10));
+
+            fdPath.assign(_procRoot).append("/").append(procEntry->d_name).append("/fd");
+            DIR* fdDir = opendir(fdPath.c_str());
+            if (!fdDir) continue;  // 进程已退出或无权限
+
+            int fdDirFd = dirfd(fdDir);
+            while (dirent* fdEntry = readdir(fdDir))
+            {
+                if (fdEntry->d_name[0] == '.') continue;
+
+                ssize_t n = readlinkat(fdDirFd, fdEntry->d_name, link, sizeof(link) - 1);
+                if (n <= 0) continue;
+                link[n] = '\0';
+
+                // 目标形如 "socket:[12345]"
+                if (std::strncmp(link, "socket:[", 8) != 0) continue;
+
+                uint64_t inode = std::strtoull(link + 8, nullptr, 10);
+                _inodeOwners.emplace(inode, pid);
+            }
+
+            closedir(fdDir);
+        }
+
+        closedir(procDir);
+    }
+}
+#endif
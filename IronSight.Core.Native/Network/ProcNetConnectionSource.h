@@ -0,0 +1,49 @@
+﻿#pragma once
+#include "ConnectionSource.h"
+#include <unordered_map>
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// 基于 /proc/net 的 Linux 连接数据源
+	/// 表文件句柄常驻，每次刷新用 pread 从偏移 0 重新读取到预分配缓冲区并原地解析
+	/// </summary>
+	class ProcNetConnectionSource final : public IConnectionSource
+	{
+		public:
+		/// <summary>
+		/// 创建数据源
+		/// </summary>
+		/// <param name="procRoot">proc 文件系统根目录，指向录制目录即可回放录制的连接表</param>
+		explicit ProcNetConnectionSource(const char* procRoot = "/proc");
+		~ProcNetConnectionSource() override;
+
+		ProcNetConnectionSource(const ProcNetConnectionSource&) = delete;
+		ProcNetConnectionSource& operator=(const ProcNetConnectionSource&) = delete;
+
+		void BeginRefresh() override;
+		bool CollectTcp(ConnectionTable& table) override;
+		bool CollectUdp(ConnectionTable& table) override;
+
+		private:
+		enum TableIndex { Tcp = 0, Tcp6 = 1, Udp = 2, Udp6 = 3, TableCount = 4 };
+
+		bool ReadTable(int fd, std::vector<uint8_t>& buffer, size_t& length);
+		bool CollectTables(TableIndex v4, TableIndex v6, ProtocolType protocol,
+			std::vector<uint8_t>& buffer, ConnectionTable& table);
+		void RebuildInodeOwners();
+
+		std::string _procRoot;
+		int _tableFds[TableCount] = { -1, -1, -1, -1 };
+
+		// 预分配的缓冲区，避免频繁内存分配
+		std::vector<uint8_t> _tcpTableBuffer;
+		std::vector<uint8_t> _udpTableBuffer;
+		std::vector<uint64_t> _inodes;
+
+		// socket inode -> 所属进程，每轮刷新重建一次 (clear 保留桶数组)
+		std::unordered_map<uint64_t, uint32_t> _inodeOwners;
+
+		static constexpr size_t InitialBufferSize = 65536;
+	};
+}
@@ -0,0 +1,202 @@
+﻿#include <pch.h>
+#include "ProcNetParser.h"
+#include <cstring>
+
+namespace IronSight::Core::Native::Network
+{
+    namespace
+    {
+        inline int HexValue(char c) noexcept
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            return -1;
+        }
+
+        inline void SkipSpaces(const char*& p, const char* end) noexcept
+        {
+            while (p < end && (*p == ' ' || *p == '\t')) ++p;
+        }
+
+        inline void SkipToken(const char*& p, const char* end) noexcept
+        {
+            while (p < end && *p != ' ' && *p != '\t' && *p != '\n') ++p;
+        }
+
+        // 解析最多 maxDigits 位十六进制数，遇到非十六进制字符即停止
+        inline bool ParseHex(const char*& p, const char* end, int maxDigits, uint64_t& value) noexcept
+        {
+            value = 0;
+            int digits = 0;
+            while (p < end && digits < maxDigits)
+            {
+                int v = HexValue(*p);
+                if (v < 0) break;
+                value = (value << 4) | static_cast<uint64_t>(v);
+                ++p;
+                ++digits;
+            }
+            return digits > 0;
+        }
+
+        inline bool ParseDecimal(const char*& p, const char* end, uint64_t& value) noexcept
+        {
+            value = 0;
+            const char* start = p;
+            while (p < end && *p >= '0' && *p <= '9')
+            {
+                value = value * 10 + static_cast<uint64_t>(*p - '0');
+                ++p;
+            }
+            return p != start;
+        }
+
+        inline bool ParsePort(const char*& p, const char* end, uint16_t& port) noexcept
+        {
+            if (p >= end || *p != ':') return false;
+            ++p;
+
+            uint64_t word = 0;
+            if (!ParseHex(p, end, 4, word)) return false;
+            port = static_cast<uint16_t>(word);
+            return true;
+        }
+
+        // 解析 "ADDR:PORT" 形式的 IPv4 端点
+        // 内核以 %08X 打印网络字节序的 32 位字，因此在小端主机上解析结果即为网络字节序的地址值
+        inline bool ParseEndpoint(const char*& p, const char* end, uint32_t& address, uint16_t& port) noexcept
+        {
+            uint64_t word = 0;
+            if (!ParseHex(p, end, 8, word)) return false;
+            address = static_cast<uint32_t>(word);
+
+            return ParsePort(p, end, port);
+        }
+
+        // 解析 IPv6 端点：地址按 4 个 32 位字打印，逐字还原其内存表示即得到网络字节序的 16 字节地址
+        inline bool ParseEndpoint(const char*& p, const char* end, Ipv6Address& address, uint16_t& port) noexcept
+        {
+            uint64_t word = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                if (!ParseHex(p, end, 8, word)) return false;
+
+                uint32_t value = static_cast<uint32_t>(word);
+                std::memcpy(address.Bytes + i * sizeof(value), &value, sizeof(value));
+            }
+
+            return ParsePort(p, end, port);
+        }
+    }
+
+    ConnectionState ProcNetParser::ConvertTcpState(uint32_t kernelState) noexcept
+    {
+        switch (kernelState)
+        {
+        case 0x01: return ConnectionState::Established;
+        case 0x02: return ConnectionState::SynSent;
+        case 0x03: return ConnectionState::SynReceived;
+        case 0x04: return ConnectionState::FinWait1;
+        case 0x05: return ConnectionState::FinWait2;
+        case 0x06: return ConnectionState::TimeWait;
+        case 0x07: return ConnectionState::Closed;
+        case 0x08: return ConnectionState::CloseWait;
+        case 0x09: return ConnectionState::LastAck;
+        case 0x0A: return ConnectionState::Listen;
+        case 0x0B: return ConnectionState::Closing;
+        case 0x0C: return ConnectionState::SynReceived;  // TCP_NEW_SYN_RECV
+        default: return ConnectionState::Unknown;
+        }
+    }
+
+    size_t ProcNetParser::Parse(const char* data, size_t length,
+        ProtocolType protocol, bool isIpv6,
+        ConnectionTable& table,
+        std::vector<uint64_t>& inodes)
+    {
+        if (!data || length == 0) return 0;
+
+        const char* p = data;
+        const char* end = data + length;
+        size_t appended = 0;
+
+        // 跳过标题行
+        while (p < end && *p != '\n') ++p;
+
+        while (p < end)
+        {
+            ++p;  // 跳过上一行的换行符
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!lineEnd) lineEnd = end;
+
+            // 格式: sl local_address rem_address st tx_queue:rx_queue tr:tm->when retrnsmt uid timeout inode ...
+            const char* q = p;
+            p = lineEnd;
+
+            SkipSpaces(q, lineEnd);
+            SkipToken(q, lineEnd);  // sl
+            SkipSpaces(q, lineEnd);
+
+            NetworkConnectionRow info{};
+            Ipv6Address local6{};
+            Ipv6Address remote6{};
+
+            if (isIpv6)
+            {
+                if (!ParseEndpoint(q, lineEnd, local6, info.LocalPort)) continue;
+                SkipSpaces(q, lineEnd);
+                if (!ParseEndpoint(q, lineEnd, remote6, info.RemotePort)) continue;
+            }
+            else
+            {
+                if (!ParseEndpoint(q, lineEnd, info.LocalAddress, info.LocalPort)) continue;
+                SkipSpaces(q, lineEnd);
+                if (!ParseEndpoint(q, lineEnd, info.RemoteAddress, info.RemotePort)) continue;
+            }
+            SkipSpaces(q, lineEnd);
+
+            uint64_t state = 0;
+            if (!ParseHex(q, lineEnd, 2, state)) continue;
+
+            // tx_queue:rx_queue, tr:tm->when, retrnsmt, uid, timeout
+            for (int field = 0; field < 5; ++field)
+            {
+                SkipSpaces(q, lineEnd);
+                SkipToken(q, lineEnd);
+            }
+            SkipSpaces(q, lineEnd);
+
+            uint64_t inode = 0;
+            if (!ParseDecimal(q, lineEnd, inode)) continue;
+
+            info.Protocol = static_cast<uint8_t>(protocol);
+            if (protocol == ProtocolType::Tcp)
+            {
+                info.State = static_cast<uint8_t>(ConvertTcpState(static_cast<uint32_t>(state)));
+            }
+            else
+            {
+                // 与 Windows 数据源保持一致：UDP 无连接、无状态
+                info.RemoteAddress = 0;
+                info.RemotePort = 0;
+                info.State = static_cast<uint8_t>(ConnectionState::Unknown);
+                remote6 = {};
+            }
+
+            if (isIpv6)
+            {
+                table.AppendIpv6(info, local6, remote6);
+            }
+            else
+            {
+                table.AppendIpv4(info);
+            }
+
+            inodes.push_back(inode);
+            ++appended;
+        }
+
+        return appended;
+    }
+}
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include "ConnectionTable.h"
+
+namespace IronSight::Core::Native::Network
+{
+	/// <summary>
+	/// /proc/net/{tcp,tcp6,udp,udp6} 文本格式解析器
+	/// 直接在读入的缓冲区上原地解析十六进制字段，不做任何字符串拷贝；
+	/// 只依赖标准库，录制下来的表可以在任意平台上回放
+	/// </summary>
+	class ProcNetParser
+	{
+		public:
+		/// <summary>
+		/// 解析一张 /proc/net 表并将结果追加到 table 末尾
+		/// </summary>
+		/// <param name="data">表的完整文本 (包含标题行)</param>
+		/// <param name="length">文本长度 (字节)</param>
+		/// <param name="protocol">表对应的协议</param>
+		/// <param name="isIpv6">是否为 tcp6/udp6 格式的表</param>
+		/// <param name="table">输出：追加解析得到的连接，ProcessId 为 0；IPv4 映射地址折叠为 IPv4 行</param>
+		/// <param name="inodes">输出：与追加的每一行一一对应的 socket inode，用于之后解析 PID</param>
+		/// <returns>追加的行数</returns>
+		static size_t Parse(const char* data, size_t length,
+			ProtocolType protocol, bool isIpv6,
+			ConnectionTable& table,
+			std::vector<uint64_t>& inodes);
+
+		/// <summary>
+		/// 将内核 TCP 状态值 (include/net/tcp_states.h) 转换为 ConnectionState
+		/// </summary>
+		static ConnectionState ConvertTcpState(uint32_t kernelState) noexcept;
+	};
+}
@@ -0,0 +1,238 @@
+﻿#include <pch.h>
+#include "BitStream.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace IronSight::Core::Native::Recorder
+{
+    namespace
+    {
+        inline uint64_t LowMask(uint32_t count) noexcept
+        {
+            return count >= 64 ? ~0ull : (1ull << count) - 1;
+        }
+
+        // 以下两个函数要求 value 不为 0
+        inline uint32_t LeadingZeros(uint64_t value) noexcept
+        {
+#if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanReverse64(&index, value);
+            return 63 - index;
+#else
+            return static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+        }
+
+        inline uint32_t TrailingZeros(uint64_t value) noexcept
+        {
+#if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanForward64(&index, value);
+            return index;
+#else
+            return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+        }
+
+        inline uint64_t DoubleBits(double value) noexcept
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        inline double BitsToDouble(uint64_t bits) noexcept
+        {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    }
+
+    void BitWriter::Clear() noexcept
+    {
+        _bytes.clear();
+        _accumulator = 0;
+        _pending = 0;
+    }
+
+    void BitWriter::WriteBits(uint64_t value, uint32_t count)
+    {
+        while (count > 0)
+        {
+            const uint32_t take = (std::min)(64 - _pending, count);
+            const uint64_t chunk = (value >> (count - take)) & LowMask(take);
+
+            _accumulator = take == 64 ? chunk : (_accumulator << take) | chunk;
+            _pending += take;
+            count -= take;
+
+            if (_pending == 64)
+            {
+                for (int shift = 56; shift >= 0; shift -= 8) _bytes.push_back(static_cast<uint8_t>(_accumulator >> shift));
+                _accumulator = 0;
+                _pending = 0;
+            }
+        }
+    }
+
+    void BitWriter::WriteVarint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            WriteBits(0x80 | (value & 0x7F), 8);
+            value >>= 7;
+        }
+        WriteBits(value, 8);
+    }
+
+    void BitWriter::WriteSigned(int64_t value)
+    {
+        WriteVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void BitWriter::WriteXor(uint64_t previous, uint64_t value, XorWindow& window)
+    {
+        const uint64_t delta = previous ^ value;
+        if (delta == 0)
+        {
+            WriteBits(0, 1);
+            return;
+        }
+
+        const uint32_t leading = LeadingZeros(delta);
+        const uint32_t trailing = TrailingZeros(delta);
+
+        if (window.Leading != 64 && leading >= window.Leading && trailing >= window.Trailing)
+        {
+            // 控制位 10：沿用上一次的窗口
+            WriteBits(0b10, 2);
+            WriteBits(delta >> window.Trailing, 64 - window.Leading - window.Trailing);
+            return;
+        }
+
+        // 控制位 11：新窗口 = 前导零数 (6 位) + 有效位长度 - 1 (6 位) + 有效位
+        const uint32_t length = 64 - leading - trailing;
+        WriteBits(0b11, 2);
+        WriteBits(leading, 6);
+        WriteBits(length - 1, 6);
+        WriteBits(delta >> trailing, length);
+
+        window.Leading = leading;
+        window.Trailing = trailing;
+    }
+
+    void BitWriter::WriteDouble(double previous, double value, XorWindow& window)
+    {
+        WriteXor(DoubleBits(previous), DoubleBits(value), window);
+    }
+
+    const std::vector<uint8_t>& BitWriter::Finish()
+    {
+        if (_pending > 0)
+        {
+            const uint32_t bytes = (_pending + 7) / 8;
+            const uint64_t aligned = _accumulator << (bytes * 8 - _pending);
+
+            for (uint32_t i = 0; i < bytes; ++i) _bytes.push_back(static_cast<uint8_t>(aligned >> ((bytes - 1 - i) * 8)));
+
+            _accumulator = 0;
+            _pending = 0;
+        }
+        return _bytes;
+    }
+
+    uint64_t BitReader::ReadBits(uint32_t count) noexcept
+    {
+        uint64_t result = 0;
+
+        while (count > 0)
+        {
+            if (_byte >= _size)
+            {
+                _overrun = true;
+                return 0;
+            }
+
+            const uint32_t available = 8 - _bit;
+            const uint32_t take = (std::min)(available, count);
+            const uint32_t chunk = (_data[_byte] >> (available - take)) & ((1u << take) - 1);
+
+            result = (result << take) | chunk;
+            _bit += take;
+            count -= take;
+
+            if (_bit == 8)
+            {
+                _bit = 0;
+                ++_byte;
+            }
+        }
+
+        return result;
+    }
+
+    uint64_t BitReader::ReadVarint() noexcept
+    {
+        uint64_t value = 0;
+
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            const uint64_t group = ReadBits(8);
+            value |= (group & 0x7F) << shift;
+            if ((group & 0x80) == 0 || _overrun) return value;
+        }
+
+        // 超过 10 组的编码不可能由 WriteVarint 产生
+        _overrun = true;
+        return value;
+    }
+
+    int64_t BitReader::ReadSigned() noexcept
+    {
+        const uint64_t value = ReadVarint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    uint64_t BitReader::ReadXor(uint64_t previous, XorWindow& window) noexcept
+    {
+        if (!ReadBit()) return previous;
+
+        if (!ReadBit())
+        {
+            if (window.Leading == 64)
+            {
+                _overrun = true;
+                return previous;
+            }
+
+            const uint64_t bits = ReadBits(64 - window.Leading - window.Trailing);
+            return previous ^ (bits << window.Trailing);
+        }
+
+        const uint32_t leading = static_cast<uint32_t>(ReadBits(6));
+        const uint32_t length = static_cast<uint32_t>(ReadBits(6)) + 1;
+        if (leading + length > 64)
+        {
+            _overrun = true;
+            return previous;
+        }
+
+        const uint32_t trailing = 64 - leading - length;
+        const uint64_t bits = ReadBits(length);
+
+        window.Leading = leading;
+        window.Trailing = trailing;
+        return previous ^ (bits << trailing);
+    }
+
+    double BitReader::ReadDouble(double previous, XorWindow& window) noexcept
+    {
+        return BitsToDouble(ReadXor(DoubleBits(previous), window));
+    }
+}
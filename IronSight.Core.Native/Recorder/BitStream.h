@@ -0,0 +1,104 @@
+﻿#pragma once
+
+namespace IronSight::Core::Native::Recorder
+{
+	/// <summary>
+	/// XOR 编码的有效位窗口 (Gorilla)
+	/// 与上一个值异或后的有效位落在上一次的窗口内时只写控制位与窗口内的位，不再重复写前导零数与长度
+	/// </summary>
+	struct XorWindow
+	{
+		uint32_t Leading = 64;      // 64 表示尚无窗口
+		uint32_t Trailing = 0;
+	};
+
+	/// <summary>
+	/// 按位追加的写入器 (高位在前)
+	/// </summary>
+	class BitWriter
+	{
+		public:
+		/// <summary>
+		/// 清空已写入的内容，保留容量
+		/// </summary>
+		void Clear() noexcept;
+
+		/// <summary>
+		/// 写入 value 的低 count 位 (count 不超过 64)
+		/// </summary>
+		void WriteBits(uint64_t value, uint32_t count);
+
+		void WriteBit(bool value) { WriteBits(value ? 1 : 0, 1); }
+
+		/// <summary>
+		/// 变长无符号整数：每组 7 位数据 + 1 位续位
+		/// </summary>
+		void WriteVarint(uint64_t value);
+
+		/// <summary>
+		/// 变长有符号整数 (ZigZag 后按 WriteVarint 写入)，用于差值
+		/// </summary>
+		void WriteSigned(int64_t value);
+
+		/// <summary>
+		/// 写入 value 与 previous 的异或：相同时只占 1 位，否则写入异或结果的有效位
+		/// </summary>
+		void WriteXor(uint64_t previous, uint64_t value, XorWindow& window);
+
+		/// <summary>
+		/// 按位模式对 double 做 XOR 编码
+		/// </summary>
+		void WriteDouble(double previous, double value, XorWindow& window);
+
+		/// <summary>
+		/// 补齐最后一个字节并返回全部内容
+		/// </summary>
+		const std::vector<uint8_t>& Finish();
+
+		size_t BitCount() const noexcept { return _bytes.size() * 8 + _pending; }
+
+		private:
+		std::vector<uint8_t> _bytes;
+		uint64_t _accumulator = 0;
+		uint32_t _pending = 0;      // 累加器中尚未落盘的位数
+	};
+
+	/// <summary>
+	/// 与 BitWriter 对应的读取器
+	/// 越界读取返回 0 并置位 Overrun，调用方在解码结束后统一检查，无需逐次判断
+	/// </summary>
+	class BitReader
+	{
+		public:
+		BitReader(const uint8_t* data, size_t size) noexcept : _data(data), _size(size) {}
+
+		uint64_t ReadBits(uint32_t count) noexcept;
+
+		bool ReadBit() noexcept { return ReadBits(1) != 0; }
+
+		uint64_t ReadVarint() noexcept;
+
+		int64_t ReadSigned() noexcept;
+
+		uint64_t ReadXor(uint64_t previous, XorWindow& window) noexcept;
+
+		double ReadDouble(double previous, XorWindow& window) noexcept;
+
+		/// <summary>
+		/// 剩余未读的位数，用于在分配前校验负载中声明的元素数量
+		/// </summary>
+		size_t RemainingBits() const noexcept { return _byte >= _size ? 0 : (_size - _byte) * 8 - _bit; }
+
+		/// <summary>
+		/// 是否读到了数据末尾之外
+		/// </summary>
+		bool Overrun() const noexcept { return _overrun; }
+
+		private:
+		const uint8_t* _data;
+		size_t _size;
+		size_t _byte = 0;
+		uint32_t _bit = 0;
+		bool _overrun = false;
+	};
+}
@@ -0,0 +1,285 @@
+﻿#include <pch.h>
+#include "FlightRecordReader.h"
+#include "FlightRecorder.h"
+#include "Text/StringPool.h"
+#include "Logging/Log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace IronSight::Core::Native::Recorder
+{
+    namespace
+    {
+        // 回放的帧类型 (字符串表在打开时已全部解码)
+        constexpr FrameType ReplayTypes[] = { FrameType::System, FrameType::Processes, FrameType::Connections };
+    }
+
+    bool FlightRecordReader::Open(const std::filesystem::path& path)
+    {
+        std::error_code error;
+        std::vector<std::filesystem::path> segments;
+
+        if (std::filesystem::is_directory(path, error)) segments = FlightRecorder::ListSegments(path);
+        else segments.push_back(path);
+
+        for (const std::filesystem::path& segment : segments)
+        {
+            auto file = std::make_unique<MappedFile>();
+            if (!file->Open(segment) || file->Size() < sizeof(RecordFileHeader)) continue;
+
+            RecordFileHeader header;
+            std::memcpy(&header, file->Data(), sizeof(header));
+            if (header.Magic != RecordFileMagic || header.Version != RecordFormatVersion) continue;
+
+            const uint32_t index = static_cast<uint32_t>(_files.size());
+            _names.emplace_back();
+            IndexSegment(index, *file);
+            _files.push_back(std::move(file));
+        }
+
+        bool any = false;
+        for (FrameType type : ReplayTypes)
+        {
+            const std::vector<FrameEntry>& frames = _tracks[static_cast<size_t>(type)].Frames;
+            if (frames.empty()) continue;
+
+            _firstMs = any ? (std::min)(_firstMs, frames.front().TimestampMs) : frames.front().TimestampMs;
+            _lastMs = any ? (std::max)(_lastMs, frames.back().TimestampMs) : frames.back().TimestampMs;
+            any = true;
+        }
+
+        return any;
+    }
+
+    void FlightRecordReader::IndexSegment(uint32_t segment, const MappedFile& file)
+    {
+        const uint8_t* data = file.Data();
+        const size_t size = file.Size();
+        size_t offset = sizeof(RecordFileHeader);
+
+        // 关键帧链不跨分段：分段开头缺少关键帧的帧不可解码
+        size_t keyframes[FrameTypeCount];
+        std::fill(std::begin(keyframes), std::end(keyframes), NoFrame);
+
+        Text::StringPool& pool = Text::StringPool::Shared();
+        std::vector<std::pair<uint32_t, std::string>> strings;
+
+        while (size - offset >= sizeof(FrameHeader))
+        {
+            FrameHeader header;
+            std::memcpy(&header, data + offset, sizeof(header));
+
+            // 末尾不完整的帧 (录制进程在写入中途退出) 或损坏的帧头：本分段到此为止
+            if (header.PayloadBytes > MaxFramePayloadBytes || header.PayloadBytes > size - offset - sizeof(header)) break;
+
+            const uint8_t* payload = data + offset + sizeof(header);
+            offset += sizeof(header) + header.PayloadBytes;
+
+            if (header.Type == FrameType::Strings)
+            {
+                BitReader reader(payload, header.PayloadBytes);
+                if (!FrameDecoder::DecodeStrings(reader, strings)) continue;
+
+                for (const auto& [id, text] : strings) _names[segment][id] = pool.Intern(text);
+                continue;
+            }
+
+            const size_t type = static_cast<size_t>(header.Type);
+            if (header.Type != FrameType::System && header.Type != FrameType::Processes && header.Type != FrameType::Connections) continue;
+
+            std::vector<FrameEntry>& frames = _tracks[type].Frames;
+            const bool keyframe = (header.Flags & FrameFlagKeyframe) != 0;
+            if (keyframe) keyframes[type] = frames.size();
+
+            frames.push_back({ header.TimestampMs, payload, header.PayloadBytes, segment, keyframe, keyframes[type] });
+        }
+    }
+
+    int64_t FlightRecordReader::Seek(int64_t timestampMs)
+    {
+        int64_t applied = 0;
+
+        for (FrameType type : ReplayTypes)
+        {
+            SeekTrack(type, timestampMs);
+
+            const Track& track = _tracks[static_cast<size_t>(type)];
+            if (track.Valid) applied = (std::max)(applied, track.Frames[track.Cursor].TimestampMs);
+        }
+
+        const Track& processes = _tracks[static_cast<size_t>(FrameType::Processes)];
+        if (processes.Valid) RemapProcesses(processes.Frames[processes.Cursor].Segment);
+        else _processes.clear();
+
+        _position = timestampMs;
+        _positioned = true;
+        return applied;
+    }
+
+    int64_t FlightRecordReader::Next()
+    {
+        // 各类型中严格晚于当前位置的最早一帧
+        bool found = false;
+        int64_t next = 0;
+
+        for (FrameType type : ReplayTypes)
+        {
+            const std::vector<FrameEntry>& frames = _tracks[static_cast<size_t>(type)].Frames;
+
+            auto it = _positioned
+                ? std::upper_bound(frames.begin(), frames.end(), _position,
+                    [](int64_t value, const FrameEntry& entry) { return value < entry.TimestampMs; })
+                : frames.begin();
+
+            if (it != frames.end() && (!found || it->TimestampMs < next))
+            {
+                next = it->TimestampMs;
+                found = true;
+            }
+        }
+
+        if (!found) return 0;
+
+        Seek(next);
+        return next;
+    }
+
+    void FlightRecordReader::SeekTrack(FrameType type, int64_t timestampMs)
+    {
+        Track& track = _tracks[static_cast<size_t>(type)];
+        const std::vector<FrameEntry>& frames = track.Frames;
+
+        auto it = std::upper_bound(frames.begin(), frames.end(), timestampMs,
+            [](int64_t value, const FrameEntry& entry) { return value < entry.TimestampMs; });
+
+        const size_t target = it == frames.begin() ? NoFrame : static_cast<size_t>(it - frames.begin()) - 1;
+        if (target == NoFrame || frames[target].Keyframe == NoFrame)
+        {
+            track.Valid = false;
+            track.Cursor = NoFrame;
+            return;
+        }
+
+        // 已解码位置与目标属于同一条关键帧链且不晚于目标时接着解码，否则从关键帧重新开始
+        const size_t keyframe = frames[target].Keyframe;
+        const bool resume = track.Valid && track.Cursor != NoFrame && track.Cursor >= keyframe && track.Cursor <= target;
+
+        for (size_t i = resume ? track.Cursor + 1 : keyframe; i <= target; ++i)
+        {
+            if (!Apply(type, frames[i]))
+            {
+                LOG_WARN("FlightRecordReader: 帧 %zu 解码失败", i);
+                track.Valid = false;
+                track.Cursor = NoFrame;
+                return;
+            }
+        }
+
+        track.Valid = true;
+        track.Cursor = target;
+    }
+
+    bool FlightRecordReader::Apply(FrameType type, const FrameEntry& entry)
+    {
+        BitReader reader(entry.Payload, entry.PayloadBytes);
+
+        switch (type)
+        {
+            case FrameType::System: return _decoder.DecodeSystem(reader, entry.IsKeyframe);
+            case FrameType::Processes: return _decoder.DecodeProcesses(reader, entry.IsKeyframe);
+            case FrameType::Connections: return _decoder.DecodeConnections(reader, entry.IsKeyframe);
+            default: return false;
+        }
+    }
+
+    void FlightRecordReader::RemapProcesses(uint32_t segment)
+    {
+        const std::unordered_map<uint32_t, uint32_t>& names = _names[segment];
+
+        _processes = _decoder.Processes();
+        for (System::ProcessDetailInfo& row : _processes)
+        {
+            auto it = names.find(row.NameId);
+            row.NameId = it != names.end() ? it->second : 0;
+        }
+    }
+
+    const Network::ConnectionTable& FlightRecordReader::Connections() const noexcept
+    {
+        return _tracks[static_cast<size_t>(FrameType::Connections)].Valid ? _decoder.Connections() : _empty;
+    }
+
+    extern "C"
+    {
+        FlightRecordReader* FlightReader_Open(const char* path)
+        {
+            std::filesystem::path location = PathFromUtf8(path);
+            if (location.empty()) return nullptr;
+
+            auto reader = std::make_unique<FlightRecordReader>();
+            if (!reader->Open(location)) return nullptr;
+            return reader.release();
+        }
+
+        void FlightReader_Close(FlightRecordReader* reader)
+        {
+            delete reader;
+        }
+
+        bool FlightReader_GetRange(const FlightRecordReader* reader, int64_t* firstMs, int64_t* lastMs)
+        {
+            if (!reader) return false;
+
+            if (firstMs) *firstMs = reader->FirstTimestamp();
+            if (lastMs) *lastMs = reader->LastTimestamp();
+            return true;
+        }
+
+        int64_t FlightReader_Seek(FlightRecordReader* reader, int64_t timestampMs)
+        {
+            if (!reader) return 0;
+            return reader->Seek(timestampMs);
+        }
+
+        int64_t FlightReader_Next(FlightRecordReader* reader)
+        {
+            if (!reader) return 0;
+            return reader->Next();
+        }
+
+        bool FlightReader_GetSystem(const FlightRecordReader* reader, System::SystemPerformanceSnapshot* snapshot)
+        {
+            if (!reader || !snapshot || !reader->HasSystem()) return false;
+
+            *snapshot = reader->System();
+            return true;
+        }
+
+        size_t FlightReader_GetProcesses(const FlightRecordReader* reader, const System::ProcessDetailInfo** rows)
+        {
+            if (!reader) return 0;
+
+            const std::vector<System::ProcessDetailInfo>& processes = reader->Processes();
+            if (rows) *rows = processes.data();
+            return processes.size();
+        }
+
+        size_t FlightReader_GetConnections(const FlightRecordReader* reader, const Network::NetworkConnectionRow** rows)
+        {
+            if (!reader) return 0;
+
+            const Network::ConnectionTable& table = reader->Connections();
+            if (rows) *rows = table.Rows.data();
+            return table.Rows.size();
+        }
+
+        size_t FlightReader_GetAddresses(const FlightRecordReader* reader, const Network::Ipv6Address** addresses)
+        {
+            if (!reader) return 0;
+
+            const Network::Ipv6AddressTable& table = reader->Connections().Addresses;
+            if (addresses) *addresses = table.Data();
+            return table.Size();
+        }
+    }
+}
@@ -0,0 +1,131 @@
+﻿#pragma once
+#include <memory>
+#include <unordered_map>
+#include "FrameCodec.h"
+#include "RecordFile.h"
+#include "RecordFormat.h"
+
+namespace IronSight::Core::Native::Recorder
+{
+	/// <summary>
+	/// 飞行记录回放
+	/// 打开时内存映射全部分段并只扫描帧头建立各类型的时间索引 (负载不解码，字符串表帧除外)；
+	/// 定位到某一时刻时二分查找该时刻之前的最后一帧，从其所属的关键帧 (或已解码到的位置) 向前解码，
+	/// 结果即采集端使用的 SystemPerformanceSnapshot / ProcessDetailInfo / NetworkConnectionRow。
+	/// 非线程安全：每个读者由一个线程使用
+	/// </summary>
+	class FlightRecordReader
+	{
+		public:
+		/// <summary>
+		/// 打开一个录制目录 (全部分段) 或单个分段文件
+		/// </summary>
+		/// <returns>没有任何可用的帧时返回 false</returns>
+		bool Open(const std::filesystem::path& path);
+
+		int64_t FirstTimestamp() const noexcept { return _firstMs; }
+		int64_t LastTimestamp() const noexcept { return _lastMs; }
+
+		/// <summary>
+		/// 把各类型的状态定位到 timestampMs 时刻 (该时刻及之前的最后一帧)
+		/// 向后顺序定位时从上次的位置继续解码
+		/// </summary>
+		/// <returns>实际应用的最新帧的时间戳，该时刻之前没有任何帧时返回 0</returns>
+		int64_t Seek(int64_t timestampMs);
+
+		/// <summary>
+		/// 前进到当前位置之后的下一帧 (任意类型)
+		/// </summary>
+		/// <returns>新位置的时间戳，已到末尾时返回 0</returns>
+		int64_t Next();
+
+		bool HasSystem() const noexcept { return _tracks[static_cast<size_t>(FrameType::System)].Valid; }
+		const System::SystemPerformanceSnapshot& System() const noexcept { return _decoder.System(); }
+
+		/// <summary>
+		/// 当前位置的进程表 (按 PID 排序)，NameId 已换算为本进程驻留池的 ID
+		/// </summary>
+		const std::vector<System::ProcessDetailInfo>& Processes() const noexcept { return _processes; }
+
+		/// <summary>
+		/// 当前位置的连接表 (按连接键排序)，该时刻之前没有连接帧时为空
+		/// </summary>
+		const Network::ConnectionTable& Connections() const noexcept;
+
+		private:
+		static constexpr size_t NoFrame = static_cast<size_t>(-1);
+
+		struct FrameEntry
+		{
+			int64_t TimestampMs;
+			const uint8_t* Payload;
+			uint32_t PayloadBytes;
+			uint32_t Segment;
+			bool IsKeyframe;
+			size_t Keyframe;        // 解码本帧需要从哪一帧开始 (NoFrame 表示缺少关键帧，不可解码)
+		};
+
+		struct Track
+		{
+			std::vector<FrameEntry> Frames;
+			size_t Cursor = NoFrame;    // 已解码到的帧
+			bool Valid = false;
+		};
+
+		void IndexSegment(uint32_t segment, const MappedFile& file);
+		void SeekTrack(FrameType type, int64_t timestampMs);
+		bool Apply(FrameType type, const FrameEntry& entry);
+		void RemapProcesses(uint32_t segment);
+
+		std::vector<std::unique_ptr<MappedFile>> _files;
+		std::vector<std::unordered_map<uint32_t, uint32_t>> _names;    // 每个分段：录制时的驻留池 ID -> 本进程的 ID
+		Track _tracks[FrameTypeCount];
+		FrameDecoder _decoder;
+		std::vector<System::ProcessDetailInfo> _processes;
+		Network::ConnectionTable _empty;
+
+		int64_t _firstMs = 0;
+		int64_t _lastMs = 0;
+		int64_t _position = 0;
+		bool _positioned = false;
+	};
+
+	extern "C"
+	{
+		/// <summary>
+		/// 打开录制目录或单个分段 (UTF-8 路径)，失败返回空
+		/// </summary>
+		__declspec(dllexport) FlightRecordReader* FlightReader_Open(const char* path);
+
+		__declspec(dllexport) void FlightReader_Close(FlightRecordReader* reader);
+
+		/// <summary>
+		/// 录制覆盖的时间范围 (Unix 毫秒)
+		/// </summary>
+		__declspec(dllexport) bool FlightReader_GetRange(const FlightRecordReader* reader, int64_t* firstMs, int64_t* lastMs);
+
+		/// <summary>
+		/// 定位到指定时刻，返回实际应用的最新帧时间戳 (没有数据时为 0)
+		/// </summary>
+		__declspec(dllexport) int64_t FlightReader_Seek(FlightRecordReader* reader, int64_t timestampMs);
+
+		/// <summary>
+		/// 前进到下一帧，已到末尾时返回 0
+		/// </summary>
+		__declspec(dllexport) int64_t FlightReader_Next(FlightRecordReader* reader);
+
+		__declspec(dllexport) bool FlightReader_GetSystem(const FlightRecordReader* reader, System::SystemPerformanceSnapshot* snapshot);
+
+		/// <summary>
+		/// 当前位置的进程表，指针在下一次 Seek/Next/Close 之前有效
+		/// </summary>
+		__declspec(dllexport) size_t FlightReader_GetProcesses(const FlightRecordReader* reader, const System::ProcessDetailInfo** rows);
+
+		/// <summary>
+		/// 当前位置的连接表，IPv6 行的地址字段为 FlightReader_GetAddresses 的索引；指针在下一次 Seek/Next/Close 之前有效
+		/// </summary>
+		__declspec(dllexport) size_t FlightReader_GetConnections(const FlightRecordReader* reader, const Network::NetworkConnectionRow** rows);
+
+		__declspec(dllexport) size_t FlightReader_GetAddresses(const FlightRecordReader* reader, const Network::Ipv6Address** addresses);
+	}
+}
@@ -0,0 +1,450 @@
+﻿#include <pch.h>
+#include "FlightRecorder.h"
+#include "Text/StringPool.h"
+#include "Logging/Log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace IronSight::Core::Native::Recorder
+{
+    namespace
+    {
+        constexpr char SegmentPrefix[] = "flight-";
+        constexpr char SegmentExtension[] = ".isfr";
+
+        std::filesystem::path SegmentPath(const std::filesystem::path& directory, uint64_t sequence)
+        {
+            char name[64];
+            std::snprintf(name, sizeof(name), "%s%010llu%s", SegmentPrefix, static_cast<unsigned long long>(sequence), SegmentExtension);
+            return directory / name;
+        }
+
+        // 解析 flight-<序号>.isfr，其他文件一律忽略
+        bool TryParseSequence(const std::filesystem::path& path, uint64_t& sequence)
+        {
+            if (path.extension() != SegmentExtension) return false;
+
+            // 按本机字符类型逐字符比较 (Windows 下为 UTF-16)，不做可能失败的编码转换
+            const auto stem = path.stem().native();
+            const size_t prefixLength = sizeof(SegmentPrefix) - 1;
+            if (stem.size() <= prefixLength) return false;
+
+            for (size_t i = 0; i < prefixLength; ++i)
+            {
+                if (stem[i] != static_cast<std::filesystem::path::value_type>(SegmentPrefix[i])) return false;
+            }
+
+            sequence = 0;
+            for (size_t i = prefixLength; i < stem.size(); ++i)
+            {
+                if (stem[i] < '0' || stem[i] > '9') return false;
+                sequence = sequence * 10 + static_cast<uint64_t>(stem[i] - '0');
+            }
+            return true;
+        }
+
+        // 写线程回收的帧缓冲区上限，稳态下每周期最多排队几帧
+        constexpr size_t MaxSpareBuffers = 8;
+
+        int64_t UnixNowMs() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    FlightRecorder& FlightRecorder::Shared()
+    {
+        static FlightRecorder* recorder = new FlightRecorder();
+        return *recorder;
+    }
+
+    std::vector<std::filesystem::path> FlightRecorder::ListSegments(const std::filesystem::path& directory)
+    {
+        std::vector<std::pair<uint64_t, std::filesystem::path>> found;
+
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+        {
+            uint64_t sequence = 0;
+            if (it->is_regular_file(error) && TryParseSequence(it->path(), sequence)) found.emplace_back(sequence, it->path());
+        }
+
+        std::sort(found.begin(), found.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<std::filesystem::path> segments;
+        segments.reserve(found.size());
+        for (auto& [sequence, path] : found) segments.push_back(std::move(path));
+        return segments;
+    }
+
+    FlightRecorder::~FlightRecorder()
+    {
+        Stop();
+    }
+
+    bool FlightRecorder::Start(const std::filesystem::path& directory, uint64_t maxSegmentBytes, uint32_t maxSegments)
+    {
+        if (directory.empty()) return false;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        StopLocked();
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) return false;
+
+        // 接着目录中已有的最大序号编号，旧录制保留到被轮转淘汰为止；之后的分段列表只在内存中维护
+        _directory = directory;
+        _sequence = 0;
+        _segments.clear();
+        for (const std::filesystem::path& segment : ListSegments(directory))
+        {
+            uint64_t sequence = 0;
+            if (!TryParseSequence(segment, sequence)) continue;
+
+            _segments.push_back(sequence);
+            _sequence = (std::max)(_sequence, sequence + 1);
+        }
+
+        _maxSegmentBytes = maxSegmentBytes != 0 ? (std::max)(maxSegmentBytes, static_cast<uint64_t>(64 * 1024)) : DefaultSegmentBytes;
+        _maxSegments = maxSegments != 0 ? maxSegments : DefaultMaxSegments;
+        _stats = {};
+        {
+            std::lock_guard<std::mutex> queueLock(_queueMutex);
+            _framesWritten = 0;
+            _bytesWritten = 0;
+            _segmentCount = 0;
+            _stopWriter = false;
+        }
+
+        // 第一个分段同步创建，目录不可写时直接返回失败
+        if (!OpenSegment(UnixNowMs())) return false;
+
+        _segmentBytes = sizeof(RecordFileHeader);
+        std::fill(std::begin(_sinceKeyframe), std::end(_sinceKeyframe), 0u);
+        _segmentNames.clear();
+        _newSegmentPending = false;
+
+        _writerThread = std::thread(&FlightRecorder::WriterLoop, this);
+
+        _recording.store(true, std::memory_order_relaxed);
+        LOG_INFO("FlightRecorder: 开始录制 - 分段上限 %llu 字节 x %u",
+            static_cast<unsigned long long>(_maxSegmentBytes), _maxSegments);
+        return true;
+    }
+
+    void FlightRecorder::Stop()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        StopLocked();
+    }
+
+    void FlightRecorder::StopLocked()
+    {
+        _recording.store(false, std::memory_order_relaxed);
+
+        // 写线程退出前写完已排队的帧
+        if (_writerThread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> queueLock(_queueMutex);
+                _stopWriter = true;
+            }
+            _queueReady.notify_one();
+            _writerThread.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> queueLock(_queueMutex);
+            _queue.clear();
+            _queuedBytes = 0;
+        }
+
+        _file.Close();
+        _encoder.Reset();
+        _segmentNames.clear();
+        _newSegmentPending = false;
+    }
+
+    bool FlightRecorder::OpenSegment(int64_t timestampMs)
+    {
+        const uint64_t sequence = _sequence++;
+        if (!_file.Open(SegmentPath(_directory, sequence)))
+        {
+            LOG_ERROR("FlightRecorder: 无法创建分段 %llu", static_cast<unsigned long long>(sequence));
+            return false;
+        }
+
+        RecordFileHeader header{};
+        header.Magic = RecordFileMagic;
+        header.Version = RecordFormatVersion;
+        header.CreatedMs = timestampMs;
+        if (!_file.Write(&header, sizeof(header)))
+        {
+            _file.Close();
+            return false;
+        }
+
+        // 超出保留数量时删除最旧的分段；删除失败 (例如正被回放打开) 也不再跟踪，避免每次轮转重试
+        _segments.push_back(sequence);
+        while (_segments.size() > _maxSegments)
+        {
+            std::error_code error;
+            std::filesystem::remove(SegmentPath(_directory, _segments.front()), error);
+            if (error) LOG_WARN("FlightRecorder: 无法删除分段 %llu", static_cast<unsigned long long>(_segments.front()));
+            _segments.pop_front();
+        }
+
+        std::lock_guard<std::mutex> queueLock(_queueMutex);
+        _bytesWritten += sizeof(header);
+        _segmentCount = static_cast<uint32_t>(_segments.size());
+        return true;
+    }
+
+    void FlightRecorder::WriterLoop()
+    {
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        bool failed = false;
+
+        while (true)
+        {
+            _queueReady.wait(lock, [this] { return _stopWriter || !_queue.empty(); });
+            if (_queue.empty()) break;
+
+            QueuedFrame frame = std::move(_queue.front());
+            _queue.pop_front();
+            lock.unlock();
+
+            bool written = false;
+            if (!failed)
+            {
+                if (frame.NewSegment)
+                {
+                    _file.Close();
+                    written = OpenSegment(frame.TimestampMs);
+                }
+                else
+                {
+                    written = _file.IsOpen();
+                }
+
+                written = written && _file.Write(frame.Bytes.data(), frame.Bytes.size());
+                if (!written)
+                {
+                    // 停止接收新帧，已排队的帧直接丢弃，等待 Stop/Start 回收本线程
+                    LOG_ERROR("FlightRecorder: 写入失败，停止录制");
+                    _recording.store(false, std::memory_order_relaxed);
+                    _file.Close();
+                    failed = true;
+                }
+            }
+
+            lock.lock();
+            _queuedBytes -= frame.Bytes.size();
+            if (written)
+            {
+                _framesWritten++;
+                _bytesWritten += frame.Bytes.size();
+            }
+            if (_spareBuffers.size() < MaxSpareBuffers) _spareBuffers.push_back(std::move(frame.Bytes));
+        }
+    }
+
+    void FlightRecorder::BeginSegmentLocked()
+    {
+        // 新分段必须能独立解码：各类型的下一帧都是关键帧，进程名重新写出
+        std::fill(std::begin(_sinceKeyframe), std::end(_sinceKeyframe), 0u);
+        _segmentNames.clear();
+        _segmentBytes = sizeof(RecordFileHeader);
+        _newSegmentPending = true;
+    }
+
+    void FlightRecorder::RotateIfFullLocked()
+    {
+        if (_segmentBytes >= _maxSegmentBytes) BeginSegmentLocked();
+    }
+
+    template <typename Encode>
+    bool FlightRecorder::AppendLocked(FrameType type, int64_t timestampMs, size_t rawBytes, Encode&& encode)
+    {
+        uint32_t& sinceKeyframe = _sinceKeyframe[static_cast<size_t>(type)];
+        const bool keyframe = sinceKeyframe == 0;
+
+        _writer.Clear();
+        encode(keyframe, _writer);
+        const std::vector<uint8_t>& payload = _writer.Finish();
+
+        FrameHeader header{};
+        header.PayloadBytes = static_cast<uint32_t>(payload.size());
+        header.Type = type;
+        header.Flags = keyframe ? FrameFlagKeyframe : 0;
+        header.TimestampMs = timestampMs;
+
+        const size_t frameBytes = sizeof(header) + payload.size();
+        bool wasEmpty = false;
+        {
+            std::lock_guard<std::mutex> queueLock(_queueMutex);
+
+            if (_queuedBytes + frameBytes > MaxQueuedBytes)
+            {
+                // 丢帧后本分段的增量链已断开，从下一帧起开始新分段
+                LOG_WARN("FlightRecorder: 写入积压 %zu 字节，丢弃一帧", _queuedBytes);
+                BeginSegmentLocked();
+                return false;
+            }
+
+            QueuedFrame frame;
+            if (!_spareBuffers.empty())
+            {
+                frame.Bytes = std::move(_spareBuffers.back());
+                _spareBuffers.pop_back();
+            }
+
+            // 帧头与负载一次写出，读取端不会看到只有帧头的帧
+            frame.Bytes.resize(frameBytes);
+            std::memcpy(frame.Bytes.data(), &header, sizeof(header));
+            if (!payload.empty()) std::memcpy(frame.Bytes.data() + sizeof(header), payload.data(), payload.size());
+            frame.TimestampMs = timestampMs;
+            frame.NewSegment = _newSegmentPending;
+
+            wasEmpty = _queue.empty();
+            _queue.push_back(std::move(frame));
+            _queuedBytes += frameBytes;
+        }
+        if (wasEmpty) _queueReady.notify_one();
+
+        _newSegmentPending = false;
+        _segmentBytes += frameBytes;
+        _stats.RawBytes += rawBytes;
+        sinceKeyframe = (sinceKeyframe + 1) % KeyframeInterval;
+        return true;
+    }
+
+    void FlightRecorder::RecordSystem(int64_t timestampMs, const System::SystemPerformanceSnapshot& snapshot)
+    {
+        if (!IsRecording()) return;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_recording.load(std::memory_order_relaxed)) return;
+
+        const auto started = std::chrono::steady_clock::now();
+
+        RotateIfFullLocked();
+
+        AppendLocked(FrameType::System, timestampMs, sizeof(snapshot), [&](bool keyframe, BitWriter& writer)
+            {
+                _encoder.EncodeSystem(snapshot, keyframe, writer);
+            });
+
+        _stats.EncodeMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count();
+    }
+
+    void FlightRecorder::RecordProcesses(int64_t timestampMs, const System::ProcessDetailInfo* rows, size_t count)
+    {
+        if (!IsRecording() || (!rows && count > 0)) return;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_recording.load(std::memory_order_relaxed)) return;
+
+        const auto started = std::chrono::steady_clock::now();
+
+        RotateIfFullLocked();
+
+        // 驻留池 ID 只在本进程内有效：本分段首次引用的名称先以字符串表帧写出
+        _newNames.clear();
+        Text::StringPool& pool = Text::StringPool::Shared();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t nameId = rows[i].NameId;
+            if (nameId != 0 && _segmentNames.insert(nameId).second) _newNames.emplace_back(nameId, pool.Get(nameId));
+        }
+
+        if (!_newNames.empty())
+        {
+            size_t rawBytes = 0;
+            for (const auto& [id, text] : _newNames) rawBytes += sizeof(id) + text.size();
+
+            // 字符串表帧被丢弃时进程帧也不能写出，否则其引用的名称在分段中缺失
+            const bool queued = AppendLocked(FrameType::Strings, timestampMs, rawBytes, [&](bool, BitWriter& writer)
+                {
+                    FrameEncoder::EncodeStrings(_newNames, writer);
+                });
+            if (!queued) return;
+        }
+
+        AppendLocked(FrameType::Processes, timestampMs, count * sizeof(System::ProcessDetailInfo), [&](bool keyframe, BitWriter& writer)
+            {
+                _encoder.EncodeProcesses(rows, count, keyframe, writer);
+            });
+
+        _stats.EncodeMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count();
+    }
+
+    void FlightRecorder::RecordConnections(int64_t timestampMs, const Network::ConnectionTable& table)
+    {
+        if (!IsRecording()) return;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_recording.load(std::memory_order_relaxed)) return;
+
+        const auto started = std::chrono::steady_clock::now();
+
+        RotateIfFullLocked();
+
+        const size_t rawBytes = table.Rows.size() * sizeof(Network::NetworkConnectionRow) +
+            table.Addresses.Size() * sizeof(Network::Ipv6Address);
+
+        AppendLocked(FrameType::Connections, timestampMs, rawBytes, [&](bool keyframe, BitWriter& writer)
+            {
+                _encoder.EncodeConnections(table, keyframe, writer);
+            });
+
+        _stats.EncodeMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count();
+    }
+
+    FlightRecorderStats FlightRecorder::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        FlightRecorderStats stats = _stats;
+        {
+            std::lock_guard<std::mutex> queueLock(_queueMutex);
+            stats.FramesWritten = _framesWritten;
+            stats.BytesWritten = _bytesWritten;
+            stats.SegmentCount = _segmentCount;
+        }
+        stats.IsRecording = _recording.load(std::memory_order_relaxed) ? 1 : 0;
+        return stats;
+    }
+
+    extern "C"
+    {
+        bool FlightRecorder_Start(const char* directory, uint64_t maxSegmentBytes, uint32_t maxSegments)
+        {
+            return FlightRecorder::Shared().Start(PathFromUtf8(directory), maxSegmentBytes, maxSegments);
+        }
+
+        void FlightRecorder_Stop()
+        {
+            FlightRecorder::Shared().Stop();
+        }
+
+        bool FlightRecorder_IsRecording()
+        {
+            return FlightRecorder::Shared().IsRecording();
+        }
+
+        void FlightRecorder_GetStats(FlightRecorderStats* stats)
+        {
+            if (stats) *stats = FlightRecorder::Shared().GetStats();
+        }
+    }
+}
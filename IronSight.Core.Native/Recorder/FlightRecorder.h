@@ -0,0 +1,166 @@
+﻿#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include "FrameCodec.h"
+#include "RecordFile.h"
+#include "RecordFormat.h"
+
+namespace IronSight::Core::Native::Recorder
+{
+#pragma pack(push, 8)
+	/// <summary>
+	/// 录制统计 (与 C# FlightRecorderStats 保持同步)
+	/// </summary>
+	struct FlightRecorderStats
+	{
+		uint64_t FramesWritten;         // 已写入的帧数 (含字符串表帧)
+		uint64_t BytesWritten;          // 已写入磁盘的字节数 (含文件头与帧头)
+		uint64_t RawBytes;              // 同样内容以原生结构表示的字节数，与 BytesWritten 之比即压缩率
+		uint64_t EncodeMicroseconds;    // 采集线程上编码的累计耗时 (写入在写线程上，不计入)
+		uint32_t SegmentCount;          // 目录中保留的分段数
+		uint32_t IsRecording;
+	};
+#pragma pack(pop)
+
+	/// <summary>
+	/// 飞行记录仪：把系统快照、进程表与连接表持续追加到本地的轮转分段文件
+	/// 采集端在每次刷新后推送结果 (未录制时只有一次原子读取)，每类帧以同类型的上一帧为基准压缩，
+	/// 稳态下一帧只包含真正变化的字段。分段写满后切换到新文件并删除最旧的分段，磁盘占用有上限；
+	/// 每个分段以关键帧开始，之后每 KeyframeInterval 帧再插入一次，回放时定位到任意时刻最多解码这么多帧。
+	/// 采集线程上只做编码；写文件、创建与删除分段由录制期间常驻的写线程完成，磁盘变慢不会拖住采集。
+	/// 写线程积压超过 MaxQueuedBytes 时丢弃新帧并从下一帧起开始新分段，保证每个分段仍能完整解码
+	/// </summary>
+	class FlightRecorder
+	{
+		public:
+		/// <summary>
+		/// 获取全局共享的记录仪 (刻意不析构，与采样线程的退出顺序无关)
+		/// </summary>
+		static FlightRecorder& Shared();
+
+		FlightRecorder() = default;
+		~FlightRecorder();
+
+		FlightRecorder(const FlightRecorder&) = delete;
+		FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+		/// <summary>
+		/// 开始录制到 directory (不存在时创建)，总是新建分段，不会改写已有的文件
+		/// 已在录制时先停止当前录制；第一个分段在返回前创建，之后的分段由写线程创建
+		/// </summary>
+		/// <param name="maxSegmentBytes">单个分段的目标大小，0 表示默认值</param>
+		/// <param name="maxSegments">目录中保留的分段数，0 表示默认值</param>
+		bool Start(const std::filesystem::path& directory, uint64_t maxSegmentBytes, uint32_t maxSegments);
+
+		/// <summary>
+		/// 停止录制：等待写线程写完已排队的帧后关闭分段
+		/// </summary>
+		void Stop();
+
+		bool IsRecording() const noexcept { return _recording.load(std::memory_order_relaxed); }
+
+		void RecordSystem(int64_t timestampMs, const System::SystemPerformanceSnapshot& snapshot);
+
+		void RecordProcesses(int64_t timestampMs, const System::ProcessDetailInfo* rows, size_t count);
+
+		/// <summary>
+		/// 记录一代已按连接键排序的连接表 (即已发布的快照)
+		/// </summary>
+		void RecordConnections(int64_t timestampMs, const Network::ConnectionTable& table);
+
+		FlightRecorderStats GetStats() const;
+
+		/// <summary>
+		/// 目录中的分段文件，按序号升序 (即时间顺序)
+		/// </summary>
+		static std::vector<std::filesystem::path> ListSegments(const std::filesystem::path& directory);
+
+		static constexpr uint64_t DefaultSegmentBytes = 64ull * 1024 * 1024;
+		static constexpr uint32_t DefaultMaxSegments = 8;
+		static constexpr uint32_t KeyframeInterval = 120;
+		static constexpr size_t MaxQueuedBytes = 16 * 1024 * 1024;
+
+		private:
+		struct QueuedFrame
+		{
+			std::vector<uint8_t> Bytes;     // 帧头 + 负载
+			int64_t TimestampMs = 0;
+			bool NewSegment = false;        // 先关闭当前分段并创建新分段再写入
+		};
+
+		// 以下函数要求调用方已持有 _mutex
+		void RotateIfFullLocked();
+		void BeginSegmentLocked();
+		void StopLocked();
+
+		/// <summary>
+		/// 编码一帧并交给写线程，encode 接收 (keyframe, writer)
+		/// 不在这里轮转：字符串表帧与引用它的进程帧必须落在同一个分段
+		/// </summary>
+		/// <returns>写线程积压过多而丢弃本帧时返回 false (此时已决定从下一帧开始新分段)</returns>
+		template <typename Encode>
+		bool AppendLocked(FrameType type, int64_t timestampMs, size_t rawBytes, Encode&& encode);
+
+		// 写线程 (以及启动时的第一个分段)
+		void WriterLoop();
+		bool OpenSegment(int64_t timestampMs);
+		void WriterFailed();
+
+		// 录制端状态 (_mutex)：编码器与分段切换的决定
+		mutable std::mutex _mutex;
+		std::atomic<bool> _recording{ false };
+
+		uint64_t _segmentBytes = 0;             // 当前分段已编码的字节数 (含尚未写出的帧)
+		uint64_t _maxSegmentBytes = DefaultSegmentBytes;
+		uint32_t _maxSegments = DefaultMaxSegments;
+		bool _newSegmentPending = false;        // 下一帧从新分段开始
+
+		FrameEncoder _encoder;
+		BitWriter _writer;
+		uint32_t _sinceKeyframe[FrameTypeCount] = {};
+
+		// 本分段已写出的进程名，ID 为本进程驻留池的 ID
+		std::unordered_set<uint32_t> _segmentNames;
+		std::vector<std::pair<uint32_t, std::string_view>> _newNames;
+
+		FlightRecorderStats _stats{};           // 帧数、原始字节与编码耗时
+
+		// 写队列 (_queueMutex)；帧缓冲区用完后回收，稳态下排队不分配内存
+		mutable std::mutex _queueMutex;
+		std::condition_variable _queueReady;
+		std::deque<QueuedFrame> _queue;
+		std::vector<std::vector<uint8_t>> _spareBuffers;
+		size_t _queuedBytes = 0;
+		bool _stopWriter = false;
+		uint64_t _framesWritten = 0;
+		uint64_t _bytesWritten = 0;
+		uint32_t _segmentCount = 0;
+		std::thread _writerThread;
+
+		// 写线程独占 (启动前与停止后由 Start/Stop 访问)；分段序号在启动时从目录读取一次，之后只在内存中维护
+		std::filesystem::path _directory;
+		RecordFileWriter _file;
+		uint64_t _sequence = 0;
+		std::deque<uint64_t> _segments;
+	};
+
+	extern "C"
+	{
+		/// <summary>
+		/// 开始录制到指定目录 (UTF-8 路径)
+		/// </summary>
+		/// <param name="maxSegmentBytes">单个分段的目标大小，0 表示 64 MB</param>
+		/// <param name="maxSegments">保留的分段数，0 表示 8 个</param>
+		__declspec(dllexport) bool FlightRecorder_Start(const char* directory, uint64_t maxSegmentBytes, uint32_t maxSegments);
+
+		__declspec(dllexport) void FlightRecorder_Stop();
+
+		__declspec(dllexport) bool FlightRecorder_IsRecording();
+
+		__declspec(dllexport) void FlightRecorder_GetStats(FlightRecorderStats* stats);
+	}
+}
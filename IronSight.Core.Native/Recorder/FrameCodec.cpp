@@ -0,0 +1,470 @@
+﻿#include <pch.h>
+#include "FrameCodec.h"
+#include "Network/ConnectionDiff.h"
+#include <algorithm>
+
+namespace IronSight::Core::Native::Recorder
+{
+    using System::ProcessDetailInfo;
+    using System::SystemPerformanceSnapshot;
+    using Network::AddressFamily;
+    using Network::ConnectionDiff;
+    using Network::Ipv6Address;
+    using Network::NetworkConnectionRow;
+
+    namespace
+    {
+        // 连接表操作码 (2 位)
+        enum ConnectionOp : uint32_t
+        {
+            OpKeep = 0,     // 保留上一帧接下来的 n 行
+            OpSkip = 1,     // 丢弃上一帧接下来的 n 行
+            OpState = 2,    // 保留上一帧的下一行，状态改为新值
+            OpInsert = 3    // 插入一行新连接
+        };
+
+        // 一帧内插入行的编码基准：按连接键排序后相邻的新连接通常属于同一进程、共享本地地址
+        struct InsertContext
+        {
+            uint32_t ProcessId = 0;
+            uint64_t Local4 = 0;
+            uint64_t Remote4 = 0;
+            uint64_t Local6[2] = {};
+            uint64_t Remote6[2] = {};
+            uint16_t LocalPort = 0;
+            uint16_t RemotePort = 0;
+            XorWindow Windows[6];
+        };
+
+        // 同类型上一帧中 PID 相同的行 (两边都按 PID 排序，游标只进不退)，没有时以全零行为基准
+        inline const ProcessDetailInfo& FindBase(const std::vector<ProcessDetailInfo>& previous, size_t& cursor,
+            uint32_t pid, const ProcessDetailInfo& zero) noexcept
+        {
+            while (cursor < previous.size() && previous[cursor].Pid < pid) ++cursor;
+            return cursor < previous.size() && previous[cursor].Pid == pid ? previous[cursor] : zero;
+        }
+
+        inline void WriteChanged(BitWriter& writer, uint32_t previous, uint32_t value)
+        {
+            writer.WriteBit(previous != value);
+            if (previous != value) writer.WriteVarint(value);
+        }
+
+        inline uint32_t ReadChanged(BitReader& reader, uint32_t previous) noexcept
+        {
+            return reader.ReadBit() ? static_cast<uint32_t>(reader.ReadVarint()) : previous;
+        }
+
+        inline void WritePort(BitWriter& writer, uint16_t& previous, uint16_t value)
+        {
+            writer.WriteBit(previous != value);
+            if (previous != value) writer.WriteBits(value, 16);
+            previous = value;
+        }
+
+        inline uint16_t ReadPort(BitReader& reader, uint16_t& previous) noexcept
+        {
+            if (reader.ReadBit()) previous = static_cast<uint16_t>(reader.ReadBits(16));
+            return previous;
+        }
+
+        inline void SplitAddress(const Ipv6Address& address, uint64_t halves[2]) noexcept
+        {
+            halves[0] = 0;
+            halves[1] = 0;
+            for (int i = 0; i < 8; ++i) halves[0] = (halves[0] << 8) | address.Bytes[i];
+            for (int i = 8; i < 16; ++i) halves[1] = (halves[1] << 8) | address.Bytes[i];
+        }
+
+        inline Ipv6Address JoinAddress(const uint64_t halves[2]) noexcept
+        {
+            Ipv6Address address{};
+            for (int i = 0; i < 8; ++i) address.Bytes[i] = static_cast<uint8_t>(halves[0] >> (56 - i * 8));
+            for (int i = 0; i < 8; ++i) address.Bytes[8 + i] = static_cast<uint8_t>(halves[1] >> (56 - i * 8));
+            return address;
+        }
+
+        void WriteAddress6(BitWriter& writer, const Ipv6Address& address, uint64_t previous[2], XorWindow* windows)
+        {
+            uint64_t halves[2];
+            SplitAddress(address, halves);
+
+            writer.WriteXor(previous[0], halves[0], windows[0]);
+            writer.WriteXor(previous[1], halves[1], windows[1]);
+            previous[0] = halves[0];
+            previous[1] = halves[1];
+        }
+
+        void ReadAddress6(BitReader& reader, uint64_t previous[2], XorWindow* windows) noexcept
+        {
+            previous[0] = reader.ReadXor(previous[0], windows[0]);
+            previous[1] = reader.ReadXor(previous[1], windows[1]);
+        }
+
+        void WriteInsert(BitWriter& writer, const NetworkConnectionRow& row,
+            const Network::Ipv6AddressTable& addresses, InsertContext& context)
+        {
+            writer.WriteSigned(static_cast<int64_t>(row.ProcessId) - static_cast<int64_t>(context.ProcessId));
+            context.ProcessId = row.ProcessId;
+
+            writer.WriteBits(row.Protocol, 2);
+            writer.WriteBit(row.Family == AddressFamily::Ipv6);
+            writer.WriteBits(row.State, 4);
+
+            if (row.Family == AddressFamily::Ipv6)
+            {
+                WriteAddress6(writer, addresses[row.LocalAddress], context.Local6, context.Windows + 2);
+                WriteAddress6(writer, addresses[row.RemoteAddress], context.Remote6, context.Windows + 4);
+            }
+            else
+            {
+                writer.WriteXor(context.Local4, row.LocalAddress, context.Windows[0]);
+                writer.WriteXor(context.Remote4, row.RemoteAddress, context.Windows[1]);
+                context.Local4 = row.LocalAddress;
+                context.Remote4 = row.RemoteAddress;
+            }
+
+            WritePort(writer, context.LocalPort, row.LocalPort);
+            WritePort(writer, context.RemotePort, row.RemotePort);
+        }
+
+        NetworkConnectionRow ReadInsert(BitReader& reader, Network::Ipv6AddressTable& addresses, InsertContext& context)
+        {
+            NetworkConnectionRow row{};
+
+            context.ProcessId = static_cast<uint32_t>(static_cast<int64_t>(context.ProcessId) + reader.ReadSigned());
+            row.ProcessId = context.ProcessId;
+
+            row.Protocol = static_cast<uint8_t>(reader.ReadBits(2));
+            row.Family = reader.ReadBit() ? AddressFamily::Ipv6 : AddressFamily::Ipv4;
+            row.State = static_cast<uint8_t>(reader.ReadBits(4));
+
+            if (row.Family == AddressFamily::Ipv6)
+            {
+                ReadAddress6(reader, context.Local6, context.Windows + 2);
+                ReadAddress6(reader, context.Remote6, context.Windows + 4);
+                row.LocalAddress = addresses.Intern(JoinAddress(context.Local6));
+                row.RemoteAddress = addresses.Intern(JoinAddress(context.Remote6));
+            }
+            else
+            {
+                context.Local4 = reader.ReadXor(context.Local4, context.Windows[0]);
+                context.Remote4 = reader.ReadXor(context.Remote4, context.Windows[1]);
+                row.LocalAddress = static_cast<uint32_t>(context.Local4);
+                row.RemoteAddress = static_cast<uint32_t>(context.Remote4);
+            }
+
+            row.LocalPort = ReadPort(reader, context.LocalPort);
+            row.RemotePort = ReadPort(reader, context.RemotePort);
+            return row;
+        }
+    }
+
+    void FrameEncoder::Reset()
+    {
+        _system = {};
+        for (XorWindow& window : _systemWindows) window = {};
+        _processes.clear();
+        _connections.Clear();
+    }
+
+    void FrameEncoder::EncodeSystem(const SystemPerformanceSnapshot& snapshot, bool keyframe, BitWriter& writer)
+    {
+        if (keyframe)
+        {
+            _system = {};
+            for (XorWindow& window : _systemWindows) window = {};
+        }
+
+        // 系统快照只有一行：XOR 窗口跨帧保留，与 Gorilla 的单序列编码一致
+        writer.WriteDouble(_system.CpuUsage, snapshot.CpuUsage, _systemWindows[0]);
+        writer.WriteDouble(_system.CpuTemperature, snapshot.CpuTemperature, _systemWindows[1]);
+        writer.WriteDouble(_system.MemoryUsagePercent, snapshot.MemoryUsagePercent, _systemWindows[2]);
+        writer.WriteDouble(_system.TotalPhysicalMemoryMB, snapshot.TotalPhysicalMemoryMB, _systemWindows[3]);
+        writer.WriteDouble(_system.AvailablePhysicalMemoryMB, snapshot.AvailablePhysicalMemoryMB, _systemWindows[4]);
+        writer.WriteDouble(_system.CommittedBytesMB, snapshot.CommittedBytesMB, _systemWindows[5]);
+        writer.WriteSigned(static_cast<int64_t>(snapshot.ProcessCount) - _system.ProcessCount);
+        writer.WriteSigned(static_cast<int64_t>(snapshot.ThreadCount) - _system.ThreadCount);
+        writer.WriteSigned(static_cast<int64_t>(snapshot.HandleCount) - _system.HandleCount);
+
+        _system = snapshot;
+    }
+
+    void FrameEncoder::EncodeProcesses(const ProcessDetailInfo* rows, size_t count, bool keyframe, BitWriter& writer)
+    {
+        if (keyframe) _processes.clear();
+
+        _sorted.assign(rows, rows + count);
+        std::sort(_sorted.begin(), _sorted.end(),
+            [](const ProcessDetailInfo& a, const ProcessDetailInfo& b) { return a.Pid < b.Pid; });
+
+        writer.WriteVarint(count);
+
+        // 同一列的数值量级相近，XOR 窗口在一帧的各行之间共享
+        XorWindow windows[4];
+        const ProcessDetailInfo zero{};
+        uint32_t lastPid = 0;
+        size_t cursor = 0;
+
+        for (const ProcessDetailInfo& row : _sorted)
+        {
+            writer.WriteVarint(row.Pid - lastPid);
+            lastPid = row.Pid;
+
+            const ProcessDetailInfo& base = FindBase(_processes, cursor, row.Pid, zero);
+
+            writer.WriteDouble(base.MemoryMB, row.MemoryMB, windows[0]);
+            writer.WriteDouble(base.CpuUsage, row.CpuUsage, windows[1]);
+            writer.WriteDouble(base.DiskReadRateMS, row.DiskReadRateMS, windows[2]);
+            writer.WriteDouble(base.DiskWriteRateMS, row.DiskWriteRateMS, windows[3]);
+            writer.WriteSigned(static_cast<int64_t>(row.ThreadCount) - base.ThreadCount);
+            writer.WriteSigned(static_cast<int64_t>(row.HandleCount) - base.HandleCount);
+            WriteChanged(writer, static_cast<uint32_t>(base.PriorityClass), static_cast<uint32_t>(row.PriorityClass));
+            WriteChanged(writer, base.NameId, row.NameId);
+        }
+
+        _processes.swap(_sorted);
+    }
+
+    void FrameEncoder::EncodeConnections(const Network::ConnectionTable& table, bool keyframe, BitWriter& writer)
+    {
+        if (keyframe) _connections.Clear();
+
+        const std::vector<NetworkConnectionRow>& previous = _connections.Rows;
+        const std::vector<NetworkConnectionRow>& current = table.Rows;
+
+        writer.WriteVarint(current.size());
+
+        InsertContext context;
+        uint64_t keep = 0;
+        uint64_t skip = 0;
+
+        // 两个计数同一时刻至多一个不为 0
+        auto flush = [&]()
+            {
+                if (keep > 0)
+                {
+                    writer.WriteBits(OpKeep, 2);
+                    writer.WriteVarint(keep);
+                    keep = 0;
+                }
+                if (skip > 0)
+                {
+                    writer.WriteBits(OpSkip, 2);
+                    writer.WriteVarint(skip);
+                    skip = 0;
+                }
+            };
+
+        size_t i = 0;
+        size_t j = 0;
+        while (j < current.size())
+        {
+            const int compare = i < previous.size()
+                ? ConnectionDiff::CompareKey(previous[i], _connections.Addresses, current[j], table.Addresses)
+                : 1;
+
+            if (compare < 0)
+            {
+                if (keep > 0) flush();
+                ++skip;
+                ++i;
+            }
+            else if (compare > 0)
+            {
+                flush();
+                writer.WriteBits(OpInsert, 2);
+                WriteInsert(writer, current[j], table.Addresses, context);
+                ++j;
+            }
+            else if (previous[i].State == current[j].State)
+            {
+                if (skip > 0) flush();
+                ++keep;
+                ++i;
+                ++j;
+            }
+            else
+            {
+                flush();
+                writer.WriteBits(OpState, 2);
+                writer.WriteBits(current[j].State, 4);
+                ++i;
+                ++j;
+            }
+        }
+
+        // 末尾被移除的行无需写出：解码端凑满行数即停止
+        if (keep > 0) flush();
+
+        _connections.Rows = table.Rows;
+        _connections.Addresses = table.Addresses;
+    }
+
+    void FrameEncoder::EncodeStrings(const std::vector<std::pair<uint32_t, std::string_view>>& strings, BitWriter& writer)
+    {
+        writer.WriteVarint(strings.size());
+
+        for (const auto& [id, text] : strings)
+        {
+            writer.WriteVarint(id);
+            writer.WriteVarint(text.size());
+            for (char c : text) writer.WriteBits(static_cast<uint8_t>(c), 8);
+        }
+    }
+
+    void FrameDecoder::Reset()
+    {
+        _system = {};
+        for (XorWindow& window : _systemWindows) window = {};
+        _processes.clear();
+        _connections.Clear();
+    }
+
+    bool FrameDecoder::DecodeSystem(BitReader& reader, bool keyframe)
+    {
+        if (keyframe)
+        {
+            _system = {};
+            for (XorWindow& window : _systemWindows) window = {};
+        }
+
+        SystemPerformanceSnapshot snapshot{};
+        snapshot.CpuUsage = reader.ReadDouble(_system.CpuUsage, _systemWindows[0]);
+        snapshot.CpuTemperature = reader.ReadDouble(_system.CpuTemperature, _systemWindows[1]);
+        snapshot.MemoryUsagePercent = reader.ReadDouble(_system.MemoryUsagePercent, _systemWindows[2]);
+        snapshot.TotalPhysicalMemoryMB = reader.ReadDouble(_system.TotalPhysicalMemoryMB, _systemWindows[3]);
+        snapshot.AvailablePhysicalMemoryMB = reader.ReadDouble(_system.AvailablePhysicalMemoryMB, _systemWindows[4]);
+        snapshot.CommittedBytesMB = reader.ReadDouble(_system.CommittedBytesMB, _systemWindows[5]);
+        snapshot.ProcessCount = static_cast<uint32_t>(_system.ProcessCount + reader.ReadSigned());
+        snapshot.ThreadCount = static_cast<uint32_t>(_system.ThreadCount + reader.ReadSigned());
+        snapshot.HandleCount = static_cast<uint32_t>(_system.HandleCount + reader.ReadSigned());
+
+        if (reader.Overrun()) return false;
+
+        _system = snapshot;
+        return true;
+    }
+
+    bool FrameDecoder::DecodeProcesses(BitReader& reader, bool keyframe)
+    {
+        if (keyframe) _processes.clear();
+
+        // 每行至少占 8 字节以上的位，声明的行数超过负载容量即为损坏
+        const uint64_t count = reader.ReadVarint();
+        if (reader.Overrun() || count > reader.RemainingBits() / 8) return false;
+
+        _next.clear();
+        _next.reserve(static_cast<size_t>(count));
+
+        XorWindow windows[4];
+        const ProcessDetailInfo zero{};
+        uint32_t pid = 0;
+        size_t cursor = 0;
+
+        for (uint64_t n = 0; n < count && !reader.Overrun(); ++n)
+        {
+            pid += static_cast<uint32_t>(reader.ReadVarint());
+
+            const ProcessDetailInfo& base = FindBase(_processes, cursor, pid, zero);
+
+            ProcessDetailInfo& row = _next.emplace_back();
+            row.Pid = pid;
+            row.MemoryMB = reader.ReadDouble(base.MemoryMB, windows[0]);
+            row.CpuUsage = reader.ReadDouble(base.CpuUsage, windows[1]);
+            row.DiskReadRateMS = reader.ReadDouble(base.DiskReadRateMS, windows[2]);
+            row.DiskWriteRateMS = reader.ReadDouble(base.DiskWriteRateMS, windows[3]);
+            row.ThreadCount = static_cast<uint32_t>(base.ThreadCount + reader.ReadSigned());
+            row.HandleCount = static_cast<uint32_t>(base.HandleCount + reader.ReadSigned());
+            row.PriorityClass = static_cast<int>(ReadChanged(reader, static_cast<uint32_t>(base.PriorityClass)));
+            row.NameId = ReadChanged(reader, base.NameId);
+        }
+
+        if (reader.Overrun()) return false;
+
+        _processes.swap(_next);
+        return true;
+    }
+
+    bool FrameDecoder::DecodeConnections(BitReader& reader, bool keyframe)
+    {
+        // 关键帧之间地址表只增不减：保留下来的行仍引用其中的旧索引
+        if (keyframe) _connections.Clear();
+
+        const std::vector<NetworkConnectionRow>& previous = _connections.Rows;
+
+        const uint64_t count = reader.ReadVarint();
+        if (reader.Overrun() || count > previous.size() + reader.RemainingBits()) return false;
+
+        _nextRows.clear();
+        _nextRows.reserve(static_cast<size_t>(count));
+
+        InsertContext context;
+        size_t i = 0;
+
+        while (_nextRows.size() < count && !reader.Overrun())
+        {
+            switch (static_cast<ConnectionOp>(reader.ReadBits(2)))
+            {
+                case OpKeep:
+                {
+                    const uint64_t n = reader.ReadVarint();
+                    if (n > previous.size() - i || n > count - _nextRows.size()) return false;
+
+                    _nextRows.insert(_nextRows.end(), previous.begin() + i, previous.begin() + i + static_cast<size_t>(n));
+                    i += static_cast<size_t>(n);
+                    break;
+                }
+                case OpSkip:
+                {
+                    const uint64_t n = reader.ReadVarint();
+                    if (n > previous.size() - i) return false;
+
+                    i += static_cast<size_t>(n);
+                    break;
+                }
+                case OpState:
+                {
+                    if (i >= previous.size()) return false;
+
+                    NetworkConnectionRow row = previous[i++];
+                    row.State = static_cast<uint8_t>(reader.ReadBits(4));
+                    _nextRows.push_back(row);
+                    break;
+                }
+                case OpInsert:
+                {
+                    _nextRows.push_back(ReadInsert(reader, _connections.Addresses, context));
+                    break;
+                }
+            }
+        }
+
+        if (reader.Overrun()) return false;
+
+        _connections.Rows.swap(_nextRows);
+        return true;
+    }
+
+    bool FrameDecoder::DecodeStrings(BitReader& reader, std::vector<std::pair<uint32_t, std::string>>& strings)
+    {
+        strings.clear();
+
+        const uint64_t count = reader.ReadVarint();
+        if (reader.Overrun() || count > reader.RemainingBits() / 16) return false;
+
+        for (uint64_t n = 0; n < count; ++n)
+        {
+            const uint32_t id = static_cast<uint32_t>(reader.ReadVarint());
+            const uint64_t length = reader.ReadVarint();
+            if (reader.Overrun() || length > reader.RemainingBits() / 8) return false;
+
+            std::string text(static_cast<size_t>(length), '\0');
+            for (char& c : text) c = static_cast<char>(reader.ReadBits(8));
+
+            strings.emplace_back(id, std::move(text));
+        }
+
+        return !reader.Overrun();
+    }
+}
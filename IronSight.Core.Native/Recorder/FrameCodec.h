@@ -0,0 +1,87 @@
+﻿#pragma once
+#include <string>
+#include <string_view>
+#include "BitStream.h"
+#include "System/ProcessTypes.h"
+#include "System/SystemTypes.h"
+#include "Network/ConnectionTable.h"
+
+namespace IronSight::Core::Native::Recorder
+{
+	/// <summary>
+	/// 帧负载编码器
+	/// 每种帧以同类型的上一帧为基准编码：浮点字段做 Gorilla 式 XOR，整数字段写差值；
+	/// 进程表按 PID 与上一帧同 PID 的行对齐，连接表按连接键归并为 保留/跳过/状态/插入 四种操作的游程，
+	/// 稳态下数万行不变的连接只占几个字节。关键帧以全零状态为基准，因此与前一帧无关
+	/// </summary>
+	class FrameEncoder
+	{
+		public:
+		/// <summary>
+		/// 丢弃全部基准 (下一帧必须是关键帧)
+		/// </summary>
+		void Reset();
+
+		void EncodeSystem(const System::SystemPerformanceSnapshot& snapshot, bool keyframe, BitWriter& writer);
+
+		/// <summary>
+		/// 编码完整进程表 (顺序任意，内部按 PID 排序)
+		/// </summary>
+		void EncodeProcesses(const System::ProcessDetailInfo* rows, size_t count, bool keyframe, BitWriter& writer);
+
+		/// <summary>
+		/// 编码已按连接键排序的连接表
+		/// </summary>
+		void EncodeConnections(const Network::ConnectionTable& table, bool keyframe, BitWriter& writer);
+
+		/// <summary>
+		/// 编码字符串表 (驻留池 ID -> UTF-8)
+		/// </summary>
+		static void EncodeStrings(const std::vector<std::pair<uint32_t, std::string_view>>& strings, BitWriter& writer);
+
+		private:
+		System::SystemPerformanceSnapshot _system{};
+		XorWindow _systemWindows[6];
+		std::vector<System::ProcessDetailInfo> _processes;     // 上一帧 (按 PID 排序)
+		std::vector<System::ProcessDetailInfo> _sorted;        // 本帧排序缓冲
+		Network::ConnectionTable _connections;                 // 上一帧
+	};
+
+	/// <summary>
+	/// 与 FrameEncoder 对应的解码器，解码结果即为采集端使用的原生结构
+	/// 负载损坏 (越界、操作数与基准不符) 时返回 false，该类型的状态不再可信，调用方应从下一个关键帧重新开始
+	/// </summary>
+	class FrameDecoder
+	{
+		public:
+		void Reset();
+
+		bool DecodeSystem(BitReader& reader, bool keyframe);
+
+		bool DecodeProcesses(BitReader& reader, bool keyframe);
+
+		bool DecodeConnections(BitReader& reader, bool keyframe);
+
+		static bool DecodeStrings(BitReader& reader, std::vector<std::pair<uint32_t, std::string>>& strings);
+
+		const System::SystemPerformanceSnapshot& System() const noexcept { return _system; }
+
+		/// <summary>
+		/// 按 PID 排序的进程表，NameId 为录制进程的驻留池 ID
+		/// </summary>
+		const std::vector<System::ProcessDetailInfo>& Processes() const noexcept { return _processes; }
+
+		/// <summary>
+		/// 按连接键排序的连接表，IPv6 行引用自身的地址表
+		/// </summary>
+		const Network::ConnectionTable& Connections() const noexcept { return _connections; }
+
+		private:
+		System::SystemPerformanceSnapshot _system{};
+		XorWindow _systemWindows[6];
+		std::vector<System::ProcessDetailInfo> _processes;
+		std::vector<System::ProcessDetailInfo> _next;
+		Network::ConnectionTable _connections;
+		std::vector<Network::NetworkConnectionRow> _nextRows;
+	};
+}
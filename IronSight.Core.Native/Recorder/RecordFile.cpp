@@ -0,0 +1,188 @@
+﻿#include <pch.h>
+#include "RecordFile.h"
+#include <algorithm>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace IronSight::Core::Native::Recorder
+{
+#if defined(_WIN32)
+    std::filesystem::path PathFromUtf8(const char* utf8)
+    {
+        if (!utf8 || !*utf8) return {};
+
+        int length = MultiByteToWideChar(CP_UTF8, 0, utf8, -1, nullptr, 0);
+        if (length <= 0) return {};
+
+        std::wstring wide(static_cast<size_t>(length), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, utf8, -1, wide.data(), length);
+        wide.resize(static_cast<size_t>(length - 1));
+        return std::filesystem::path(wide);
+    }
+
+    bool RecordFileWriter::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        _file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+            nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return _file != INVALID_HANDLE_VALUE;
+    }
+
+    bool RecordFileWriter::Write(const void* data, size_t size)
+    {
+        if (_file == INVALID_HANDLE_VALUE) return false;
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0)
+        {
+            DWORD chunk = static_cast<DWORD>((std::min)(size, static_cast<size_t>(1u << 30)));
+            DWORD written = 0;
+            if (!WriteFile(_file, bytes, chunk, &written, nullptr) || written == 0) return false;
+
+            bytes += written;
+            size -= written;
+        }
+        return true;
+    }
+
+    void RecordFileWriter::Close() noexcept
+    {
+        if (_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(_file);
+            _file = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    bool RecordFileWriter::IsOpen() const noexcept
+    {
+        return _file != INVALID_HANDLE_VALUE;
+    }
+
+    bool MappedFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        // 允许写入端继续追加与轮转删除正在回放的分段
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return false;
+
+        // 视图独立于文件与映射句柄存在，两者可以立即关闭
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view) return false;
+
+        _data = static_cast<const uint8_t*>(view);
+        _size = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close() noexcept
+    {
+        if (_data)
+        {
+            UnmapViewOfFile(_data);
+            _data = nullptr;
+            _size = 0;
+        }
+    }
+
+#elif defined(__linux__)
+    std::filesystem::path PathFromUtf8(const char* utf8)
+    {
+        if (!utf8 || !*utf8) return {};
+        return std::filesystem::path(utf8);
+    }
+
+    bool RecordFileWriter::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        _file = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        return _file >= 0;
+    }
+
+    bool RecordFileWriter::Write(const void* data, size_t size)
+    {
+        if (_file < 0) return false;
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0)
+        {
+            ssize_t written = write(_file, bytes, size);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    void RecordFileWriter::Close() noexcept
+    {
+        if (_file >= 0)
+        {
+            close(_file);
+            _file = -1;
+        }
+    }
+
+    bool RecordFileWriter::IsOpen() const noexcept
+    {
+        return _file >= 0;
+    }
+
+    bool MappedFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0) return false;
+
+        struct stat info{};
+        if (fstat(file, &info) != 0 || info.st_size <= 0)
+        {
+            close(file);
+            return false;
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, file, 0);
+        close(file);
+        if (view == MAP_FAILED) return false;
+
+        _data = static_cast<const uint8_t*>(view);
+        _size = static_cast<size_t>(info.st_size);
+        return true;
+    }
+
+    void MappedFile::Close() noexcept
+    {
+        if (_data)
+        {
+            munmap(const_cast<uint8_t*>(_data), _size);
+            _data = nullptr;
+            _size = 0;
+        }
+    }
+#endif
+}
@@ -0,0 +1,71 @@
+﻿#pragma once
+#include <filesystem>
+
+namespace IronSight::Core::Native::Recorder
+{
+	/// <summary>
+	/// 把导出函数接收的 UTF-8 路径转换为 std::filesystem::path (Windows 下经 UTF-16 转换，不受当前代码页影响)
+	/// </summary>
+	std::filesystem::path PathFromUtf8(const char* utf8);
+
+	/// <summary>
+	/// 只追加的分段文件
+	/// 每次 Write 直接提交给系统 (不经过用户态缓冲)，读取端随时打开都能看到完整的帧；
+	/// Windows 下允许其他进程以只读方式打开与映射正在写入的分段
+	/// </summary>
+	class RecordFileWriter
+	{
+		public:
+		RecordFileWriter() = default;
+		~RecordFileWriter() { Close(); }
+
+		RecordFileWriter(const RecordFileWriter&) = delete;
+		RecordFileWriter& operator=(const RecordFileWriter&) = delete;
+
+		/// <summary>
+		/// 创建 (或截断) 文件
+		/// </summary>
+		bool Open(const std::filesystem::path& path);
+
+		/// <summary>
+		/// 追加全部数据，部分写入视为失败
+		/// </summary>
+		bool Write(const void* data, size_t size);
+
+		void Close() noexcept;
+
+		bool IsOpen() const noexcept;
+
+		private:
+#if defined(_WIN32)
+		HANDLE _file = INVALID_HANDLE_VALUE;
+#else
+		int _file = -1;
+#endif
+	};
+
+	/// <summary>
+	/// 只读内存映射文件
+	/// 映射长度为打开时的文件长度，之后追加的内容需要重新打开才能看到
+	/// </summary>
+	class MappedFile
+	{
+		public:
+		MappedFile() = default;
+		~MappedFile() { Close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const std::filesystem::path& path);
+
+		void Close() noexcept;
+
+		const uint8_t* Data() const noexcept { return _data; }
+		size_t Size() const noexcept { return _size; }
+
+		private:
+		const uint8_t* _data = nullptr;
+		size_t _size = 0;
+	};
+}
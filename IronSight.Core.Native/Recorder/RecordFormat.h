@@ -0,0 +1,60 @@
+﻿#pragma once
+
+namespace IronSight::Core::Native::Recorder
+{
+	/// <summary>
+	/// 飞行记录分段文件格式
+	/// 文件头之后是连续的帧：16 字节帧头 + 位流编码的负载。每个分段以各类型的关键帧开始，可以独立解码；
+	/// 进程崩溃时只会丢失最后一个不完整的帧，读取端遇到越界的帧头即停止
+	/// </summary>
+	constexpr uint32_t RecordFileMagic = 0x52465349;   // "ISFR"
+	constexpr uint16_t RecordFormatVersion = 1;
+
+	/// <summary>
+	/// 帧类型
+	/// </summary>
+	enum class FrameType : uint8_t
+	{
+		System = 1,         // SystemPerformanceSnapshot
+		Processes = 2,      // 完整进程表 (ProcessDetailInfo，按 PID 排序)
+		Connections = 3,    // 双栈连接表 (NetworkConnectionRow，按连接键排序)
+		Strings = 4         // 本分段新出现的进程名 (驻留池 ID -> UTF-8)，先于引用它们的进程帧写入
+	};
+
+	constexpr size_t FrameTypeCount = 5;
+
+	/// <summary>
+	/// 帧标志
+	/// </summary>
+	enum FrameFlags : uint8_t
+	{
+		FrameFlagKeyframe = 0x01    // 关键帧：不依赖同类型的前一帧
+	};
+
+#pragma pack(push, 1)
+	struct RecordFileHeader
+	{
+		uint32_t Magic;
+		uint16_t Version;
+		uint16_t Reserved;
+		int64_t CreatedMs;          // 分段创建时间 (Unix 毫秒)
+	};
+
+	struct FrameHeader
+	{
+		uint32_t PayloadBytes;
+		FrameType Type;
+		uint8_t Flags;
+		uint16_t Reserved;
+		int64_t TimestampMs;        // 采样时间 (Unix 毫秒)
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(RecordFileHeader) == 16, "RecordFileHeader size mismatch");
+	static_assert(sizeof(FrameHeader) == 16, "FrameHeader size mismatch");
+
+	/// <summary>
+	/// 单帧负载上限：超过时视为损坏，避免读取端按错误的长度跳转
+	/// </summary>
+	constexpr uint32_t MaxFramePayloadBytes = 256u * 1024 * 1024;
+}
@@ -0,0 +1,245 @@
+﻿#include <pch.h>
+#include "SamplingScheduler.h"
+#include "System/CpuCoreSampler.h"
+#include "System/SystemMethods.h"
+#include "System/SystemMonitor.h"
+#include "Utilities.h"
+
+namespace IronSight::Core::Native::Sampling
+{
+    SamplingScheduler& SamplingScheduler::Instance()
+    {
+        static SamplingScheduler* instance = new SamplingScheduler();
+        return *instance;
+    }
+
+    bool SamplingScheduler::SetInterval(SamplingCollector collector, const void* source, uint32_t intervalMs, SampleFunction sample)
+    {
+        if (intervalMs == 0)
+        {
+            Remove(collector, source);
+            return true;
+        }
+
+        intervalMs = (std::max)(intervalMs, MinimumIntervalMs);
+        auto interval = std::chrono::milliseconds(intervalMs);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            auto it = std::find_if(_collectors.begin(), _collectors.end(), [&](const CollectorSlot& slot)
+                {
+                    return slot.Collector == collector && slot.Source == source;
+                });
+
+            if (it != _collectors.end())
+            {
+                // 已注册：只调整间隔，新截止时间不晚于按新间隔计算的时间
+                it->Interval = interval;
+                it->Deadline = (std::min)(it->Deadline, Clock::now() + interval);
+                if (sample) it->Sample = std::move(sample);
+            }
+            else
+            {
+                if (!sample) return false;
+
+                // 首次注册立即采样一次，消费者无需等待一个完整间隔
+                _collectors.push_back({ collector, source, interval, Clock::now(), std::move(sample) });
+            }
+
+            EnsureThreadStarted();
+        }
+
+        _wakeup.notify_one();
+        return true;
+    }
+
+    void SamplingScheduler::Remove(SamplingCollector collector, const void* source)
+    {
+        bool onSamplingThread = false;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            onSamplingThread = std::this_thread::get_id() == _threadId;
+
+            auto it = std::remove_if(_collectors.begin(), _collectors.end(), [&](const CollectorSlot& slot)
+                {
+                    return slot.Collector == collector && slot.Source == source;
+                });
+
+            if (it == _collectors.end()) return;
+            _collectors.erase(it, _collectors.end());
+        }
+
+        // 采样线程在持有 _mutex 时进入 _sampleMutex，因此这里拿到锁即表示包含该采集器的批次已结束
+        // 在采样线程内部 (回调中) 调用时批次的采样阶段已完成，无需等待
+        if (!onSamplingThread)
+        {
+            std::lock_guard<std::mutex> sampleLock(_sampleMutex);
+        }
+    }
+
+    void SamplingScheduler::RegisterCallback(SnapshotReadyCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _callback = callback;
+    }
+
+    void SamplingScheduler::Stop()
+    {
+        std::thread thread;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _isRunning = false;
+            _collectors.clear();
+            thread = std::move(_thread);
+        }
+
+        _wakeup.notify_one();
+
+        if (thread.joinable())
+        {
+            if (thread.get_id() == std::this_thread::get_id())
+            {
+                thread.detach();
+            }
+            else
+            {
+                thread.join();
+            }
+        }
+
+        LOG_INFO("SamplingScheduler: 采样线程已停止");
+    }
+
+    void SamplingScheduler::EnsureThreadStarted()
+    {
+        // 调用方持有 _mutex
+        if (_isRunning) return;
+
+        if (_thread.joinable())
+        {
+            // 上一次 Stop 在采样线程内部发起，线程即将自行退出
+            _thread.detach();
+        }
+
+        _isRunning = true;
+        _thread = std::thread(&SamplingScheduler::ThreadProc, this);
+        _threadId = _thread.get_id();
+        LOG_INFO("SamplingScheduler: 采样线程已启动");
+    }
+
+    void SamplingScheduler::ThreadProc()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (_isRunning)
+        {
+            if (_collectors.empty())
+            {
+                _wakeup.wait(lock);
+                continue;
+            }
+
+            auto earliest = std::min_element(_collectors.begin(), _collectors.end(),
+                [](const CollectorSlot& a, const CollectorSlot& b) { return a.Deadline < b.Deadline; })->Deadline;
+
+            if (Clock::now() < earliest)
+            {
+                // 唤醒后重新评估：期间可能有采集器被增删或间隔被修改
+                _wakeup.wait_until(lock, earliest);
+                continue;
+            }
+
+            // 收集截止时间已到或即将在合并窗口内到达的采集器，一次唤醒全部执行
+            auto now = Clock::now();
+            _batch.clear();
+
+            for (auto& slot : _collectors)
+            {
+                if (slot.Deadline > now + CoalesceWindow) continue;
+
+                _batch.push_back(slot);
+
+                // 按固定节拍推进，避免累积漂移；严重落后时从当前时间重新对齐
+                slot.Deadline += slot.Interval;
+                if (slot.Deadline <= now)
+                {
+                    slot.Deadline = now + slot.Interval;
+                }
+            }
+
+            SnapshotReadyCallback callback = _callback;
+
+            std::lock_guard<std::mutex> sampleLock(_sampleMutex);
+            lock.unlock();
+
+            _notifications.clear();
+            for (const auto& slot : _batch)
+            {
+                uint64_t version = slot.Sample();
+                if (version != 0)
+                {
+                    _notifications.push_back({ slot.Collector, slot.Source, version });
+                }
+            }
+
+            // 只在有新快照时通知消费者
+            if (callback)
+            {
+                for (const auto& notification : _notifications)
+                {
+                    callback(notification.Collector, notification.Source, notification.Version);
+                }
+            }
+
+            lock.lock();
+        }
+    }
+}
+
+using namespace IronSight::Core::Native;
+
+extern "C"
+{
+    bool SamplingScheduler_SetInterval(Sampling::SamplingCollector collector, uint32_t intervalMs)
+    {
+        auto& scheduler = Sampling::SamplingScheduler::Instance();
+
+        switch (collector)
+        {
+        case Sampling::SamplingCollector::SystemMonitor:
+            return scheduler.SetInterval(collector, nullptr, intervalMs, []() -> uint64_t
+                {
+                    return System::SystemMonitor::SampleStats();
+                });
+
+        case Sampling::SamplingCollector::SystemMethods:
+            return scheduler.SetInterval(collector, nullptr, intervalMs, []() -> uint64_t
+                {
+                    return System::SystemMethods::SampleSnapshot();
+                });
+
+        case Sampling::SamplingCollector::CpuCores:
+            return scheduler.SetInterval(collector, nullptr, intervalMs, []() -> uint64_t
+                {
+                    return System::CpuCoreSampler::Shared().Sample();
+                });
+
+        default:
+            // 网络采集器与具体的 NetworkMonitor 实例绑定，使用 NetworkMonitor_SetUpdateInterval
+            return false;
+        }
+    }
+
+    void SamplingScheduler_RegisterCallback(Sampling::SnapshotReadyCallback callback)
+    {
+        Sampling::SamplingScheduler::Instance().RegisterCallback(callback);
+    }
+
+    void SamplingScheduler_Stop()
+    {
+        Sampling::SamplingScheduler::Instance().Stop();
+    }
+}
@@ -0,0 +1,111 @@
+﻿#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+namespace IronSight::Core::Native::Sampling
+{
+	/// <summary>
+	/// 采集器类型 (与 C# SamplingCollector 保持同步)
+	/// </summary>
+	enum class SamplingCollector : uint32_t
+	{
+		Network = 1,        // NetworkMonitor 实例，source 为监控器指针
+		SystemMonitor = 2,  // SystemMonitor PDH 计数器 (CPU / 磁盘)
+		SystemMethods = 3,  // SystemMethods 性能快照
+		CpuCores = 4        // 逐逻辑处理器 CPU 占用率 (CpuCoreSampler)
+	};
+
+	// 回调签名：新快照就绪时在采样线程上调用，version 为该采集器的快照代数
+	typedef void(__stdcall* SnapshotReadyCallback)(SamplingCollector collector, const void* source, uint64_t version);
+
+	/// <summary>
+	/// 原生后台采样调度器
+	/// 所有采集器在同一条专用线程上运行，各自拥有独立的采样间隔；
+	/// 相近的截止时间会被合并为一批执行，以减少唤醒次数与计时抖动
+	/// </summary>
+	class SamplingScheduler
+	{
+		public:
+		// 返回采集到的新快照代数，返回 0 表示本次采样失败 (不通知消费者)
+		using SampleFunction = std::function<uint64_t()>;
+
+		/// <summary>
+		/// 获取全局调度器实例 (刻意不析构：DLL 卸载时无法安全地 join 线程)
+		/// </summary>
+		static SamplingScheduler& Instance();
+
+		/// <summary>
+		/// 注册或更新采集器。intervalMs 为 0 时移除该采集器
+		/// </summary>
+		/// <param name="collector">采集器类型</param>
+		/// <param name="source">采集器实例标识 (同一类型可有多个实例)</param>
+		/// <param name="intervalMs">采样间隔 (毫秒)</param>
+		/// <param name="sample">采样函数，仅在首次注册时需要</param>
+		/// <returns>成功返回 true</returns>
+		bool SetInterval(SamplingCollector collector, const void* source, uint32_t intervalMs, SampleFunction sample = nullptr);
+
+		/// <summary>
+		/// 移除采集器，并等待正在进行的该批采样结束，返回后可安全销毁 source
+		/// </summary>
+		void Remove(SamplingCollector collector, const void* source);
+
+		/// <summary>
+		/// 注册新快照就绪回调
+		/// </summary>
+		void RegisterCallback(SnapshotReadyCallback callback);
+
+		/// <summary>
+		/// 停止采样线程并移除所有采集器
+		/// </summary>
+		void Stop();
+
+		private:
+		using Clock = std::chrono::steady_clock;
+
+		struct CollectorSlot
+		{
+			SamplingCollector Collector;
+			const void* Source;
+			std::chrono::milliseconds Interval;
+			Clock::time_point Deadline;
+			SampleFunction Sample;
+		};
+
+		struct ReadyNotification
+		{
+			SamplingCollector Collector;
+			const void* Source;
+			uint64_t Version;
+		};
+
+		SamplingScheduler() = default;
+		void EnsureThreadStarted();
+		void ThreadProc();
+
+		std::vector<CollectorSlot> _collectors;
+		std::vector<CollectorSlot> _batch;
+		std::vector<ReadyNotification> _notifications;
+
+		SnapshotReadyCallback _callback = nullptr;
+		std::thread _thread;
+		std::thread::id _threadId;
+		bool _isRunning = false;
+
+		std::mutex _mutex;              // 保护采集器列表与线程状态
+		std::mutex _sampleMutex;        // 采样批次执行期间持有，Remove 借此等待批次结束
+		std::condition_variable _wakeup;
+
+		// 截止时间落在窗口内的采集器与最早的一个合并执行
+		static constexpr std::chrono::milliseconds CoalesceWindow{ 25 };
+		static constexpr uint32_t MinimumIntervalMs = 50;
+	};
+}
+
+extern "C"
+{
+	__declspec(dllexport) bool SamplingScheduler_SetInterval(IronSight::Core::Native::Sampling::SamplingCollector collector, uint32_t intervalMs);
+	__declspec(dllexport) void SamplingScheduler_RegisterCallback(IronSight::Core::Native::Sampling::SnapshotReadyCallback callback);
+	__declspec(dllexport) void SamplingScheduler_Stop();
+}
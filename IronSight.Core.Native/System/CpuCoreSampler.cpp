@@ -0,0 +1,163 @@
+﻿#include <pch.h>
+#include "CpuCoreSampler.h"
+#include <algorithm>
+
+// x64 (以及启用 SSE2 的 x86) 一律可用 SSE2：每条指令同时处理两个处理器
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IRONSIGHT_CPU_USAGE_SSE2 1
+#endif
+
+namespace IronSight::Core::Native::System
+{
+    CpuCoreSampler& CpuCoreSampler::Shared()
+    {
+        static CpuCoreSampler* sampler = new CpuCoreSampler(ICpuTimeSource::CreateDefault());
+        return *sampler;
+    }
+
+    CpuCoreSampler::CpuCoreSampler(std::unique_ptr<ICpuTimeSource> source)
+        : _source(std::move(source))
+    {
+    }
+
+    uint64_t CpuCoreSampler::Sample()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (!_source || !_source->Collect(_current)) return 0;
+
+        const size_t coreCount = _current.CoreCount();
+
+        // 处理器上线/下线后旧基线与新的编号不再对应，重新建立基线
+        if (!_hasBaseline || _previous.CoreCount() != coreCount)
+        {
+            _previous.Resize(coreCount);
+            std::swap(_previous, _current);
+            _hasBaseline = true;
+            return 0;
+        }
+
+        _usage.Resize(coreCount);
+        ComputeUsage(_previous, _current, _usage);
+
+        // 本次的累计值成为下一次的基线，两组缓冲区交替使用
+        std::swap(_previous, _current);
+        return ++_version;
+    }
+
+    size_t CpuCoreSampler::CoreCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _usage.CoreCount();
+    }
+
+    size_t CpuCoreSampler::CopyTo(CpuCoreUsage* buffer, size_t maxCount, uint64_t* version) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (version) *version = _version;
+        if (!buffer) return 0;
+
+        const size_t count = (std::min)(maxCount, _usage.CoreCount());
+        for (size_t i = 0; i < count; ++i)
+        {
+            CpuCoreUsage& row = buffer[i];
+            row.User = static_cast<float>(_usage.User[i]);
+            row.System = static_cast<float>(_usage.System[i]);
+            row.Idle = static_cast<float>(_usage.Idle[i]);
+            row.Irq = static_cast<float>(_usage.Irq[i]);
+            row.Steal = static_cast<float>(_usage.Steal[i]);
+        }
+
+        return count;
+    }
+
+    void CpuCoreSampler::ComputeUsage(const CpuTimeColumns& previous, const CpuTimeColumns& current, CpuTimeColumns& usage) noexcept
+    {
+        const size_t count = (std::min)({ previous.CoreCount(), current.CoreCount(), usage.CoreCount() });
+
+        const double* previousUser = previous.User.data();
+        const double* previousSystem = previous.System.data();
+        const double* previousIdle = previous.Idle.data();
+        const double* previousIrq = previous.Irq.data();
+        const double* previousSteal = previous.Steal.data();
+
+        const double* currentUser = current.User.data();
+        const double* currentSystem = current.System.data();
+        const double* currentIdle = current.Idle.data();
+        const double* currentIrq = current.Irq.data();
+        const double* currentSteal = current.Steal.data();
+
+        double* user = usage.User.data();
+        double* system = usage.System.data();
+        double* idle = usage.Idle.data();
+        double* irq = usage.Irq.data();
+        double* steal = usage.Steal.data();
+
+        size_t i = 0;
+
+#if defined(IRONSIGHT_CPU_USAGE_SSE2)
+        const __m128d zero = _mm_setzero_pd();
+        const __m128d hundred = _mm_set1_pd(100.0);
+
+        for (; i + 2 <= count; i += 2)
+        {
+            // 计数器回退 (处理器离线后重新上线) 时差量按 0 处理
+            const __m128d deltaUser = _mm_max_pd(_mm_sub_pd(_mm_loadu_pd(currentUser + i), _mm_loadu_pd(previousUser + i)), zero);
+            const __m128d deltaSystem = _mm_max_pd(_mm_sub_pd(_mm_loadu_pd(currentSystem + i), _mm_loadu_pd(previousSystem + i)), zero);
+            const __m128d deltaIdle = _mm_max_pd(_mm_sub_pd(_mm_loadu_pd(currentIdle + i), _mm_loadu_pd(previousIdle + i)), zero);
+            const __m128d deltaIrq = _mm_max_pd(_mm_sub_pd(_mm_loadu_pd(currentIrq + i), _mm_loadu_pd(previousIrq + i)), zero);
+            const __m128d deltaSteal = _mm_max_pd(_mm_sub_pd(_mm_loadu_pd(currentSteal + i), _mm_loadu_pd(previousSteal + i)), zero);
+
+            const __m128d total = _mm_add_pd(_mm_add_pd(_mm_add_pd(deltaUser, deltaSystem), _mm_add_pd(deltaIdle, deltaIrq)), deltaSteal);
+
+            // 总差量为 0 时除法得到 inf，用比较掩码清零，避免分支
+            const __m128d scale = _mm_and_pd(_mm_div_pd(hundred, total), _mm_cmpgt_pd(total, zero));
+
+            _mm_storeu_pd(user + i, _mm_mul_pd(deltaUser, scale));
+            _mm_storeu_pd(system + i, _mm_mul_pd(deltaSystem, scale));
+            _mm_storeu_pd(idle + i, _mm_mul_pd(deltaIdle, scale));
+            _mm_storeu_pd(irq + i, _mm_mul_pd(deltaIrq, scale));
+            _mm_storeu_pd(steal + i, _mm_mul_pd(deltaSteal, scale));
+        }
+#endif
+
+        // 标量尾部 (处理器数为奇数，或不支持 SSE2 的平台)
+        for (; i < count; ++i)
+        {
+            const double deltaUser = (std::max)(currentUser[i] - previousUser[i], 0.0);
+            const double deltaSystem = (std::max)(currentSystem[i] - previousSystem[i], 0.0);
+            const double deltaIdle = (std::max)(currentIdle[i] - previousIdle[i], 0.0);
+            const double deltaIrq = (std::max)(currentIrq[i] - previousIrq[i], 0.0);
+            const double deltaSteal = (std::max)(currentSteal[i] - previousSteal[i], 0.0);
+
+            const double total = deltaUser + deltaSystem + deltaIdle + deltaIrq + deltaSteal;
+            const double scale = total > 0 ? 100.0 / total : 0.0;
+
+            user[i] = deltaUser * scale;
+            system[i] = deltaSystem * scale;
+            idle[i] = deltaIdle * scale;
+            irq[i] = deltaIrq * scale;
+            steal[i] = deltaSteal * scale;
+        }
+    }
+
+    extern "C"
+    {
+        uint64_t CpuCores_Sample()
+        {
+            return CpuCoreSampler::Shared().Sample();
+        }
+
+        uint32_t CpuCores_GetCount()
+        {
+            return static_cast<uint32_t>(CpuCoreSampler::Shared().CoreCount());
+        }
+
+        uint32_t CpuCores_Copy(CpuCoreUsage* buffer, uint32_t maxCount, uint64_t* version)
+        {
+            return static_cast<uint32_t>(CpuCoreSampler::Shared().CopyTo(buffer, maxCount, version));
+        }
+    }
+}
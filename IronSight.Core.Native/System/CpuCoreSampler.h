@@ -0,0 +1,100 @@
+﻿#pragma once
+#include <mutex>
+#include "CpuTimeSource.h"
+
+namespace IronSight::Core::Native::System
+{
+#pragma pack(push, 4)
+	/// <summary>
+	/// 单个逻辑处理器在两次采样之间的占用率 (%)，各项之和为 100 (处理器离线时全为 0)
+	/// </summary>
+	struct CpuCoreUsage
+	{
+		float User;
+		float System;
+		float Idle;
+		float Irq;
+		float Steal;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(CpuCoreUsage) == 20,
+		"CpuCoreUsage size mismatch");
+
+	/// <summary>
+	/// 逐逻辑处理器 CPU 占用率采样器
+	/// 前后两次采样的累计时间以结构数组布局双缓冲保存，差量与占比由 SIMD 内核对所有处理器一次算出，
+	/// 每次采样的开销随处理器数量线性增长且不分配内存 (处理器数量不变时)；
+	/// 每处理器开销与分配次数由 IronSight.Core.Native.Benchmark 的 cpu.cores 场景测量
+	/// </summary>
+	class CpuCoreSampler
+	{
+		public:
+		/// <summary>
+		/// 获取使用当前平台默认数据源的全局采样器 (刻意不析构，与采样线程的退出顺序无关)
+		/// </summary>
+		static CpuCoreSampler& Shared();
+
+		explicit CpuCoreSampler(std::unique_ptr<ICpuTimeSource> source);
+
+		CpuCoreSampler(const CpuCoreSampler&) = delete;
+		CpuCoreSampler& operator=(const CpuCoreSampler&) = delete;
+
+		/// <summary>
+		/// 采集一次并计算相对于上一次采集的占用率
+		/// 首次采集或处理器数量发生变化时只建立基线
+		/// </summary>
+		/// <returns>新的采样代数；采集失败或只建立了基线时返回 0</returns>
+		uint64_t Sample();
+
+		/// <summary>
+		/// 最近一次计算的占用率对应的逻辑处理器数量
+		/// </summary>
+		size_t CoreCount() const;
+
+		/// <summary>
+		/// 复制最近一次计算的占用率 (按处理器编号排列)
+		/// </summary>
+		/// <param name="version">输出：占用率对应的采样代数，可为空</param>
+		/// <returns>写入的处理器数量</returns>
+		size_t CopyTo(CpuCoreUsage* buffer, size_t maxCount, uint64_t* version) const;
+
+		/// <summary>
+		/// 差量与占比内核：usage[i] = max(current[i] - previous[i], 0) / 各列差量之和 * 100
+		/// 三者的处理器数量须一致；总差量为 0 的处理器各项均为 0
+		/// </summary>
+		static void ComputeUsage(const CpuTimeColumns& previous, const CpuTimeColumns& current, CpuTimeColumns& usage) noexcept;
+
+		private:
+		std::unique_ptr<ICpuTimeSource> _source;
+		CpuTimeColumns _previous;
+		CpuTimeColumns _current;
+		CpuTimeColumns _usage;
+		bool _hasBaseline = false;
+		uint64_t _version = 0;
+
+		// 采样 (调度线程) 与复制 (调用方线程) 互斥；一次采样只需数微秒
+		mutable std::mutex _mutex;
+	};
+
+	extern "C"
+	{
+		/// <summary>
+		/// 采集一次逐处理器占用率 (通常由采样调度器定时调用)
+		/// </summary>
+		/// <returns>新的采样代数，失败或只建立了基线时返回 0</returns>
+		__declspec(dllexport) uint64_t CpuCores_Sample();
+
+		/// <summary>
+		/// 最近一次占用率对应的逻辑处理器数量
+		/// </summary>
+		__declspec(dllexport) uint32_t CpuCores_GetCount();
+
+		/// <summary>
+		/// 复制最近一次的逐处理器占用率
+		/// </summary>
+		/// <param name="version">输出：采样代数，可为空</param>
+		/// <returns>写入的处理器数量</returns>
+		__declspec(dllexport) uint32_t CpuCores_Copy(CpuCoreUsage* buffer, uint32_t maxCount, uint64_t* version);
+	}
+}
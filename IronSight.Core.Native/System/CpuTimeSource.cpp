@@ -0,0 +1,22 @@
+﻿#include <pch.h>
+#include "CpuTimeSource.h"
+
+#if defined(_WIN32)
+#include "NtCpuTimeSource.h"
+#elif defined(__linux__)
+#include "ProcStatCpuTimeSource.h"
+#endif
+
+namespace IronSight::Core::Native::System
+{
+    std::unique_ptr<ICpuTimeSource> ICpuTimeSource::CreateDefault()
+    {
+#if defined(_WIN32)
+        return std::make_unique<NtCpuTimeSource>();
+#elif defined(__linux__)
+        return std::make_unique<ProcStatCpuTimeSource>();
+#else
+        return nullptr;
+#endif
+    }
+}
@@ -0,0 +1,53 @@
+﻿#pragma once
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 逐逻辑处理器的 CPU 时间 (结构数组布局)
+	/// 每一类时间一列，第 i 个元素属于逻辑处理器 i；同一列在内存中连续，差量与占比计算可以一次处理多个处理器。
+	/// 采样的累计时间与计算得到的占用率 (%) 共用此布局。单位由数据源决定，只要各列一致即可
+	/// </summary>
+	struct CpuTimeColumns
+	{
+		std::vector<double> User;       // 用户态 (Linux 含 nice)
+		std::vector<double> System;     // 内核态 (不含中断)
+		std::vector<double> Idle;       // 空闲 (Linux 含 iowait)
+		std::vector<double> Irq;        // 硬中断与软中断 (Windows 为 Interrupt + DPC)
+		std::vector<double> Steal;      // 被虚拟机监控程序占用 (Windows 恒为 0)
+
+		size_t CoreCount() const noexcept { return User.size(); }
+
+		/// <summary>
+		/// 调整处理器数量，新增的元素为 0
+		/// </summary>
+		void Resize(size_t coreCount)
+		{
+			User.resize(coreCount);
+			System.resize(coreCount);
+			Idle.resize(coreCount);
+			Irq.resize(coreCount);
+			Steal.resize(coreCount);
+		}
+	};
+
+	/// <summary>
+	/// 逐处理器 CPU 时间数据源接口
+	/// </summary>
+	class ICpuTimeSource
+	{
+		public:
+		virtual ~ICpuTimeSource() = default;
+
+		/// <summary>
+		/// 读取全部逻辑处理器的累计时间，times 会被调整为处理器数量 (累计值不要求从 0 开始)
+		/// </summary>
+		/// <returns>成功返回true</returns>
+		virtual bool Collect(CpuTimeColumns& times) = 0;
+
+		/// <summary>
+		/// 创建当前平台的默认数据源
+		/// Windows 使用 NtQuerySystemInformationEx (逐处理器组)，Linux 使用 /proc/stat
+		/// </summary>
+		static std::unique_ptr<ICpuTimeSource> CreateDefault();
+	};
+}
@@ -0,0 +1,96 @@
+﻿#include <pch.h>
+#include "NtCpuTimeSource.h"
+#include <algorithm>
+
+#if defined(_WIN32)
+
+// NTSTATUS 由 winternl.h 声明，windows.h 不提供
+#include <winternl.h>
+
+namespace IronSight::Core::Native::System
+{
+    namespace
+    {
+        constexpr ULONG SystemProcessorPerformanceInformationClass = 8;
+
+        using NtQuerySystemInformationExFn = NTSTATUS(NTAPI*)(ULONG, PVOID, ULONG, PVOID, ULONG, PULONG);
+
+        // SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION 的完整布局 (winternl.h 把 DPC 与中断时间隐藏在 Reserved1 中)
+        // 内核时间包含空闲、DPC 与中断时间
+        struct NativeProcessorTimes
+        {
+            LARGE_INTEGER IdleTime;
+            LARGE_INTEGER KernelTime;
+            LARGE_INTEGER UserTime;
+            LARGE_INTEGER DpcTime;
+            LARGE_INTEGER InterruptTime;
+            ULONG InterruptCount;
+        };
+
+        NtQuerySystemInformationExFn ResolveNtQuerySystemInformationEx()
+        {
+            static NtQuerySystemInformationExFn function = []()
+                {
+                    HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+                    return ntdll ? reinterpret_cast<NtQuerySystemInformationExFn>(GetProcAddress(ntdll, "NtQuerySystemInformationEx")) : nullptr;
+                }();
+
+            return function;
+        }
+
+        inline double ToDouble(const LARGE_INTEGER& value) noexcept
+        {
+            return static_cast<double>(value.QuadPart);
+        }
+    }
+
+    bool NtCpuTimeSource::Collect(CpuTimeColumns& times)
+    {
+        NtQuerySystemInformationExFn query = ResolveNtQuerySystemInformationEx();
+        if (!query) return false;
+
+        const WORD groupCount = GetActiveProcessorGroupCount();
+        if (groupCount == 0) return false;
+
+        size_t coreCount = 0;
+        for (WORD group = 0; group < groupCount; ++group)
+        {
+            coreCount += GetActiveProcessorCount(group);
+        }
+
+        times.Resize(coreCount);
+
+        size_t core = 0;
+        for (WORD group = 0; group < groupCount && core < coreCount; ++group)
+        {
+            const size_t groupCores = GetActiveProcessorCount(group);
+            const size_t required = groupCores * sizeof(NativeProcessorTimes);
+            if (_buffer.size() < required) _buffer.resize(required);
+
+            USHORT groupNumber = group;
+            ULONG returned = 0;
+            NTSTATUS status = query(SystemProcessorPerformanceInformationClass, &groupNumber, sizeof(groupNumber),
+                _buffer.data(), static_cast<ULONG>(_buffer.size()), &returned);
+            if (status < 0) return false;
+
+            const auto* entries = reinterpret_cast<const NativeProcessorTimes*>(_buffer.data());
+            const size_t count = (std::min)(static_cast<size_t>(returned / sizeof(NativeProcessorTimes)), coreCount - core);
+
+            for (size_t i = 0; i < count; ++i, ++core)
+            {
+                const NativeProcessorTimes& entry = entries[i];
+                const double irq = ToDouble(entry.InterruptTime) + ToDouble(entry.DpcTime);
+
+                times.User[core] = ToDouble(entry.UserTime);
+                times.Idle[core] = ToDouble(entry.IdleTime);
+                times.Irq[core] = irq;
+                times.System[core] = (std::max)(0.0, ToDouble(entry.KernelTime) - ToDouble(entry.IdleTime) - irq);
+                times.Steal[core] = 0;
+            }
+        }
+
+        times.Resize(core);
+        return core > 0;
+    }
+}
+#endif
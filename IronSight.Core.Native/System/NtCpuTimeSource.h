@@ -0,0 +1,18 @@
+﻿#pragma once
+#include "CpuTimeSource.h"
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 基于 NtQuerySystemInformationEx(SystemProcessorPerformanceInformation) 的 Windows 逐处理器时间数据源
+	/// 不带组参数的查询只返回调用线程所在处理器组 (最多 64 个逻辑处理器)，因此逐组查询后按组顺序拼接
+	/// </summary>
+	class NtCpuTimeSource final : public ICpuTimeSource
+	{
+		public:
+		bool Collect(CpuTimeColumns& times) override;
+
+		private:
+		std::vector<uint8_t> _buffer;
+	};
+}
@@ -0,0 +1,95 @@
+﻿#include <pch.h>
+#include "NtProcessBackend.h"
+
+#if defined(_WIN32)
+
+namespace IronSight::Core::Native::System
+{
+    namespace
+    {
+        inline uint64_t ToUInt64(const FILETIME& time) noexcept
+        {
+            ULARGE_INTEGER value;
+            value.LowPart = time.dwLowDateTime;
+            value.HighPart = time.dwHighDateTime;
+            return value.QuadPart;
+        }
+
+        // 受限查询权限足以读取优先级与创建时间，且对受保护进程同样可用，
+        // 与 GetProcessFullPath 所需的权限一致，同一个缓存句柄可以服务两者
+        constexpr DWORD QueryAccess = PROCESS_QUERY_LIMITED_INFORMATION;
+    }
+
+    NtProcessBackend::NtProcessBackend(ProcessHandleCache& handles, uint32_t snapshotMaxAgeMs)
+        : _handles(handles),
+        _snapshotMaxAgeMs(snapshotMaxAgeMs)
+    {
+    }
+
+    bool NtProcessBackend::Enumerate(std::vector<ProcessSample>& samples, size_t maxCount)
+    {
+        // 传入上次使用的代数：同一份快照不会被本数据源用两次，两次采集之间的时间差始终为正
+        return SystemProcessSnapshot::Shared().CopySamples(samples, maxCount, _snapshotMaxAgeMs, _summary.Generation, _summary);
+    }
+
+    void NtProcessBackend::Prepare(std::vector<ProcessSample>& samples)
+    {
+        // 稳态下所有句柄都已缓存，只有新进程才会调用 OpenProcess
+        _handles.BeginSweep();
+
+        for (ProcessSample& sample : samples)
+        {
+            sample.Handle = _handles.Acquire(sample.Pid, QueryAccess);
+        }
+    }
+
+    void NtProcessBackend::Query(ProcessSample& sample)
+    {
+        // 计数器已由快照填充；无法打开句柄的进程保留由基本优先级推算的优先级类
+        if (!sample.Handle) return;
+
+        HANDLE hProcess = sample.Handle->Process;
+
+        // 句柄首次使用时记录其进程的创建时间，之后与快照中的创建时间比较即可识别 PID 复用
+        if (sample.Handle->StartTime == 0)
+        {
+            FILETIME createTime, exitTime, kernelTime, userTime;
+            if (GetProcessTimes(hProcess, &createTime, &exitTime, &kernelTime, &userTime))
+            {
+                sample.Handle->StartTime = ToUInt64(createTime);
+            }
+        }
+
+        if (sample.Handle->StartTime != 0 && sample.Handle->StartTime != sample.CreateTime)
+        {
+            sample.HandleStale = true;
+            return;
+        }
+
+        DWORD priorityClass = GetPriorityClass(hProcess);
+        if (priorityClass != 0) sample.PriorityClass = static_cast<int>(priorityClass);
+    }
+
+    void NtProcessBackend::Complete(const std::vector<ProcessSample>& samples)
+    {
+        for (const ProcessSample& sample : samples)
+        {
+            if (sample.HandleStale) _handles.Invalidate(sample.Pid);
+        }
+
+        // 快照中已不存在的进程已经退出，关闭其句柄
+        _handles.Sweep();
+    }
+
+    uint64_t NtProcessBackend::QuerySystemTime()
+    {
+        // 快照枚举时读取的系统时间，与进程时间属于同一时刻
+        return _summary.SystemTime;
+    }
+
+    uint64_t NtProcessBackend::QuerySampleTick()
+    {
+        return _summary.SampleTick;
+    }
+}
+#endif
@@ -0,0 +1,32 @@
+﻿#pragma once
+#include "ProcessBackend.h"
+#include "SystemProcessSnapshot.h"
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 基于系统进程快照与进程句柄的 Windows 进程数据源
+	/// 一次 NtQuerySystemInformation 提供 PID、名称、线程数、句柄数、时间、IO 与内存计数器；
+	/// 缓存的进程句柄只用于读取准确的优先级类，并在采样期间固定 PID
+	/// 持有句柄期间进程对象不会被销毁，其 PID 也不会被系统复用，因此仍出现在快照中的 PID 对应的缓存句柄必然有效
+	/// </summary>
+	class NtProcessBackend final : public IProcessBackend
+	{
+		public:
+		/// <param name="handles">跨周期复用的进程句柄缓存</param>
+		/// <param name="snapshotMaxAgeMs">可直接复用的共享快照 (例如性能快照刚刚枚举过) 的最长时间，0 表示每次都重新枚举</param>
+		NtProcessBackend(ProcessHandleCache& handles, uint32_t snapshotMaxAgeMs);
+
+		bool Enumerate(std::vector<ProcessSample>& samples, size_t maxCount) override;
+		void Prepare(std::vector<ProcessSample>& samples) override;
+		void Query(ProcessSample& sample) override;
+		void Complete(const std::vector<ProcessSample>& samples) override;
+		uint64_t QuerySystemTime() override;
+		uint64_t QuerySampleTick() override;
+
+		private:
+		ProcessHandleCache& _handles;
+		uint32_t _snapshotMaxAgeMs;
+		SystemProcessSummary _summary{};    // 本次使用的快照概要 (时间基准与代数)
+	};
+}
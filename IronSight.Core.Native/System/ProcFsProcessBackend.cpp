@@ -0,0 +1,253 @@
+﻿#include <pch.h>
+#include "ProcFsProcessBackend.h"
+#include "Text/StringPool.h"
+
+#if defined(__linux__)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+namespace IronSight::Core::Native::System
+{
+    namespace
+    {
+        inline bool IsNumeric(const char* name) noexcept
+        {
+            if (!*name) return false;
+            for (; *name; ++name)
+            {
+                if (*name < '0' || *name > '9') return false;
+            }
+            return true;
+        }
+
+        // 读取小文件到栈缓冲区 (以 0 结尾)，失败返回 0
+        size_t ReadSmallFile(const char* path, char* buffer, size_t size) noexcept
+        {
+            int fd = open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return 0;
+
+            ssize_t n = read(fd, buffer, size - 1);
+            close(fd);
+
+            if (n <= 0) return 0;
+            buffer[n] = '\0';
+            return static_cast<size_t>(n);
+        }
+
+        // 从头重读常驻打开的 proc 文件 (以 0 结尾)，失败返回 0
+        size_t ReadCachedFile(int fd, char* buffer, size_t size) noexcept
+        {
+            if (fd < 0) return 0;
+
+            ssize_t n = pread(fd, buffer, size - 1, 0);
+            if (n <= 0) return 0;
+            buffer[n] = '\0';
+            return static_cast<size_t>(n);
+        }
+
+        // 统计常驻打开的目录中的条目数 (不含 . 与 ..)，复用描述符而不是每次 opendir
+        bool CountDirectoryEntries(int fd, uint32_t& count) noexcept
+        {
+            struct LinuxDirent64
+            {
+                uint64_t Inode;
+                int64_t Offset;
+                unsigned short RecordLength;
+                unsigned char Type;
+                char Name[1];
+            };
+
+            if (fd < 0 || lseek(fd, 0, SEEK_SET) < 0) return false;
+
+            alignas(8) char buffer[4096];
+            count = 0;
+
+            for (;;)
+            {
+                long n = syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+                if (n < 0) return false;
+                if (n == 0) return true;
+
+                for (long offset = 0; offset < n;)
+                {
+                    const auto* entry = reinterpret_cast<const LinuxDirent64*>(buffer + offset);
+                    if (entry->Name[0] != '.') ++count;
+                    offset += entry->RecordLength;
+                }
+            }
+        }
+
+        // 跳过 count 个以空格分隔的字段
+        inline const char* SkipFields(const char* p, int count) noexcept
+        {
+            while (count-- > 0 && *p)
+            {
+                while (*p == ' ') ++p;
+                while (*p && *p != ' ') ++p;
+            }
+            while (*p == ' ') ++p;
+            return p;
+        }
+    }
+
+    ProcFsProcessBackend::ProcFsProcessBackend(ProcessHandleCache& handles, const char* procRoot)
+        : _handles(handles),
+        _procRoot(procRoot ? procRoot : "/proc")
+    {
+        long ticks = sysconf(_SC_CLK_TCK);
+        long pageSize = sysconf(_SC_PAGESIZE);
+
+        if (ticks > 0) _ticksTo100ns = 10000000ull / static_cast<uint64_t>(ticks);
+        if (pageSize > 0) _pageSize = static_cast<uint64_t>(pageSize);
+
+        // 录制目录是普通文件系统，目录大小没有意义
+        struct statfs info;
+        _isProcFs = statfs(_procRoot.c_str(), &info) == 0 && info.f_type == 0x9fa0;   // PROC_SUPER_MAGIC
+    }
+
+    bool ProcFsProcessBackend::Enumerate(std::vector<ProcessSample>& samples, size_t maxCount)
+    {
+        samples.clear();
+
+        DIR* procDir = opendir(_procRoot.c_str());
+        if (!procDir) return false;
+
+        while (dirent* entry = readdir(procDir))
+        {
+            if (samples.size() >= maxCount) break;
+            if (!IsNumeric(entry->d_name)) continue;
+
+            samples.emplace_back().Pid = static_cast<uint32_t>(std::strtoul(entry->d_name, nullptr, 10));
+        }
+
+        closedir(procDir);
+        return true;
+    }
+
+    void ProcFsProcessBackend::Prepare(std::vector<ProcessSample>& samples)
+    {
+        // 稳态下所有描述符都已缓存，只有新进程才会打开 /proc/<pid> 下的文件
+        _handles.BeginSweep();
+
+        for (ProcessSample& sample : samples)
+        {
+            sample.Handle = _handles.Acquire(sample.Pid);
+        }
+    }
+
+    void ProcFsProcessBackend::Query(ProcessSample& sample)
+    {
+        if (!sample.Handle) return;
+
+        const ProcessHandle& handle = *sample.Handle;
+        char buffer[1024];
+
+        // stat: pid (comm) state ppid ... 括号内的进程名可能包含空格，从最后一个 ')' 之后解析
+        // 进程退出后读取缓存的描述符返回 ESRCH，PID 即使被复用也不会读到新进程的数据
+        if (ReadCachedFile(handle.Stat, buffer, sizeof(buffer)) == 0)
+        {
+            sample.HandleStale = true;
+            return;
+        }
+
+        const char* nameBegin = std::strchr(buffer, '(');
+        const char* nameEnd = std::strrchr(buffer, ')');
+        if (!nameBegin || !nameEnd || nameEnd < nameBegin) return;
+
+        sample.NameId = Text::StringPool::Shared().Intern(std::string_view(nameBegin + 1, static_cast<size_t>(nameEnd - nameBegin - 1)));
+
+        // ')' 之后依次为第 3 个字段 state 起的各字段：utime 14、stime 15、num_threads 20、starttime 22
+        const char* fields = SkipFields(nameEnd + 1, 0);
+        const char* p = SkipFields(fields, 11);
+        uint64_t utime = std::strtoull(p, nullptr, 10);
+        p = SkipFields(p, 1);
+        uint64_t stime = std::strtoull(p, nullptr, 10);
+        p = SkipFields(p, 5);
+        sample.ThreadCount = static_cast<uint32_t>(std::strtoul(p, nullptr, 10));
+        p = SkipFields(p, 2);
+        uint64_t startTime = std::strtoull(p, nullptr, 10);
+
+        sample.UserTime = utime * _ticksTo100ns;
+        sample.KernelTime = stime * _ticksTo100ns;
+        sample.CreateTime = startTime * _ticksTo100ns;
+
+        // 每个句柄只属于一个任务，记录创建时间无需同步
+        if (sample.Handle->StartTime == 0) sample.Handle->StartTime = sample.CreateTime;
+        else if (sample.Handle->StartTime != sample.CreateTime) sample.HandleStale = true;
+
+        // statm: size resident shared ... (页)，工作集取驻留页，私有内存取驻留页减去共享页
+        if (ReadCachedFile(handle.Statm, buffer, sizeof(buffer)) != 0)
+        {
+            unsigned long long size = 0, resident = 0, shared = 0;
+            if (std::sscanf(buffer, "%llu %llu %llu", &size, &resident, &shared) == 3 && resident >= shared)
+            {
+                sample.WorkingSetBytes = resident * _pageSize;
+                sample.PrivateBytes = (resident - shared) * _pageSize;
+            }
+        }
+
+        // io 只有同一用户 (或特权) 才能读取，读不到时磁盘速率为 0
+        if (ReadCachedFile(handle.Io, buffer, sizeof(buffer)) != 0)
+        {
+            if (const char* readBytes = std::strstr(buffer, "read_bytes:")) sample.ReadBytes = std::strtoull(readBytes + 11, nullptr, 10);
+            if (const char* writeBytes = std::strstr(buffer, "\nwrite_bytes:")) sample.WriteBytes = std::strtoull(writeBytes + 13, nullptr, 10);
+        }
+
+        // 句柄数对应打开的文件描述符数量；procfs 上 fd 目录的大小即为该数量，旧内核为 0 时逐项统计
+        struct stat fdInfo;
+        uint32_t count = 0;
+
+        if (_isProcFs && handle.Fds >= 0 && fstat(handle.Fds, &fdInfo) == 0 && fdInfo.st_size > 0)
+        {
+            sample.HandleCount = static_cast<uint32_t>(fdInfo.st_size);
+        }
+        else if (CountDirectoryEntries(handle.Fds, count))
+        {
+            sample.HandleCount = count;
+        }
+
+        sample.HasCounters = true;
+    }
+
+    void ProcFsProcessBackend::Complete(const std::vector<ProcessSample>& samples)
+    {
+        for (const ProcessSample& sample : samples)
+        {
+            if (sample.HandleStale) _handles.Invalidate(sample.Pid);
+        }
+
+        // 本轮未枚举到的进程已经退出，关闭其描述符
+        _handles.Sweep();
+    }
+
+    uint64_t ProcFsProcessBackend::QuerySystemTime()
+    {
+        // /proc/stat 首行为全部处理器的累计时间 (含空闲)，与 Windows 的系统内核时间含义一致
+        char path[512];
+        char buffer[1024];
+
+        std::snprintf(path, sizeof(path), "%s/stat", _procRoot.c_str());
+        if (ReadSmallFile(path, buffer, sizeof(buffer)) == 0 || std::strncmp(buffer, "cpu ", 4) != 0) return 0;
+
+        uint64_t total = 0;
+        const char* p = buffer + 4;
+
+        for (int i = 0; i < 8; ++i)
+        {
+            char* end = nullptr;
+            total += std::strtoull(p, &end, 10);
+            if (end == p) break;
+            p = end;
+        }
+
+        return total * _ticksTo100ns;
+    }
+}
+#endif
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include "ProcessBackend.h"
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 基于 /proc 的 Linux 进程数据源
+	/// 每个进程读取 stat (名称、线程数、CPU 时间、启动时间)、statm (内存)、io (磁盘) 与 fd 目录 (句柄数)
+	/// 这些文件的描述符由句柄缓存常驻打开，每个周期以 pread 从头重读；进程退出后读取失败，句柄随即失效
+	/// </summary>
+	class ProcFsProcessBackend final : public IProcessBackend
+	{
+		public:
+		/// <summary>
+		/// 创建数据源
+		/// </summary>
+		/// <param name="handles">进程句柄缓存，须使用相同的 proc 根目录创建</param>
+		/// <param name="procRoot">proc 文件系统根目录，指向录制目录即可回放</param>
+		explicit ProcFsProcessBackend(ProcessHandleCache& handles, const char* procRoot = "/proc");
+
+		bool Enumerate(std::vector<ProcessSample>& samples, size_t maxCount) override;
+		void Prepare(std::vector<ProcessSample>& samples) override;
+		void Query(ProcessSample& sample) override;
+		void Complete(const std::vector<ProcessSample>& samples) override;
+		uint64_t QuerySystemTime() override;
+
+		private:
+		ProcessHandleCache& _handles;
+		std::string _procRoot;
+		bool _isProcFs = false;             // 真实 procfs 上 fd 目录的大小即为描述符数量 (Linux 6.2+)
+		uint64_t _ticksTo100ns = 100000;    // 时钟滴答 -> 100 纳秒
+		uint64_t _pageSize = 4096;
+	};
+}
@@ -0,0 +1,98 @@
+﻿#include <pch.h>
+#include "ProcStatCpuTimeSource.h"
+
+#if defined(__linux__)
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace IronSight::Core::Native::System
+{
+    namespace
+    {
+        // 解析一个十进制字段并跳过其后的空白，行尾或非数字时返回 0 且不前进
+        inline uint64_t ParseField(const char*& cursor, const char* end) noexcept
+        {
+            while (cursor < end && *cursor == ' ') ++cursor;
+
+            uint64_t value = 0;
+            while (cursor < end && *cursor >= '0' && *cursor <= '9')
+            {
+                value = value * 10 + static_cast<uint64_t>(*cursor - '0');
+                ++cursor;
+            }
+            return value;
+        }
+
+        // 字段顺序：user nice system idle iowait irq softirq steal (guest 与 guest_nice 已计入 user 与 nice)
+        enum StatField { User, Nice, System, Idle, IoWait, Irq, SoftIrq, Steal, FieldCount };
+    }
+
+    ProcStatCpuTimeSource::ProcStatCpuTimeSource(const char* procRoot)
+    {
+        std::string path = std::string(procRoot ? procRoot : "/proc") + "/stat";
+        _fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        _buffer.resize(InitialBufferSize);
+    }
+
+    ProcStatCpuTimeSource::~ProcStatCpuTimeSource()
+    {
+        if (_fd >= 0) close(_fd);
+    }
+
+    bool ProcStatCpuTimeSource::Collect(CpuTimeColumns& times)
+    {
+        if (_fd < 0) return false;
+
+        // 数百个处理器时文件可达数十 KB，一次读不完就扩容后从头重读，保证内容来自同一次生成
+        size_t length = 0;
+        while (true)
+        {
+            ssize_t n = pread(_fd, _buffer.data(), _buffer.size(), 0);
+            if (n < 0) return false;
+
+            length = static_cast<size_t>(n);
+            if (length < _buffer.size()) break;
+            _buffer.resize(_buffer.size() * 2);
+        }
+
+        const char* cursor = _buffer.data();
+        const char* end = cursor + length;
+        size_t coreCount = 0;
+
+        while (cursor < end)
+        {
+            const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+            if (!lineEnd) lineEnd = end;
+
+            // cpu 行位于文件开头，遇到第一行其他内容即可停止
+            if (lineEnd - cursor < 4 || std::memcmp(cursor, "cpu", 3) != 0) break;
+
+            // 汇总行 "cpu " 没有编号，跳过
+            const char* field = cursor + 3;
+            if (*field >= '0' && *field <= '9')
+            {
+                const size_t core = static_cast<size_t>(ParseField(field, lineEnd));
+
+                uint64_t values[FieldCount] = {};
+                for (uint64_t& value : values) value = ParseField(field, lineEnd);
+
+                if (core >= times.CoreCount()) times.Resize(core + 1);
+                coreCount = (std::max)(coreCount, core + 1);
+
+                times.User[core] = static_cast<double>(values[User] + values[Nice]);
+                times.System[core] = static_cast<double>(values[System]);
+                times.Idle[core] = static_cast<double>(values[Idle] + values[IoWait]);
+                times.Irq[core] = static_cast<double>(values[Irq] + values[SoftIrq]);
+                times.Steal[core] = static_cast<double>(values[Steal]);
+            }
+
+            cursor = lineEnd + 1;
+        }
+
+        times.Resize(coreCount);
+        return coreCount > 0;
+    }
+}
+#endif
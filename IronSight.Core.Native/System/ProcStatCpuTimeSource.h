@@ -0,0 +1,32 @@
+﻿#pragma once
+#include "CpuTimeSource.h"
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 基于 /proc/stat 的 Linux 逐处理器时间数据源
+	/// 文件句柄常驻，每次采集用 pread 从偏移 0 重新读取并原地解析 cpuN 行；
+	/// 按处理器编号存放，离线的处理器不出现在文件中，其时间保持为 0
+	/// </summary>
+	class ProcStatCpuTimeSource final : public ICpuTimeSource
+	{
+		public:
+		/// <summary>
+		/// 创建数据源
+		/// </summary>
+		/// <param name="procRoot">proc 文件系统根目录，指向录制目录即可回放录制的 stat 文件</param>
+		explicit ProcStatCpuTimeSource(const char* procRoot = "/proc");
+		~ProcStatCpuTimeSource() override;
+
+		ProcStatCpuTimeSource(const ProcStatCpuTimeSource&) = delete;
+		ProcStatCpuTimeSource& operator=(const ProcStatCpuTimeSource&) = delete;
+
+		bool Collect(CpuTimeColumns& times) override;
+
+		private:
+		int _fd = -1;
+		std::vector<char> _buffer;
+
+		static constexpr size_t InitialBufferSize = 65536;
+	};
+}
@@ -0,0 +1,29 @@
+﻿#include <pch.h>
+#include "ProcessBackend.h"
+#include <chrono>
+
+#if defined(_WIN32)
+#include "NtProcessBackend.h"
+#elif defined(__linux__)
+#include "ProcFsProcessBackend.h"
+#endif
+
+namespace IronSight::Core::Native::System
+{
+    uint64_t IProcessBackend::QuerySampleTick()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    std::unique_ptr<IProcessBackend> IProcessBackend::CreateDefault([[maybe_unused]] ProcessHandleCache& handles, [[maybe_unused]] uint32_t snapshotMaxAgeMs)
+    {
+#if defined(_WIN32)
+        return std::make_unique<NtProcessBackend>(handles, snapshotMaxAgeMs);
+#elif defined(__linux__)
+        return std::make_unique<ProcFsProcessBackend>(handles);
+#else
+        return nullptr;
+#endif
+    }
+}
@@ -0,0 +1,57 @@
+﻿#pragma once
+#include "ProcessTypes.h"
+#include "ProcessHandleCache.h"
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 进程数据源接口
+	/// 枚举、Prepare 与 Complete 在调用线程上串行执行；Query 会被多个工作线程并发调用 (每次针对不同的进程)，实现必须线程安全
+	/// </summary>
+	class IProcessBackend
+	{
+		public:
+		virtual ~IProcessBackend() = default;
+
+		/// <summary>
+		/// 枚举当前进程 (至少填充 Pid)，samples 会被清空后重新填充
+		/// </summary>
+		/// <param name="maxCount">最多枚举的进程数</param>
+		/// <returns>成功返回true</returns>
+		virtual bool Enumerate(std::vector<ProcessSample>& samples, size_t maxCount) = 0;
+
+		/// <summary>
+		/// 并行查询之前调用，为各进程关联缓存的句柄 (新进程在此打开句柄)
+		/// </summary>
+		virtual void Prepare(std::vector<ProcessSample>& /*samples*/) {}
+
+		/// <summary>
+		/// 并行查询之后调用，关闭已失效与本轮未出现的进程的句柄
+		/// </summary>
+		virtual void Complete(const std::vector<ProcessSample>& /*samples*/) {}
+
+		/// <summary>
+		/// 查询单个进程的计数器，无法访问时保持 HasCounters 为 false
+		/// </summary>
+		virtual void Query(ProcessSample& sample) = 0;
+
+		/// <summary>
+		/// 查询系统累计 CPU 时间 (与进程时间单位相同)，作为 CPU 占用率的分母
+		/// </summary>
+		virtual uint64_t QuerySystemTime() = 0;
+
+		/// <summary>
+		/// 本次枚举的采样时刻 (毫秒，单调时钟)，作为磁盘速率的时间基准
+		/// 数据源复用较早的枚举结果时应返回该结果的采样时刻，默认返回当前时刻
+		/// </summary>
+		virtual uint64_t QuerySampleTick();
+
+		/// <summary>
+		/// 创建当前平台的默认数据源
+		/// Windows 使用共享的系统进程快照与进程句柄，Linux 使用 /proc
+		/// </summary>
+		/// <param name="handles">跨周期复用的进程句柄缓存，生命周期须长于数据源</param>
+		/// <param name="snapshotMaxAgeMs">Windows：可直接复用的共享快照的最长时间 (毫秒)，0 表示每次都重新枚举</param>
+		static std::unique_ptr<IProcessBackend> CreateDefault(ProcessHandleCache& handles, uint32_t snapshotMaxAgeMs = 0);
+	};
+}
@@ -0,0 +1,105 @@
+﻿#include <pch.h>
+#include "ProcessChangeTracker.h"
+#include <cstring>
+
+namespace IronSight::Core::Native::System
+{
+    namespace
+    {
+        inline ProcessUpdateRecord MakeUpdate(const ProcessDetailInfo& row) noexcept
+        {
+            ProcessUpdateRecord update{};
+            update.Pid = row.Pid;
+            update.ThreadCount = row.ThreadCount;
+            update.HandleCount = row.HandleCount;
+            update.MemoryMB = static_cast<float>(row.MemoryMB);
+            update.CpuUsage = static_cast<float>(row.CpuUsage);
+            update.DiskReadRateMS = static_cast<float>(row.DiskReadRateMS);
+            update.DiskWriteRateMS = static_cast<float>(row.DiskWriteRateMS);
+            return update;
+        }
+    }
+
+    uint64_t ProcessChangeTracker::Update(ProcessCollector& collector, int maxCount, uint64_t baseVersion)
+    {
+        if (maxCount <= 0) return 0;
+
+        if (_rows.size() < static_cast<size_t>(maxCount)) _rows.resize(static_cast<size_t>(maxCount));
+
+        int count = collector.Collect(_rows.data(), maxCount);
+        if (count <= 0) return 0;
+
+        const std::vector<ProcessSample>& samples = collector.Samples();
+        const bool reset = baseVersion == 0 || baseVersion != _version;
+
+        _added.clear();
+        _updated.clear();
+        _exited.clear();
+
+        _processes.BeginSweep();
+
+        for (int i = 0; i < count; ++i)
+        {
+            const ProcessDetailInfo& row = _rows[i];
+            const uint64_t createTime = samples[i].CreateTime;
+
+            // 复用了旧 PID 的新进程是另一个键：旧进程在 Sweep 中报告退出，新进程作为新增发送
+            bool inserted = false;
+            TrackedProcess& tracked = _processes.Touch(row.Pid, createTime, inserted);
+
+            const ProcessUpdateRecord update = MakeUpdate(row);
+
+            // 名称已驻留，ID 相同即内容相同
+            if (reset || inserted || tracked.PriorityClass != row.PriorityClass || tracked.NameId != row.NameId)
+            {
+                ProcessStaticRecord& record = _added.emplace_back();
+                record.Pid = row.Pid;
+                record.PriorityClass = row.PriorityClass;
+                record.CreateTime = createTime;
+                record.NameId = row.NameId;
+                record.Reserved = 0;
+            }
+
+            // 记录没有填充字节，可以整体比较
+            if (reset || inserted || std::memcmp(&tracked.Last, &update, sizeof(update)) != 0)
+            {
+                _updated.push_back(update);
+            }
+
+            tracked.Last = update;
+            tracked.PriorityClass = row.PriorityClass;
+            tracked.NameId = row.NameId;
+        }
+
+        // 重置变更集让消费方清空列表，不需要逐个报告退出
+        _processes.Sweep([&](uint32_t pid, uint64_t, TrackedProcess&)
+            {
+                if (!reset) _exited.push_back(pid);
+            });
+
+        _info = {};
+        _info.Version = ++_version;
+        _info.BaseVersion = reset ? 0 : baseVersion;
+        _info.ProcessCount = static_cast<uint32_t>(count);
+        _info.AddedCount = static_cast<uint32_t>(_added.size());
+        _info.UpdatedCount = static_cast<uint32_t>(_updated.size());
+        _info.ExitedCount = static_cast<uint32_t>(_exited.size());
+        _info.IsReset = reset ? 1 : 0;
+
+        return _version;
+    }
+
+    bool ProcessChangeTracker::CopyTo(ProcessStaticRecord* added, size_t addedCapacity,
+        ProcessUpdateRecord* updated, size_t updatedCapacity,
+        uint32_t* exited, size_t exitedCapacity) const
+    {
+        if (addedCapacity < _added.size() || updatedCapacity < _updated.size() || exitedCapacity < _exited.size()) return false;
+        if ((!_added.empty() && !added) || (!_updated.empty() && !updated) || (!_exited.empty() && !exited)) return false;
+
+        if (!_added.empty()) std::memcpy(added, _added.data(), _added.size() * sizeof(ProcessStaticRecord));
+        if (!_updated.empty()) std::memcpy(updated, _updated.data(), _updated.size() * sizeof(ProcessUpdateRecord));
+        if (!_exited.empty()) std::memcpy(exited, _exited.data(), _exited.size() * sizeof(uint32_t));
+
+        return true;
+    }
+}
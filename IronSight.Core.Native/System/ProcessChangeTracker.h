@@ -0,0 +1,55 @@
+﻿#pragma once
+#include "ProcessCollector.h"
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 进程列表增量导出
+	/// 记录上一次发送给消费方的每个进程 (以 PID + 创建时间识别) 的字段，每次采集后只导出新进程的静态字段、
+	/// 退出的 PID 与动态字段确有变化的进程。名称、优先级与空闲进程的计数器几乎不变，稳态下变更集远小于完整列表
+	/// </summary>
+	class ProcessChangeTracker
+	{
+		public:
+		/// <summary>
+		/// 用采集器采集一次并生成相对于 baseVersion 的变更集
+		/// baseVersion 不是上一次生成的版本 (首次调用、消费方丢弃过变更集) 时生成包含全部进程的重置变更集
+		/// </summary>
+		/// <param name="maxCount">最多采集的进程数</param>
+		/// <returns>新变更集的版本，采集失败返回 0 (状态保持不变)</returns>
+		uint64_t Update(ProcessCollector& collector, int maxCount, uint64_t baseVersion);
+
+		/// <summary>
+		/// 最近一次生成的变更集概要
+		/// </summary>
+		const ProcessChangeSetInfo& Info() const noexcept { return _info; }
+
+		/// <summary>
+		/// 最近一次采集的完整进程行 (前 Info().ProcessCount 项有效)
+		/// </summary>
+		const std::vector<ProcessDetailInfo>& Rows() const noexcept { return _rows; }
+
+		/// <summary>
+		/// 复制最近一次生成的变更集，任一缓冲区容量不足时不复制并返回 false
+		/// </summary>
+		bool CopyTo(ProcessStaticRecord* added, size_t addedCapacity,
+			ProcessUpdateRecord* updated, size_t updatedCapacity,
+			uint32_t* exited, size_t exitedCapacity) const;
+
+		private:
+		struct TrackedProcess
+		{
+			ProcessUpdateRecord Last;       // 上一次发送的动态字段
+			int PriorityClass;
+			uint32_t NameId;
+		};
+
+		ProcessTable<TrackedProcess> _processes;
+		std::vector<ProcessDetailInfo> _rows;
+		std::vector<ProcessStaticRecord> _added;
+		std::vector<ProcessUpdateRecord> _updated;
+		std::vector<uint32_t> _exited;
+		ProcessChangeSetInfo _info{};
+		uint64_t _version = 0;
+	};
+}
@@ -0,0 +1,91 @@
+﻿#include <pch.h>
+#include "ProcessCollector.h"
+
+namespace IronSight::Core::Native::System
+{
+    ProcessCollector::ProcessCollector(std::unique_ptr<IProcessBackend> backend, unsigned workerCount)
+        : _backend(std::move(backend)),
+        _pool(workerCount)
+    {
+    }
+
+    int ProcessCollector::Collect(ProcessDetailInfo* buffer, int maxCount)
+    {
+        if (!_backend || !buffer || maxCount <= 0) return 0;
+
+        if (!_backend->Enumerate(_samples, static_cast<size_t>(maxCount))) return 0;
+
+        const uint64_t systemTime = _backend->QuerySystemTime();
+        const uint64_t currentTick = _backend->QuerySampleTick();
+
+        // 句柄缓存非线程安全，在分发前由调用线程为每个进程取得句柄
+        _backend->Prepare(_samples);
+
+        // 并行阶段：每个任务只访问 _samples[i] 与 buffer[i]，无需同步
+        _pool.ParallelFor(_samples.size(), ChunkSize, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ProcessSample& sample = _samples[i];
+                    _backend->Query(sample);
+
+                    ProcessDetailInfo& info = buffer[i];
+                    info.Pid = sample.Pid;
+                    info.MemoryMB = sample.PrivateBytes / (1024.0 * 1024.0);
+                    info.CpuUsage = 0;
+                    info.DiskReadRateMS = 0;
+                    info.DiskWriteRateMS = 0;
+                    info.ThreadCount = sample.ThreadCount;
+                    info.HandleCount = sample.HandleCount;
+                    info.PriorityClass = sample.PriorityClass;
+                    info.NameId = sample.NameId;
+                }
+            });
+
+        _backend->Complete(_samples);
+
+        // 顺序阶段：以 (PID, 创建时间) 查历史表计算速率；本轮未再出现的进程在结束时统一清理
+        _history.BeginSweep();
+
+        for (size_t i = 0; i < _samples.size(); ++i)
+        {
+            const ProcessSample& sample = _samples[i];
+            if (!sample.HasCounters) continue;
+
+            ProcessDetailInfo& info = buffer[i];
+
+            // 复用了旧 PID 的新进程从空历史开始，不会算出异常速率
+            bool inserted = false;
+            auto& hist = _history.Touch(sample.Pid, sample.CreateTime, inserted);
+
+            if (hist.LastSampleTick > 0)
+            {
+                // CPU 计算
+                uint64_t procDiff = (sample.KernelTime - hist.LastKernelTime) + (sample.UserTime - hist.LastUserTime);
+                uint64_t sysDiff = systemTime - hist.LastSystemTime;
+                if (sysDiff > 0) info.CpuUsage = (static_cast<double>(procDiff) / sysDiff) * 100.0;
+
+                // 磁盘速率计算
+                double timeSec = (currentTick - hist.LastSampleTick) / 1000.0;
+                if (timeSec > 0)
+                {
+                    info.DiskReadRateMS = ((sample.ReadBytes - hist.LastReadBytes) / (1024.0 * 1024.0)) / timeSec;
+                    info.DiskWriteRateMS = ((sample.WriteBytes - hist.LastWriteBytes) / (1024.0 * 1024.0)) / timeSec;
+                }
+            }
+
+            // 更新历史缓存
+            hist.LastKernelTime = sample.KernelTime;
+            hist.LastUserTime = sample.UserTime;
+            hist.LastSystemTime = systemTime;
+            hist.LastReadBytes = sample.ReadBytes;
+            hist.LastWriteBytes = sample.WriteBytes;
+            hist.LastSampleTick = currentTick;
+        }
+
+        // 内存管理：丢弃本轮未出现的进程历史，表的大小始终跟随存活进程数
+        _history.Sweep();
+
+        return static_cast<int>(_samples.size());
+    }
+}
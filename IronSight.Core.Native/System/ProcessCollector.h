@@ -0,0 +1,58 @@
+﻿#pragma once
+#include "ProcessBackend.h"
+#include "ProcessTable.h"
+#include "Threading/WorkerPool.h"
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 并行进程采集器
+	/// 枚举进程后把逐进程的查询按块分发到常驻工作线程，每个任务只写入自己下标对应的槽位，
+	/// 输出顺序与枚举顺序一致；速率计算依赖历史表，在全部查询完成后由调用线程顺序完成
+	/// </summary>
+	class ProcessCollector
+	{
+		public:
+		/// <summary>
+		/// 创建采集器
+		/// </summary>
+		/// <param name="backend">进程数据源</param>
+		/// <param name="workerCount">工作线程数 (不含调用线程)，0 表示自动选择</param>
+		explicit ProcessCollector(std::unique_ptr<IProcessBackend> backend, unsigned workerCount = 0);
+
+		ProcessCollector(const ProcessCollector&) = delete;
+		ProcessCollector& operator=(const ProcessCollector&) = delete;
+
+		/// <summary>
+		/// 采集一次进程列表，CPU 与磁盘速率相对于上一次采集计算
+		/// </summary>
+		/// <param name="buffer">目标缓冲区</param>
+		/// <param name="maxCount">缓冲区大小(元素数量)</param>
+		/// <returns>实际写入的进程数量</returns>
+		int Collect(ProcessDetailInfo* buffer, int maxCount);
+
+		/// <summary>
+		/// 最近一次 Collect 的原始采样，与写入缓冲区的行一一对应 (含创建时间)
+		/// </summary>
+		const std::vector<ProcessSample>& Samples() const noexcept { return _samples; }
+
+		private:
+		struct ProcessHistory
+		{
+			uint64_t LastKernelTime;
+			uint64_t LastUserTime;
+			uint64_t LastSystemTime;
+			uint64_t LastReadBytes;
+			uint64_t LastWriteBytes;
+			uint64_t LastSampleTick;    // 毫秒 (单调时钟)
+		};
+
+		std::unique_ptr<IProcessBackend> _backend;
+		Threading::WorkerPool _pool;
+		ProcessTable<ProcessHistory> _history;
+		std::vector<ProcessSample> _samples;
+
+		// 逐进程查询的系统调用开销远大于领取任务的原子操作，小块即可均衡负载
+		static constexpr size_t ChunkSize = 8;
+	};
+}
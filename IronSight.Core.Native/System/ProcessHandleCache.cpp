@@ -0,0 +1,237 @@
+﻿#include <pch.h>
+#include "ProcessHandleCache.h"
+#include <chrono>
+
+#if defined(__linux__)
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace IronSight::Core::Native::System
+{
+    namespace
+    {
+        inline uint64_t MonotonicMilliseconds() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+#if defined(__linux__)
+        inline void CloseDescriptor(int& fd) noexcept
+        {
+            if (fd >= 0) close(fd);
+            fd = -1;
+        }
+#endif
+    }
+
+    ProcessHandleCache::ProcessHandleCache(size_t capacity, const char* procRoot)
+        : _procRoot(procRoot ? procRoot : "/proc"),
+        _capacity(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    ProcessHandleCache::~ProcessHandleCache()
+    {
+        Clear();
+    }
+
+    void ProcessHandleCache::BeginSweep() noexcept
+    {
+        // 代数 0 表示从未被采样使用，回绕时跳过
+        if (++_generation == 0) _generation = 1;
+    }
+
+    ProcessHandle* ProcessHandleCache::Acquire(uint32_t pid, uint32_t access)
+    {
+        auto it = _entries.find(pid);
+
+        if (it == _entries.end())
+        {
+            if (_entries.size() >= _capacity) EvictOne();
+            it = _entries.emplace(pid, Entry{}).first;
+            it->second.Pid = pid;
+        }
+        else
+        {
+            Unlink(it->second);
+        }
+
+        Entry& entry = it->second;
+        entry.Generation = _generation;
+        LinkNewest(entry);
+
+        if (IsOpen(entry.Handle) && HasAccess(entry.Handle, access)) return &entry.Handle;
+
+        // 同样 (或更少) 的权限最近打开失败过，重试间隔内直接返回
+        if (entry.FailedAt != 0 && (entry.FailedAccess & access) == access &&
+            MonotonicMilliseconds() - entry.FailedAt < RetryIntervalMs)
+        {
+            return nullptr;
+        }
+
+        // 与已缓存的权限合并，使同一个句柄能服务所有入口
+        const uint32_t combined = access | AccessOf(entry.Handle);
+
+        ProcessHandle handle;
+        if (!Open(pid, combined, handle))
+        {
+            // 合并后的权限被拒绝时保留已缓存的句柄，不换成只含本次权限的句柄，以免其他入口失去已有的权限
+            entry.FailedAt = MonotonicMilliseconds();
+            entry.FailedAccess = access;
+            return nullptr;
+        }
+
+        Close(entry.Handle);
+        entry.Handle = handle;
+        entry.FailedAt = 0;
+        entry.FailedAccess = 0;
+        return &entry.Handle;
+    }
+
+    void ProcessHandleCache::Invalidate(uint32_t pid)
+    {
+        auto it = _entries.find(pid);
+        if (it != _entries.end()) Erase(it->second);
+    }
+
+    void ProcessHandleCache::Sweep()
+    {
+        // 本轮 Acquire 过的项都在链表尾部，从头部开始遇到本轮的项即可停止
+        while (_oldest && _oldest->Generation != _generation) Erase(*_oldest);
+
+        // 存活进程多于容量时淘汰最久未使用的句柄，下一轮再按需打开
+        while (_entries.size() > _capacity) Erase(*_oldest);
+    }
+
+    void ProcessHandleCache::Clear()
+    {
+        for (auto& [pid, entry] : _entries) Close(entry.Handle);
+        _entries.clear();
+        _oldest = nullptr;
+        _newest = nullptr;
+    }
+
+    void ProcessHandleCache::EvictOne()
+    {
+        // 本轮采样已发出的句柄指针必须保持有效；链表头也属于本轮时说明全部属于本轮，暂时超出容量，由 Sweep 裁剪
+        if (_oldest && _oldest->Generation != _generation) Erase(*_oldest);
+    }
+
+    void ProcessHandleCache::Erase(Entry& entry)
+    {
+        const uint32_t pid = entry.Pid;
+        Close(entry.Handle);
+        Unlink(entry);
+        _entries.erase(pid);
+    }
+
+    void ProcessHandleCache::Unlink(Entry& entry) noexcept
+    {
+        (entry.Older ? entry.Older->Newer : _oldest) = entry.Newer;
+        (entry.Newer ? entry.Newer->Older : _newest) = entry.Older;
+        entry.Older = nullptr;
+        entry.Newer = nullptr;
+    }
+
+    void ProcessHandleCache::LinkNewest(Entry& entry) noexcept
+    {
+        entry.Older = _newest;
+        entry.Newer = nullptr;
+        (_newest ? _newest->Newer : _oldest) = &entry;
+        _newest = &entry;
+    }
+
+#if defined(_WIN32)
+    bool ProcessHandleCache::Open(uint32_t pid, uint32_t access, ProcessHandle& handle) const
+    {
+        HANDLE process = OpenProcess(access, FALSE, pid);
+        if (!process) return false;
+
+        handle.Process = process;
+        handle.Access = access;
+        handle.StartTime = 0;
+        return true;
+    }
+
+    void ProcessHandleCache::Close(ProcessHandle& handle) noexcept
+    {
+        if (handle.Process) CloseHandle(handle.Process);
+        handle = ProcessHandle{};
+    }
+
+    bool ProcessHandleCache::IsOpen(const ProcessHandle& handle) noexcept
+    {
+        return handle.Process != nullptr;
+    }
+
+    bool ProcessHandleCache::HasAccess(const ProcessHandle& handle, uint32_t access) noexcept
+    {
+        return (handle.Access & access) == access;
+    }
+
+    uint32_t ProcessHandleCache::AccessOf(const ProcessHandle& handle) noexcept
+    {
+        return handle.Access;
+    }
+#elif defined(__linux__)
+    bool ProcessHandleCache::Open(uint32_t pid, [[maybe_unused]] uint32_t access, ProcessHandle& handle) const
+    {
+        char path[512];
+        std::snprintf(path, sizeof(path), "%s/%u", _procRoot.c_str(), pid);
+
+        int directory = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (directory < 0) return false;
+
+        handle.Directory = directory;
+        handle.Stat = openat(directory, "stat", O_RDONLY | O_CLOEXEC);
+        handle.Statm = openat(directory, "statm", O_RDONLY | O_CLOEXEC);
+        handle.Io = openat(directory, "io", O_RDONLY | O_CLOEXEC);
+        handle.Fds = openat(directory, "fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        handle.StartTime = 0;
+
+        // stat 是识别进程所必需的，读不到说明进程已经退出
+        if (handle.Stat < 0)
+        {
+            Close(handle);
+            return false;
+        }
+
+        return true;
+    }
+
+    void ProcessHandleCache::Close(ProcessHandle& handle) noexcept
+    {
+        CloseDescriptor(handle.Fds);
+        CloseDescriptor(handle.Io);
+        CloseDescriptor(handle.Statm);
+        CloseDescriptor(handle.Stat);
+        CloseDescriptor(handle.Directory);
+        handle.StartTime = 0;
+        handle.ImagePathId = 0;
+    }
+
+    bool ProcessHandleCache::IsOpen(const ProcessHandle& handle) noexcept
+    {
+        return handle.Directory >= 0;
+    }
+
+    bool ProcessHandleCache::HasAccess([[maybe_unused]] const ProcessHandle& handle, [[maybe_unused]] uint32_t access) noexcept
+    {
+        return true;
+    }
+
+    uint32_t ProcessHandleCache::AccessOf([[maybe_unused]] const ProcessHandle& handle) noexcept
+    {
+        return 0;
+    }
+#else
+    bool ProcessHandleCache::Open([[maybe_unused]] uint32_t pid, [[maybe_unused]] uint32_t access, [[maybe_unused]] ProcessHandle& handle) const { return false; }
+    void ProcessHandleCache::Close(ProcessHandle& handle) noexcept { handle = ProcessHandle{}; }
+    bool ProcessHandleCache::IsOpen([[maybe_unused]] const ProcessHandle& handle) noexcept { return false; }
+    bool ProcessHandleCache::HasAccess([[maybe_unused]] const ProcessHandle& handle, [[maybe_unused]] uint32_t access) noexcept { return false; }
+    uint32_t ProcessHandleCache::AccessOf([[maybe_unused]] const ProcessHandle& handle) noexcept { return 0; }
+#endif
+}
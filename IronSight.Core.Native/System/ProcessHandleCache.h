@@ -0,0 +1,118 @@
+﻿#pragma once
+#include <string>
+#include <unordered_map>
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 缓存的进程句柄
+	/// Windows 为进程句柄及其访问权限；Linux 为 /proc/<pid> 目录描述符与常驻打开的计数器文件 (以 pread 从头重读)
+	/// </summary>
+	struct ProcessHandle
+	{
+#if defined(_WIN32)
+		HANDLE Process = nullptr;
+		DWORD Access = 0;
+#else
+		int Directory = -1;     // /proc/<pid>
+		int Stat = -1;          // /proc/<pid>/stat
+		int Statm = -1;         // /proc/<pid>/statm
+		int Io = -1;            // /proc/<pid>/io (无权限时为 -1)
+		int Fds = -1;           // /proc/<pid>/fd
+#endif
+		uint64_t StartTime = 0; // 首次查询到的进程创建时间 (100 纳秒)，0 表示尚未查询
+		uint32_t ImagePathId = 0;   // 映像路径 (字符串驻留池 ID)，进程存活期间不变，0 表示尚未查询
+	};
+
+	/// <summary>
+	/// 跨采样周期复用的进程句柄缓存
+	/// 以 PID 查找，并记录句柄对应进程的创建时间：创建时间不一致或句柄读取失败说明 PID 已被复用或进程已退出，
+	/// 此时由调用方 Invalidate 后重新打开。稳态下存活进程不再产生任何打开/关闭句柄的系统调用。
+	/// 非线程安全：由调用方串行访问；Acquire 返回的指针在下一次 Invalidate/Sweep/Clear 之前有效
+	/// </summary>
+	class ProcessHandleCache
+	{
+		public:
+		static constexpr size_t DefaultCapacity = 4096;
+
+		ProcessHandleCache() : ProcessHandleCache(DefaultCapacity) {}
+
+		/// <summary>
+		/// 创建缓存
+		/// </summary>
+		/// <param name="capacity">最多缓存的句柄数，超出时按最近最少使用淘汰</param>
+		/// <param name="procRoot">Linux: proc 文件系统根目录 (Windows 忽略)</param>
+		explicit ProcessHandleCache(size_t capacity, const char* procRoot = "/proc");
+		~ProcessHandleCache();
+
+		ProcessHandleCache(const ProcessHandleCache&) = delete;
+		ProcessHandleCache& operator=(const ProcessHandleCache&) = delete;
+
+		/// <summary>
+		/// 开始新一轮采样。此后 Acquire 过的句柄视为存活，其余句柄在 Sweep 时关闭
+		/// </summary>
+		void BeginSweep() noexcept;
+
+		/// <summary>
+		/// 获取进程句柄，缓存中没有或权限不足时打开 (权限与已缓存的权限合并)
+		/// 打开失败的 PID 在短时间内直接返回 nullptr，不再重复发起系统调用
+		/// </summary>
+		/// <param name="access">Windows: 需要的访问权限 (Linux 忽略)</param>
+		/// <returns>句柄，无法打开时返回 nullptr</returns>
+		ProcessHandle* Acquire(uint32_t pid, uint32_t access = 0);
+
+		/// <summary>
+		/// 关闭并移除进程的句柄 (进程已退出、已被结束或 PID 已被复用)
+		/// </summary>
+		void Invalidate(uint32_t pid);
+
+		/// <summary>
+		/// 关闭本轮未被 Acquire 的句柄 (进程已退出)，并把缓存裁剪到容量以内
+		/// </summary>
+		void Sweep();
+
+		/// <summary>
+		/// 关闭全部句柄
+		/// </summary>
+		void Clear();
+
+		size_t Size() const noexcept { return _entries.size(); }
+
+		private:
+		struct Entry
+		{
+			ProcessHandle Handle;
+			Entry* Older = nullptr;         // LRU 链表：更早使用的相邻项
+			Entry* Newer = nullptr;         // LRU 链表：更晚使用的相邻项
+			uint32_t Pid = 0;
+			uint64_t FailedAt = 0;          // 最近一次打开失败的时间 (毫秒，单调时钟)，0 表示未失败
+			uint32_t FailedAccess = 0;      // 打开失败时请求的权限
+			uint32_t Generation = 0;        // 最近一次被 Acquire 的采样代数
+		};
+
+		bool Open(uint32_t pid, uint32_t access, ProcessHandle& handle) const;
+		static void Close(ProcessHandle& handle) noexcept;
+		static bool IsOpen(const ProcessHandle& handle) noexcept;
+		static bool HasAccess(const ProcessHandle& handle, uint32_t access) noexcept;
+		static uint32_t AccessOf(const ProcessHandle& handle) noexcept;
+
+		// 淘汰一个不属于本轮采样的最久未使用项，全部属于本轮时不淘汰
+		void EvictOne();
+		void Erase(Entry& entry);
+
+		// 侵入式 LRU 链表 (最久未使用的在链表头)，移动与摘除都是 O(1)
+		void Unlink(Entry& entry) noexcept;
+		void LinkNewest(Entry& entry) noexcept;
+
+		// unordered_map 的节点地址在插入与重新散列时保持不变，链表可以直接保存 Entry 指针
+		std::unordered_map<uint32_t, Entry> _entries;
+		Entry* _oldest = nullptr;
+		Entry* _newest = nullptr;
+		std::string _procRoot;
+		size_t _capacity;
+		uint32_t _generation = 1;
+
+		// 打开失败 (受保护进程、已退出的 PID) 后的重试间隔，避免每个周期都为同一 PID 发起失败的系统调用
+		static constexpr uint64_t RetryIntervalMs = 2000;
+	};
+}
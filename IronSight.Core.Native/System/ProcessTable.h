@@ -0,0 +1,199 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 以 (PID, 创建时间) 为键的扁平哈希表 (开放寻址 + 线性探测)
+	/// PID 会被系统回收复用，加入创建时间后新进程不会继承已退出进程的数据；
+	/// 每轮采样以代数标记存活项，Sweep 遍历紧凑的键列表并就地删除本轮未出现的项，
+	/// 开销与项数成正比而与表的容量无关 (容量只增不减)，稳态下不产生任何分配
+	/// </summary>
+	template <typename T>
+	class ProcessTable
+	{
+		public:
+		ProcessTable() : ProcessTable(DefaultCapacity) {}
+
+		explicit ProcessTable(size_t initialCapacity)
+		{
+			size_t capacity = MinimumCapacity;
+			while (capacity < initialCapacity) capacity <<= 1;
+
+			_slots.resize(capacity);
+		}
+
+		/// <summary>
+		/// 开始新一轮采样。此后 Touch 过的项视为存活，其余项在 Sweep 时丢弃
+		/// </summary>
+		void BeginSweep() noexcept
+		{
+			// 代数 0 表示空槽，回绕时跳过
+			if (++_generation == 0) _generation = 1;
+			_touched = 0;
+		}
+
+		/// <summary>
+		/// 查找或插入进程对应的项，并标记为本轮存活
+		/// </summary>
+		/// <param name="inserted">输出：是否为新插入的项 (值已初始化为 T{})</param>
+		T& Touch(uint32_t pid, uint64_t createTime, bool& inserted)
+		{
+			// 负载因子不超过 1/2，保证探测序列很短
+			if ((_keys.size() + 1) * 2 > _slots.size()) Rehash(_slots.size() * 2);
+
+			Slot& slot = Probe(_slots, pid, createTime);
+			inserted = slot.Generation == 0;
+
+			if (inserted)
+			{
+				slot.Pid = pid;
+				slot.CreateTime = createTime;
+				slot.Value = T{};
+				_keys.push_back({ pid, createTime });
+			}
+
+			if (slot.Generation != _generation)
+			{
+				slot.Generation = _generation;
+				++_touched;
+			}
+
+			return slot.Value;
+		}
+
+		/// <summary>
+		/// 查找进程对应的项，不存在时返回 nullptr (不影响存活标记)
+		/// </summary>
+		T* Find(uint32_t pid, uint64_t createTime) noexcept
+		{
+			Slot& slot = Probe(_slots, pid, createTime);
+			return slot.Generation != 0 ? &slot.Value : nullptr;
+		}
+
+		/// <summary>
+		/// 丢弃本轮未被 Touch 的项。所有项都存活时 (进程集合未变化) 无需任何工作
+		/// </summary>
+		void Sweep()
+		{
+			Sweep([](uint32_t, uint64_t, T&) {});
+		}
+
+		/// <summary>
+		/// 丢弃本轮未被 Touch 的项，丢弃前对每一项调用 removed(pid, createTime, value)
+		/// </summary>
+		template <typename Callback>
+		void Sweep(Callback&& removed)
+		{
+			if (_touched == _keys.size()) return;
+
+			// 键列表与表中的项一一对应，遍历它即可找到所有失效项，无需扫描整个槽数组
+			size_t kept = 0;
+			for (const Key& key : _keys)
+			{
+				const size_t index = ProbeIndex(_slots, key.Pid, key.CreateTime);
+				Slot& slot = _slots[index];
+
+				if (slot.Generation == _generation)
+				{
+					_keys[kept++] = key;
+					continue;
+				}
+
+				removed(slot.Pid, slot.CreateTime, slot.Value);
+				Erase(index);
+			}
+
+			_keys.resize(kept);
+			_touched = kept;
+		}
+
+		size_t Size() const noexcept { return _keys.size(); }
+
+		void Clear()
+		{
+			std::fill(_slots.begin(), _slots.end(), Slot{});
+			_keys.clear();
+			_touched = 0;
+		}
+
+		private:
+		struct Slot
+		{
+			uint64_t CreateTime = 0;
+			uint32_t Pid = 0;
+			uint32_t Generation = 0;    // 最后一次被 Touch 的代数，0 表示空槽
+			T Value{};
+		};
+
+		static size_t Hash(uint32_t pid, uint64_t createTime) noexcept
+		{
+			uint64_t value = (createTime ^ (static_cast<uint64_t>(pid) << 32 | pid)) * 0x9E3779B97F4A7C15ull;
+			return static_cast<size_t>(value ^ (value >> 29));
+		}
+
+		static size_t ProbeIndex(const std::vector<Slot>& slots, uint32_t pid, uint64_t createTime) noexcept
+		{
+			const size_t mask = slots.size() - 1;
+
+			for (size_t index = Hash(pid, createTime) & mask;; index = (index + 1) & mask)
+			{
+				const Slot& slot = slots[index];
+				if (slot.Generation == 0 || (slot.Pid == pid && slot.CreateTime == createTime)) return index;
+			}
+		}
+
+		static Slot& Probe(std::vector<Slot>& slots, uint32_t pid, uint64_t createTime) noexcept
+		{
+			return slots[ProbeIndex(slots, pid, createTime)];
+		}
+
+		// 线性探测的回移删除：把探测序列上后续的项前移填补空位，不留墓碑，查找无需跳过已删除的槽
+		void Erase(size_t hole) noexcept
+		{
+			const size_t mask = _slots.size() - 1;
+
+			for (size_t next = (hole + 1) & mask; _slots[next].Generation != 0; next = (next + 1) & mask)
+			{
+				// 该项的起始槽不在 (hole, next] 区间内时，前移到空位不会使它脱离自己的探测序列
+				const size_t home = Hash(_slots[next].Pid, _slots[next].CreateTime) & mask;
+				if (((next - home) & mask) >= ((next - hole) & mask))
+				{
+					_slots[hole] = std::move(_slots[next]);
+					hole = next;
+				}
+			}
+
+			_slots[hole] = Slot{};
+		}
+
+		// 扩容：把全部项重新散列到新数组 (只在项数超过历史最大值时发生)
+		void Rehash(size_t capacity)
+		{
+			std::vector<Slot> slots(capacity);
+
+			for (Slot& slot : _slots)
+			{
+				if (slot.Generation != 0) Probe(slots, slot.Pid, slot.CreateTime) = std::move(slot);
+			}
+
+			_slots.swap(slots);
+		}
+
+		struct Key
+		{
+			uint32_t Pid;
+			uint64_t CreateTime;
+		};
+
+		std::vector<Slot> _slots;
+		std::vector<Key> _keys;     // 表中全部项的键 (顺序无关)，与槽数组同步增删
+		size_t _touched = 0;
+		uint32_t _generation = 1;
+
+		static constexpr size_t MinimumCapacity = 64;
+		static constexpr size_t DefaultCapacity = 1024;
+	};
+}
@@ -0,0 +1,107 @@
+﻿#pragma once
+
+namespace IronSight::Core::Native::System
+{
+#pragma pack(push, 8)
+	/**
+	* 结构体: ProcessDetailInfo
+	* 功能: 单个进程的详细深度信息数据
+	* 规范: 严格遵循 PascalCase 以映射 C# 结构
+	* 名称以驻留池 ID 表示 (StringPool_Get 取 UTF-8 文本)，整行不超过一条缓存行
+	*/
+	struct ProcessDetailInfo
+	{
+		uint32_t Pid;
+		double MemoryMB;
+		double CpuUsage;        // CPU 占用
+		double DiskReadRateMS;  // 磁盘读取 MB/s
+		double DiskWriteRateMS; // 磁盘写入 MB/s
+		uint32_t ThreadCount;
+		uint32_t HandleCount;
+		int PriorityClass;
+		uint32_t NameId;        // 进程名称 (字符串驻留池 ID)
+	};
+#pragma pack(pop)
+
+	/// <summary>
+	/// 进程列表变更集概要 (增量导出)
+	/// 消费方应依次应用：IsReset 时清空本地列表 -> 移除退出的 PID -> 添加/覆盖静态记录 -> 应用动态更新
+	/// </summary>
+	struct ProcessChangeSetInfo
+	{
+		uint64_t Version;               // 本次变更集的版本，下次调用时作为 baseVersion 传回
+		uint64_t BaseVersion;           // 变更集所基于的版本 (IsReset 时为 0)
+		uint32_t ProcessCount;          // 应用后的进程总数
+		uint32_t AddedCount;            // 静态记录数
+		uint32_t UpdatedCount;          // 动态更新数
+		uint32_t ExitedCount;           // 退出的 PID 数
+		uint8_t IsReset;                // 为 1 时变更集包含全部进程，本地列表需先清空
+		uint8_t Reserved[7];
+	};
+
+	/// <summary>
+	/// 进程的静态字段：新出现的进程，或名称、优先级发生变化的进程 (按 PID 覆盖)
+	/// </summary>
+	struct ProcessStaticRecord
+	{
+		uint32_t Pid;
+		int PriorityClass;
+		uint64_t CreateTime;            // 进程创建时间 (100 纳秒)，无权限访问时为 0
+		uint32_t NameId;                // 进程名称 (字符串驻留池 ID)
+		uint32_t Reserved;
+	};
+
+	/// <summary>
+	/// 进程的动态字段：只在任一字段与上一次发送的值不同时出现在变更集中
+	/// </summary>
+	struct ProcessUpdateRecord
+	{
+		uint32_t Pid;
+		uint32_t ThreadCount;
+		uint32_t HandleCount;
+		float MemoryMB;
+		float CpuUsage;                 // CPU 占用
+		float DiskReadRateMS;           // 磁盘读取 MB/s
+		float DiskWriteRateMS;          // 磁盘写入 MB/s
+		uint32_t Reserved;
+	};
+
+	static_assert(sizeof(ProcessChangeSetInfo) == 40,
+		"ProcessChangeSetInfo size mismatch");
+
+	static_assert(sizeof(ProcessDetailInfo) == 56,
+		"ProcessDetailInfo size mismatch");
+
+	static_assert(sizeof(ProcessStaticRecord) == 24,
+		"ProcessStaticRecord size mismatch");
+
+	static_assert(sizeof(ProcessUpdateRecord) == 32,
+		"ProcessUpdateRecord size mismatch");
+
+	struct ProcessHandle;
+
+	/// <summary>
+	/// 单个进程的一次原始采样 (由进程数据源填充，与平台无关)
+	/// 时间均以 100 纳秒为单位，与 Windows FILETIME 一致
+	/// </summary>
+	struct ProcessSample
+	{
+		uint32_t Pid = 0;
+		uint32_t ThreadCount = 0;
+		uint32_t HandleCount = 0;
+		int PriorityClass = 0;
+		bool HasCounters = false;       // CreateTime 之后的计数器是否有效 (无权限访问的进程为 false)
+		uint64_t CreateTime = 0;        // 进程创建时间
+		uint64_t KernelTime = 0;        // 累计内核态时间
+		uint64_t UserTime = 0;          // 累计用户态时间
+		uint64_t ReadBytes = 0;         // 累计读取字节数
+		uint64_t WriteBytes = 0;        // 累计写入字节数
+		uint64_t PrivateBytes = 0;      // 私有内存字节数
+		uint64_t WorkingSetBytes = 0;   // 工作集 (驻留内存) 字节数
+		uint32_t NameId = 0;            // 进程名称 (字符串驻留池 ID)
+
+		// 以下字段仅供数据源内部使用：Prepare 时关联的缓存句柄，Query 发现句柄已失效时置位
+		ProcessHandle* Handle = nullptr;
+		bool HandleStale = false;
+	};
+}
@@ -1,8 +1,15 @@
 ﻿#include <pch.h>
 #include "SystemMethods.h"
+#include "ProcessCollector.h"
+#include "ProcessChangeTracker.h"
+#include "SystemProcessSnapshot.h"
 #include "Utilities.h"
+#include "Metrics/MetricsStore.h"
+#include "Recorder/FlightRecorder.h"
+#include "Sampling/SamplingScheduler.h"
+#include "Text/StringPool.h"
+#include <cstring>
 #include <shellapi.h>
-#include <unordered_set>
 
 namespace IronSight::Core::Native::System
 {
@@ -43,19 +50,15 @@ namespace IronSight::Core::Native::System
 		}
 
 		// 3. 获取进程、线程与句柄总数
-		// 使用 GetProcessReferenceCount 风格的逻辑，但为了稳健性使用更通用的 API
-		std::vector<DWORD> processIds = std::vector<DWORD>(4096);
-		DWORD cbNeeded;
-		if (EnumProcesses(processIds.data(), sizeof(processIds), &cbNeeded))
+		// 与进程列表共享同一次系统进程枚举：列表刚刚采集过时直接复用其结果
+		SystemProcessSummary summary;
+		if (SystemProcessSnapshot::Shared().GetSummary(ProcessSnapshotMaxAgeMs, summary))
 		{
-			snapshot.ProcessCount = cbNeeded / sizeof(DWORD);
+			snapshot.ProcessCount = summary.ProcessCount;
+			snapshot.ThreadCount = summary.ThreadCount;
+			snapshot.HandleCount = summary.HandleCount;
 		}
 
-		// 获取系统总句柄和线程数 (简略逻辑，通常需通过 NtQuerySystemInformation 获取全局精准值)
-		// 此处展示基础实现，后续可升级至 NtQuery 提高精度
-		snapshot.HandleCount = 0; // 预留
-		snapshot.ThreadCount = 0; // 预留
-
 		// 4. 获取 CPU 温度 (通过 WMI 或特定驱动获取更为准确，原生 API 限制较多)
 		// 这是一个示意占位，真实环境通常需要从 ThermalZone 对象读取
 		snapshot.CpuTemperature = 45.5;
@@ -66,197 +69,269 @@ namespace IronSight::Core::Native::System
 		return snapshot;
 	}
 
+	uint64_t SystemMethods::SampleSnapshot()
+	{
+		if (!Initialize()) return 0;
+
+		SystemPerformanceSnapshot snapshot = GetPerformanceSnapshot();
+		const int64_t now = Metrics::MetricsStore::NowMs();
+
+		Metrics::MetricsStore::Shared().RecordBatch(now, [&](auto record)
+			{
+				record(Metrics::MetricKind::SystemCpu, 0, snapshot.CpuUsage);
+				record(Metrics::MetricKind::SystemMemory, 0, snapshot.MemoryUsagePercent);
+			});
+		Recorder::FlightRecorder::Shared().RecordSystem(now, snapshot);
+
+		std::lock_guard<std::mutex> lock(_snapshotMutex);
+		_latestSnapshot = snapshot;
+		return ++_snapshotVersion;
+	}
+
+	uint64_t SystemMethods::GetLatestSnapshot(SystemPerformanceSnapshot* snapshot)
+	{
+		std::lock_guard<std::mutex> lock(_snapshotMutex);
+
+		if (snapshot) *snapshot = _latestSnapshot;
+		return _snapshotVersion;
+	}
+
 	void SystemMethods::Cleanup()
 	{
+		// 与 SystemMonitor 相同：先摘除采集器并等待进行中的 SampleSnapshot 结束，再关闭查询
+		Sampling::SamplingScheduler::Instance().Remove(Sampling::SamplingCollector::SystemMethods, nullptr);
+
 		if (_isPdhInitialized)
 		{
 			PdhCloseQuery(_pdhQuery);
 			_isPdhInitialized = false;
 		}
 
+		// 在此处 (而不是 DLL 卸载时) 销毁采集器：加载器锁内无法安全地 join 工作线程
+		std::lock_guard<std::mutex> lock(_processMutex);
+		delete _changeTracker;
+		_changeTracker = nullptr;
+		delete _processCollector;
+		_processCollector = nullptr;
+		_handleCache.Clear();
 	}
 
 	int SystemMethods::GetDetailedProcessList(ProcessDetailInfo* buffer, int maxCount)
 	{
 		if (!buffer || maxCount <= 0) return 0;
 
-		HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-		if (hSnapshot == INVALID_HANDLE_VALUE) return 0;
+		std::lock_guard<std::mutex> lock(_processMutex);
 
-		PROCESSENTRY32W pe32;
-		pe32.dwSize = sizeof(PROCESSENTRY32W);
+		// 逐进程查询由采集器分发到工作线程并行执行，输出顺序与快照中的进程顺序一致
+		int count = EnsureCollector().Collect(buffer, maxCount);
+		RecordProcessHistory(buffer, count);
+		return count;
+	}
 
-		if (!Process32FirstW(hSnapshot, &pe32))
-		{
-			CloseHandle(hSnapshot);
-			return 0;
-		}
+	uint64_t SystemMethods::CollectProcessChanges(uint64_t baseVersion, int maxCount, ProcessChangeSetInfo* info)
+	{
+		if (maxCount <= 0) return 0;
 
-		ULONGLONG currentTick = GetTickCount64();
-		FILETIME sysIdle, sysKernel, sysUser;
-		GetSystemTimes(&sysIdle, &sysKernel, &sysUser);
+		std::lock_guard<std::mutex> lock(_processMutex);
 
-		ULARGE_INTEGER sTime;
-		sTime.LowPart = sysKernel.dwLowDateTime; sTime.HighPart = sysKernel.dwHighDateTime;
+		if (!_changeTracker) _changeTracker = new ProcessChangeTracker();
 
-		int count = 0;
-		std::vector<uint32_t> activePids;
+		uint64_t version = _changeTracker->Update(EnsureCollector(), maxCount, baseVersion);
+		if (version == 0) return 0;
 
-		do
-		{
-			if (count >= maxCount) break;
+		RecordProcessHistory(_changeTracker->Rows().data(), static_cast<int>(_changeTracker->Info().ProcessCount));
+		if (info) *info = _changeTracker->Info();
+		return version;
+	}
 
-			ProcessDetailInfo& info = buffer[count];
-			info.Pid = pe32.th32ProcessID;
-			info.ThreadCount = pe32.cntThreads;
-			activePids.push_back(info.Pid);
+	void SystemMethods::RecordProcessHistory(const ProcessDetailInfo* rows, int count)
+	{
+		if (!rows || count <= 0) return;
 
-			// 字符转换：Unicode -> ANSI
-			WideCharToMultiByte(CP_ACP, 0, pe32.szExeFile, -1, info.Name, sizeof(info.Name), NULL, NULL);
+		const int64_t now = Metrics::MetricsStore::NowMs();
 
-			// 核心优化：一次 OpenProcess 获取所有权限
-			// 需要 PROCESS_QUERY_INFORMATION 用于 Times/IO，PROCESS_VM_READ 用于 MemoryMB
-			HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, info.Pid);
+		// 采集器的原始采样与刚写出的行一一对应，以创建时间区分复用了同一 PID 的进程
+		const std::vector<ProcessSample>& samples = EnsureCollector().Samples();
 
-			if (hProcess)
+		// 整张进程表在一次加锁内写入历史存储
+		Metrics::MetricsStore::Shared().RecordBatch(now, [&](auto record)
 			{
-				// 1. 获取内存与句柄数
-				PROCESS_MEMORY_COUNTERS_EX pmc;
-				if (GetProcessMemoryInfo(hProcess, (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc)))
+				for (int i = 0; i < count; ++i)
 				{
-					info.MemoryMB = pmc.PrivateUsage / (1024.0 * 1024.0);
+					const uint64_t createTime = static_cast<size_t>(i) < samples.size() ? samples[i].CreateTime : 0;
+					record(Metrics::MetricKind::ProcessCpu, rows[i].Pid, rows[i].CpuUsage, createTime);
+					record(Metrics::MetricKind::ProcessMemory, rows[i].Pid, rows[i].MemoryMB, createTime);
 				}
+			});
+		Recorder::FlightRecorder::Shared().RecordProcesses(now, rows, static_cast<size_t>(count));
+	}
 
-				DWORD handleCount = 0;
-				if (GetProcessHandleCount(hProcess, &handleCount))
-				{
-					info.HandleCount = handleCount;
-				}
+	bool SystemMethods::CopyProcessChanges(uint64_t version, ProcessStaticRecord* added, int addedCapacity,
+		ProcessUpdateRecord* updated, int updatedCapacity,
+		uint32_t* exited, int exitedCapacity)
+	{
+		std::lock_guard<std::mutex> lock(_processMutex);
 
-				// 2. 速率采样计算 (CPU & Disk)
-				FILETIME createTime, exitTime, kernelTime, userTime;
-				IO_COUNTERS ioCounters;
+		// 两次调用之间其他调用方重新采集过，按 info 分配的缓冲区与当前变更集不再对应
+		if (!_changeTracker || version == 0 || _changeTracker->Info().Version != version) return false;
 
-				if (GetProcessTimes(hProcess, &createTime, &exitTime, &kernelTime, &userTime) &&
-					GetProcessIoCounters(hProcess, &ioCounters))
-				{
-					auto& hist = _historyMap[info.Pid];
-
-					ULARGE_INTEGER kTime, uTime;
-					kTime.LowPart = kernelTime.dwLowDateTime; kTime.HighPart = kernelTime.dwHighDateTime;
-					uTime.LowPart = userTime.dwLowDateTime; uTime.HighPart = userTime.dwHighDateTime;
-
-					if (hist.LastSampleTick > 0)
-					{
-						// CPU 计算
-						ULONGLONG procDiff = (kTime.QuadPart - hist.LastKernelTime.QuadPart) +
-							(uTime.QuadPart - hist.LastUserTime.QuadPart);
-						ULONGLONG sysDiff = (sTime.QuadPart - hist.LastSystemTime.QuadPart);
-						if (sysDiff > 0) info.CpuUsage = (static_cast<double>(procDiff) / sysDiff) * 100.0;
-
-						// 磁盘速率计算
-						double timeSec = (currentTick - hist.LastSampleTick) / 1000.0;
-						if (timeSec > 0)
-						{
-							ULONGLONG readDiff = ioCounters.ReadTransferCount - hist.LastIo.ReadTransferCount;
-							ULONGLONG writeDiff = ioCounters.WriteTransferCount - hist.LastIo.WriteTransferCount;
-							info.DiskReadRateMS = (readDiff / (1024.0 * 1024.0)) / timeSec;
-							info.DiskWriteRateMS = (writeDiff / (1024.0 * 1024.0)) / timeSec;
-						}
-					}
-
-					// 更新历史缓存
-					hist.LastKernelTime = kTime;
-					hist.LastUserTime = uTime;
-					hist.LastSystemTime = sTime;
-					hist.LastIo = ioCounters;
-					hist.LastSampleTick = currentTick;
-				}
-				CloseHandle(hProcess);
-			}
-			else
-			{
-				// 权限不足的进程填充 0
-				info.MemoryMB = 0;
-				info.HandleCount = 0;
-				info.CpuUsage = 0;
-			}
+		return _changeTracker->CopyTo(added, addedCapacity > 0 ? addedCapacity : 0,
+			updated, updatedCapacity > 0 ? updatedCapacity : 0,
+			exited, exitedCapacity > 0 ? exitedCapacity : 0);
+	}
 
-			count++;
+	ProcessCollector& SystemMethods::EnsureCollector()
+	{
+		if (!_processCollector)
+		{
+			_processCollector = new ProcessCollector(IProcessBackend::CreateDefault(_handleCache, ProcessSnapshotMaxAgeMs));
 		}
-		while (Process32NextW(hSnapshot, &pe32));
 
-		CloseHandle(hSnapshot);
+		return *_processCollector;
+	}
+
+	uint32_t SystemMethods::GetProcessImagePathId(uint32_t pid)
+	{
+		std::lock_guard<std::mutex> lock(_processMutex);
 
-		// 内存管理：清理已经退出的 PID 缓存，防止 Map 无限膨胀
-		if (_historyMap.size() > (size_t)count + 50)
+		// 与采集器使用相同的权限，列表中的进程直接复用其句柄
+		ProcessHandle* handle = _handleCache.Acquire(pid, PROCESS_QUERY_LIMITED_INFORMATION);
+		if (!handle) return 0;
+
+		if (handle->ImagePathId == 0)
 		{
-			std::unordered_set<uint32_t> currentSet(activePids.begin(), activePids.end());
-			for (auto it = _historyMap.begin(); it != _historyMap.end(); )
-			{
-				if (currentSet.find(it->first) == currentSet.end()) it = _historyMap.erase(it);
-				else ++it;
-			}
+			// 宽字符版本避免 ANSI 代码页丢失字符；长路径 (\\?\ 前缀) 最多 32767 个字符
+			std::vector<WCHAR> path(32768);
+			DWORD size = static_cast<DWORD>(path.size());
+
+			if (!QueryFullProcessImageNameW(handle->Process, 0, path.data(), &size)) return 0;
+
+			handle->ImagePathId = Text::StringPool::Shared().Intern(std::wstring_view(path.data(), size));
 		}
 
-		return count;
+		return handle->ImagePathId;
+	}
+
+	bool SystemMethods::GetProcessFullPath(uint32_t pid, char* pathBuffer, uint32_t bufferSize)
+	{
+		if (!pathBuffer || bufferSize == 0) return false;
+
+		uint32_t pathId = GetProcessImagePathId(pid);
+		if (pathId == 0) return false;
+
+		std::string_view path = Text::StringPool::Shared().Get(pathId);
+		if (path.size() >= bufferSize) return false;
+
+		std::memcpy(pathBuffer, path.data(), path.size());
+		pathBuffer[path.size()] = '\0';
+		return true;
+	}
+
+	bool SystemMethods::SetProcessPriority(uint32_t pid, uint32_t priorityClass)
+	{
+		std::lock_guard<std::mutex> lock(_processMutex);
+
+		ProcessHandle* handle = _handleCache.Acquire(pid, PROCESS_SET_INFORMATION);
+		if (!handle) return false;
+
+		return SetPriorityClass(handle->Process, priorityClass) != FALSE;
+	}
+
+	bool SystemMethods::TerminateSelectedProcess(uint32_t pid)
+	{
+		std::lock_guard<std::mutex> lock(_processMutex);
+
+		// PROCESS_TERMINATE: 结束进程的权限；如果打开失败 (例如进程不存在、权限不足)，直接返回 false
+		ProcessHandle* handle = _handleCache.Acquire(pid, PROCESS_TERMINATE);
+		if (!handle) return false;
+
+		// 这里的退出码通常使用 1 表示异常终止，或者你可以使用其他自定义码
+		BOOL isSuccess = TerminateProcess(handle->Process, 0xFFFFFFFF);
+
+		// 进程即将退出，不再保留其句柄
+		if (isSuccess) _handleCache.Invalidate(pid);
+
+		return (isSuccess == TRUE);
+	}
+
+	bool InitializeSystemMethods()
+	{
+		return SystemMethods::Initialize();
+	}
+
+	SystemPerformanceSnapshot GetSystemPerformanceSnapshot()
+	{
+		return SystemMethods::GetPerformanceSnapshot();
+	}
+
+	void CleanupSystemMethods()
+	{
+		SystemMethods::Cleanup();
+	}
+
+	int GetDetailedProcessList(ProcessDetailInfo* buffer, int maxCount)
+	{
+		return SystemMethods::GetDetailedProcessList(buffer, maxCount);
+	}
+
+	uint64_t CollectProcessChanges(uint64_t baseVersion, int maxCount, ProcessChangeSetInfo* info)
+	{
+		return SystemMethods::CollectProcessChanges(baseVersion, maxCount, info);
+	}
+
+	bool CopyProcessChanges(uint64_t version, ProcessStaticRecord* added, int addedCapacity,
+		ProcessUpdateRecord* updated, int updatedCapacity,
+		uint32_t* exited, int exitedCapacity)
+	{
+		return SystemMethods::CopyProcessChanges(version, added, addedCapacity, updated, updatedCapacity, exited, exitedCapacity);
+	}
+
+	uint64_t GetLatestSystemPerformanceSnapshot(SystemPerformanceSnapshot* snapshot)
+	{
+		return SystemMethods::GetLatestSnapshot(snapshot);
+	}
+
+	uint32_t GetProcessImagePathId(uint32_t pid)
+	{
+		return SystemMethods::GetProcessImagePathId(pid);
 	}
 
 	// 获取进程完整路径
 	bool GetProcessFullPath(uint32_t pid, char* pathBuffer, uint32_t bufferSize)
 	{
-		HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
-		if (!hProcess) return false;
-
-		DWORD size = bufferSize;
-		bool success = QueryFullProcessImageNameA(hProcess, 0, pathBuffer, &size);
-		CloseHandle(hProcess);
-		return success;
+		return SystemMethods::GetProcessFullPath(pid, pathBuffer, bufferSize);
 	}
 
 	// 设置进程优先级
 	bool SetProcessPriority(uint32_t pid, uint32_t priorityClass)
 	{
-		HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION, FALSE, pid);
-		if (!hProcess) return false;
-
-		bool success = SetPriorityClass(hProcess, priorityClass);
-		CloseHandle(hProcess);
-		return success;
+		return SystemMethods::SetProcessPriority(pid, priorityClass);
 	}
 
 	// 弹出文件属性窗口
 	void ShowFileProperties(const char* filePath)
 	{
-		SHELLEXECUTEINFOA sei = { sizeof(sei) };
+		if (!filePath) return;
+
+		// 路径来自驻留池 (UTF-8)，转换为宽字符后调用 W 版本
+		int length = MultiByteToWideChar(CP_UTF8, 0, filePath, -1, NULL, 0);
+		if (length <= 0) return;
+
+		std::vector<WCHAR> path(static_cast<size_t>(length));
+		MultiByteToWideChar(CP_UTF8, 0, filePath, -1, path.data(), length);
+
+		SHELLEXECUTEINFOW sei = { sizeof(sei) };
 		sei.fMask = SEE_MASK_INVOKEIDLIST;
-		sei.lpVerb = "properties";
-		sei.lpFile = filePath;
+		sei.lpVerb = L"properties";
+		sei.lpFile = path.data();
 		sei.nShow = SW_SHOW;
-		ShellExecuteExA(&sei);
+		ShellExecuteExW(&sei);
 	}
 
-	// 假设这是在 SystemMethods 类中
+	// 结束进程 (句柄来自共享缓存)
 	bool TerminateSelectedProcess(DWORD pid)
 	{
-		// 1. 尝试获取进程句柄
-		// PROCESS_TERMINATE: 仅需要结束进程的权限
-		HANDLE hProcess = OpenProcess(PROCESS_TERMINATE, FALSE, pid);
-
-		// 如果打开失败（例如进程不存在、权限不足），直接返回 false
-		if (hProcess == NULL)
-		{
-			return false;
-		}
-
-		// 2. 执行终止
-		// 这里的退出码通常使用 1 表示异常终止，或者你可以使用其他自定义码
-		BOOL isSuccess = TerminateProcess(hProcess, 0xFFFFFFFF);
-
-		// 3. 【关键】无论终止成功与否，必须关闭句柄以释放系统资源
-		CloseHandle(hProcess);
-
-		return (isSuccess == TRUE);
+		return SystemMethods::TerminateSelectedProcess(pid);
 	}
 
 
@@ -1,54 +1,14 @@
 ﻿#pragma once
-#include <map>
+#include <mutex>
+#include "ProcessTypes.h"
+#include "SystemTypes.h"
+#include "ProcessHandleCache.h"
 
 namespace IronSight::Core::Native::System
 {
-	/**
-	* 结构体: SystemPerformanceSnapshot
-	* 功能: 存储系统级的性能深度快照数据
-	* 规范: PascalCase (与 C# 保持同步)
-	*/
-#pragma pack(push, 8)
-	struct SystemPerformanceSnapshot
-	{
-		double CpuUsage;                // 总 CPU 使用率 (%)
-		double CpuTemperature;          // CPU 温度 (Celsius) - 注意：某些硬件可能返回 0
-		double MemoryUsagePercent;      // 内存占用率 (%)
-		double TotalPhysicalMemoryMB;   // 总物理内存 (MB)
-		double AvailablePhysicalMemoryMB; // 可用物理内存 (MB)
-		uint32_t ProcessCount;          // 当前运行进程数
-		uint32_t ThreadCount;           // 当前总线程数
-		uint32_t HandleCount;           // 系统总句柄数
-		double CommittedBytesMB;        // 已提交页面内存 (MB)
-	};
+	class ProcessCollector;
+	class ProcessChangeTracker;
 
-	/**
-	* 结构体: ProcessDetailInfo
-	* 功能: 单个进程的详细深度信息数据
-	* 规范: 严格遵循 PascalCase 以映射 C# 结构
-	*/
-	struct ProcessDetailInfo
-	{
-		uint32_t Pid;
-		double MemoryMB;
-		double CpuUsage;        // CPU 占用
-		double DiskReadRateMS;  // 磁盘读取 MB/s
-		double DiskWriteRateMS; // 磁盘写入 MB/s
-		uint32_t ThreadCount;
-		uint32_t HandleCount;
-		int PriorityClass;
-		char Name[260];         // 进程名称 (ANSI)
-	};
-#pragma pack(pop)
-	
-	struct ProcessHistory
-	{
-		ULARGE_INTEGER LastKernelTime;
-		ULARGE_INTEGER LastUserTime;
-		ULARGE_INTEGER LastSystemTime;
-		IO_COUNTERS LastIo;
-		ULONGLONG LastSampleTick;
-	};
 	/**
 	* 类名: SystemMethods
 	* 功能: 负责 System 命名空间下的所有底层监控逻辑
@@ -59,42 +19,125 @@ namespace IronSight::Core::Native::System
 		inline static PDH_HQUERY _pdhQuery = nullptr;
 		inline static PDH_HCOUNTER _cpuCounter = nullptr;
 		inline static bool _isPdhInitialized = false;
-		inline static std::map<uint32_t, ProcessHistory> _historyMap;
+
+		// 进程列表采集器 (含工作线程)，首次使用时创建，Cleanup 时销毁
+		inline static ProcessCollector* _processCollector = nullptr;
+
+		// 进程列表增量导出的状态 (上一次发送的各进程字段)，与采集器同生命周期
+		inline static ProcessChangeTracker* _changeTracker = nullptr;
+
+		// 采集器与各进程操作入口共享的句柄缓存，均在 _processMutex 下访问
+		inline static ProcessHandleCache _handleCache;
+		inline static std::mutex _processMutex;
+
+		// 性能快照与进程列表可复用对方刚刚完成的系统进程枚举的最长时间 (毫秒)
+		static constexpr uint32_t ProcessSnapshotMaxAgeMs = 500;
+
+		// 后台采样线程写入的最新快照
+		inline static SystemPerformanceSnapshot _latestSnapshot = {};
+		inline static uint64_t _snapshotVersion = 0;
+		inline static std::mutex _snapshotMutex;
 
 		public:
 		static bool Initialize();
 		static SystemPerformanceSnapshot GetPerformanceSnapshot();
 		static void Cleanup();
 		static int GetDetailedProcessList(ProcessDetailInfo* buffer, int maxCount);
+
+		/// <summary>
+		/// 采集一次进程列表并生成相对于 baseVersion 的变更集 (见 ProcessChangeTracker)
+		/// </summary>
+		/// <returns>新变更集的版本，失败返回 0</returns>
+		static uint64_t CollectProcessChanges(uint64_t baseVersion, int maxCount, ProcessChangeSetInfo* info);
+
+		/// <summary>
+		/// 复制最近一次生成的变更集，version 不是其版本 (期间有其他调用方重新采集) 或容量不足时返回 false
+		/// </summary>
+		static bool CopyProcessChanges(uint64_t version, ProcessStaticRecord* added, int addedCapacity,
+			ProcessUpdateRecord* updated, int updatedCapacity,
+			uint32_t* exited, int exitedCapacity);
+
+		/// <summary>
+		/// 获取进程映像路径的驻留池 ID，路径随缓存的句柄保存，同一进程只查询一次
+		/// </summary>
+		/// <returns>失败返回 0</returns>
+		static uint32_t GetProcessImagePathId(uint32_t pid);
+
+		static bool GetProcessFullPath(uint32_t pid, char* pathBuffer, uint32_t bufferSize);
+		static bool SetProcessPriority(uint32_t pid, uint32_t priorityClass);
+		static bool TerminateSelectedProcess(uint32_t pid);
+
+		/// <summary>
+		/// 采集一次性能快照并缓存 (由 SamplingScheduler 调用)
+		/// </summary>
+		/// <returns>新快照的代数，失败返回 0</returns>
+		static uint64_t SampleSnapshot();
+
+		/// <summary>
+		/// 读取最近一次缓存的性能快照，不触发任何采集
+		/// </summary>
+		/// <returns>快照代数，尚未采样过返回 0</returns>
+		static uint64_t GetLatestSnapshot(SystemPerformanceSnapshot* snapshot);
+
+		private:
+		// 首次使用时创建采集器，调用方须持有 _processMutex
+		static ProcessCollector& EnsureCollector();
+
+		// 把一次采集的 CPU 与内存写入历史存储 (Metrics::MetricsStore)，录制中时整张表写入飞行记录
+		static void RecordProcessHistory(const ProcessDetailInfo* rows, int count);
 	};
 
 	extern "C"
 	{
-		__declspec(dllexport) bool InitializeSystemMethods()
-		{
-			return SystemMethods::Initialize();
-		}
+		__declspec(dllexport) bool InitializeSystemMethods();
 
-		__declspec(dllexport) SystemPerformanceSnapshot GetSystemPerformanceSnapshot()
-		{
-			return SystemMethods::GetPerformanceSnapshot();
-		}
+		__declspec(dllexport) SystemPerformanceSnapshot GetSystemPerformanceSnapshot();
 
-		__declspec(dllexport) void CleanupSystemMethods()
-		{
-			SystemMethods::Cleanup();
-		}
+		__declspec(dllexport) void CleanupSystemMethods();
 
 		/**
 		* 功能: 获取详细进程列表 (由 SystemMonitorServiceEx 调用)
 		* 解决 Unicode 不兼容问题: 显式使用 W 系列 API 并进行多字节转换
 		*/
-		__declspec(dllexport) int GetDetailedProcessList(ProcessDetailInfo* buffer, int maxCount) { return SystemMethods::GetDetailedProcessList(buffer, maxCount); }
+		__declspec(dllexport) int GetDetailedProcessList(ProcessDetailInfo* buffer, int maxCount);
+
+		/**
+		* 功能: 增量获取进程列表 - 采集一次并生成相对于 baseVersion 的变更集，概要写入 info
+		* 首次调用或 baseVersion 不是上一次返回的版本时生成包含全部进程的重置变更集
+		* 返回: 新版本号，失败返回 0；变更内容通过 CopyProcessChanges 读取
+		*/
+		__declspec(dllexport) uint64_t CollectProcessChanges(uint64_t baseVersion, int maxCount, ProcessChangeSetInfo* info);
+
+		/**
+		* 功能: 复制 CollectProcessChanges 生成的变更集 (version 为其返回值，容量取自 info 中的计数)
+		* 返回: 变更集已被之后的采集替换或任一缓冲区容量不足时返回 false
+		*/
+		__declspec(dllexport) bool CopyProcessChanges(uint64_t version, ProcessStaticRecord* added, int addedCapacity,
+			ProcessUpdateRecord* updated, int updatedCapacity,
+			uint32_t* exited, int exitedCapacity);
 
+		/**
+		* 功能: 读取后台采样线程缓存的最新性能快照 (配合 SamplingScheduler 使用)
+		* 返回: 快照代数，尚未采样过返回 0
+		*/
+		__declspec(dllexport) uint64_t GetLatestSystemPerformanceSnapshot(SystemPerformanceSnapshot* snapshot);
+
+		/**
+		* 功能: 获取进程映像路径的字符串驻留池 ID (StringPool_Get 取 UTF-8 文本)
+		* 返回: 失败返回 0
+		*/
+		__declspec(dllexport) uint32_t GetProcessImagePathId(uint32_t pid);
+
+		/**
+		* 功能: 获取进程映像路径 (UTF-8)，缓冲区不足时返回 false
+		*/
 		__declspec(dllexport) bool GetProcessFullPath(uint32_t pid, char* pathBuffer, uint32_t bufferSize);
 
 		__declspec(dllexport) bool SetProcessPriority(uint32_t pid, uint32_t priorityClass);
 
+		/**
+		* 功能: 弹出文件属性窗口，filePath 为 UTF-8
+		*/
 		__declspec(dllexport) void ShowFileProperties(const char* filePath);
 
 		__declspec(dllexport) bool TerminateSelectedProcess(DWORD pid);
@@ -1,6 +1,8 @@
 ﻿#include <pch.h>
 #include "SystemMonitor.h"
 #include "Utilities.h"
+#include "Metrics/MetricsStore.h"
+#include "Sampling/SamplingScheduler.h"
 
 #pragma comment(lib, "pdh.lib")
 
@@ -47,6 +49,8 @@ namespace IronSight::Core::Native::System
 
 	void SystemMonitor::UpdateSystemStats()
 	{
+		std::lock_guard<std::mutex> lock(_queryMutex);
+
 		if (_hQuery)
 		{
 			PDH_STATUS status = PdhCollectQueryData(_hQuery);
@@ -58,8 +62,27 @@ namespace IronSight::Core::Native::System
 		}
 	}
 
+	uint64_t SystemMonitor::SampleStats()
+	{
+		std::lock_guard<std::mutex> lock(_queryMutex);
+
+		if (!_hQuery) return 0;
+
+		if (PdhCollectQueryData(_hQuery) != ERROR_SUCCESS) return 0;
+
+		Metrics::MetricsStore::Shared().RecordBatch(Metrics::MetricsStore::NowMs(), [](auto record)
+			{
+				record(Metrics::MetricKind::DiskRead, 0, ReadDiskReadRate());
+				record(Metrics::MetricKind::DiskWrite, 0, ReadDiskWriteRate());
+			});
+
+		return ++_sampleVersion;
+	}
+
 	double SystemMonitor::GetCpuUsage()
 	{
+		std::lock_guard<std::mutex> lock(_queryMutex);
+
 		if (!_hQuery || !_hCpuCounter) return 0.0;
 
 		PDH_FMT_COUNTERVALUE value;
@@ -72,6 +95,12 @@ namespace IronSight::Core::Native::System
 	}
 
 	double SystemMonitor::GetDiskReadRate()
+	{
+		std::lock_guard<std::mutex> lock(_queryMutex);
+		return ReadDiskReadRate();
+	}
+
+	double SystemMonitor::ReadDiskReadRate()
 	{
 		if (!_hQuery || !_hDiskReadCounter) return 0.0;
 
@@ -85,6 +114,12 @@ namespace IronSight::Core::Native::System
 	}
 
 	double SystemMonitor::GetDiskWriteRate()
+	{
+		std::lock_guard<std::mutex> lock(_queryMutex);
+		return ReadDiskWriteRate();
+	}
+
+	double SystemMonitor::ReadDiskWriteRate()
 	{
 		if (!_hQuery || !_hDiskWriteCounter) return 0.0;
 
@@ -99,10 +134,29 @@ namespace IronSight::Core::Native::System
 
 	void SystemMonitor::CleanupSystemMonitor()
 	{
+		// 先从采样线程摘除并等待进行中的批次结束，之后不会再有 SampleStats 开始
+		// 摘除时不能持有 _queryMutex：正在执行的 SampleStats 需要它才能结束
+		Sampling::SamplingScheduler::Instance().Remove(Sampling::SamplingCollector::SystemMonitor, nullptr);
+
+		std::lock_guard<std::mutex> lock(_queryMutex);
+
 		if (_hQuery)
 		{
 			PdhCloseQuery(_hQuery);
 			_hQuery = NULL;
+			_hCpuCounter = NULL;
+			_hDiskReadCounter = NULL;
+			_hDiskWriteCounter = NULL;
 		}
 	}
 }
+
+extern "C"
+{
+	bool InitializeSystemMonitor() { return IronSight::Core::Native::System::SystemMonitor::InitializeSystemMonitor(); }
+	void UpdateSystemStats() { return IronSight::Core::Native::System::SystemMonitor::UpdateSystemStats(); }
+	double GetCpuUsage() { return IronSight::Core::Native::System::SystemMonitor::GetCpuUsage(); }
+	double GetDiskReadRate() { return IronSight::Core::Native::System::SystemMonitor::GetDiskReadRate(); }
+	double GetDiskWriteRate() { return IronSight::Core::Native::System::SystemMonitor::GetDiskWriteRate(); }
+	void CleanupSystemMonitor() { return IronSight::Core::Native::System::SystemMonitor::CleanupSystemMonitor(); }
+}
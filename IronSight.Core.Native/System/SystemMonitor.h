@@ -1,4 +1,6 @@
 ﻿#pragma once
+#include <mutex>
+
 namespace IronSight::Core::Native::System
 {
 	class SystemMonitor
@@ -8,6 +10,14 @@ namespace IronSight::Core::Native::System
 		inline static PDH_HCOUNTER _hCpuCounter = nullptr;
 		inline static PDH_HCOUNTER _hDiskReadCounter = nullptr;
 		inline static PDH_HCOUNTER _hDiskWriteCounter = nullptr;
+		inline static std::atomic<uint64_t> _sampleVersion{ 0 };
+
+		// 保护查询句柄：采样线程与托管调用方可能同时访问，Cleanup 关闭查询时不能有人正在使用
+		inline static std::mutex _queryMutex;
+
+		// 调用方持有 _queryMutex
+		static double ReadDiskReadRate();
+		static double ReadDiskWriteRate();
 
 		public:
 		/// <summary>
@@ -20,6 +30,11 @@ namespace IronSight::Core::Native::System
 		/// </summary>
 		static void UpdateSystemStats();
 		/// <summary>
+		/// 采集一次计数器数据 (由 SamplingScheduler 调用)。
+		/// </summary>
+		/// <returns>采集成功时返回新的采样代数，未初始化或采集失败时返回 0。</returns>
+		static uint64_t SampleStats();
+		/// <summary>
 		/// 获取当前 CPU 使用率。
 		/// </summary>
 		/// <returns>返回表示当前 CPU 使用率的 double 值，通常以百分比表示（例如 0.0 到 100.0 之间）。</returns>
@@ -44,11 +59,10 @@ namespace IronSight::Core::Native::System
 
 extern "C"
 {
-	__declspec(dllexport) bool InitializeSystemMonitor() { return IronSight::Core::Native::System::SystemMonitor::InitializeSystemMonitor(); }
-	__declspec(dllexport) void UpdateSystemStats() { return IronSight::Core::Native::System::SystemMonitor::UpdateSystemStats(); }
-	__declspec(dllexport) double GetCpuUsage() { return IronSight::Core::Native::System::SystemMonitor::GetCpuUsage(); };
-	__declspec(dllexport) double GetDiskReadRate() { return IronSight::Core::Native::System::SystemMonitor::GetDiskReadRate(); } // Bytes/sec
-	__declspec(dllexport) double GetDiskWriteRate() { return IronSight::Core::Native::System::SystemMonitor::GetDiskWriteRate(); }; // Bytes/sec
-	__declspec(dllexport) void CleanupSystemMonitor() { return IronSight::Core::Native::System::SystemMonitor::CleanupSystemMonitor(); };
+	__declspec(dllexport) bool InitializeSystemMonitor();
+	__declspec(dllexport) void UpdateSystemStats();
+	__declspec(dllexport) double GetCpuUsage();
+	__declspec(dllexport) double GetDiskReadRate(); // Bytes/sec
+	__declspec(dllexport) double GetDiskWriteRate(); // Bytes/sec
+	__declspec(dllexport) void CleanupSystemMonitor();
 }
-
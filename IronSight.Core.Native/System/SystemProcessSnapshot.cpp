@@ -0,0 +1,225 @@
+﻿#include <pch.h>
+#include "SystemProcessSnapshot.h"
+#include "Text/StringPool.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(_WIN32)
+
+// NTSTATUS 与 KPRIORITY 由 winternl.h 声明，windows.h 不提供
+#include <winternl.h>
+
+namespace IronSight::Core::Native::System
+{
+    namespace
+    {
+        constexpr ULONG SystemProcessInformationClass = 5;
+        constexpr NTSTATUS StatusInfoLengthMismatch = static_cast<NTSTATUS>(0xC0000004L);
+
+        using NtQuerySystemInformationFn = NTSTATUS(NTAPI*)(ULONG, PVOID, ULONG, PULONG);
+
+        struct NativeUnicodeString
+        {
+            USHORT Length;              // 字节数，不含结尾的 0
+            USHORT MaximumLength;
+            PWSTR Buffer;
+        };
+
+        // SYSTEM_PROCESS_INFORMATION 的完整布局 (winternl.h 只公开了其中一部分字段)
+        // 每个进程之后紧跟 NumberOfThreads 个线程记录，NextEntryOffset 指向下一个进程，最后一项为 0
+        struct NativeProcessInformation
+        {
+            ULONG NextEntryOffset;
+            ULONG NumberOfThreads;
+            LARGE_INTEGER WorkingSetPrivateSize;
+            ULONG HardFaultCount;
+            ULONG NumberOfThreadsHighWatermark;
+            ULONGLONG CycleTime;
+            LARGE_INTEGER CreateTime;
+            LARGE_INTEGER UserTime;
+            LARGE_INTEGER KernelTime;
+            NativeUnicodeString ImageName;
+            KPRIORITY BasePriority;
+            HANDLE UniqueProcessId;
+            HANDLE InheritedFromUniqueProcessId;
+            ULONG HandleCount;
+            ULONG SessionId;
+            ULONG_PTR UniqueProcessKey;
+            SIZE_T PeakVirtualSize;
+            SIZE_T VirtualSize;
+            ULONG PageFaultCount;
+            SIZE_T PeakWorkingSetSize;
+            SIZE_T WorkingSetSize;
+            SIZE_T QuotaPeakPagedPoolUsage;
+            SIZE_T QuotaPagedPoolUsage;
+            SIZE_T QuotaPeakNonPagedPoolUsage;
+            SIZE_T QuotaNonPagedPoolUsage;
+            SIZE_T PagefileUsage;       // 即 PROCESS_MEMORY_COUNTERS_EX::PrivateUsage
+            SIZE_T PeakPagefileUsage;
+            SIZE_T PrivatePageCount;
+            LARGE_INTEGER ReadOperationCount;
+            LARGE_INTEGER WriteOperationCount;
+            LARGE_INTEGER OtherOperationCount;
+            LARGE_INTEGER ReadTransferCount;
+            LARGE_INTEGER WriteTransferCount;
+            LARGE_INTEGER OtherTransferCount;
+        };
+
+        NtQuerySystemInformationFn ResolveNtQuerySystemInformation()
+        {
+            // ntdll 总是已加载，按名称解析可以避免链接 ntdll.lib
+            static NtQuerySystemInformationFn function = []()
+                {
+                    HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+                    return ntdll ? reinterpret_cast<NtQuerySystemInformationFn>(GetProcAddress(ntdll, "NtQuerySystemInformation")) : nullptr;
+                }();
+
+            return function;
+        }
+
+        // 进程基本优先级由优先级类决定；无法打开句柄的进程以此作为优先级类
+        inline int PriorityClassFromBase(KPRIORITY basePriority) noexcept
+        {
+            if (basePriority >= 24) return REALTIME_PRIORITY_CLASS;
+            if (basePriority >= 13) return HIGH_PRIORITY_CLASS;
+            if (basePriority >= 10) return ABOVE_NORMAL_PRIORITY_CLASS;
+            if (basePriority >= 8) return NORMAL_PRIORITY_CLASS;
+            if (basePriority >= 6) return BELOW_NORMAL_PRIORITY_CLASS;
+            return basePriority > 0 ? IDLE_PRIORITY_CLASS : 0;
+        }
+
+        inline uint64_t MonotonicMilliseconds() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        inline uint64_t ToUInt64(const FILETIME& time) noexcept
+        {
+            ULARGE_INTEGER value;
+            value.LowPart = time.dwLowDateTime;
+            value.HighPart = time.dwHighDateTime;
+            return value.QuadPart;
+        }
+    }
+
+    SystemProcessSnapshot& SystemProcessSnapshot::Shared()
+    {
+        static SystemProcessSnapshot* snapshot = new SystemProcessSnapshot();
+        return *snapshot;
+    }
+
+    bool SystemProcessSnapshot::GetSummary(uint32_t maxAgeMs, SystemProcessSummary& summary)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (!EnsureFresh(maxAgeMs, 0)) return false;
+
+        summary = _summary;
+        return true;
+    }
+
+    bool SystemProcessSnapshot::CopySamples(std::vector<ProcessSample>& samples, size_t maxCount, uint32_t maxAgeMs,
+        uint64_t lastGeneration, SystemProcessSummary& summary)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        samples.clear();
+        if (!EnsureFresh(maxAgeMs, lastGeneration)) return false;
+
+        const size_t count = (std::min)(maxCount, _samples.size());
+        samples.assign(_samples.begin(), _samples.begin() + count);
+
+        summary = _summary;
+        return true;
+    }
+
+    bool SystemProcessSnapshot::EnsureFresh(uint32_t maxAgeMs, uint64_t lastGeneration)
+    {
+        if (_summary.Generation != 0 && _summary.Generation != lastGeneration &&
+            MonotonicMilliseconds() - _summary.SampleTick <= maxAgeMs)
+        {
+            return true;
+        }
+
+        return Refresh();
+    }
+
+    bool SystemProcessSnapshot::Refresh()
+    {
+        NtQuerySystemInformationFn query = ResolveNtQuerySystemInformation();
+        if (!query) return false;
+
+        if (_buffer.empty()) _buffer.resize(InitialBufferSize / sizeof(uint64_t));
+
+        NTSTATUS status = StatusInfoLengthMismatch;
+        for (int attempt = 0; attempt < MaxQueryAttempts && status == StatusInfoLengthMismatch; ++attempt)
+        {
+            ULONG required = 0;
+            status = query(SystemProcessInformationClass, _buffer.data(), static_cast<ULONG>(_buffer.size() * sizeof(uint64_t)), &required);
+
+            if (status == StatusInfoLengthMismatch)
+            {
+                _buffer.resize((static_cast<size_t>(required) + BufferHeadroom) / sizeof(uint64_t) + 1);
+            }
+        }
+
+        if (status < 0) return false;
+
+        // 系统时间紧随枚举读取，与进程时间构成同一时刻的分子与分母
+        FILETIME sysIdle, sysKernel, sysUser;
+        const uint64_t systemTime = GetSystemTimes(&sysIdle, &sysKernel, &sysUser) ? ToUInt64(sysKernel) : 0;
+
+        SystemProcessSummary summary{};
+        summary.SampleTick = MonotonicMilliseconds();
+        summary.SystemTime = systemTime;
+
+        _samples.clear();
+
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(_buffer.data());
+        size_t offset = 0;
+
+        // 单次遍历：逐进程填充采样并累计系统总数
+        while (true)
+        {
+            const NativeProcessInformation& info = *reinterpret_cast<const NativeProcessInformation*>(bytes + offset);
+
+            ProcessSample& sample = _samples.emplace_back();
+            sample.Pid = static_cast<uint32_t>(reinterpret_cast<ULONG_PTR>(info.UniqueProcessId));
+            sample.ThreadCount = info.NumberOfThreads;
+            sample.HandleCount = info.HandleCount;
+            sample.PriorityClass = PriorityClassFromBase(info.BasePriority);
+            sample.CreateTime = static_cast<uint64_t>(info.CreateTime.QuadPart);
+            sample.KernelTime = static_cast<uint64_t>(info.KernelTime.QuadPart);
+            sample.UserTime = static_cast<uint64_t>(info.UserTime.QuadPart);
+            sample.ReadBytes = static_cast<uint64_t>(info.ReadTransferCount.QuadPart);
+            sample.WriteBytes = static_cast<uint64_t>(info.WriteTransferCount.QuadPart);
+            sample.PrivateBytes = info.PagefileUsage;
+            sample.WorkingSetBytes = info.WorkingSetSize;
+            sample.HasCounters = true;
+
+            // 空闲进程 (PID 0) 没有映像名；名称驻留为 UTF-8，已出现过的名称按宽字符直接命中
+            if (info.ImageName.Buffer && info.ImageName.Length > 0)
+            {
+                sample.NameId = Text::StringPool::Shared().Intern(std::wstring_view(info.ImageName.Buffer, info.ImageName.Length / sizeof(WCHAR)));
+            }
+            else if (sample.Pid == 0)
+            {
+                sample.NameId = Text::StringPool::Shared().Intern(std::string_view("System Idle Process"));
+            }
+
+            summary.ThreadCount += info.NumberOfThreads;
+            summary.HandleCount += info.HandleCount;
+
+            if (info.NextEntryOffset == 0) break;
+            offset += info.NextEntryOffset;
+        }
+
+        summary.ProcessCount = static_cast<uint32_t>(_samples.size());
+        summary.Generation = _summary.Generation + 1;
+        _summary = summary;
+
+        return true;
+    }
+}
+#endif
@@ -0,0 +1,89 @@
+﻿#pragma once
+#include <mutex>
+#include "ProcessTypes.h"
+
+namespace IronSight::Core::Native::System
+{
+	/// <summary>
+	/// 系统进程快照概要：系统级总数与采样时刻
+	/// </summary>
+	struct SystemProcessSummary
+	{
+		uint64_t Generation;            // 快照代数，每次重新枚举加 1
+		uint64_t SampleTick;            // 枚举时刻 (毫秒，单调时钟)
+		uint64_t SystemTime;            // 枚举时刻的系统累计 CPU 时间 (100 纳秒，含空闲)
+		uint32_t ProcessCount;          // 进程总数
+		uint32_t ThreadCount;           // 线程总数
+		uint32_t HandleCount;           // 句柄总数
+	};
+
+	/// <summary>
+	/// 系统进程快照 (Windows)
+	/// 一次 NtQuerySystemInformation(SystemProcessInformation) 调用取得全部进程的线程数、句柄数、创建时间、CPU 时间、
+	/// IO 与内存计数器，并在同一次遍历中累计进程/线程/句柄总数。
+	/// 性能快照与进程列表共享同一份枚举结果：不超过 maxAgeMs 的快照直接复用，不必各自再遍历一次进程表
+	/// </summary>
+	class SystemProcessSnapshot
+	{
+		public:
+		/// <summary>
+		/// 获取全局共享的快照 (刻意不析构，与采样线程的退出顺序无关)
+		/// </summary>
+		static SystemProcessSnapshot& Shared();
+
+		SystemProcessSnapshot() = default;
+
+		SystemProcessSnapshot(const SystemProcessSnapshot&) = delete;
+		SystemProcessSnapshot& operator=(const SystemProcessSnapshot&) = delete;
+
+		/// <summary>
+		/// 获取系统级总数，快照早于 maxAgeMs 时重新枚举
+		/// </summary>
+		/// <returns>枚举失败返回 false</returns>
+		bool GetSummary(uint32_t maxAgeMs, SystemProcessSummary& summary);
+
+		/// <summary>
+		/// 复制逐进程采样 (计数器均已填充，HasCounters 为 true)，samples 会被清空后重新填充
+		/// 快照早于 maxAgeMs，或其代数等于 lastGeneration (调用方已经用过这一份) 时重新枚举，
+		/// 保证同一调用方两次采集之间的时间差不为 0
+		/// </summary>
+		/// <param name="maxCount">最多复制的进程数 (总数不受影响)</param>
+		/// <returns>枚举失败返回 false</returns>
+		bool CopySamples(std::vector<ProcessSample>& samples, size_t maxCount, uint32_t maxAgeMs,
+			uint64_t lastGeneration, SystemProcessSummary& summary);
+
+		/// <summary>
+		/// 在快照锁内直接读取逐进程采样，不复制；新鲜度规则与 CopySamples 相同
+		/// visit 接收 (采样数组, 概要) 的只读引用，执行期间阻塞其他调用方，
+		/// 只适合单次遍历并保留少量结果的调用方，且不能再调用本快照的其他方法
+		/// </summary>
+		/// <returns>枚举失败返回 false (visit 不会被调用)</returns>
+		template <typename Visit>
+		bool VisitSamples(uint32_t maxAgeMs, uint64_t lastGeneration, Visit&& visit)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			if (!EnsureFresh(maxAgeMs, lastGeneration)) return false;
+
+			const std::vector<ProcessSample>& samples = _samples;
+			const SystemProcessSummary& summary = _summary;
+			visit(samples, summary);
+			return true;
+		}
+
+		private:
+		// 以下函数要求调用方已持有锁
+		bool EnsureFresh(uint32_t maxAgeMs, uint64_t lastGeneration);
+		bool Refresh();
+
+		std::mutex _mutex;
+		std::vector<uint64_t> _buffer;  // 按 8 字节对齐，跨周期复用
+		std::vector<ProcessSample> _samples;
+		SystemProcessSummary _summary{};
+
+		// 两次查询之间新建的进程会使所需大小增长，扩容时预留余量以免反复重试
+		static constexpr size_t InitialBufferSize = 512 * 1024;
+		static constexpr size_t BufferHeadroom = 64 * 1024;
+		static constexpr int MaxQueryAttempts = 4;
+	};
+}
@@ -0,0 +1,24 @@
+﻿#pragma once
+
+namespace IronSight::Core::Native::System
+{
+	/**
+	* 结构体: SystemPerformanceSnapshot
+	* 功能: 存储系统级的性能深度快照数据
+	* 规范: PascalCase (与 C# 保持同步)
+	*/
+#pragma pack(push, 8)
+	struct SystemPerformanceSnapshot
+	{
+		double CpuUsage;                // 总 CPU 使用率 (%)
+		double CpuTemperature;          // CPU 温度 (Celsius) - 注意：某些硬件可能返回 0
+		double MemoryUsagePercent;      // 内存占用率 (%)
+		double TotalPhysicalMemoryMB;   // 总物理内存 (MB)
+		double AvailablePhysicalMemoryMB; // 可用物理内存 (MB)
+		uint32_t ProcessCount;          // 当前运行进程数
+		uint32_t ThreadCount;           // 当前总线程数
+		uint32_t HandleCount;           // 系统总句柄数
+		double CommittedBytesMB;        // 已提交页面内存 (MB)
+	};
+#pragma pack(pop)
+}
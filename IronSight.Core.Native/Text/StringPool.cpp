@@ -0,0 +1,309 @@
+﻿#include <pch.h>
+#include "StringPool.h"
+#include <cstring>
+#include <mutex>
+
+namespace IronSight::Core::Native::Text
+{
+    namespace
+    {
+        constexpr char32_t ReplacementCharacter = 0xFFFD;
+
+        // 依次取出宽字符串中的码点：wchar_t 为 16 位时按 UTF-16 解码，为 32 位时按 UTF-32 处理
+        template <typename Callback>
+        void ForEachCodePoint(std::wstring_view wide, Callback&& callback)
+        {
+            for (size_t i = 0; i < wide.size(); ++i)
+            {
+                char32_t unit = static_cast<char32_t>(wide[i]);
+
+                if constexpr (sizeof(wchar_t) == 2)
+                {
+                    if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < wide.size())
+                    {
+                        char32_t low = static_cast<char32_t>(wide[i + 1]);
+                        if (low >= 0xDC00 && low <= 0xDFFF)
+                        {
+                            callback(0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+                            ++i;
+                            continue;
+                        }
+                    }
+                }
+
+                // 孤立的代理项与超出范围的值均不是合法码点
+                if ((unit >= 0xD800 && unit <= 0xDFFF) || unit > 0x10FFFF) unit = ReplacementCharacter;
+                callback(unit);
+            }
+        }
+
+        inline size_t EncodeCodePoint(char32_t codePoint, char* output) noexcept
+        {
+            if (codePoint < 0x80)
+            {
+                output[0] = static_cast<char>(codePoint);
+                return 1;
+            }
+            if (codePoint < 0x800)
+            {
+                output[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+                output[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                return 2;
+            }
+            if (codePoint < 0x10000)
+            {
+                output[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+                output[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                output[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                return 3;
+            }
+
+            output[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+            output[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            output[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            output[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 4;
+        }
+    }
+
+    StringPool& StringPool::Shared()
+    {
+        static StringPool* pool = new StringPool();
+        return *pool;
+    }
+
+    StringPool::StringPool()
+        : _utf8Index(InitialIndexCapacity),
+        _wideIndex(InitialIndexCapacity)
+    {
+        // ID 0 固定为空字符串
+        _entries.push_back({ "", 0 });
+    }
+
+    uint32_t StringPool::Intern(std::string_view utf8)
+    {
+        if (utf8.empty() || utf8.size() >= UINT32_MAX) return 0;
+
+        const uint32_t hash = HashUtf8(utf8);
+
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            if (uint32_t id = FindUtf8(utf8, hash)) return id;
+        }
+
+        // 升级为独占锁后重新查找：其他线程可能已经插入了同一个字符串
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        if (uint32_t id = FindUtf8(utf8, hash)) return id;
+
+        return Append(utf8, hash);
+    }
+
+    uint32_t StringPool::Intern(std::wstring_view wide)
+    {
+        if (wide.empty() || wide.size() >= UINT32_MAX / 4) return 0;
+
+        const uint32_t wideHash = HashWide(wide);
+
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            if (uint32_t id = FindWide(wide, wideHash)) return id;
+        }
+
+        // 首次出现：在锁外完成编码转换
+        std::string utf8;
+        EncodeUtf8(wide, utf8);
+        const uint32_t hash = HashUtf8(utf8);
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        if (uint32_t id = FindWide(wide, wideHash)) return id;
+
+        uint32_t id = FindUtf8(utf8, hash);
+        if (id == 0) id = Append(utf8, hash);
+
+        if ((_wideCount + 1) * 2 > _wideIndex.size())
+        {
+            std::vector<Slot> grown(_wideIndex.size() * 2);
+            for (const Slot& slot : _wideIndex)
+            {
+                if (slot.Id != 0) Insert(grown, slot.Hash, slot.Id);
+            }
+            _wideIndex.swap(grown);
+        }
+
+        Insert(_wideIndex, wideHash, id);
+        ++_wideCount;
+        return id;
+    }
+
+    std::string_view StringPool::Get(uint32_t id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+
+        if (id >= _entries.size()) return {};
+
+        // 数据位于不会移动的内存块中，返回的视图在解锁后仍然有效
+        const Entry& entry = _entries[id];
+        return std::string_view(entry.Data, entry.Length);
+    }
+
+    size_t StringPool::Count() const
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return _entries.size();
+    }
+
+    uint32_t StringPool::HashUtf8(std::string_view utf8) noexcept
+    {
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        for (char c : utf8)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    uint32_t StringPool::HashWide(std::wstring_view wide) noexcept
+    {
+        uint32_t hash = 2166136261u;
+        for (wchar_t c : wide)
+        {
+            hash ^= static_cast<uint32_t>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    bool StringPool::EqualsWide(std::string_view utf8, std::wstring_view wide) noexcept
+    {
+        // 逐码点编码后与已存储的 UTF-8 比较，无需分配临时字符串
+        size_t position = 0;
+        bool equal = true;
+
+        ForEachCodePoint(wide, [&](char32_t codePoint)
+            {
+                if (!equal) return;
+
+                char bytes[4];
+                size_t count = EncodeCodePoint(codePoint, bytes);
+
+                if (position + count > utf8.size() || std::memcmp(utf8.data() + position, bytes, count) != 0) equal = false;
+                position += count;
+            });
+
+        return equal && position == utf8.size();
+    }
+
+    void StringPool::EncodeUtf8(std::wstring_view wide, std::string& utf8)
+    {
+        utf8.clear();
+        utf8.reserve(wide.size());
+
+        ForEachCodePoint(wide, [&](char32_t codePoint)
+            {
+                char bytes[4];
+                utf8.append(bytes, EncodeCodePoint(codePoint, bytes));
+            });
+    }
+
+    uint32_t StringPool::FindUtf8(std::string_view utf8, uint32_t hash) const noexcept
+    {
+        const size_t mask = _utf8Index.size() - 1;
+
+        for (size_t index = hash & mask;; index = (index + 1) & mask)
+        {
+            const Slot& slot = _utf8Index[index];
+            if (slot.Id == 0) return 0;
+            if (slot.Hash != hash) continue;
+
+            const Entry& entry = _entries[slot.Id];
+            if (entry.Length == utf8.size() && std::memcmp(entry.Data, utf8.data(), utf8.size()) == 0) return slot.Id;
+        }
+    }
+
+    uint32_t StringPool::FindWide(std::wstring_view wide, uint32_t hash) const noexcept
+    {
+        const size_t mask = _wideIndex.size() - 1;
+
+        for (size_t index = hash & mask;; index = (index + 1) & mask)
+        {
+            const Slot& slot = _wideIndex[index];
+            if (slot.Id == 0) return 0;
+            if (slot.Hash != hash) continue;
+
+            const Entry& entry = _entries[slot.Id];
+            if (EqualsWide(std::string_view(entry.Data, entry.Length), wide)) return slot.Id;
+        }
+    }
+
+    uint32_t StringPool::Append(std::string_view utf8, uint32_t hash)
+    {
+        const size_t size = utf8.size() + 1;
+        char* data = nullptr;
+
+        if (size > ChunkSize)
+        {
+            // 超长字符串独占一个内存块，不影响当前块的剩余空间
+            _chunks.push_back(std::make_unique<char[]>(size));
+            data = _chunks.back().get();
+        }
+        else
+        {
+            if (!_current || _chunkUsed + size > ChunkSize)
+            {
+                _chunks.push_back(std::make_unique<char[]>(ChunkSize));
+                _current = _chunks.back().get();
+                _chunkUsed = 0;
+            }
+
+            data = _current + _chunkUsed;
+            _chunkUsed += size;
+        }
+
+        std::memcpy(data, utf8.data(), utf8.size());
+        data[utf8.size()] = '\0';
+
+        const uint32_t id = static_cast<uint32_t>(_entries.size());
+        _entries.push_back({ data, static_cast<uint32_t>(utf8.size()) });
+
+        // 索引中的项数为 _entries.size() - 1 (空字符串不入索引)，负载因子不超过 1/2
+        if (_entries.size() * 2 > _utf8Index.size())
+        {
+            std::vector<Slot> grown(_utf8Index.size() * 2);
+            for (const Slot& slot : _utf8Index)
+            {
+                if (slot.Id != 0) Insert(grown, slot.Hash, slot.Id);
+            }
+            _utf8Index.swap(grown);
+        }
+
+        Insert(_utf8Index, hash, id);
+        return id;
+    }
+
+    void StringPool::Insert(std::vector<Slot>& index, uint32_t hash, uint32_t id)
+    {
+        const size_t mask = index.size() - 1;
+
+        size_t position = hash & mask;
+        while (index[position].Id != 0) position = (position + 1) & mask;
+
+        index[position] = { hash, id };
+    }
+
+    extern "C"
+    {
+        const char* StringPool_Get(uint32_t id, uint32_t* length)
+        {
+            std::string_view value = StringPool::Shared().Get(id);
+            if (length) *length = static_cast<uint32_t>(value.size());
+            return value.empty() ? "" : value.data();
+        }
+
+        uint32_t StringPool_GetCount()
+        {
+            return static_cast<uint32_t>(StringPool::Shared().Count());
+        }
+    }
+}
@@ -0,0 +1,99 @@
+﻿#pragma once
+#include <shared_mutex>
+#include <string_view>
+
+namespace IronSight::Core::Native::Text
+{
+	/// <summary>
+	/// 追加式字符串驻留池 (UTF-8)
+	/// 相同内容只存一份，以 32 位 ID 引用；字符串写入分块的内存区后永不移动也不释放，
+	/// 因此 ID 与 Get 返回的指针在 DLL 生命周期内始终有效，行结构只需携带 ID。
+	/// ID 0 固定表示空字符串。线程安全：查找持共享锁，只有首次出现的字符串需要独占锁
+	/// </summary>
+	class StringPool
+	{
+		public:
+		/// <summary>
+		/// 获取全局共享的驻留池 (刻意不析构：导出的指针在卸载前必须保持有效)
+		/// </summary>
+		static StringPool& Shared();
+
+		StringPool();
+
+		StringPool(const StringPool&) = delete;
+		StringPool& operator=(const StringPool&) = delete;
+
+		/// <summary>
+		/// 驻留 UTF-8 字符串，返回其 ID
+		/// </summary>
+		uint32_t Intern(std::string_view utf8);
+
+		/// <summary>
+		/// 驻留宽字符串 (Windows 为 UTF-16)，返回其 ID
+		/// 以宽字符内容建立独立索引，已出现过的字符串无需再做编码转换；无效的代理项替换为 U+FFFD
+		/// </summary>
+		uint32_t Intern(std::wstring_view wide);
+
+		/// <summary>
+		/// 按 ID 取字符串 (以 0 结尾)，ID 无效时返回空字符串
+		/// </summary>
+		std::string_view Get(uint32_t id) const;
+
+		/// <summary>
+		/// 已驻留的字符串数量 (含 ID 0 的空字符串)
+		/// </summary>
+		size_t Count() const;
+
+		private:
+		struct Entry
+		{
+			const char* Data;
+			uint32_t Length;
+		};
+
+		// 开放寻址索引的槽位：Id 为 0 表示空槽 (空字符串不进入索引)
+		struct Slot
+		{
+			uint32_t Hash;
+			uint32_t Id;
+		};
+
+		static uint32_t HashUtf8(std::string_view utf8) noexcept;
+		static uint32_t HashWide(std::wstring_view wide) noexcept;
+		static bool EqualsWide(std::string_view utf8, std::wstring_view wide) noexcept;
+		static void EncodeUtf8(std::wstring_view wide, std::string& utf8);
+
+		// 以下函数要求调用方已持有锁
+		uint32_t FindUtf8(std::string_view utf8, uint32_t hash) const noexcept;
+		uint32_t FindWide(std::wstring_view wide, uint32_t hash) const noexcept;
+		uint32_t Append(std::string_view utf8, uint32_t hash);
+		static void Insert(std::vector<Slot>& index, uint32_t hash, uint32_t id);
+
+		mutable std::shared_mutex _mutex;
+		std::vector<Entry> _entries;
+		std::vector<Slot> _utf8Index;
+		std::vector<Slot> _wideIndex;
+		size_t _wideCount = 0;
+		std::vector<std::unique_ptr<char[]>> _chunks;
+		char* _current = nullptr;     // 当前正在填充的内存块
+		size_t _chunkUsed = 0;
+
+		static constexpr size_t ChunkSize = 64 * 1024;
+		static constexpr size_t InitialIndexCapacity = 1024;
+	};
+
+	extern "C"
+	{
+		/// <summary>
+		/// 按 ID 取驻留的 UTF-8 字符串，指针在 DLL 卸载前始终有效
+		/// </summary>
+		/// <param name="length">输出：字节数 (不含结尾的 0)，可为空</param>
+		/// <returns>ID 无效时返回空字符串</returns>
+		__declspec(dllexport) const char* StringPool_Get(uint32_t id, uint32_t* length);
+
+		/// <summary>
+		/// 已驻留的字符串数量
+		/// </summary>
+		__declspec(dllexport) uint32_t StringPool_GetCount();
+	}
+}
@@ -0,0 +1,101 @@
+﻿#include <pch.h>
+#include "WorkerPool.h"
+#include <algorithm>
+
+namespace IronSight::Core::Native::Threading
+{
+    WorkerPool::WorkerPool(unsigned workerCount)
+    {
+        if (workerCount == 0)
+        {
+            // 调用线程也参与执行，自动模式下再开 (处理器数 - 1) 个线程，且不超过上限
+            unsigned processors = (std::max)(std::thread::hardware_concurrency(), 1u);
+            workerCount = (std::min)(processors - 1, MaxAutoWorkers);
+        }
+
+        _threads.reserve(workerCount);
+        for (unsigned i = 0; i < workerCount; ++i)
+        {
+            _threads.emplace_back(&WorkerPool::ThreadProc, this);
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _isStopping = true;
+        }
+
+        _wakeup.notify_all();
+
+        for (auto& thread : _threads)
+        {
+            if (thread.joinable()) thread.join();
+        }
+    }
+
+    void WorkerPool::ParallelFor(size_t count, size_t chunkSize, const RangeFunction& body)
+    {
+        if (count == 0) return;
+        if (chunkSize == 0) chunkSize = 1;
+
+        if (_threads.empty() || count <= chunkSize)
+        {
+            body(0, count);
+            return;
+        }
+
+        std::lock_guard<std::mutex> callLock(_callMutex);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _body = &body;
+            _count = count;
+            _chunkSize = chunkSize;
+            _nextIndex.store(0);
+            _pendingWorkers = static_cast<unsigned>(_threads.size());
+            ++_jobGeneration;
+        }
+
+        _wakeup.notify_all();
+        RunChunks();
+
+        // 调用线程领完任务后等待其余线程结束各自正在处理的块
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finished.wait(lock, [this]() { return _pendingWorkers == 0; });
+        _body = nullptr;
+    }
+
+    void WorkerPool::RunChunks()
+    {
+        while (true)
+        {
+            size_t begin = _nextIndex.fetch_add(_chunkSize);
+            if (begin >= _count) return;
+
+            (*_body)(begin, (std::min)(begin + _chunkSize, _count));
+        }
+    }
+
+    void WorkerPool::ThreadProc()
+    {
+        uint64_t seenGeneration = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wakeup.wait(lock, [&]() { return _isStopping || _jobGeneration != seenGeneration; });
+
+                if (_isStopping) return;
+                seenGeneration = _jobGeneration;
+            }
+
+            RunChunks();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_pendingWorkers == 0) _finished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+namespace IronSight::Core::Native::Threading
+{
+	/// <summary>
+	/// 常驻的小型工作线程池，用于把一批独立的任务按块分发到多个线程
+	/// 调用线程同样参与执行；任务按原子计数领取，执行期间不持有任何锁
+	/// </summary>
+	class WorkerPool
+	{
+		public:
+		// 处理 [begin, end) 区间的任务
+		using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+		/// <summary>
+		/// 创建线程池
+		/// </summary>
+		/// <param name="workerCount">工作线程数 (不含调用线程)，0 表示按处理器数量自动选择</param>
+		explicit WorkerPool(unsigned workerCount = 0);
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		/// <summary>
+		/// 并行处理 count 个任务，每次领取 chunkSize 个，全部完成后返回
+		/// 任务较少或没有工作线程时直接在调用线程上执行
+		/// </summary>
+		void ParallelFor(size_t count, size_t chunkSize, const RangeFunction& body);
+
+		unsigned WorkerCount() const noexcept { return static_cast<unsigned>(_threads.size()); }
+
+		private:
+		void ThreadProc();
+		void RunChunks();
+
+		std::vector<std::thread> _threads;
+
+		std::mutex _callMutex;              // 串行化 ParallelFor 的调用方
+		std::mutex _mutex;                  // 保护任务的发布与完成计数 (不在执行期间持有)
+		std::condition_variable _wakeup;
+		std::condition_variable _finished;
+		uint64_t _jobGeneration = 0;
+		unsigned _pendingWorkers = 0;
+		bool _isStopping = false;
+
+		// 当前任务，发布后到全部完成前只读
+		const RangeFunction* _body = nullptr;
+		size_t _count = 0;
+		size_t _chunkSize = 1;
+		std::atomic<size_t> _nextIndex{ 0 };
+
+		static constexpr unsigned MaxAutoWorkers = 4;
+	};
+}
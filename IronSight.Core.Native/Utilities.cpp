@@ -3,7 +3,6 @@
 
 namespace Utils 
 {
-    static LogDispatcherCallback g_LogCallback = nullptr;
 
     extern "C" BOOL EnableDebugPrivilege(BOOL enableFlag) 
     {
@@ -35,13 +34,31 @@ namespace Utils
 
     extern "C" void RegisterLogCallback(LogDispatcherCallback callback) 
     {
-        g_LogCallback = callback;
+        IronSight::Core::Native::Logging::SetCallback(callback);
+    }
+
+    extern "C" void FlushLogs()
+    {
+        IronSight::Core::Native::Logging::Flush();
+    }
+
+    extern "C" void ShutdownLogging()
+    {
+        IronSight::Core::Native::Logging::Shutdown();
+    }
+
+    extern "C" void SetLogLevel(LogLevel level)
+    {
+        IronSight::Core::Native::Logging::SetMinimumLevel(level);
     }
 
     extern "C" int DebugPrintEx(LogLevel level, const char* format, ...) 
     {
         if (!format) return -1;
 
+        // 被运行时级别过滤的日志不做格式化
+        if (level != LogLevel::Fatal && !IronSight::Core::Native::Logging::IsEnabled(level)) return 0;
+
         char buffer[4096]; // 足够大的缓冲区
         va_list args;
         va_start(args, format);
@@ -50,14 +67,8 @@ namespace Utils
 
         if (result > 0) 
         {
-            // 1. 发送到系统调试器 (OutputDebugString)
-            OutputDebugStringA(buffer);
-
-            // 2. 发送到 C# 分发器
-            if (g_LogCallback) 
-            {
-                g_LogCallback(level, buffer);
-            }
+            // 格式串可能不是字面量，这里直接格式化；发送到系统调试器与 C# 分发器由日志线程完成
+            IronSight::Core::Native::Logging::Log(level, nullptr, static_cast<const char*>(buffer));
         }
         return result;
     }
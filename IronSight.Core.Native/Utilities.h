@@ -1,22 +1,9 @@
 ﻿#pragma once
+#include "Logging/Log.h"
 
 namespace Utils
 { // 建议放入命名空间，保持一致性
 
-	// 显式继承 uint32_t 确保与 C# UInt32 对齐
-	enum class LogLevel : uint32_t
-	{
-		Trace = 0,
-		Debug = 1,
-		Info = 2,
-		Warn = 3,
-		Error = 4,
-		Fatal = 5
-	};
-
-	// 回调签名：使用 __stdcall (WinAPI 标准) 确保堆栈平衡
-	typedef void(__stdcall* LogDispatcherCallback)(LogLevel level, const char* message);
-
 	extern "C"
 	{
 		/// <summary>
@@ -25,8 +12,27 @@ namespace Utils
 		/// <param name="callback">要注册的回调函数（类型为 LogDispatcherCallback）。当有日志消息需要分发时将调用该回调。调用时机、线程语境和生命周期由实现决定。</param>
 		__declspec(dllexport) void RegisterLogCallback(LogDispatcherCallback callback);
 
+		/// <summary>
+		/// 同步处理所有已提交但尚未分发的日志（例如进程退出前调用）。
+		/// </summary>
+		__declspec(dllexport) void FlushLogs();
+
+		/// <summary>
+		/// 停止并等待后台日志线程，再同步处理剩余的日志（托管端在进程退出时调用，不能在 DllMain 中调用）。
+		/// 之后产生的日志只在调用 FlushLogs 时送达。
+		/// </summary>
+		__declspec(dllexport) void ShutdownLogging();
+
+		/// <summary>
+		/// 设置原生日志的运行时最低级别，低于该级别的日志在格式化之前即被丢弃。
+		/// 低于编译期级别 (IRONSIGHT_LOG_MIN_LEVEL) 的调用点已被编译掉，调低此值不会使其恢复。
+		/// </summary>
+		/// <param name="level">最低级别（默认 Trace，即不额外过滤）。</param>
+		__declspec(dllexport) void SetLogLevel(LogLevel level);
+
 		/// <summary>
 		/// 导出函数：打印日志到Debug Output中，具有扩展功能。
+		/// 在调用线程上格式化，输出到调试器与回调由后台日志线程完成。
 		/// </summary>
 		/// <param name="level">指示日志的级别。</param>
 		/// <param name="format">用于格式化日志的字符串。</param>
@@ -42,18 +48,3 @@ namespace Utils
 		__declspec(dllexport) BOOL EnableDebugPrivilege(BOOL enableFlag);
 	}
 }
-
-// 定义便捷宏，方便在 C++ 内部调用
-#define LOG_INFO(fmt, ...)  Utils::DebugPrintEx(Utils::LogLevel::Info,  fmt, ##__VA_ARGS__)
-#define LOG_ERROR(fmt, ...) Utils::DebugPrintEx(Utils::LogLevel::Error, fmt, ##__VA_ARGS__)
-#define LOG_WARN(fmt, ...)  Utils::DebugPrintEx(Utils::LogLevel::Warn,  fmt, ##__VA_ARGS__)
-#define LOG_FATAL(fmt, ...) Utils::DebugPrintEx(Utils::LogLevel::Fatal, fmt, ##__VA_ARGS__)
-
-
-#ifdef _DEBUG
-#define LOG_TRACE(fmt, ...) Utils::DebugPrintEx(Utils::LogLevel::Trace, fmt, ##__VA_ARGS__)
-#define LOG_DEBUG(fmt, ...) Utils::DebugPrintEx(Utils::LogLevel::Debug, fmt, ##__VA_ARGS__)
-#else
-#define LOG_TRACE(fmt, ...) ((void)0)
-#define LOG_DEBUG(fmt, ...) ((void)0)
-#endif
\ No newline at end of file
@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#if defined(_WIN32)
+
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #endif
@@ -26,15 +28,24 @@
 #include <fileapi.h>
 #include <sysinfoapi.h>
 
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "IPHLPAPI.lib")
+#pragma comment(lib, "Pdh.lib")
+#pragma comment(lib, "advapi32.lib")
+
+#else
+
+// 非 Windows 平台只编译与平台无关的模块 (Linux 上的测试与基准程序)，MSVC 扩展关键字在此置空
+#define __declspec(x) __attribute__((visibility("default")))
+#define __stdcall
+
+#endif
+
 // 标准库
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
 #include <thread>
 #include <atomic>
-
-#pragma comment(lib, "ws2_32.lib")
-#pragma comment(lib, "IPHLPAPI.lib")
-#pragma comment(lib, "Pdh.lib")
-#pragma comment(lib, "advapi32.lib")
\ No newline at end of file
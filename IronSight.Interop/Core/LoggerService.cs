@@ -27,12 +27,37 @@ namespace IronSight.Interop.Core
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Ansi)]
         private static extern void RegisterLogCallback(LogDispatcherCallback callback);
 
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void FlushLogs();
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void ShutdownLogging();
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void SetLogLevel(LogLevel level);
+
         public static void Log(LogLevel level, string message)
         {
             // Same logic as callback
             WriteLog(level, message);
         }
 
+        /// <summary>
+        /// 原生日志由后台线程批量分发，调用此方法立即送达所有已提交的日志
+        /// </summary>
+        public static void Flush()
+        {
+            FlushLogs();
+        }
+
+        /// <summary>
+        /// 设置原生日志的最低级别，低于该级别的日志在原生层格式化之前即被丢弃
+        /// </summary>
+        public static void SetMinimumLevel(LogLevel level)
+        {
+            SetLogLevel(level);
+        }
+
         private static void WriteLog(LogLevel level, string message)
         {
 #if !DEBUG
@@ -65,7 +90,17 @@ namespace IronSight.Interop.Core
 
                 RegisterLogCallback(_nativeCallback);
 
+                // 进程退出前送达原生层尚未分发的日志
+                AppDomain.CurrentDomain.ProcessExit -= OnProcessExit;
+                AppDomain.CurrentDomain.ProcessExit += OnProcessExit;
+
             }
         }
+
+        private static void OnProcessExit(object? sender, EventArgs e)
+        {
+            // 停止并等待原生日志线程，送达尚未分发的日志 (DllMain 中无法等待线程，只能在这里做)
+            ShutdownLogging();
+        }
     }
 }
\ No newline at end of file
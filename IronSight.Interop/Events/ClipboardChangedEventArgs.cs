@@ -0,0 +1,23 @@
+﻿using System;
+
+namespace IronSight.Interop.Events
+{
+    public class ClipboardChangedEventArgs : EventArgs
+    {
+        /// <summary>
+        /// 原生剪贴板历史条目 ID，同一内容再次复制时不变；内容过大未保存时为 0
+        /// </summary>
+        public ulong EntryId { get; }
+
+        /// <summary>
+        /// 条目文本，EntryId 为 0 或内容不是文本时为 null (需要时自行读取剪贴板)
+        /// </summary>
+        public string? Text { get; }
+
+        public ClipboardChangedEventArgs(ulong entryId, string? text)
+        {
+            EntryId = entryId;
+            Text = text;
+        }
+    }
+}
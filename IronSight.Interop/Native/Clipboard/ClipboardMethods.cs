@@ -1,17 +1,76 @@
-using System;
+﻿using System;
 using System.Runtime.InteropServices;
 
 namespace IronSight.Interop.Native.Clipboard
 {
+    /// <summary>
+    /// 剪贴板内容格式 (与 C++ ClipboardFormat 保持同步)
+    /// </summary>
+    public enum ClipboardFormat : uint
+    {
+        None = 0,
+        Text = 1
+    }
+
+    /// <summary>
+    /// 原生剪贴板历史中的一条内容 (与 C++ ClipboardEntryInfo 保持同步)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
+    public struct ClipboardEntryInfo
+    {
+        public ulong Id;
+        public ulong Hash;
+        public long TimestampMs;
+        public uint Size;
+        public ClipboardFormat Format;
+    }
+
     public static class ClipboardMethods
     {
+        /// <summary>
+        /// 剪贴板内容确实变化时调用，entryId 为原生历史条目 ID (内容过大未保存时为 0)
+        /// </summary>
         [UnmanagedFunctionPointer(CallingConvention.StdCall)]
-        public delegate void OnClipboardChangedCallback();
+        public delegate void OnClipboardChangedCallback(ulong entryId);
 
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
         public static extern bool StartClipboardListener(OnClipboardChangedCallback callback);
 
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
         public static extern void StopClipboardListener();
+
+        /// <summary>
+        /// 按 ID 取历史条目，data 指向原生内存；成功时读取完毕后必须调用 ClipboardHistory_Release
+        /// </summary>
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool ClipboardHistory_Acquire(ulong id, out ClipboardEntryInfo info, out IntPtr data);
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ClipboardHistory_Release();
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint ClipboardHistory_List([Out] ClipboardEntryInfo[] buffer, nuint maxCount);
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ClipboardHistory_Clear();
+
+        /// <summary>
+        /// 直接从原生历史解码条目文本 (不经过系统剪贴板)，条目不存在或不是文本时返回 null
+        /// </summary>
+        public static string? GetText(ulong id)
+        {
+            if (id == 0 || !ClipboardHistory_Acquire(id, out ClipboardEntryInfo info, out IntPtr data)) return null;
+
+            try
+            {
+                if (info.Format != ClipboardFormat.Text) return null;
+                return info.Size == 0 ? string.Empty : Marshal.PtrToStringUTF8(data, checked((int)info.Size));
+            }
+            finally
+            {
+                ClipboardHistory_Release();
+            }
+        }
     }
-}
\ No newline at end of file
+}
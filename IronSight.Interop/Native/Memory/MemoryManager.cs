@@ -18,5 +18,15 @@ namespace IronSight.Interop.Native.Memory
                          .Where(p => p.WorkingSetMB > 0.1)
                          .ToList();
         }
+
+        /// <summary>
+        /// 按指定指标取前 limit 个进程 (按指标降序)
+        /// </summary>
+        public static List<ConsumerInfo> GetTopConsumers(ConsumerMetric metric, int limit = 10)
+        {
+            var buffer = new ConsumerInfo[limit];
+            int count = MemoryMethods.GetTopConsumers(metric, buffer, limit);
+            return buffer.Take(count).ToList();
+        }
     }
 }
@@ -4,6 +4,7 @@ using System.Linq;
 using System.Runtime.InteropServices;
 using System.Text;
 using System.Threading.Tasks;
+using IronSight.Interop.Native.Text;
 
 namespace IronSight.Interop.Native.Memory
 {
@@ -14,13 +15,68 @@ namespace IronSight.Interop.Native.Memory
         public long TotalBytesReleased;
     }
 
-    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    /// <summary>
+    /// 工作集回收参数 (与 C++ TrimOptions 保持同步)，字段为 0 时使用默认值
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
+    public struct TrimOptions
+    {
+        public ulong MinReclaimBytes;   // 预计回收量低于此值的进程跳过 (默认 8 MB)
+        public ulong TargetBytes;       // 累计回收达到此值后不再开始新的回收 (默认不限)
+        public uint MaxConcurrency;     // 同时回收的进程数上限 (默认 4)
+        public uint Reserved;
+    }
+
+    /// <summary>
+    /// 一次工作集回收的结果 (与 C++ TrimResult 保持同步)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
+    public struct TrimResult
+    {
+        public uint TrimmedProcesses;
+        public uint SkippedProcesses;
+        public uint FailedProcesses;
+        public uint Reserved;
+        public ulong ReleasedBytes;
+        public ulong ExpectedBytes;
+        public ulong ElapsedMicroseconds;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
     public struct ProcessInfo
     {
         public uint Pid;
+        public uint NameId;             // 进程名称 (字符串驻留池 ID)
         public double WorkingSetMB;
-        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 260)]
-        public string Name;
+
+        public string Name => NativeStringPool.Resolve(NameId);
+    }
+
+    /// <summary>
+    /// 进程排名依据 (与 C++ ConsumerMetric 保持同步)
+    /// </summary>
+    public enum ConsumerMetric : uint
+    {
+        WorkingSet = 0,
+        PrivateBytes = 1,
+        Cpu = 2,
+        IoRate = 3
+    }
+
+    /// <summary>
+    /// 排名结果中的一个进程 (与 C++ ConsumerInfo 保持同步)，四项指标均已填充
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
+    public struct ConsumerInfo
+    {
+        public uint Pid;
+        public uint NameId;             // 进程名称 (字符串驻留池 ID)
+        public double WorkingSetMB;
+        public double PrivateMB;
+        public double CpuUsage;         // CPU 占用 (%)
+        public double IoRateMBs;        // 磁盘读写合计 MB/s
+
+        public string Name => NativeStringPool.Resolve(NameId);
     }
 
     public static class MemoryMethods
@@ -35,8 +91,23 @@ namespace IronSight.Interop.Native.Memory
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern int GetTopMemoryConsumers([In, Out] ProcessInfo[] buffer, int maxCount);
 
+        // 按任意指标排名 (CPU 与磁盘速率相对于上一次调用计算)
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int GetTopConsumers(ConsumerMetric metric, [In, Out] ConsumerInfo[] buffer, int maxCount);
+
         // 还可以加上我们之前写的全量清理
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern CleanupResult CleanSystemMemory();
+
+        // 按预计回收量排序的并行回收 (阈值、目标回收量与并发上限)
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern TrimResult TrimSystemMemory(in TrimOptions options);
+
+        // 回收保护列表 (进程名须与枚举结果完全一致，如 "dwm.exe")
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void AddTrimProtectedName([MarshalAs(UnmanagedType.LPUTF8Str)] string name);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ClearTrimProtectedNames();
     }
 }
@@ -0,0 +1,57 @@
+﻿using System.Runtime.InteropServices;
+
+namespace IronSight.Interop.Native.Memory
+{
+    /// <summary>
+    /// 内存压力监视参数 (与 C++ MemoryPressureOptions 保持同步)，字段为 0 时使用默认值
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
+    public struct MemoryPressureOptions
+    {
+        public uint LowPercent;         // 可用内存低于此百分比时进入压力状态 (默认 10)
+        public uint HighPercent;        // 回升到此百分比时退出压力状态 (默认 20)
+        public uint MinIntervalMs;      // 两次回收之间的最短间隔 (默认 10 秒)
+        public uint PollIntervalMs;     // 检查可用内存的间隔 (默认 5 秒)
+        public ulong StepBytes;         // 单次回收的目标上限 (默认 256 MB)
+        public ulong MinReclaimBytes;   // 单个进程的预计回收量阈值 (默认 32 MB)
+        public uint MaxConcurrency;     // 同时回收的进程数上限 (默认 2)
+        public uint Reserved;
+    }
+
+    /// <summary>
+    /// 内存压力监视统计 (与 C++ MemoryPressureStats 保持同步)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
+    public struct MemoryPressureStats
+    {
+        public ulong Notifications;
+        public ulong PressureEpisodes;
+        public ulong ReclaimSteps;
+        public ulong ReleasedBytes;
+        public ulong AvailableBytes;
+        public ulong TotalBytes;
+        [MarshalAs(UnmanagedType.U1)] public bool IsRunning;
+        [MarshalAs(UnmanagedType.U1)] public bool IsUnderPressure;
+        [MarshalAs(UnmanagedType.U1)] public bool HasNotifications;
+        private byte _reserved0;
+        private uint _reserved1;
+    }
+
+    public static class MemoryPressureMethods
+    {
+        private const string DllName = "IronSight.Core.Native.dll";
+
+        /// <summary>
+        /// 启动内存压力驱动的自动回收 (已在运行时以新参数重新启动)
+        /// </summary>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool MemoryPressure_Start(in MemoryPressureOptions options);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void MemoryPressure_Stop();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void MemoryPressure_GetStats(out MemoryPressureStats stats);
+    }
+}
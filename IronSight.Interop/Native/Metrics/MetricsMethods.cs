@@ -0,0 +1,73 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace IronSight.Interop.Native.Metrics
+{
+    /// <summary>
+    /// 指标类型 (与 C++ MetricKind 保持同步)
+    /// </summary>
+    public enum MetricKind : uint
+    {
+        SystemCpu = 1,
+        SystemMemory = 2,
+        DiskRead = 3,
+        DiskWrite = 4,
+        ProcessCpu = 5,
+        ProcessMemory = 6,
+        ConnectionCount = 7
+    }
+
+    /// <summary>
+    /// 聚合分辨率 (与 C++ MetricResolution 保持同步)
+    /// </summary>
+    public enum MetricResolution : uint
+    {
+        Second = 0,
+        TenSeconds = 1,
+        Minute = 2
+    }
+
+    /// <summary>
+    /// 一个聚合桶：桶起始时间 (Unix 毫秒) 与桶内样本的最小/最大/平均值
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
+    public struct MetricPoint
+    {
+        public long TimestampMs;
+        public float Min;
+        public float Max;
+        public float Avg;
+        public uint Count;
+
+        public DateTimeOffset Timestamp => DateTimeOffset.FromUnixTimeMilliseconds(TimestampMs);
+    }
+
+    public static class MetricsMethods
+    {
+        private const string DllName = "IronSight.Core.Native.dll";
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint Metrics_Query(MetricKind kind, uint id, MetricResolution resolution,
+            long fromMs, long toMs, [In, Out] MetricPoint[] buffer, uint maxCount);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint Metrics_GetSeriesCount();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Metrics_Clear();
+
+        /// <summary>
+        /// 查询图表绘制窗口内的聚合点，按时间升序 (id：系统级指标为 0，进程级指标为 PID)
+        /// 点数不超过 maxPoints，窗口更长时保留最新的部分
+        /// </summary>
+        public static MetricPoint[] Query(MetricKind kind, uint id, MetricResolution resolution,
+            DateTimeOffset from, DateTimeOffset to, int maxPoints = 3600)
+        {
+            var buffer = new MetricPoint[maxPoints];
+            uint count = Metrics_Query(kind, id, resolution, from.ToUnixTimeMilliseconds(), to.ToUnixTimeMilliseconds(), buffer, (uint)buffer.Length);
+
+            if (count < buffer.Length) Array.Resize(ref buffer, (int)count);
+            return buffer;
+        }
+    }
+}
@@ -32,6 +32,73 @@ namespace IronSight.Interop.Native.Network
         Udp = 2
     }
 
+    /// <summary>
+    /// 连接变更类型枚举 (增量模式)
+    /// </summary>
+    public enum ConnectionChangeKind : int
+    {
+        Added = 1,
+        Removed = 2,
+        StateChanged = 3
+    }
+
+    /// <summary>
+    /// 地址族
+    /// </summary>
+    public enum AddressFamily : byte
+    {
+        Ipv4 = 4,
+        Ipv6 = 6
+    }
+
+    /// <summary>
+    /// 连接过滤条件位 (与 C++ ConnectionFilterFlags 保持同步)
+    /// </summary>
+    [Flags]
+    public enum ConnectionFilterFlags : uint
+    {
+        None = 0,
+        Protocol = 1 << 0,
+        State = 1 << 1,
+        LocalPort = 1 << 2,
+        RemotePort = 1 << 3,
+        LocalAddress = 1 << 4,
+        RemoteAddress = 1 << 5,
+        ProcessId = 1 << 6
+    }
+
+    /// <summary>
+    /// 地址前缀 (与 C++ AddressPrefix 布局一致)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct NativeAddressPrefix
+    {
+        public fixed byte Address[16];
+        public AddressFamily Family;
+        public byte PrefixLength;
+        public ushort Reserved;
+    }
+
+    /// <summary>
+    /// 连接过滤条件 (与 C++ ConnectionFilter 布局一致)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct NativeConnectionFilter
+    {
+        public ConnectionFilterFlags Flags;
+        public uint ProtocolMask;
+        public uint StateMask;
+        public ushort LocalPortMin;
+        public ushort LocalPortMax;
+        public ushort RemotePortMin;
+        public ushort RemotePortMax;
+        public NativeAddressPrefix LocalPrefix;
+        public NativeAddressPrefix RemotePrefix;
+        public IntPtr ProcessIds;
+        public uint ProcessIdCount;
+        public uint Reserved;
+    }
+
     /// <summary>
     /// 网络监控器Native互操作类
     /// </summary>
@@ -39,6 +106,11 @@ namespace IronSight.Interop.Native.Network
     {
         public const string DllName = "IronSight.Core.Native.dll";
 
+        /// <summary>
+        /// 期望的原生行格式版本 (与 C++ NetworkAbiVersion 保持同步)
+        /// </summary>
+        public const int AbiVersion = 2;
+
         #region P/Invoke Declarations
 
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
@@ -72,7 +144,117 @@ namespace IronSight.Interop.Native.Network
         [return: MarshalAs(UnmanagedType.I1)]
         public static extern bool NetworkMonitor_SetUpdateInterval(IntPtr monitor, uint intervalMs);
 
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool NetworkMonitor_SetIncrementalMode(IntPtr monitor, [MarshalAs(UnmanagedType.I1)] bool enabled);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern ulong NetworkMonitor_GetGeneration(IntPtr monitor);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkMonitor_GetDeltaCount(IntPtr monitor);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkMonitor_CopyDelta(IntPtr monitor, IntPtr buffer, nuint bufferSize, out ulong generation);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int NetworkConnectionDelta_GetSize();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int NetworkMonitor_GetAbiVersion();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int NetworkConnectionRow_GetSize();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int NetworkConnectionRowDelta_GetSize();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr NetworkMonitor_AcquireSnapshot(IntPtr monitor, out ulong version);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void NetworkMonitor_ReleaseSnapshot(IntPtr snapshot);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkSnapshot_GetRows(IntPtr snapshot, out IntPtr rows);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkSnapshot_GetAddresses(IntPtr snapshot, out IntPtr addresses);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkSnapshot_GetDelta(IntPtr snapshot, out IntPtr delta);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkSnapshot_GetProcessSummaries(IntPtr snapshot, out IntPtr summaries);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkSnapshot_GetListeningPorts(IntPtr snapshot, out IntPtr ports);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkMonitor_GetProcessCount(IntPtr monitor);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkMonitor_CopyProcessSummaries(IntPtr monitor, IntPtr buffer, nuint bufferSize);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ProcessConnectionSummary_GetSize();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkMonitor_CopyConnectionsFiltered(IntPtr monitor, in NativeConnectionFilter filter, IntPtr buffer, nuint bufferSize);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern unsafe nuint NetworkSnapshot_Query(IntPtr snapshot, in NativeConnectionFilter filter, uint* indices, nuint capacity);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConnectionFilter_GetSize();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool NetworkMonitor_FindPortOwner(IntPtr monitor, ushort port, ProtocolType protocol, out uint processId);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern unsafe nuint NetworkSnapshot_FindByLocalPort(IntPtr snapshot, ushort port, uint* indices, nuint capacity);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkSnapshot_FindByProcess(IntPtr snapshot, uint processId, out uint firstRow);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern ulong NetworkSnapshot_GetTimestamp(IntPtr snapshot);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkSnapshot_GetFirstSeen(IntPtr snapshot, out IntPtr firstSeen);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkSnapshot_GetProcessChurn(IntPtr snapshot, out IntPtr churn);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint NetworkMonitor_CopyClosedConnections(IntPtr monitor, IntPtr buffer, nuint bufferSize, ulong afterSequence);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ClosedConnectionRecord_GetSize();
+
         #endregion // P/Invoke Declarations
     }
+
+    /// <summary>
+    /// 原生 NetworkMonitor 句柄
+    /// 每个未释放的快照都持有一次引用，Dispose 后要等最后一个快照释放才真正销毁监控器，
+    /// 因此快照指向的内存不会先于快照失效
+    /// </summary>
+    internal sealed class NetworkMonitorHandle : SafeHandle
+    {
+        public NetworkMonitorHandle(IntPtr monitor) : base(IntPtr.Zero, ownsHandle: true)
+        {
+            SetHandle(monitor);
+        }
+
+        public override bool IsInvalid => handle == IntPtr.Zero;
+
+        protected override bool ReleaseHandle()
+        {
+            NetworkMethods.NetworkMonitor_Destroy(handle);
+            return true;
+        }
+    }
 }
 
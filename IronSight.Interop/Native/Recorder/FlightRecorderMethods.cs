@@ -0,0 +1,183 @@
+﻿using System;
+using System.IO;
+using System.Runtime.InteropServices;
+using IronSight.Interop.Native.System;
+using IronSight.Interop.Services;
+
+namespace IronSight.Interop.Native.Recorder
+{
+    /// <summary>
+    /// 录制统计 (与 C++ FlightRecorderStats 保持同步)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
+    public struct FlightRecorderStats
+    {
+        public ulong FramesWritten;
+        public ulong BytesWritten;
+        public ulong RawBytes;
+        public ulong EncodeMicroseconds;
+        public uint SegmentCount;
+        public uint IsRecording;
+
+        /// <summary>
+        /// 原生结构字节数与磁盘字节数之比
+        /// </summary>
+        public double CompressionRatio => BytesWritten == 0 ? 0 : (double)RawBytes / BytesWritten;
+    }
+
+    public static class FlightRecorderMethods
+    {
+        private const string DllName = "IronSight.Core.Native.dll";
+
+        /// <summary>
+        /// 默认录制目录 (%LocalAppData%\IronSight\FlightRecords)
+        /// </summary>
+        public static string DefaultDirectory =>
+            Path.Combine(Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData), "IronSight", "FlightRecords");
+
+        /// <summary>
+        /// 开始录制到指定目录；maxSegmentBytes / maxSegments 为 0 时使用默认值 (64 MB x 8)
+        /// </summary>
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool FlightRecorder_Start([MarshalAs(UnmanagedType.LPUTF8Str)] string directory, ulong maxSegmentBytes, uint maxSegments);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void FlightRecorder_Stop();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool FlightRecorder_IsRecording();
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void FlightRecorder_GetStats(out FlightRecorderStats stats);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr FlightReader_Open([MarshalAs(UnmanagedType.LPUTF8Str)] string path);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void FlightReader_Close(IntPtr reader);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool FlightReader_GetRange(IntPtr reader, out long firstMs, out long lastMs);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern long FlightReader_Seek(IntPtr reader, long timestampMs);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern long FlightReader_Next(IntPtr reader);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool FlightReader_GetSystem(IntPtr reader, out SystemPerformanceSnapshot snapshot);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint FlightReader_GetProcesses(IntPtr reader, out IntPtr rows);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint FlightReader_GetConnections(IntPtr reader, out IntPtr rows);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern nuint FlightReader_GetAddresses(IntPtr reader, out IntPtr addresses);
+    }
+
+    /// <summary>
+    /// 飞行记录回放 (原生 FlightRecordReader 的托管包装)
+    /// 每次 Seek / Next 之后取出的数组是当前位置的副本，之后再移动位置不影响已取出的数据
+    /// </summary>
+    public sealed class FlightRecordReader : IDisposable
+    {
+        private IntPtr _handle;
+
+        private FlightRecordReader(IntPtr handle)
+        {
+            _handle = handle;
+        }
+
+        /// <summary>
+        /// 打开录制目录或单个分段，没有可回放的数据时返回 null
+        /// </summary>
+        public static FlightRecordReader? Open(string path)
+        {
+            IntPtr handle = FlightRecorderMethods.FlightReader_Open(path);
+            return handle == IntPtr.Zero ? null : new FlightRecordReader(handle);
+        }
+
+        public DateTimeOffset First => GetRange().First;
+
+        public DateTimeOffset Last => GetRange().Last;
+
+        /// <summary>
+        /// 定位到指定时刻，返回实际应用的最新帧时间；该时刻之前没有数据时返回 null
+        /// </summary>
+        public DateTimeOffset? Seek(DateTimeOffset timestamp)
+        {
+            long applied = FlightRecorderMethods.FlightReader_Seek(EnsureHandle(), timestamp.ToUnixTimeMilliseconds());
+            return applied == 0 ? null : DateTimeOffset.FromUnixTimeMilliseconds(applied);
+        }
+
+        /// <summary>
+        /// 前进到下一帧，已到末尾时返回 null
+        /// </summary>
+        public DateTimeOffset? Next()
+        {
+            long next = FlightRecorderMethods.FlightReader_Next(EnsureHandle());
+            return next == 0 ? null : DateTimeOffset.FromUnixTimeMilliseconds(next);
+        }
+
+        public bool TryGetSystem(out SystemPerformanceSnapshot snapshot) =>
+            FlightRecorderMethods.FlightReader_GetSystem(EnsureHandle(), out snapshot);
+
+        /// <summary>
+        /// 当前位置的进程表 (按 PID 排序)，名称 ID 已换算为本进程驻留池的 ID
+        /// </summary>
+        public ProcessDetailInfo[] GetProcesses()
+        {
+            nuint count = FlightRecorderMethods.FlightReader_GetProcesses(EnsureHandle(), out IntPtr rows);
+            return Copy<ProcessDetailInfo>(rows, count);
+        }
+
+        /// <summary>
+        /// 当前位置的连接表，IPv6 行的地址字段为 GetAddresses 返回数组的索引
+        /// </summary>
+        public NetworkConnectionRow[] GetConnections()
+        {
+            nuint count = FlightRecorderMethods.FlightReader_GetConnections(EnsureHandle(), out IntPtr rows);
+            return Copy<NetworkConnectionRow>(rows, count);
+        }
+
+        public Ipv6Address[] GetAddresses()
+        {
+            nuint count = FlightRecorderMethods.FlightReader_GetAddresses(EnsureHandle(), out IntPtr addresses);
+            return Copy<Ipv6Address>(addresses, count);
+        }
+
+        public void Dispose()
+        {
+            if (_handle != IntPtr.Zero)
+            {
+                FlightRecorderMethods.FlightReader_Close(_handle);
+                _handle = IntPtr.Zero;
+            }
+        }
+
+        private (DateTimeOffset First, DateTimeOffset Last) GetRange()
+        {
+            FlightRecorderMethods.FlightReader_GetRange(EnsureHandle(), out long firstMs, out long lastMs);
+            return (DateTimeOffset.FromUnixTimeMilliseconds(firstMs), DateTimeOffset.FromUnixTimeMilliseconds(lastMs));
+        }
+
+        private IntPtr EnsureHandle()
+        {
+            if (_handle == IntPtr.Zero) throw new ObjectDisposedException(nameof(FlightRecordReader));
+            return _handle;
+        }
+
+        private static unsafe T[] Copy<T>(IntPtr source, nuint count) where T : unmanaged
+        {
+            if (source == IntPtr.Zero || count == 0) return Array.Empty<T>();
+            return new ReadOnlySpan<T>((void*)source, checked((int)count)).ToArray();
+        }
+    }
+}
@@ -0,0 +1,35 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace IronSight.Interop.Native.Sampling
+{
+    /// <summary>
+    /// 采集器类型 (与 C++ SamplingCollector 保持同步)
+    /// </summary>
+    public enum SamplingCollector : uint
+    {
+        Network = 1,
+        SystemMonitor = 2,
+        SystemMethods = 3,
+        CpuCores = 4
+    }
+
+    public static class SamplingMethods
+    {
+        /// <summary>
+        /// 新快照就绪回调，在原生采样线程上调用
+        /// </summary>
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        public delegate void SnapshotReadyCallback(SamplingCollector collector, IntPtr source, ulong version);
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool SamplingScheduler_SetInterval(SamplingCollector collector, uint intervalMs);
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SamplingScheduler_RegisterCallback(SnapshotReadyCallback? callback);
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SamplingScheduler_Stop();
+    }
+}
@@ -1,6 +1,7 @@
 ﻿using System;
 using System.Runtime.InteropServices;
 using System.Text;
+using IronSight.Interop.Native.Text;
 
 namespace IronSight.Interop.Native.System
 {
@@ -23,8 +24,9 @@ namespace IronSight.Interop.Native.System
      * 1. 必须使用显式字段 (Fields) 以确保 [StructLayout] 能够精准控制内存对齐。
      * 2. WPF 无法直接绑定字段，因此我们手动编写属性 (Properties) 包装这些字段。
      * 3. 这样既满足了 C++ 的 8 字节对齐要求，也解决了 WPF Error 40 绑定错误。
+     * 4. 名称以原生字符串驻留池 ID 传输，结构体可直接按位复制，Name 按需解析。
      */
-    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi, Pack = 8)]
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
     public struct ProcessDetailInfo
     {
         private uint _pid;
@@ -35,8 +37,7 @@ namespace IronSight.Interop.Native.System
         private uint _threadCount;
         private uint _handleCount;
         private int _priorityClass;
-        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 260)]
-        private string _name;
+        private uint _nameId;
 
         public uint Pid { get => _pid; set => _pid = value; }
         public double MemoryMB { get => _memoryMB; set => _memoryMB = value; }
@@ -46,7 +47,8 @@ namespace IronSight.Interop.Native.System
         public uint ThreadCount { get => _threadCount; set => _threadCount = value; }
         public uint HandleCount { get => _handleCount; set => _handleCount = value; }
         public int PriorityClass { get => _priorityClass; set => _priorityClass = value; }
-        public string Name { get => _name; set => _name = value; }
+        public uint NameId { get => _nameId; set => _nameId = value; }
+        public string Name => NativeStringPool.Resolve(_nameId);
 
         // 辅助判断数据是否发生显著变化，用于差量更新性能优化
         public bool IsVisuallyDifferent(ProcessDetailInfo other) =>
@@ -55,6 +57,68 @@ namespace IronSight.Interop.Native.System
             Math.Abs(DiskReadRateMS - other.DiskReadRateMS) > 0.01;
     }
 
+    /// <summary>
+    /// 进程列表变更集概要 (与原生 ProcessChangeSetInfo 对应)
+    /// 应用顺序：IsReset 时清空 -> 移除 Exited -> 添加/覆盖 Added -> 应用 Updated
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Size = 40)]
+    public struct ProcessChangeSetInfo
+    {
+        public ulong Version;           // 下次调用时作为 baseVersion 传回
+        public ulong BaseVersion;       // 变更集所基于的版本 (重置时为 0)
+        public uint ProcessCount;       // 应用后的进程总数
+        public uint AddedCount;
+        public uint UpdatedCount;
+        public uint ExitedCount;
+        public byte IsReset;            // 为 1 时包含全部进程，本地列表需先清空
+    }
+
+    /// <summary>
+    /// 进程的静态字段：新出现的进程，或名称、优先级发生变化的进程 (按 PID 覆盖)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ProcessStaticRecord
+    {
+        public uint Pid;
+        public int PriorityClass;
+        public ulong CreateTime;        // 进程创建时间 (100 纳秒)，无权限访问时为 0
+        public uint NameId;             // 进程名称 (字符串驻留池 ID)
+        private uint _reserved;
+
+        public string Name => NativeStringPool.Resolve(NameId);
+    }
+
+    /// <summary>
+    /// 进程的动态字段：只在有变化时出现在变更集中
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ProcessUpdateRecord
+    {
+        public uint Pid;
+        public uint ThreadCount;
+        public uint HandleCount;
+        public float MemoryMB;
+        public float CpuUsage;
+        public float DiskReadRateMS;
+        public float DiskWriteRateMS;
+        private uint _reserved;
+    }
+
+    /// <summary>
+    /// 单个逻辑处理器在两次采样之间的占用率 (%)，各项之和为 100
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 4)]
+    public struct CpuCoreUsage
+    {
+        public float User;
+        public float System;
+        public float Idle;
+        public float Irq;
+        public float Steal;
+
+        public float Busy => 100f - Idle;
+    }
+
     public static class SystemMethods
     {
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
@@ -84,22 +148,86 @@ namespace IronSight.Interop.Native.System
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
         public static extern void CleanupSystemMethods();
 
+        /// <summary>
+        /// 读取后台采样线程缓存的最新快照，返回快照代数 (0 表示尚未采样)
+        /// </summary>
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern ulong GetLatestSystemPerformanceSnapshot(out SystemPerformanceSnapshot snapshot);
+
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
         public static extern int GetDetailedProcessList([In, Out, MarshalAs(UnmanagedType.LPArray)] ProcessDetailInfo[] buffer, int maxCount);
 
+        /// <summary>
+        /// 采集一次进程列表并生成相对于 baseVersion 的变更集，返回新版本 (0 表示失败)
+        /// baseVersion 不是上一次返回的版本时生成包含全部进程的重置变更集
+        /// </summary>
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern ulong CollectProcessChanges(ulong baseVersion, int maxCount, out ProcessChangeSetInfo info);
+
+        /// <summary>
+        /// 复制 CollectProcessChanges 返回的 version 对应的变更集
+        /// 期间其他调用方已重新采集 (版本不一致) 或任一缓冲区容量不足时返回 false
+        /// </summary>
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool CopyProcessChanges(ulong version,
+            [In, Out] ProcessStaticRecord[] added, int addedCapacity,
+            [In, Out] ProcessUpdateRecord[] updated, int updatedCapacity,
+            [In, Out] uint[] exited, int exitedCapacity);
+
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
         [return: MarshalAs(UnmanagedType.Bool)]
         public static extern bool TerminateSelectedProcess(uint pid);
 
+        /// <summary>
+        /// 获取进程映像路径的字符串驻留池 ID，失败返回 0 (同一进程只在原生端查询一次)
+        /// </summary>
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
-        [return: MarshalAs(UnmanagedType.Bool)]
-        public static extern bool GetProcessFullPath(uint pid, [MarshalAs(UnmanagedType.LPStr)] StringBuilder pathBuffer, uint bufferSize);
+        public static extern uint GetProcessImagePathId(uint pid);
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool GetProcessFullPath(uint pid, [MarshalAs(UnmanagedType.LPUTF8Str)] StringBuilder pathBuffer, uint bufferSize);
+
+        /// <summary>
+        /// 获取进程映像路径
+        /// </summary>
+        public static bool TryGetProcessPath(uint pid, out string path)
+        {
+            path = NativeStringPool.Resolve(GetProcessImagePathId(pid));
+            return path.Length > 0;
+        }
 
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
         [return: MarshalAs(UnmanagedType.Bool)]
         public static extern bool SetProcessPriority(uint pid, uint priorityClass);
 
         [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
-        public static extern void ShowFileProperties([MarshalAs(UnmanagedType.LPStr)] string filePath);
+        public static extern void ShowFileProperties([MarshalAs(UnmanagedType.LPUTF8Str)] string filePath);
+
+        /// <summary>
+        /// 采集一次逐处理器占用率，返回采样代数 (首次采集只建立基线，返回 0)
+        /// 通常改用 SamplingService.SetInterval(SamplingCollector.CpuCores, ...) 由原生线程定时采集
+        /// </summary>
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern ulong CpuCores_Sample();
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint CpuCores_GetCount();
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint CpuCores_Copy([In, Out] CpuCoreUsage[] buffer, uint maxCount, out ulong version);
+
+        /// <summary>
+        /// 获取最近一次的逐处理器占用率 (按处理器编号排列)
+        /// </summary>
+        public static CpuCoreUsage[] GetCpuCoreUsage(out ulong version)
+        {
+            var buffer = new CpuCoreUsage[CpuCores_GetCount()];
+            uint count = CpuCores_Copy(buffer, (uint)buffer.Length, out version);
+
+            if (count < buffer.Length) Array.Resize(ref buffer, (int)count);
+            return buffer;
+        }
     }
 }
\ No newline at end of file
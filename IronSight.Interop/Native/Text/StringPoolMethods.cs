@@ -0,0 +1,43 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Runtime.InteropServices;
+
+namespace IronSight.Interop.Native.Text
+{
+    public static class StringPoolMethods
+    {
+        /// <summary>
+        /// 按 ID 取驻留的 UTF-8 字符串，指针在 DLL 卸载前始终有效
+        /// </summary>
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr StringPool_Get(uint id, out uint length);
+
+        [DllImport("IronSight.Core.Native.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint StringPool_GetCount();
+    }
+
+    /// <summary>
+    /// 原生字符串驻留池的托管视图
+    /// 原生 ID 一经分配内容永不改变，每个 ID 只需解码一次，之后直接返回同一个 string 实例
+    /// </summary>
+    public static class NativeStringPool
+    {
+        private static readonly ConcurrentDictionary<uint, string> _cache = new();
+
+        /// <summary>
+        /// 把驻留池 ID 解析为字符串，ID 0 或无效 ID 返回空字符串
+        /// </summary>
+        public static string Resolve(uint id)
+        {
+            if (id == 0) return string.Empty;
+            if (_cache.TryGetValue(id, out var cached)) return cached;
+
+            IntPtr pointer = StringPoolMethods.StringPool_Get(id, out uint length);
+            string value = length > 0 ? Marshal.PtrToStringUTF8(pointer, (int)length) : string.Empty;
+
+            // 无效 ID 不缓存，避免占用字典
+            if (length > 0) _cache.TryAdd(id, value);
+            return value;
+        }
+    }
+}
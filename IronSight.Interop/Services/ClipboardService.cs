@@ -1,6 +1,7 @@
 using System;
 using IronSight.Interop.Native.Clipboard;
 using IronSight.Interop.Core;
+using IronSight.Interop.Events;
 
 namespace IronSight.Interop.Services
 {
@@ -9,7 +10,10 @@ namespace IronSight.Interop.Services
         private ClipboardMethods.OnClipboardChangedCallback _nativeCallback;
         private bool _isListening;
 
-        public event EventHandler ClipboardChanged;
+        /// <summary>
+        /// 剪贴板内容确实变化时触发 (原生层已去重，程序反复设置相同内容不会触发)
+        /// </summary>
+        public event EventHandler<ClipboardChangedEventArgs> ClipboardChanged;
 
         public void Start()
         {
@@ -34,13 +38,14 @@ namespace IronSight.Interop.Services
             }
         }
 
-        private void OnNativeClipboardChanged()
+        private void OnNativeClipboardChanged(ulong entryId)
         {
             // This comes from a background thread (native thread).
             // We invoke the event. The subscriber (UI) must handle Dispatching.
             try
             {
-                 ClipboardChanged?.Invoke(this, EventArgs.Empty);
+                 // 在监听线程上按 ID 解码文本，订阅者不必再打开剪贴板
+                 ClipboardChanged?.Invoke(this, new ClipboardChangedEventArgs(entryId, ClipboardMethods.GetText(entryId)));
             }
             catch (Exception ex)
             {
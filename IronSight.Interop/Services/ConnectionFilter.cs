@@ -0,0 +1,122 @@
+﻿using IronSight.Interop.Native.Network;
+using System.Net;
+
+namespace IronSight.Interop.Services
+{
+    /// <summary>
+    /// 连接查询条件，由原生层在复制前逐行求值，只有匹配的行会被封送
+    /// 未设置的条件不参与匹配，已设置的条件之间为"与"关系
+    /// </summary>
+    public sealed class ConnectionFilter
+    {
+        /// <summary>
+        /// 允许的协议集合
+        /// </summary>
+        public ProtocolType[]? Protocols { get; init; }
+
+        /// <summary>
+        /// 允许的连接状态集合
+        /// </summary>
+        public ConnectionState[]? States { get; init; }
+
+        /// <summary>
+        /// 本地端口范围 (闭区间)
+        /// </summary>
+        public (ushort Min, ushort Max)? LocalPorts { get; init; }
+
+        /// <summary>
+        /// 远程端口范围 (闭区间)
+        /// </summary>
+        public (ushort Min, ushort Max)? RemotePorts { get; init; }
+
+        /// <summary>
+        /// 本地地址前缀 (CIDR)
+        /// </summary>
+        public (IPAddress Address, int PrefixLength)? LocalPrefix { get; init; }
+
+        /// <summary>
+        /// 远程地址前缀 (CIDR)
+        /// </summary>
+        public (IPAddress Address, int PrefixLength)? RemotePrefix { get; init; }
+
+        /// <summary>
+        /// 允许的进程ID集合
+        /// </summary>
+        public uint[]? ProcessIds { get; init; }
+
+        /// <summary>
+        /// 转换为原生过滤条件。processIds 必须指向已固定的 ProcessIds 数组
+        /// </summary>
+        internal NativeConnectionFilter ToNative(IntPtr processIds)
+        {
+            var native = new NativeConnectionFilter();
+
+            if (Protocols != null)
+            {
+                native.Flags |= ConnectionFilterFlags.Protocol;
+                foreach (var protocol in Protocols) native.ProtocolMask |= 1u << (int)protocol;
+            }
+
+            if (States != null)
+            {
+                native.Flags |= ConnectionFilterFlags.State;
+                foreach (var state in States) native.StateMask |= 1u << (int)state;
+            }
+
+            if (LocalPorts is { } localPorts)
+            {
+                native.Flags |= ConnectionFilterFlags.LocalPort;
+                native.LocalPortMin = localPorts.Min;
+                native.LocalPortMax = localPorts.Max;
+            }
+
+            if (RemotePorts is { } remotePorts)
+            {
+                native.Flags |= ConnectionFilterFlags.RemotePort;
+                native.RemotePortMin = remotePorts.Min;
+                native.RemotePortMax = remotePorts.Max;
+            }
+
+            if (LocalPrefix is { } localPrefix)
+            {
+                native.Flags |= ConnectionFilterFlags.LocalAddress;
+                native.LocalPrefix = ToNativePrefix(localPrefix.Address, localPrefix.PrefixLength);
+            }
+
+            if (RemotePrefix is { } remotePrefix)
+            {
+                native.Flags |= ConnectionFilterFlags.RemoteAddress;
+                native.RemotePrefix = ToNativePrefix(remotePrefix.Address, remotePrefix.PrefixLength);
+            }
+
+            if (ProcessIds != null)
+            {
+                native.Flags |= ConnectionFilterFlags.ProcessId;
+                native.ProcessIds = processIds;
+                native.ProcessIdCount = (uint)ProcessIds.Length;
+            }
+
+            return native;
+        }
+
+        private static unsafe NativeAddressPrefix ToNativePrefix(IPAddress address, int prefixLength)
+        {
+            // 与原生层一致：IPv4 映射地址按 IPv4 处理
+            if (address.IsIPv4MappedToIPv6)
+            {
+                address = address.MapToIPv4();
+            }
+
+            var prefix = new NativeAddressPrefix
+            {
+                Family = address.AddressFamily == System.Net.Sockets.AddressFamily.InterNetworkV6
+                    ? Native.Network.AddressFamily.Ipv6
+                    : Native.Network.AddressFamily.Ipv4,
+                PrefixLength = (byte)Math.Clamp(prefixLength, 0, 128)
+            };
+
+            address.TryWriteBytes(new Span<byte>(prefix.Address, 16), out _);
+            return prefix;
+        }
+    }
+}
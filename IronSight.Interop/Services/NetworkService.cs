@@ -1,4 +1,5 @@
 ﻿using IronSight.Interop.Native.Network;
+using IronSight.Interop.Native.Sampling;
 using System.ComponentModel;
 using System.Net;
 using System.Runtime.CompilerServices;
@@ -14,36 +15,67 @@ namespace IronSight.Interop.Services
     public sealed class NetworkService : IDisposable
     {
 
+        private readonly NetworkMonitorHandle _monitorHandle;
         private IntPtr _nativeHandle;
         private bool _disposed;
+        private bool _isSubscribed;
+        private bool _filterLayoutVerified;
 
         // 预分配的缓冲区，避免频繁GC
         private NetworkConnectionInfo[] _connectionBuffer;
         private GCHandle _bufferHandle;
         private const int DefaultBufferCapacity = 2048;
 
+        // 增量模式的缓冲区，仅在启用增量模式后分配
+        private NetworkConnectionDelta[] _deltaBuffer = Array.Empty<NetworkConnectionDelta>();
+
+        // 进程汇总缓冲区，按需增长
+        private ProcessConnectionSummary[] _summaryBuffer = Array.Empty<ProcessConnectionSummary>();
+
+        // 已关闭连接记录缓冲区 (按需分配，不超过原生环形缓冲区的读取批量)
+        private ClosedConnectionRecord[] _closedBuffer = Array.Empty<ClosedConnectionRecord>();
+        private const int ClosedBatchCapacity = 1024;
+
         /// <summary>
         /// 创建网络监控器实例
         /// </summary>
         public NetworkService()
         {
-            _nativeHandle = NetworkMonitor_Create();
+            _monitorHandle = new NetworkMonitorHandle(NetworkMonitor_Create());
+            _nativeHandle = _monitorHandle.DangerousGetHandle();
 
-            if (_nativeHandle == IntPtr.Zero)
+            if (_monitorHandle.IsInvalid)
             {
                 throw new InvalidOperationException(
                     "Failed to create native NetworkMonitor instance.");
             }
 
-            // 验证结构体大小匹配
+            // 验证行格式版本与结构体大小匹配
+            int nativeVersion = NetworkMonitor_GetAbiVersion();
+
+            if (nativeVersion != AbiVersion)
+            {
+                _monitorHandle.Dispose();
+                throw new InvalidOperationException(
+                    $"Network ABI version mismatch: Native={nativeVersion}, Managed={AbiVersion}");
+            }
+
             int nativeSize = NetworkConnectionInfo_GetSize();
             int managedSize = Marshal.SizeOf<NetworkConnectionInfo>();
+            int nativeRowSize = NetworkConnectionRow_GetSize();
+            int managedRowSize = Marshal.SizeOf<NetworkConnectionRow>();
+            int nativeSummarySize = ProcessConnectionSummary_GetSize();
+            int managedSummarySize = Marshal.SizeOf<ProcessConnectionSummary>();
+            int nativeClosedSize = ClosedConnectionRecord_GetSize();
+            int managedClosedSize = Marshal.SizeOf<ClosedConnectionRecord>();
 
-            if (nativeSize != managedSize)
+            if (nativeSize != managedSize || nativeRowSize != managedRowSize ||
+                nativeSummarySize != managedSummarySize || nativeClosedSize != managedClosedSize)
             {
-                NetworkMonitor_Destroy(_nativeHandle);
+                _monitorHandle.Dispose();
                 throw new InvalidOperationException(
-                    $"Structure size mismatch: Native={nativeSize}, Managed={managedSize}");
+                    $"Structure size mismatch: Native={nativeSize}/{nativeRowSize}/{nativeSummarySize}/{nativeClosedSize}, " +
+                    $"Managed={managedSize}/{managedRowSize}/{managedSummarySize}/{managedClosedSize}");
             }
 
             _connectionBuffer = new NetworkConnectionInfo[DefaultBufferCapacity];
@@ -81,7 +113,7 @@ namespace IronSight.Interop.Services
         }
 
         /// <summary>
-        /// 获取当前连接数量
+        /// 获取当前 IPv4 连接数量 (v1 行格式)
         /// </summary>
         public int ConnectionCount
         {
@@ -94,14 +126,14 @@ namespace IronSight.Interop.Services
         }
 
         /// <summary>
-        /// 获取连接信息数组
+        /// 获取 IPv4 连接信息数组 (v1 行格式，不包含 IPv6 连接)
         /// </summary>
         /// <returns>连接信息只读跨度</returns>
         public ReadOnlySpan<NetworkConnectionInfo> GetConnections()
         {
             ThrowIfDisposed();
 
-            int count = ConnectionCount;
+            int count = (int)NetworkMonitor_GetConnectionCount(_nativeHandle);
 
             if (count == 0)
             {
@@ -111,32 +143,255 @@ namespace IronSight.Interop.Services
             // 如果缓冲区太小，重新分配
             EnsureBufferCapacity(count);
 
+            // 两次调用之间可能发生刷新，以实际复制的数量为准
             nuint copied = NetworkMonitor_CopyConnections(
                 _nativeHandle,
                 _bufferHandle.AddrOfPinnedObject(),
-                (nuint)count);
+                (nuint)_connectionBuffer.Length);
 
             return new ReadOnlySpan<NetworkConnectionInfo>(_connectionBuffer, 0, (int)copied);
         }
 
         /// <summary>
-        /// 获取连接信息列表（分配新内存）
+        /// 获取满足条件的 IPv4 连接 (v1 行格式)，过滤在原生层完成，只复制匹配的行
         /// </summary>
-        public List<NetworkConnectionInfo> GetConnectionsList()
+        /// <param name="filter">过滤条件</param>
+        /// <returns>连接信息只读跨度</returns>
+        public unsafe ReadOnlySpan<NetworkConnectionInfo> GetConnections(ConnectionFilter filter)
         {
-            var span = GetConnections();
-            var list = new List<NetworkConnectionInfo>(span.Length);
+            ThrowIfDisposed();
+            EnsureFilterLayout();
+
+            // 匹配行数不会超过全部 IPv4 连接数
+            EnsureBufferCapacity((int)NetworkMonitor_GetConnectionCount(_nativeHandle));
 
-            foreach (ref readonly var connection in span)
+            nuint copied;
+
+            fixed (uint* processIds = filter.ProcessIds)
             {
-                list.Add(connection);
+                var native = filter.ToNative((IntPtr)processIds);
+
+                copied = NetworkMonitor_CopyConnectionsFiltered(
+                    _nativeHandle,
+                    in native,
+                    _bufferHandle.AddrOfPinnedObject(),
+                    (nuint)_connectionBuffer.Length);
+            }
+
+            return new ReadOnlySpan<NetworkConnectionInfo>(_connectionBuffer, 0, (int)copied);
+        }
+
+        /// <summary>
+        /// 获取满足条件的连接列表（分配新内存，包含 IPv4 与 IPv6 连接）
+        /// </summary>
+        public List<NetworkConnectionEntry> GetConnectionsList(ConnectionFilter filter)
+        {
+            ThrowIfDisposed();
+            EnsureFilterLayout();
+
+            using var snapshot = AcquireSnapshot();
+            var rows = snapshot.Rows;
+
+            // 先按行数分配下标缓冲区，快照固定期间匹配数不会变化
+            uint[] indices = new uint[rows.Length];
+            int count = snapshot.Query(filter, indices);
+            var list = new List<NetworkConnectionEntry>(count);
+
+            for (int i = 0; i < count; i++)
+            {
+                ref readonly var row = ref rows[(int)indices[i]];
+                list.Add(new NetworkConnectionEntry(row,
+                    snapshot.GetLocalAddress(in row),
+                    snapshot.GetRemoteAddress(in row)));
+            }
+
+            return list;
+        }
+
+        /// <summary>
+        /// 固定当前连接表快照，可在不复制的情况下直接读取原生内存 (双栈)
+        /// 快照在 Dispose 之前保持不变，刷新不会被阻塞；服务先于快照释放时，监控器推迟到快照释放后销毁
+        /// </summary>
+        public NetworkConnectionSnapshot AcquireSnapshot()
+        {
+            ThrowIfDisposed();
+
+            return new NetworkConnectionSnapshot(_monitorHandle);
+        }
+
+        /// <summary>
+        /// 获取连接信息列表（分配新内存，包含 IPv4 与 IPv6 连接）
+        /// </summary>
+        public List<NetworkConnectionEntry> GetConnectionsList()
+        {
+            ThrowIfDisposed();
+
+            using var snapshot = AcquireSnapshot();
+            var rows = snapshot.Rows;
+            var list = new List<NetworkConnectionEntry>(rows.Length);
+
+            foreach (ref readonly var row in rows)
+            {
+                list.Add(new NetworkConnectionEntry(row,
+                    snapshot.GetLocalAddress(in row),
+                    snapshot.GetRemoteAddress(in row)));
             }
 
             return list;
         }
 
+        /// <summary>
+        /// 获取按 PID 升序的进程套接字汇总 (原生层在刷新时聚合，只需复制每个进程一行)
+        /// </summary>
+        /// <returns>进程汇总只读跨度</returns>
+        public ReadOnlySpan<ProcessConnectionSummary> GetProcessSummaries()
+        {
+            ThrowIfDisposed();
+
+            int count = (int)NetworkMonitor_GetProcessCount(_nativeHandle);
+
+            if (_summaryBuffer.Length < count)
+            {
+                _summaryBuffer = new ProcessConnectionSummary[Math.Max(count, (int)(_summaryBuffer.Length * 1.5))];
+            }
+
+            GCHandle handle = GCHandle.Alloc(_summaryBuffer, GCHandleType.Pinned);
+            nuint copied;
+
+            try
+            {
+                copied = NetworkMonitor_CopyProcessSummaries(
+                    _nativeHandle,
+                    handle.AddrOfPinnedObject(),
+                    (nuint)_summaryBuffer.Length);
+            }
+            finally
+            {
+                handle.Free();
+            }
+
+            return new ReadOnlySpan<ProcessConnectionSummary>(_summaryBuffer, 0, (int)copied);
+        }
+
+        /// <summary>
+        /// 查找占用本地端口的进程 (使用刷新时构建的端口索引)
+        /// </summary>
+        /// <param name="port">本地端口</param>
+        /// <param name="protocol">协议</param>
+        /// <param name="processId">占用端口的进程ID</param>
+        /// <returns>是否找到</returns>
+        public bool TryGetPortOwner(ushort port, ProtocolType protocol, out uint processId)
+        {
+            ThrowIfDisposed();
+            return NetworkMonitor_FindPortOwner(_nativeHandle, port, protocol, out processId);
+        }
+
+        /// <summary>
+        /// 读取序号大于 afterSequence 的已关闭连接 (按序号升序，每次最多一批)
+        /// 原生层只保留最近的记录，调用方可由返回记录的序号间断判断是否有记录被覆盖
+        /// </summary>
+        /// <param name="afterSequence">上次读取到的最后序号，首次读取传 0</param>
+        /// <returns>已关闭连接记录只读跨度</returns>
+        public ReadOnlySpan<ClosedConnectionRecord> GetClosedConnections(ulong afterSequence)
+        {
+            ThrowIfDisposed();
+
+            if (_closedBuffer.Length == 0)
+            {
+                _closedBuffer = new ClosedConnectionRecord[ClosedBatchCapacity];
+            }
+
+            GCHandle handle = GCHandle.Alloc(_closedBuffer, GCHandleType.Pinned);
+            nuint copied;
+
+            try
+            {
+                copied = NetworkMonitor_CopyClosedConnections(
+                    _nativeHandle,
+                    handle.AddrOfPinnedObject(),
+                    (nuint)_closedBuffer.Length,
+                    afterSequence);
+            }
+            finally
+            {
+                handle.Free();
+            }
+
+            return new ReadOnlySpan<ClosedConnectionRecord>(_closedBuffer, 0, (int)copied);
+        }
+
+        /// <summary>
+        /// 当前连接表代数，每次刷新递增
+        /// </summary>
+        public ulong Generation
+        {
+            [MethodImpl(MethodImplOptions.AggressiveInlining)]
+            get
+            {
+                ThrowIfDisposed();
+                return NetworkMonitor_GetGeneration(_nativeHandle);
+            }
+        }
+
+        /// <summary>
+        /// 启用或关闭增量模式。启用后首个增量包含全部连接
+        /// </summary>
+        public void SetIncrementalMode(bool enabled)
+        {
+            ThrowIfDisposed();
+
+            int nativeSize = NetworkConnectionDelta_GetSize();
+            int managedSize = Marshal.SizeOf<NetworkConnectionDelta>();
+
+            if (nativeSize != managedSize)
+            {
+                throw new InvalidOperationException(
+                    $"Structure size mismatch: Native={nativeSize}, Managed={managedSize}");
+            }
+
+            NetworkMonitor_SetIncrementalMode(_nativeHandle, enabled);
+        }
+
+        /// <summary>
+        /// 获取最近一次刷新产生的增量 (新增、移除与状态变化的连接)
+        /// </summary>
+        /// <param name="generation">增量对应的代数；若与上次获取的代数不连续，调用方应改用 GetConnections 全量同步</param>
+        /// <returns>增量记录只读跨度</returns>
+        public ReadOnlySpan<NetworkConnectionDelta> GetDelta(out ulong generation)
+        {
+            ThrowIfDisposed();
+
+            // 代数与增量取自同一个固定的快照，期间的后台刷新不会让两者错位
+            using var snapshot = AcquireSnapshot();
+            var delta = snapshot.Delta;
+            generation = snapshot.Version;
+
+            if (_deltaBuffer.Length < delta.Length)
+            {
+                _deltaBuffer = new NetworkConnectionDelta[Math.Max(delta.Length, (int)(_deltaBuffer.Length * 1.5))];
+            }
+
+            int count = 0;
+
+            foreach (ref readonly var entry in delta)
+            {
+                // v1 行格式只能表示 IPv4
+                if (entry.Connection.Family != AddressFamily.Ipv4) continue;
+
+                _deltaBuffer[count++] = new NetworkConnectionDelta(in entry);
+            }
+
+            return new ReadOnlySpan<NetworkConnectionDelta>(_deltaBuffer, 0, count);
+        }
+
+        /// <summary>
+        /// 后台采样产生新一代连接表时触发 (在原生采样线程上调用)，参数为新的代数
+        /// </summary>
+        public event EventHandler<ulong>? SnapshotReady;
+
         /// <summary>
         /// 更新网络监控的采样频率
+        /// 原生采样线程按此间隔自动刷新，TimeSpan.Zero 表示停止后台刷新
         /// </summary>
         /// <param name="tickRate">采样间隔时间</param>
         public void UpdateTickRate(TimeSpan tickRate)
@@ -153,6 +408,20 @@ namespace IronSight.Interop.Services
             {
                 throw new InvalidOperationException("Failed to update network monitor tick rate.");
             }
+
+            if (!_isSubscribed && intervalMs != 0)
+            {
+                SamplingService.SnapshotReady += OnSamplingSnapshotReady;
+                _isSubscribed = true;
+            }
+        }
+
+        private void OnSamplingSnapshotReady(object? sender, SnapshotReadyEventArgs e)
+        {
+            if (e.Collector == SamplingCollector.Network && e.Source == _nativeHandle)
+            {
+                SnapshotReady?.Invoke(this, e.Version);
+            }
         }
 
         private void EnsureBufferCapacity(int requiredCapacity)
@@ -176,6 +445,22 @@ namespace IronSight.Interop.Services
             _bufferHandle = GCHandle.Alloc(_connectionBuffer, GCHandleType.Pinned);
         }
 
+        private void EnsureFilterLayout()
+        {
+            if (_filterLayoutVerified) return;
+
+            int nativeSize = ConnectionFilter_GetSize();
+            int managedSize = Marshal.SizeOf<NativeConnectionFilter>();
+
+            if (nativeSize != managedSize)
+            {
+                throw new InvalidOperationException(
+                    $"Structure size mismatch: Native={nativeSize}, Managed={managedSize}");
+            }
+
+            _filterLayoutVerified = true;
+        }
+
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         private void ThrowIfDisposed()
         {
@@ -191,17 +476,21 @@ namespace IronSight.Interop.Services
 
             _disposed = true;
 
-            if (_bufferHandle.IsAllocated)
+            if (_isSubscribed)
             {
-                _bufferHandle.Free();
+                SamplingService.SnapshotReady -= OnSamplingSnapshotReady;
+                _isSubscribed = false;
             }
 
-            if (_nativeHandle != IntPtr.Zero)
+            if (_bufferHandle.IsAllocated)
             {
-                NetworkMonitor_Destroy(_nativeHandle);
-                _nativeHandle = IntPtr.Zero;
+                _bufferHandle.Free();
             }
 
+            // 仍有快照未释放时由最后一个快照触发销毁
+            _monitorHandle.Dispose();
+            _nativeHandle = IntPtr.Zero;
+
             GC.SuppressFinalize(this);
         }
 
@@ -212,7 +501,7 @@ namespace IronSight.Interop.Services
     }
 
     /// <summary>
-    /// 网络连接信息结构体
+    /// 网络连接信息结构体 (v1 行格式，仅 IPv4)
     /// </summary>
     [StructLayout(LayoutKind.Sequential, Pack = 1)]
     public readonly struct NetworkConnectionInfo
@@ -226,6 +515,21 @@ namespace IronSight.Interop.Services
         private readonly uint _processId;
         private readonly ulong _reserved;
 
+        /// <summary>
+        /// 由 IPv4 双栈行转换 (地址字段即为地址本身)
+        /// </summary>
+        internal NetworkConnectionInfo(in NetworkConnectionRow row)
+        {
+            _localAddress = row.LocalAddressOrIndex;
+            _remoteAddress = row.RemoteAddressOrIndex;
+            _localPort = row.LocalPort;
+            _remotePort = row.RemotePort;
+            _state = row.State;
+            _protocol = row.Protocol;
+            _processId = row.ProcessId;
+            _reserved = 0;
+        }
+
         /// <summary>
         /// 本地IP地址
         /// </summary>
@@ -282,6 +586,501 @@ namespace IronSight.Interop.Services
         public string RemoteEndPoint => $"{RemoteAddressString}:{RemotePort}";
     }
 
+    /// <summary>
+    /// 双栈连接行 (v2 行格式)
+    /// IPv6 行的地址字段为所属快照地址表的索引，需通过 NetworkConnectionSnapshot 解析
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public readonly struct NetworkConnectionRow
+    {
+        private readonly uint _localAddress;
+        private readonly uint _remoteAddress;
+        private readonly ushort _localPort;
+        private readonly ushort _remotePort;
+        private readonly uint _processId;
+        private readonly byte _state;
+        private readonly byte _protocol;
+        private readonly AddressFamily _family;
+        private readonly byte _reserved;
+
+        /// <summary>
+        /// IPv4: 地址 (网络字节序)；IPv6: 地址表索引
+        /// </summary>
+        public uint LocalAddressOrIndex => _localAddress;
+
+        /// <summary>
+        /// IPv4: 地址 (网络字节序)；IPv6: 地址表索引
+        /// </summary>
+        public uint RemoteAddressOrIndex => _remoteAddress;
+
+        public ushort LocalPort => _localPort;
+
+        public ushort RemotePort => _remotePort;
+
+        public uint ProcessId => _processId;
+
+        public ConnectionState State => (ConnectionState)_state;
+
+        public ProtocolType Protocol => (ProtocolType)_protocol;
+
+        public AddressFamily Family => _family;
+    }
+
+    /// <summary>
+    /// IPv6 地址 (网络字节序)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct Ipv6Address
+    {
+        private fixed byte _bytes[16];
+
+        public IPAddress ToIPAddress()
+        {
+            fixed (byte* bytes = _bytes)
+            {
+                return new IPAddress(new ReadOnlySpan<byte>(bytes, 16));
+            }
+        }
+    }
+
+    /// <summary>
+    /// 双栈连接增量记录 (v2 行格式)
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public readonly struct NetworkConnectionRowDelta
+    {
+        private readonly NetworkConnectionRow _connection;
+        private readonly byte _kind;
+        private readonly byte _previousState;
+        private readonly ushort _reserved;
+
+        /// <summary>
+        /// 变更后的连接 (Removed 时为上一代的记录，地址索引同样指向本快照的地址表)
+        /// </summary>
+        public NetworkConnectionRow Connection => _connection;
+
+        public ConnectionChangeKind Kind => (ConnectionChangeKind)_kind;
+
+        public ConnectionState PreviousState => (ConnectionState)_previousState;
+    }
+
+    /// <summary>
+    /// 单个进程的套接字汇总
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct ProcessConnectionSummary
+    {
+        private const int StateCount = 13;
+
+        private uint _processId;
+        private uint _firstRow;
+        private uint _connectionCount;
+        private uint _tcpCount;
+        private uint _udpCount;
+        private uint _ipv6Count;
+        private uint _remoteEndpointCount;
+        private uint _listeningPortOffset;
+        private uint _listeningPortCount;
+        private fixed uint _stateCounts[StateCount];
+
+        public uint ProcessId => _processId;
+
+        /// <summary>
+        /// 该进程第一行在快照行数组中的位置
+        /// </summary>
+        public uint FirstRow => _firstRow;
+
+        public uint ConnectionCount => _connectionCount;
+
+        public uint TcpCount => _tcpCount;
+
+        public uint UdpCount => _udpCount;
+
+        public uint Ipv6Count => _ipv6Count;
+
+        /// <summary>
+        /// 不同远程端点 (地址 + 端口) 的数量
+        /// </summary>
+        public uint RemoteEndpointCount => _remoteEndpointCount;
+
+        public uint ListeningPortOffset => _listeningPortOffset;
+
+        public uint ListeningPortCount => _listeningPortCount;
+
+        /// <summary>
+        /// 获取指定状态的连接数
+        /// </summary>
+        public uint GetStateCount(ConnectionState state) =>
+            (uint)state < StateCount ? _stateCounts[(int)state] : 0;
+    }
+
+    /// <summary>
+    /// 单个进程在一个刷新周期内的连接变动
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public readonly struct ProcessConnectionChurn
+    {
+        private readonly uint _processId;
+        private readonly uint _opened;
+        private readonly uint _closed;
+
+        public uint ProcessId => _processId;
+
+        public uint Opened => _opened;
+
+        public uint Closed => _closed;
+    }
+
+    /// <summary>
+    /// 已关闭连接的生命周期记录
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ClosedConnectionRecord
+    {
+        private ulong _sequence;
+        private ulong _firstSeen;
+        private ulong _lastSeen;
+        private Ipv6Address _localAddress;
+        private Ipv6Address _remoteAddress;
+        private ushort _localPort;
+        private ushort _remotePort;
+        private uint _processId;
+        private byte _state;
+        private byte _protocol;
+        private AddressFamily _family;
+        private byte _reserved;
+        private uint _reserved2;
+
+        /// <summary>
+        /// 退役序号，从 1 开始单调递增
+        /// </summary>
+        public ulong Sequence => _sequence;
+
+        public DateTimeOffset FirstSeen => DateTimeOffset.FromUnixTimeMilliseconds((long)_firstSeen);
+
+        public DateTimeOffset LastSeen => DateTimeOffset.FromUnixTimeMilliseconds((long)_lastSeen);
+
+        /// <summary>
+        /// 观察到的存活时长 (精度受刷新间隔限制)
+        /// </summary>
+        public TimeSpan Lifetime => TimeSpan.FromMilliseconds(_lastSeen - _firstSeen);
+
+        public IPAddress LocalAddress => ToIPAddress(_localAddress);
+
+        public IPAddress RemoteAddress => ToIPAddress(_remoteAddress);
+
+        public ushort LocalPort => _localPort;
+
+        public ushort RemotePort => _remotePort;
+
+        public uint ProcessId => _processId;
+
+        /// <summary>
+        /// 最后观察到的状态
+        /// </summary>
+        public ConnectionState State => (ConnectionState)_state;
+
+        public ProtocolType Protocol => (ProtocolType)_protocol;
+
+        public AddressFamily Family => _family;
+
+        private IPAddress ToIPAddress(Ipv6Address address)
+        {
+            IPAddress value = address.ToIPAddress();
+            return _family == AddressFamily.Ipv6
+                ? value
+                : new IPAddress(value.GetAddressBytes().AsSpan(0, 4));
+        }
+    }
+
+    /// <summary>
+    /// 原生连接表快照的固定视图，应当 Dispose 以解除固定
+    /// 解除固定只会发生一次 (重复 Dispose 无效)，忘记 Dispose 的快照由终结器释放；
+    /// 快照持有监控器句柄的一次引用，监控器不会在快照释放前销毁
+    /// </summary>
+    public sealed class NetworkConnectionSnapshot : SafeHandle
+    {
+        private readonly NetworkMonitorHandle _monitor;
+        private readonly IntPtr _rows;
+        private readonly int _rowCount;
+        private readonly IntPtr _addresses;
+        private readonly int _addressCount;
+        private readonly IntPtr _delta;
+        private readonly int _deltaCount;
+        private readonly IntPtr _processes;
+        private readonly int _processCount;
+        private readonly IntPtr _listeningPorts;
+        private readonly int _listeningPortCount;
+        private readonly IntPtr _firstSeen;
+        private readonly int _firstSeenCount;
+        private readonly IntPtr _churn;
+        private readonly int _churnCount;
+
+        internal NetworkConnectionSnapshot(NetworkMonitorHandle monitor) : base(IntPtr.Zero, ownsHandle: true)
+        {
+            // 监控器已释放时抛出 ObjectDisposedException
+            bool referenced = false;
+            monitor.DangerousAddRef(ref referenced);
+            _monitor = monitor;
+
+            IntPtr handle = NetworkMonitor_AcquireSnapshot(monitor.DangerousGetHandle(), out ulong version);
+            Version = version;
+
+            if (handle == IntPtr.Zero)
+            {
+                // 没有固定任何快照，ReleaseHandle 不会被调用
+                monitor.DangerousRelease();
+                return;
+            }
+
+            SetHandle(handle);
+            _rowCount = (int)NetworkSnapshot_GetRows(handle, out _rows);
+            _addressCount = (int)NetworkSnapshot_GetAddresses(handle, out _addresses);
+            _deltaCount = (int)NetworkSnapshot_GetDelta(handle, out _delta);
+            _processCount = (int)NetworkSnapshot_GetProcessSummaries(handle, out _processes);
+            _listeningPortCount = (int)NetworkSnapshot_GetListeningPorts(handle, out _listeningPorts);
+            _firstSeenCount = (int)NetworkSnapshot_GetFirstSeen(handle, out _firstSeen);
+            _churnCount = (int)NetworkSnapshot_GetProcessChurn(handle, out _churn);
+            Timestamp = DateTimeOffset.FromUnixTimeMilliseconds((long)NetworkSnapshot_GetTimestamp(handle));
+        }
+
+        public override bool IsInvalid => handle == IntPtr.Zero;
+
+        // 已解除固定或未固定任何快照，此时所有视图均为空
+        private bool IsReleased => IsClosed || IsInvalid;
+
+        /// <summary>
+        /// 快照代数
+        /// </summary>
+        public ulong Version { get; }
+
+        /// <summary>
+        /// 快照采集时间
+        /// </summary>
+        public DateTimeOffset Timestamp { get; }
+
+        /// <summary>
+        /// 快照中的连接 (直接指向原生内存，仅在 Dispose 之前有效)
+        /// </summary>
+        public unsafe ReadOnlySpan<NetworkConnectionRow> Rows =>
+            IsReleased
+                ? ReadOnlySpan<NetworkConnectionRow>.Empty
+                : new ReadOnlySpan<NetworkConnectionRow>(_rows.ToPointer(), _rowCount);
+
+        /// <summary>
+        /// IPv6 行引用的地址表
+        /// </summary>
+        public unsafe ReadOnlySpan<Ipv6Address> Addresses =>
+            IsReleased
+                ? ReadOnlySpan<Ipv6Address>.Empty
+                : new ReadOnlySpan<Ipv6Address>(_addresses.ToPointer(), _addressCount);
+
+        /// <summary>
+        /// 相对上一代的增量 (仅增量模式)
+        /// </summary>
+        public unsafe ReadOnlySpan<NetworkConnectionRowDelta> Delta =>
+            IsReleased
+                ? ReadOnlySpan<NetworkConnectionRowDelta>.Empty
+                : new ReadOnlySpan<NetworkConnectionRowDelta>(_delta.ToPointer(), _deltaCount);
+
+        /// <summary>
+        /// 按 PID 升序的进程汇总
+        /// </summary>
+        public unsafe ReadOnlySpan<ProcessConnectionSummary> Processes =>
+            IsReleased
+                ? ReadOnlySpan<ProcessConnectionSummary>.Empty
+                : new ReadOnlySpan<ProcessConnectionSummary>(_processes.ToPointer(), _processCount);
+
+        /// <summary>
+        /// 本周期有连接打开或关闭的进程 (按 PID 升序)
+        /// </summary>
+        public unsafe ReadOnlySpan<ProcessConnectionChurn> Churn =>
+            IsReleased
+                ? ReadOnlySpan<ProcessConnectionChurn>.Empty
+                : new ReadOnlySpan<ProcessConnectionChurn>(_churn.ToPointer(), _churnCount);
+
+        /// <summary>
+        /// 行首次被观察到的时间
+        /// </summary>
+        /// <param name="rowIndex">行在 Rows 中的下标</param>
+        public unsafe DateTimeOffset GetFirstSeen(int rowIndex)
+        {
+            if (IsClosed)
+            {
+                throw new ObjectDisposedException(nameof(NetworkConnectionSnapshot));
+            }
+
+            if ((uint)rowIndex >= (uint)_firstSeenCount)
+            {
+                throw new ArgumentOutOfRangeException(nameof(rowIndex));
+            }
+
+            return DateTimeOffset.FromUnixTimeMilliseconds((long)((ulong*)_firstSeen.ToPointer())[rowIndex]);
+        }
+
+        /// <summary>
+        /// 进程的全部连接 (同一进程的行在快照中连续存放)
+        /// </summary>
+        public ReadOnlySpan<NetworkConnectionRow> GetRows(in ProcessConnectionSummary summary) =>
+            Rows.Slice((int)summary.FirstRow, (int)summary.ConnectionCount);
+
+        /// <summary>
+        /// 指定进程的全部连接，进程没有套接字时为空
+        /// </summary>
+        public ReadOnlySpan<NetworkConnectionRow> GetRows(uint processId)
+        {
+            if (IsReleased) return ReadOnlySpan<NetworkConnectionRow>.Empty;
+
+            int count = (int)NetworkSnapshot_FindByProcess(handle, processId, out uint firstRow);
+            return count == 0 ? ReadOnlySpan<NetworkConnectionRow>.Empty : Rows.Slice((int)firstRow, count);
+        }
+
+        /// <summary>
+        /// 查找使用指定本地端口的行
+        /// </summary>
+        /// <param name="port">本地端口</param>
+        /// <param name="indices">输出：匹配行在 Rows 中的下标 (升序)</param>
+        /// <returns>匹配行总数，大于 indices 长度时仅写入前 indices.Length 个</returns>
+        public unsafe int FindByLocalPort(ushort port, Span<uint> indices)
+        {
+            if (IsReleased) return 0;
+
+            fixed (uint* output = indices)
+            {
+                return (int)NetworkSnapshot_FindByLocalPort(handle, port, output, (nuint)indices.Length);
+            }
+        }
+
+        /// <summary>
+        /// 进程的 TCP 监听端口 (升序且不重复)
+        /// </summary>
+        public unsafe ReadOnlySpan<ushort> GetListeningPorts(in ProcessConnectionSummary summary) =>
+            IsReleased
+                ? ReadOnlySpan<ushort>.Empty
+                : new ReadOnlySpan<ushort>(_listeningPorts.ToPointer(), _listeningPortCount)
+                    .Slice((int)summary.ListeningPortOffset, (int)summary.ListeningPortCount);
+
+        /// <summary>
+        /// 在原生层对快照求值过滤条件
+        /// </summary>
+        /// <param name="filter">过滤条件</param>
+        /// <param name="indices">输出：匹配行在 Rows 中的下标 (升序)</param>
+        /// <returns>匹配行总数，大于 indices 长度时仅写入前 indices.Length 个</returns>
+        public unsafe int Query(ConnectionFilter filter, Span<uint> indices)
+        {
+            if (IsReleased) return 0;
+
+            fixed (uint* processIds = filter.ProcessIds)
+            fixed (uint* output = indices)
+            {
+                var native = filter.ToNative((IntPtr)processIds);
+                return (int)NetworkSnapshot_Query(handle, in native, output, (nuint)indices.Length);
+            }
+        }
+
+        public IPAddress GetLocalAddress(in NetworkConnectionRow row) =>
+            ResolveAddress(row.Family, row.LocalAddressOrIndex);
+
+        public IPAddress GetRemoteAddress(in NetworkConnectionRow row) =>
+            ResolveAddress(row.Family, row.RemoteAddressOrIndex);
+
+        private IPAddress ResolveAddress(AddressFamily family, uint value) =>
+            family == AddressFamily.Ipv6
+                ? Addresses[(int)value].ToIPAddress()
+                : new IPAddress(value);
+
+        protected override bool ReleaseHandle()
+        {
+            NetworkMonitor_ReleaseSnapshot(handle);
+            _monitor.DangerousRelease();
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// 已解析地址的双栈连接记录
+    /// </summary>
+    public readonly struct NetworkConnectionEntry
+    {
+        public NetworkConnectionEntry(in NetworkConnectionRow row, IPAddress localAddress, IPAddress remoteAddress)
+        {
+            LocalAddress = localAddress;
+            RemoteAddress = remoteAddress;
+            LocalPort = row.LocalPort;
+            RemotePort = row.RemotePort;
+            State = row.State;
+            Protocol = row.Protocol;
+            ProcessId = row.ProcessId;
+            Family = row.Family;
+        }
+
+        public IPAddress LocalAddress { get; }
+
+        public IPAddress RemoteAddress { get; }
+
+        public ushort LocalPort { get; }
+
+        public ushort RemotePort { get; }
+
+        public ConnectionState State { get; }
+
+        public ProtocolType Protocol { get; }
+
+        public uint ProcessId { get; }
+
+        public AddressFamily Family { get; }
+
+        public string LocalAddressString => LocalAddress.ToString();
+
+        public string RemoteAddressString => RemoteAddress.ToString();
+
+        /// <summary>
+        /// 本地端点字符串 (IPv6 地址使用方括号)
+        /// </summary>
+        public string LocalEndPoint => new IPEndPoint(LocalAddress, LocalPort).ToString();
+
+        /// <summary>
+        /// 远程端点字符串 (IPv6 地址使用方括号)
+        /// </summary>
+        public string RemoteEndPoint => new IPEndPoint(RemoteAddress, RemotePort).ToString();
+    }
+
+    /// <summary>
+    /// 连接增量记录结构体
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public readonly struct NetworkConnectionDelta
+    {
+        private readonly NetworkConnectionInfo _connection;
+        private readonly ConnectionChangeKind _kind;
+        private readonly ConnectionState _previousState;
+
+        /// <summary>
+        /// 由 IPv4 双栈增量记录转换
+        /// </summary>
+        internal NetworkConnectionDelta(in NetworkConnectionRowDelta delta)
+        {
+            _connection = new NetworkConnectionInfo(delta.Connection);
+            _kind = delta.Kind;
+            _previousState = delta.PreviousState;
+        }
+
+        /// <summary>
+        /// 变更后的连接 (Removed 时为上一代的记录)
+        /// </summary>
+        public NetworkConnectionInfo Connection => _connection;
+
+        /// <summary>
+        /// 变更类型
+        /// </summary>
+        public ConnectionChangeKind Kind => _kind;
+
+        /// <summary>
+        /// 上一代的连接状态
+        /// </summary>
+        public ConnectionState PreviousState => _previousState;
+    }
+
     /// <summary>
     /// 网络连接显示模型
     /// </summary>
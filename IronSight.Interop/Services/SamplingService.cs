@@ -0,0 +1,108 @@
+﻿using IronSight.Interop.Core;
+using IronSight.Interop.Native.Sampling;
+using static IronSight.Interop.Native.Sampling.SamplingMethods;
+
+namespace IronSight.Interop.Services
+{
+    /// <summary>
+    /// 新快照就绪事件参数
+    /// </summary>
+    public sealed class SnapshotReadyEventArgs : EventArgs
+    {
+        public SnapshotReadyEventArgs(SamplingCollector collector, IntPtr source, ulong version)
+        {
+            Collector = collector;
+            Source = source;
+            Version = version;
+        }
+
+        public SamplingCollector Collector { get; }
+
+        /// <summary>
+        /// 采集器实例 (Network 为 NetworkMonitor 句柄，其余为 IntPtr.Zero)
+        /// </summary>
+        public IntPtr Source { get; }
+
+        public ulong Version { get; }
+    }
+
+    /// <summary>
+    /// 原生后台采样调度器的托管入口
+    /// 采样在原生线程上进行，仅在新快照就绪时触发 SnapshotReady，订阅方需自行切换到 UI 线程
+    /// </summary>
+    public static class SamplingService
+    {
+        private static readonly object _syncRoot = new();
+        private static EventHandler<SnapshotReadyEventArgs>? _snapshotReady;
+
+        // 必须保持引用，防止回调委托被 GC 回收
+        private static SnapshotReadyCallback? _nativeCallback;
+
+        /// <summary>
+        /// 新快照就绪事件 (在原生采样线程上触发)
+        /// </summary>
+        public static event EventHandler<SnapshotReadyEventArgs> SnapshotReady
+        {
+            add
+            {
+                lock (_syncRoot)
+                {
+                    _snapshotReady += value;
+                    EnsureCallbackRegistered();
+                }
+            }
+            remove
+            {
+                lock (_syncRoot)
+                {
+                    _snapshotReady -= value;
+                }
+            }
+        }
+
+        /// <summary>
+        /// 设置系统级采集器的采样间隔，TimeSpan.Zero 表示停止该采集器
+        /// </summary>
+        public static void SetInterval(SamplingCollector collector, TimeSpan interval)
+        {
+            if (collector == SamplingCollector.Network)
+            {
+                throw new ArgumentException(
+                    "Network sampling is bound to a monitor instance; use NetworkService.UpdateTickRate.", nameof(collector));
+            }
+
+            if (!SamplingScheduler_SetInterval(collector, (uint)interval.TotalMilliseconds))
+            {
+                throw new InvalidOperationException($"Failed to update sampling interval for {collector}.");
+            }
+        }
+
+        /// <summary>
+        /// 停止后台采样线程并移除所有采集器
+        /// </summary>
+        public static void Stop()
+        {
+            SamplingScheduler_Stop();
+        }
+
+        private static void EnsureCallbackRegistered()
+        {
+            if (_nativeCallback != null) return;
+
+            _nativeCallback = OnNativeSnapshotReady;
+            SamplingScheduler_RegisterCallback(_nativeCallback);
+        }
+
+        private static void OnNativeSnapshotReady(SamplingCollector collector, IntPtr source, ulong version)
+        {
+            try
+            {
+                _snapshotReady?.Invoke(null, new SnapshotReadyEventArgs(collector, source, version));
+            }
+            catch (Exception ex)
+            {
+                LoggerService.Log(LogLevel.Error, $"Error in SnapshotReady handler: {ex.Message}");
+            }
+        }
+    }
+}
@@ -1,15 +1,21 @@
 using System;
-using System.Timers;
+using IronSight.Interop.Native.Sampling;
 using IronSight.Interop.Native.System;
 using IronSight.Interop.Events;
 using IronSight.Interop.Core;
 
 namespace IronSight.Interop.Services
 {
+    /// <summary>
+    /// CPU 与磁盘计数器服务
+    /// 计数器由原生采样调度器定期采集，每次采集完成后读取格式化值并触发 StatsUpdated (在原生采样线程上)
+    /// </summary>
     public class SystemMonitorService : IDisposable
     {
-        private System.Timers.Timer _timer;
+        private static readonly TimeSpan SampleInterval = TimeSpan.FromSeconds(1);
+
         private bool _isInitialized;
+        private bool _isRunning;
 
         public event EventHandler<SystemStatsEventArgs> StatsUpdated;
 
@@ -21,32 +27,33 @@ namespace IronSight.Interop.Services
                 // Handle error or log
                 LoggerService.Log(LogLevel.Error, "Failed to initialize SystemMonitor");
             }
-
-            _timer = new System.Timers.Timer(1000); // 1 second update interval
-            _timer.Elapsed += OnTimerElapsed;
-            _timer.AutoReset = true;
         }
 
         public void Start()
         {
-            if (_isInitialized)
-            {
-                _timer.Start();
-            }
+            if (!_isInitialized || _isRunning) return;
+
+            SamplingService.SnapshotReady += OnSnapshotReady;
+            SamplingService.SetInterval(SamplingCollector.SystemMonitor, SampleInterval);
+            _isRunning = true;
         }
 
         public void Stop()
         {
-            _timer.Stop();
+            if (!_isRunning) return;
+
+            SamplingService.SetInterval(SamplingCollector.SystemMonitor, TimeSpan.Zero);
+            SamplingService.SnapshotReady -= OnSnapshotReady;
+            _isRunning = false;
         }
 
-        private void OnTimerElapsed(object sender, ElapsedEventArgs e)
+        private void OnSnapshotReady(object? sender, SnapshotReadyEventArgs e)
         {
-            if (!_isInitialized) return;
+            if (e.Collector != SamplingCollector.SystemMonitor) return;
 
             try
             {
-                SystemMethods.UpdateSystemStats();
+                // 采样线程已完成本次 PdhCollectQueryData，这里只读取格式化值
                 double cpu = SystemMethods.GetCpuUsage();
                 double diskRead = SystemMethods.GetDiskReadRate();
                 double diskWrite = SystemMethods.GetDiskWriteRate();
@@ -62,7 +69,6 @@ namespace IronSight.Interop.Services
         public void Dispose()
         {
             Stop();
-            _timer.Dispose();
             if (_isInitialized)
             {
                 SystemMethods.CleanupSystemMonitor();
@@ -70,4 +76,4 @@ namespace IronSight.Interop.Services
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -1,7 +1,8 @@
 ﻿using System;
 using System.Collections.Generic;
 using System.Linq;
-using System.Timers;
+using System.Threading;
+using IronSight.Interop.Native.Sampling;
 using IronSight.Interop.Native.System;
 using IronSight.Interop.Core;
 
@@ -9,14 +10,26 @@ namespace IronSight.Interop.Services
 {
     /// <summary>
     /// 系统监控服务扩展版 - 专门负责高频、深度的进程与性能分析
+    /// 由原生采样调度器驱动：每次性能快照就绪后 (在原生采样线程上) 发布快照并增量获取进程列表，
+    /// 同一采样线程上的回调依次执行，不会重叠
     /// </summary>
     public class SystemMonitorServiceEx : IDisposable
     {
-        private readonly System.Timers.Timer _timer;
+        private const int MaxProcessCount = 2048;
+
+        private readonly TimeSpan _interval;
         private bool _isInitialized = false;
+        private bool _isRunning;
+
+        // 上一次成功交付的变更集版本，0 表示下次需要完整重置
+        private ulong _processVersion;
+        private int _resyncRequested;
 
-        // 事件：当详细快照更新时触发
-        public event EventHandler<List<ProcessDetailInfo>>? ProcessListUpdated;
+        // 回调正在执行时为 1；采样线程上的回调本不会重叠，这里防止其他线程上的订阅路径重入
+        private int _collecting;
+
+        // 事件：进程列表变更集 (新进程、退出的 PID、动态字段有变化的进程)
+        public event EventHandler<ProcessChangeSet>? ProcessChangesUpdated;
         public event EventHandler<SystemPerformanceSnapshot>? GlobalSnapshotUpdated;
 
         public SystemMonitorServiceEx(double intervalMs = 2000)
@@ -28,50 +41,78 @@ namespace IronSight.Interop.Services
                 LoggerService.Log(LogLevel.Error, "Failed to initialize SystemMonitorEx");
             }
 
-            _timer = new System.Timers.Timer(intervalMs);
-            _timer.Elapsed += OnTimerElapsed;
-            _timer.AutoReset = true;
+            _interval = TimeSpan.FromMilliseconds(intervalMs);
         }
 
         public void Start()
         {
-            if (_isInitialized)
-            {
-                _timer.Start();
-            }
+            if (!_isInitialized || _isRunning) return;
+
+            SamplingService.SnapshotReady += OnSnapshotReady;
+            SamplingService.SetInterval(SamplingCollector.SystemMethods, _interval);
+            _isRunning = true;
         }
-        public void Stop() => _timer.Stop();
 
-        private void OnTimerElapsed(object? sender, ElapsedEventArgs e)
+        public void Stop()
         {
-            if (!_isInitialized) return;
+            if (!_isRunning) return;
+
+            SamplingService.SetInterval(SamplingCollector.SystemMethods, TimeSpan.Zero);
+            SamplingService.SnapshotReady -= OnSnapshotReady;
+            _isRunning = false;
+        }
+
+        /// <summary>
+        /// 订阅方丢弃了某次变更集时调用，下一次将收到包含全部进程的重置变更集
+        /// </summary>
+        public void RequestProcessResync() => Interlocked.Exchange(ref _resyncRequested, 1);
+
+        private void OnSnapshotReady(object? sender, SnapshotReadyEventArgs e)
+        {
+            if (e.Collector != SamplingCollector.SystemMethods || !_isInitialized) return;
+            if (Interlocked.Exchange(ref _collecting, 1) != 0) return;
 
             try
             {
-                // 1. 获取全局性能快照
-                var globalSnapshot = SystemMethods.GetSystemPerformanceSnapshot();
+                // 1. 读取采样线程刚生成的全局性能快照 (不再重新采集)
+                SystemMethods.GetLatestSystemPerformanceSnapshot(out var globalSnapshot);
                 GlobalSnapshotUpdated?.Invoke(this, globalSnapshot);
 
-                // 2. 获取深度进程列表 (预留 2000 个缓冲区)
-                var buffer = new ProcessDetailInfo[2048];
-                int actualCount = SystemMethods.GetDetailedProcessList(buffer, buffer.Length);
+                // 2. 增量获取进程列表：只跨边界传输新进程、退出的 PID 与动态字段有变化的进程
+                ulong baseVersion = Interlocked.Exchange(ref _resyncRequested, 0) != 0 ? 0 : _processVersion;
+                ulong version = SystemMethods.CollectProcessChanges(baseVersion, MaxProcessCount, out var info);
 
-                if (actualCount > 0)
+                if (version != 0)
                 {
-                    var resultList = buffer.Take(actualCount).ToList();
-                    ProcessListUpdated?.Invoke(this, resultList);
+                    var changes = new ProcessChangeSet(info);
+
+                    if (SystemMethods.CopyProcessChanges(version,
+                        changes.Added, changes.Added.Length,
+                        changes.Updated, changes.Updated.Length,
+                        changes.Exited, changes.Exited.Length))
+                    {
+                        _processVersion = version;
+                        ProcessChangesUpdated?.Invoke(this, changes);
+                    }
+                    else
+                    {
+                        _processVersion = 0;
+                    }
                 }
             }
             catch (Exception ex)
             {
                 LoggerService.Log(LogLevel.Error, $"SystemMonitorServiceEx 运行异常: {ex.Message}");
             }
+            finally
+            {
+                Interlocked.Exchange(ref _collecting, 0);
+            }
         }
 
         public void Dispose()
         {
             Stop();
-            _timer?.Dispose();
             if (_isInitialized)
             {
                 SystemMethods.CleanupSystemMethods();
@@ -79,4 +120,37 @@ namespace IronSight.Interop.Services
             }
         }
     }
+
+    /// <summary>
+    /// 一次进程列表变更集
+    /// 应用顺序：IsReset 时清空本地列表 -> 移除 Exited -> 添加/覆盖 Added -> 应用 Updated
+    /// </summary>
+    public sealed class ProcessChangeSet
+    {
+        internal ProcessChangeSet(in ProcessChangeSetInfo info)
+        {
+            Version = info.Version;
+            IsReset = info.IsReset != 0;
+            ProcessCount = (int)info.ProcessCount;
+            Added = info.AddedCount > 0 ? new ProcessStaticRecord[info.AddedCount] : Array.Empty<ProcessStaticRecord>();
+            Updated = info.UpdatedCount > 0 ? new ProcessUpdateRecord[info.UpdatedCount] : Array.Empty<ProcessUpdateRecord>();
+            Exited = info.ExitedCount > 0 ? new uint[info.ExitedCount] : Array.Empty<uint>();
+        }
+
+        public ulong Version { get; }
+
+        /// <summary>
+        /// 为 true 时变更集包含全部进程，应先清空本地列表
+        /// </summary>
+        public bool IsReset { get; }
+
+        /// <summary>
+        /// 应用后的进程总数
+        /// </summary>
+        public int ProcessCount { get; }
+
+        public ProcessStaticRecord[] Added { get; }
+        public ProcessUpdateRecord[] Updated { get; }
+        public uint[] Exited { get; }
+    }
 }
\ No newline at end of file